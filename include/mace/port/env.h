@@ -50,6 +50,18 @@ class Env {
   virtual MaceStatus AdviseFree(void *addr, size_t length);
   virtual MaceStatus GetCPUMaxFreq(std::vector<float> *max_freqs);
   virtual MaceStatus SchedSetAffinity(const std::vector<size_t> &cpu_ids);
+  // The CPU ids of each NUMA node, indexed by the node id.
+  virtual MaceStatus GetNumaNodeCPUs(
+      std::vector<std::vector<size_t>> *node_cpus);
+  // Allocate the pages of the page aligned memory on the NUMA node.
+  virtual MaceStatus BindMemoryToNumaNode(void *addr, size_t length,
+                                          int node);
+  // Map the huge page aligned memory of length rounded up to huge pages,
+  // with the reserved huge pages if explicit_huge_pages, or advise the kernel
+  // to use transparent huge pages otherwise.
+  virtual MaceStatus HugePageAlloc(void **memptr, size_t *length,
+                                   bool explicit_huge_pages);
+  virtual MaceStatus HugePageFree(void *addr, size_t length);
   virtual FileSystem *GetFileSystem() = 0;
   virtual LogWriter *GetLogWriter() = 0;
   // Return the current backtrace, will allocate memory inside the call
@@ -88,6 +100,25 @@ inline MaceStatus SchedSetAffinity(const std::vector<size_t> &cpu_ids) {
   return port::Env::Default()->SchedSetAffinity(cpu_ids);
 }
 
+inline MaceStatus GetNumaNodeCPUs(
+    std::vector<std::vector<size_t>> *node_cpus) {
+  return port::Env::Default()->GetNumaNodeCPUs(node_cpus);
+}
+
+inline MaceStatus BindMemoryToNumaNode(void *addr, size_t length, int node) {
+  return port::Env::Default()->BindMemoryToNumaNode(addr, length, node);
+}
+
+inline MaceStatus HugePageAlloc(void **memptr, size_t *length,
+                                bool explicit_huge_pages) {
+  return port::Env::Default()->HugePageAlloc(memptr, length,
+                                             explicit_huge_pages);
+}
+
+inline MaceStatus HugePageFree(void *addr, size_t length) {
+  return port::Env::Default()->HugePageFree(addr, length);
+}
+
 inline port::FileSystem *GetFileSystem() {
   return port::Env::Default()->GetFileSystem();
 }
@@ -19,6 +19,7 @@
 #define MACE_PUBLIC_MACE_H_
 
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <memory>
 #include <string>
@@ -82,6 +83,8 @@ enum MemoryType {
 
 enum class DataFormat {
   NONE = 0, NHWC = 1, NCHW = 2,
+  // CPU internal, the channels are blocked as N, C/x, H, W, x.
+  NCHWc = 3,
   HWOI = 100, OIHW = 101, HWIO = 102, OHWI = 103,
   AUTO = 1000,
 };
@@ -124,6 +127,16 @@ enum CPUAffinityPolicy {
   AFFINITY_POWER_SAVE = 4,
 };
 
+// Huge pages back the large CPU buffers to reduce the TLB misses.
+// HUGE_PAGE_TRANSPARENT: Advise the kernel to use transparent huge pages.
+// HUGE_PAGE_EXPLICIT: Use the reserved huge pages (vm.nr_hugepages), fall
+//                     back to the transparent ones if there are not enough.
+enum CPUHugePagePolicy {
+  HUGE_PAGE_NONE = 0,
+  HUGE_PAGE_TRANSPARENT = 1,
+  HUGE_PAGE_EXPLICIT = 2,
+};
+
 enum class OpenCLCacheReusePolicy {
   REUSE_NONE = 0,
   REUSE_SAME_GPU = 1,
@@ -247,6 +260,8 @@ class MACE_API MaceStatus {
     MACE_OUT_OF_RESOURCES = 2,
     MACE_UNSUPPORTED = 3,
     MACE_RUNTIME_ERROR = 4,
+    MACE_CANCELLED = 5,
+    MACE_DEADLINE_EXCEEDED = 6,
   };
 
  public:
@@ -368,9 +383,22 @@ class MACE_API GPUContextBuilder {
   std::unique_ptr<Impl> impl_;
 };
 
+class MaceTensor;
+
+/// \brief Decide whether a run exits early at a checkpoint.
+///
+/// \param tensor the checkpoint tensor, in the data format of the model even
+///        if the CPU ops compute it in NCHW or NCHWc. Its data is only valid
+///        during the call.
+/// \return true to stop the run.
+typedef std::function<bool(const MaceTensor &tensor)> CheckpointPredicate;
+
 class MaceEngineCfgImpl;
+class BaseEngine;
 class MACE_API MaceEngineConfig {
   friend class BaseEngine;
+  friend std::unique_ptr<BaseEngine> SmartCreateEngine(
+      const MaceEngineConfig &config);
 
  public:
   MaceEngineConfig();
@@ -430,6 +458,45 @@ class MACE_API MaceEngineConfig {
   MaceStatus SetCPUThreadPolicy(int num_threads_hint,
                                 CPUAffinityPolicy policy);
 
+  /// \brief Run the CPU threads and allocate the CPU memory on a NUMA node.
+  ///
+  /// For multi-socket servers, the threads are bound to the CPUs of the node
+  /// instead of the cores chosen by the affinity policy, at most
+  /// num_threads_hint of them, and the weights and the activations are
+  /// allocated on the node's memory. The NUMA topology is read from sysfs,
+  /// the node is ignored if it is not found.
+  ///
+  /// \param node the NUMA node id, a negative one disables the binding.
+  /// \return MaceStatus::MACE_SUCCESS for success, other for failure.
+  MaceStatus SetCPUNumaNode(int node);
+
+  /// \brief Back the large CPU buffers with huge pages.
+  ///
+  /// The buffers of at least one huge page (2MB), such as the big weights
+  /// and the activation buffers, are mapped with huge pages, the weights are
+  /// copied into them instead of referencing the model data. It falls back
+  /// to the normal pages if huge pages are not available, and the share of
+  /// the CPU buffers backed by huge pages is logged after the first run.
+  ///
+  /// \param policy one of CPUHugePagePolicy.
+  /// \return MaceStatus::MACE_SUCCESS for success, other for failure.
+  MaceStatus SetCPUHugePagePolicy(CPUHugePagePolicy policy);
+
+  /// \brief Share the CPU weights with the other engines of the process.
+  ///
+  /// The weights are registered by their content in a process-wide registry,
+  /// engines with the same weights, e.g. different heads on a shared
+  /// backbone, reference one copy which is freed with the last engine. When
+  /// the engine is created from a model data file, the file is mapped once
+  /// per process and the weights are used from the mapping, so its pages are
+  /// shared with the other processes by the page cache; otherwise the weights
+  /// are copied and the model data is reported unused. It is ignored by the
+  /// engines bound to a NUMA node or using huge pages.
+  ///
+  /// \param enable whether to share the weights.
+  /// \return MaceStatus::MACE_SUCCESS for success, other for failure.
+  MaceStatus SetConstTensorSharing(bool enable);
+
   /// \brief Set Hexagon NN to run on unsigned PD
   ///
   /// Caution: This function must be called before any Hexagon related
@@ -494,6 +561,98 @@ class MACE_API MaceEngineConfig {
   MaceStatus SetAPUHints(uint8_t boost_hint,
                          APUPreferenceHint preference_hint);
 
+  /// \brief Run the sub graphs of a MultiNetDef as a pipeline.
+  ///
+  /// Each sub graph runs on its own thread with its own part of the CPU
+  /// threads, so when Run() is called from several threads, a request can
+  /// enter the first sub graph while the previous one is still in the
+  /// following sub graphs. It raises the throughput of a stream of requests,
+  /// the latency of a single request is about the same. The tensors passed
+  /// between sub graphs are double buffered. A pipelined engine can neither
+  /// be the tutor of another engine nor have a tutor.
+  ///
+  /// \param enable whether to run the sub graphs as a pipeline.
+  /// \param queue_capacity the max number of requests waiting before each
+  ///        sub graph.
+  /// \return MaceStatus::MACE_SUCCESS for success, other for failure.
+  MaceStatus SetPipelineExecution(bool enable, int queue_capacity = 2);
+
+  /// \brief Set the directory of the CPU init cache.
+  ///
+  /// The NetDef adapted for the CPU is saved in the directory the first
+  /// time a model is initialized, and is reused by the later initializations
+  /// of the same model, NetDef adaptation is skipped. The cache file is keyed
+  /// by the NetDef, the runtime and the MACE version, and is ignored if it is
+  /// corrupted. The cache does not contain the weights, it is still valid if
+  /// only the model data changes.
+  ///
+  /// \param path the directory, the APP must have the permission to read and
+  ///        write it. An empty path disables the cache.
+  /// \return MaceStatus::MACE_SUCCESS for success, other for failure.
+  MaceStatus SetInitCachePath(const std::string &path);
+
+  /// \brief Set the parameter file of the CPU autotuner.
+  ///
+  /// Some CPU ops, such as Conv2D, have several implementations and thread
+  /// tiling choices, the best one depends on the host. If MACE_TUNING=1 is
+  /// set in the environment, the candidates are timed for each op shape at
+  /// the first run and the fastest ones are written to the file when the
+  /// engine is destroyed. Otherwise the tuned parameters are read from the
+  /// file, and the built-in heuristics are used for the missing shapes.
+  ///
+  /// \param path the parameter file, an empty path disables the tuner.
+  /// \return MaceStatus::MACE_SUCCESS for success, other for failure.
+  MaceStatus SetCPUTuningParameterPath(const std::string &path);
+
+  /// \brief Run the ops of a float model on CPU in a lower precision.
+  ///
+  /// The compute bound ops (Conv2D, MatMul, FullyConnected...) run in
+  /// data_type, and the other ops follow the precision of their first input,
+  /// so Cast ops are only inserted where the precision changes. An op whose
+  /// name or type is in sensitivities runs in data_type only if its
+  /// sensitivity is not above tolerance, the normalization ops and Softmax
+  /// have a sensitivity of 1 by default. The ops without a kernel of
+  /// data_type stay in float. It is ignored by the quantized models and the
+  /// models which are not float.
+  ///
+  /// \param data_type IDT_BFLOAT16 or IDT_FLOAT16, IDT_FLOAT disables it.
+  /// \param sensitivities the sensitivity of the op names or types, e.g. the
+  ///        relative output error measured by running the op in data_type.
+  /// \param tolerance the largest sensitivity of the ops run in data_type.
+  /// \return MaceStatus::MACE_SUCCESS for success, other for failure.
+  MaceStatus SetCPUMixedPrecision(
+      IDataType data_type,
+      const std::map<std::string, float> &sensitivities =
+          std::map<std::string, float>(),
+      float tolerance = 0.f);
+
+  /// \brief Add a checkpoint at which a run could exit early.
+  ///
+  /// The predicate is called with the checkpoint tensor once the op producing
+  /// it has run, e.g. the output of an intermediate head of a cascaded
+  /// classifier, and the run stops there if it returns true. Run() then
+  /// returns MaceStatus::MACE_SUCCESS with the outputs computed so far, the
+  /// outputs which are not computed are removed from its outputs. Only float
+  /// tensors are passed to the predicate. Checkpoints are ignored by the
+  /// pipelined engines.
+  ///
+  /// \param tensor_name the output of an op of the model, usually one of the
+  ///        output nodes so that its value is returned.
+  /// \param predicate the exit condition, nullptr to exit only when the
+  ///        latency budget is exhausted.
+  /// \return MaceStatus::MACE_SUCCESS for success, other for failure.
+  MaceStatus AddCheckpoint(const std::string &tensor_name,
+                           CheckpointPredicate predicate = nullptr);
+
+  /// \brief Set the latency budget of a run.
+  ///
+  /// A run exits at the first checkpoint reached after the budget is
+  /// exhausted, whatever its predicate returns.
+  ///
+  /// \param budget_us the budget in microseconds, 0 means no budget.
+  /// \return MaceStatus::MACE_SUCCESS for success, other for failure.
+  MaceStatus SetCheckpointLatencyBudget(int64_t budget_us);
+
  private:
   std::shared_ptr<MaceEngineCfgImpl> impl_;
 };
@@ -550,6 +709,34 @@ class MACE_API MaceTensor {
   std::unique_ptr<Impl> impl_;
 };
 
+/// \brief The result of a run started by MaceEngine::RunAsync.
+///
+/// Copies of a RunFuture refer to the same run. Thread-safe.
+class MACE_API RunFuture {
+ public:
+  RunFuture();
+  ~RunFuture();
+
+  /// \brief Wait for the run to finish.
+  /// \return the status of the run, MACE_CANCELLED if it is cancelled and
+  ///         MACE_DEADLINE_EXCEEDED if its timeout has elapsed.
+  MaceStatus Wait() const;
+
+  /// \brief Wait at most timeout_us microseconds for the run to finish.
+  /// \return true if the run is finished.
+  bool WaitFor(int64_t timeout_us) const;
+
+  /// \brief Cancel the run.
+  ///
+  /// A queued run is dropped, a running one stops before its next op.
+  void Cancel();
+
+ private:
+  friend class MaceEngine;
+  class Impl;
+  std::shared_ptr<Impl> impl_;
+};
+
 class MACE_API MaceEngine {
  public:
   explicit MaceEngine(const MaceEngineConfig &config);
@@ -578,6 +765,27 @@ class MACE_API MaceEngine {
                  std::map<std::string, MaceTensor> *outputs,
                  RunMetadata *run_metadata);
 
+  /// \brief Run the model asynchronously.
+  ///
+  /// The runs are executed one by one in the request order by a thread of
+  /// the engine, so the inputs of the next run can be prepared meanwhile.
+  /// The input and output tensors must be kept alive until the run finishes,
+  /// and Run should not be called before the pending runs finish. The run
+  /// is cancelled through the returned future, and it stops with
+  /// MACE_DEADLINE_EXCEEDED once timeout_us microseconds have elapsed since
+  /// the request, either in the queue or between two ops. The pipeline
+  /// engine only checks them before the run starts.
+  ///
+  /// \param timeout_us the latency budget of the run, 0 for none.
+  /// \param callback called with the status when the run finishes, on the
+  ///        thread of the engine.
+  /// \return the future of the run.
+  RunFuture RunAsync(
+      const std::map<std::string, MaceTensor> &inputs,
+      std::map<std::string, MaceTensor> *outputs,
+      int64_t timeout_us = 0,
+      std::function<void(const MaceStatus &)> callback = nullptr);
+
   /// \brief Release intermediate buffer for layers' activations
   ///
   /// Caution: This function may hurt performance.
@@ -15,6 +15,7 @@
 #ifndef MACE_UTILS_MACE_ENGINE_CONFIG_H_
 #define MACE_UTILS_MACE_ENGINE_CONFIG_H_
 
+#include <map>
 #include <memory>
 #include <unordered_map>
 #include <string>
@@ -38,6 +39,12 @@ class MaceEngineCfgImpl {
   MaceStatus SetCPUThreadPolicy(int num_threads_hint,
                                 CPUAffinityPolicy policy);
 
+  MaceStatus SetCPUNumaNode(int node);
+
+  MaceStatus SetCPUHugePagePolicy(CPUHugePagePolicy policy);
+
+  MaceStatus SetConstTensorSharing(bool enable);
+
   MaceStatus SetHexagonToUnsignedPD();
 
   MaceStatus SetHexagonPower(HexagonNNCornerType corner,
@@ -53,10 +60,32 @@ class MaceEngineCfgImpl {
   MaceStatus SetAPUHints(uint8_t boost_hint,
                          APUPreferenceHint preference_hint);
 
+  MaceStatus SetPipelineExecution(bool enable, int queue_capacity);
+
+  MaceStatus SetInitCachePath(const std::string &path);
+
+  MaceStatus SetCPUTuningParameterPath(const std::string &path);
+
+  MaceStatus SetCPUMixedPrecision(
+      IDataType data_type,
+      const std::map<std::string, float> &sensitivities,
+      float tolerance);
+
+  MaceStatus AddCheckpoint(const std::string &tensor_name,
+                           CheckpointPredicate predicate);
+
+  MaceStatus SetCheckpointLatencyBudget(int64_t budget_us);
+
   int num_threads() const;
 
   CPUAffinityPolicy cpu_affinity_policy() const;
 
+  int cpu_numa_node() const;
+
+  CPUHugePagePolicy cpu_huge_page_policy() const;
+
+  bool const_tensor_sharing() const;
+
   std::shared_ptr<OpenclContext> opencl_context() const;
 
   GPUPriorityHint gpu_priority_hint() const;
@@ -83,9 +112,30 @@ class MaceEngineCfgImpl {
 
   RuntimeType runtime_type(const std::string &sub_graph_name) const;
 
+  bool pipeline_enabled() const;
+
+  int pipeline_queue_capacity() const;
+
+  std::string init_cache_path() const;
+
+  std::string cpu_tuning_parameter_path() const;
+
+  IDataType cpu_mixed_precision_data_type() const;
+
+  const std::map<std::string, float> &op_precision_sensitivities() const;
+
+  float op_precision_tolerance() const;
+
+  const std::map<std::string, CheckpointPredicate> &checkpoints() const;
+
+  int64_t checkpoint_latency_budget() const;
+
  private:
   int num_threads_;
   CPUAffinityPolicy cpu_affinity_policy_;
+  int cpu_numa_node_;
+  CPUHugePagePolicy cpu_huge_page_policy_;
+  bool const_tensor_sharing_;
   std::shared_ptr<OpenclContext> opencl_context_;
   GPUPriorityHint gpu_priority_hint_;
   GPUPerfHint gpu_perf_hint_;
@@ -98,6 +148,15 @@ class MaceEngineCfgImpl {
   std::string accelerator_storage_file_;
   uint8_t apu_boost_hint_;
   APUPreferenceHint apu_preference_hint_;
+  bool pipeline_enabled_;
+  int pipeline_queue_capacity_;
+  std::string init_cache_path_;
+  std::string cpu_tuning_parameter_path_;
+  IDataType cpu_mixed_precision_data_type_;
+  std::map<std::string, float> op_precision_sensitivities_;
+  float op_precision_tolerance_;
+  std::map<std::string, CheckpointPredicate> checkpoints_;
+  int64_t checkpoint_latency_budget_;
   std::unordered_map<std::string, int> runtime_map_;
 };
 
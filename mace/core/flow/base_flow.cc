@@ -18,6 +18,7 @@
 #include <functional>
 
 #include "mace/core/mace_tensor_impl.h"
+#include "mace/core/net/run_control.h"
 #include "mace/core/net_def_adapter.h"
 #include "mace/core/proto/net_def_helper.h"
 #include "mace/utils/math.h"
@@ -35,7 +36,8 @@ BaseFlow::BaseFlow(FlowContext *flow_context)
       cpu_runtime_(flow_context->cpu_runtime),
       main_runtime_(flow_context->main_runtime),
       thread_pool_(flow_context->thread_pool),
-      parent_engine_(flow_context->parent_engine) {}
+      parent_engine_(flow_context->parent_engine),
+      run_control_(flow_context->run_control) {}
 
 const std::string &BaseFlow::GetName() const {
   return name_;
@@ -61,6 +63,9 @@ MaceStatus BaseFlow::Init(const NetDef *net_def,
   for (auto &output_info : net_def->output_info()) {
     output_info_map_[output_info.name()] = output_info;
   }
+  if (run_control_ != nullptr && run_control_->has_checkpoints()) {
+    run_control_->SetCheckpointFormats(*net_def);
+  }
 
   MACE_RETURN_IF_ERROR(InitInputTensors());
   MACE_RETURN_IF_ERROR(AllocateBufferForInputTensors());
@@ -76,6 +81,14 @@ MaceStatus BaseFlow::Run(const std::map<std::string, MaceTensor> &inputs,
                          std::map<std::string, MaceTensor> *outputs,
                          RunMetadata *run_metadata) {
   MACE_CHECK_NOTNULL(outputs);
+  if (run_control_ != nullptr && run_control_->exited()) {
+    // The run exited early in a previous flow.
+    for (auto &output : *outputs) {
+      run_control_->SkipOutput(output.first);
+    }
+    return MaceStatus::MACE_SUCCESS;
+  }
+
   TensorMap input_tensors;
   TensorMap output_tensors;
 
@@ -107,6 +120,10 @@ MaceStatus BaseFlow::Run(const std::map<std::string, MaceTensor> &inputs,
 
   // Transpose output tensors
   for (auto &output : *outputs) {
+    if (run_control_ != nullptr && !run_control_->Produced(output.first)) {
+      run_control_->SkipOutput(output.first);
+      continue;
+    }
     Tensor *output_tensor = ws_->GetTensor(output.first);
     // save output
     MACE_RETURN_IF_ERROR(TransposeOutput(*output_tensor, &output));
@@ -40,6 +40,7 @@ class Runtime;
 class NetDef;
 class Tensor;
 class OpRegistry;
+class RunControl;
 
 struct FlowContext {
   MaceEngineCfgImpl *config_impl;
@@ -49,14 +50,16 @@ struct FlowContext {
   Runtime *main_runtime;
   utils::ThreadPool *thread_pool;
   BaseEngine *parent_engine;
+  RunControl *run_control;
 
   FlowContext(MaceEngineCfgImpl *cfg_impl, OpRegistry *op_reg,
               OpDelegatorRegistry *op_delegator_reg, Runtime *cpu_rt,
               Runtime *main_rt, utils::ThreadPool *thrd_pool,
-              BaseEngine *engine)
+              BaseEngine *engine, RunControl *control = nullptr)
       : config_impl(cfg_impl), op_registry(op_reg),
         op_delegator_registry(op_delegator_reg), cpu_runtime(cpu_rt),
-        main_runtime(main_rt), thread_pool(thrd_pool), parent_engine(engine) {}
+        main_runtime(main_rt), thread_pool(thrd_pool), parent_engine(engine),
+        run_control(control) {}
 };
 
 class BaseFlow {
@@ -133,6 +136,7 @@ class BaseFlow {
   Runtime *main_runtime_;
   utils::ThreadPool *thread_pool_;
   BaseEngine *parent_engine_;
+  RunControl *run_control_;
 };
 
 }  // namespace mace
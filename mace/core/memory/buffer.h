@@ -75,6 +75,10 @@ class Buffer : public MemInfo {
     return 0;
   }
 
+  virtual bool is_slice() const {
+    return false;
+  }
+
  private:
   void *buf_;
   void *host_;
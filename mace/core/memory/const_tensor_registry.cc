@@ -0,0 +1,162 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mace/core/memory/const_tensor_registry.h"
+
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include "mace/core/types.h"
+#include "mace/port/env.h"
+#include "mace/utils/logging.h"
+#include "mace/utils/string_util.h"
+
+namespace mace {
+
+namespace {
+// FNV-1a, it is combined with the CRC32 of the content to make collisions
+// between different weights negligible.
+uint64_t Fnv1aHash(const unsigned char *data, index_t size) {
+  uint64_t hash = 14695981039346656037ULL;
+  for (index_t i = 0; i < size; ++i) {
+    hash ^= data[i];
+    hash *= 1099511628211ULL;
+  }
+  return hash;
+}
+}  // namespace
+
+SharedConstTensor::SharedConstTensor(index_t bytes)
+    : buffer_(MemoryType::CPU_BUFFER, DataType::DT_UINT8, {bytes}) {
+  void *data = nullptr;
+  MACE_CHECK_SUCCESS(Memalign(&data, kMaceAlignment, bytes));
+  buffer_.SetBuf(data);
+  buffer_.SetHost(data);
+}
+
+SharedConstTensor::SharedConstTensor(
+    const void *data, index_t bytes,
+    std::shared_ptr<port::ReadOnlyMemoryRegion> region)
+    : buffer_(MemoryType::CPU_BUFFER, DataType::DT_UINT8, {bytes},
+              const_cast<void *>(data)),
+      region_(std::move(region)) {
+  MACE_CHECK(region_ != nullptr);
+  buffer_.SetHost(const_cast<void *>(data));
+}
+
+SharedConstTensor::~SharedConstTensor() {
+  if (owned()) {
+    free(buffer_.mutable_memory<void>());
+  }
+}
+
+ConstTensorRegistry *ConstTensorRegistry::Get() {
+  static ConstTensorRegistry registry;
+  return &registry;
+}
+
+std::string ConstTensorRegistry::Key(const ConstTensor &const_tensor,
+                                     DataType dst_dt,
+                                     const unsigned char *model_data) {
+  const unsigned char *data = model_data + const_tensor.offset();
+  const index_t bytes = const_tensor.data_size() *
+      GetEnumTypeSize(const_tensor.data_type());
+  std::vector<index_t> dims(const_tensor.dims().begin(),
+                            const_tensor.dims().end());
+  return MakeString(const_tensor.data_type(), "_", dst_dt, "_",
+                    MakeString(dims), "_", const_tensor.quantized(), "_",
+                    const_tensor.scale(), "_", const_tensor.zero_point(), "_",
+                    bytes, "_", CalculateCRC32(data, bytes), "_",
+                    Fnv1aHash(data, bytes));
+}
+
+std::shared_ptr<SharedConstTensor> ConstTensorRegistry::Find(
+    const std::string &key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto iter = tensors_.find(key);
+  if (iter == tensors_.end()) {
+    return nullptr;
+  }
+  return iter->second.lock();
+}
+
+std::shared_ptr<SharedConstTensor> ConstTensorRegistry::Insert(
+    const std::string &key, std::shared_ptr<SharedConstTensor> tensor) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &entry = tensors_[key];
+  auto registered = entry.lock();
+  if (registered != nullptr) {
+    return registered;
+  }
+  entry = tensor;
+
+  // Drop the keys of the released tensors.
+  for (auto iter = tensors_.begin(); iter != tensors_.end();) {
+    if (iter->second.expired()) {
+      iter = tensors_.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+  return tensor;
+}
+
+size_t ConstTensorRegistry::Size() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t size = 0;
+  for (auto &entry : tensors_) {
+    if (!entry.second.expired()) {
+      ++size;
+    }
+  }
+  return size;
+}
+
+MaceStatus ConstTensorRegistry::MapFile(
+    const std::string &path,
+    std::shared_ptr<port::ReadOnlyMemoryRegion> *region) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto &entry = files_[path];
+  *region = entry.lock();
+  if (*region != nullptr) {
+    return MaceStatus::MACE_SUCCESS;
+  }
+
+  std::unique_ptr<port::ReadOnlyMemoryRegion> mapped;
+  MACE_RETURN_IF_ERROR(GetFileSystem()->NewReadOnlyMemoryRegionFromFile(
+      path.c_str(), &mapped));
+  region->reset(mapped.release());
+  entry = *region;
+  return MaceStatus::MACE_SUCCESS;
+}
+
+std::shared_ptr<port::ReadOnlyMemoryRegion> ConstTensorRegistry::FindMappedFile(
+    const void *data) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto ptr = static_cast<const unsigned char *>(data);
+  for (auto &entry : files_) {
+    auto region = entry.second.lock();
+    if (region == nullptr) {
+      continue;
+    }
+    auto begin = static_cast<const unsigned char *>(region->data());
+    if (ptr >= begin && ptr < begin + region->length()) {
+      return region;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace mace
@@ -0,0 +1,97 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MACE_CORE_MEMORY_CONST_TENSOR_REGISTRY_H_
+#define MACE_CORE_MEMORY_CONST_TENSOR_REGISTRY_H_
+
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <unordered_map>
+
+#include "mace/core/memory/buffer.h"
+#include "mace/port/file_system.h"
+#include "mace/proto/mace.pb.h"
+#include "mace/utils/macros.h"
+
+namespace mace {
+
+// The CPU data of a const tensor shared by the engines of the process. It
+// either owns a copy of the data or references a mapped model data file,
+// which is kept alive as long as the tensor.
+class SharedConstTensor {
+ public:
+  explicit SharedConstTensor(index_t bytes);
+  SharedConstTensor(const void *data, index_t bytes,
+                    std::shared_ptr<port::ReadOnlyMemoryRegion> region);
+  ~SharedConstTensor();
+
+  // The parent buffer to slice the tensors from.
+  Buffer *buffer() {
+    return &buffer_;
+  }
+
+  bool owned() const {
+    return region_ == nullptr;
+  }
+
+ private:
+  Buffer buffer_;
+  std::shared_ptr<port::ReadOnlyMemoryRegion> region_;
+
+  MACE_DISABLE_COPY_AND_ASSIGN(SharedConstTensor);
+};
+
+// Process-wide registry of the const tensors keyed by their content, the
+// tensors are refcounted by the workspaces using them and dropped with the
+// last one.
+class ConstTensorRegistry {
+ public:
+  static ConstTensorRegistry *Get();
+
+  // The key of the const tensor stored as dst_dt, computed from its content.
+  static std::string Key(const ConstTensor &const_tensor, DataType dst_dt,
+                         const unsigned char *model_data);
+
+  std::shared_ptr<SharedConstTensor> Find(const std::string &key);
+
+  // Register the tensor, return the one registered before with the same key
+  // if it is still alive.
+  std::shared_ptr<SharedConstTensor> Insert(
+      const std::string &key, std::shared_ptr<SharedConstTensor> tensor);
+
+  // The number of alive tensors.
+  size_t Size();
+
+  // Map the model data file once per process.
+  MaceStatus MapFile(const std::string &path,
+                     std::shared_ptr<port::ReadOnlyMemoryRegion> *region);
+
+  // Return the mapped file which contains the data, nullptr if there is none.
+  std::shared_ptr<port::ReadOnlyMemoryRegion> FindMappedFile(const void *data);
+
+ private:
+  ConstTensorRegistry() = default;
+
+  std::mutex mutex_;
+  std::unordered_map<std::string, std::weak_ptr<SharedConstTensor>> tensors_;
+  std::unordered_map<std::string, std::weak_ptr<port::ReadOnlyMemoryRegion>>
+      files_;
+
+  MACE_DISABLE_COPY_AND_ASSIGN(ConstTensorRegistry);
+};
+
+}  // namespace mace
+
+#endif  // MACE_CORE_MEMORY_CONST_TENSOR_REGISTRY_H_
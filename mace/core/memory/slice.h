@@ -34,6 +34,10 @@ class Slice : public Buffer {
     return buf_offset;
   }
 
+  bool is_slice() const override {
+    return true;
+  }
+
  private:
   index_t buf_offset;
 };
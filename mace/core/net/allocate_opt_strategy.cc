@@ -15,6 +15,9 @@
 #include "mace/core/net/allocate_strategy.h"
 
 #include <list>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "mace/core/tensor.h"
 #include "mace/utils/logging.h"
@@ -28,11 +31,24 @@ struct TensorRef {
   Tensor *tensor;
   int refs;
   Buffer *buffer;
+  // The buffer is handed over to an op output written in place.
+  bool buffer_moved;
 
   explicit TensorRef(Tensor *tensor_ptr)
-      : tensor(tensor_ptr), refs(1), buffer(nullptr) {}
+      : tensor(tensor_ptr), refs(1), buffer(nullptr), buffer_moved(false) {}
 };
 
+typedef std::unordered_map<std::string, std::shared_ptr<TensorRef>>
+    TensorRefMap;
+
+// The tensor is stored in parent's buffer at offset bytes.
+struct SliceInfo {
+  Tensor *parent;
+  index_t offset;
+};
+
+typedef std::unordered_map<std::string, SliceInfo> SliceInfoMap;
+
 // If *monotonous return false, the compare result is meaningless
 int CompareShape(const std::vector<index_t> &shape1,
                  const std::vector<index_t> &shape2, bool *monotonous) {
@@ -154,8 +170,7 @@ void SimulateDeleteBuffer(std::shared_ptr<TensorRef> tensor_ref,
   used_buf_list->erase(idx);
 }
 
-void ReallyAllocateBuffer(
-    std::unordered_map<std::string, std::shared_ptr<TensorRef>> tensor_refs) {
+void ReallyAllocateBuffer(const TensorRefMap &tensor_refs) {
   for (auto i = tensor_refs.begin(); i != tensor_refs.end(); ++i) {
     Buffer *buffer = i->second->buffer;
     if (buffer == nullptr) {
@@ -176,11 +191,115 @@ void ReallyAllocateBuffer(
     runtime->SetBufferToTensor(make_unique<Buffer>(*buffer), tensor);
   }
 }
+// Find the op inputs that can be produced directly in a slice of the op's
+// output buffer (e.g. Concat on the outermost axis). Such an input must be
+// produced by an earlier op and consumed only by this op.
+SliceInfoMap CollectSliceInfos(const OperationArray &operators,
+                               const TensorRefMap &tensor_refs) {
+  SliceInfoMap slice_infos;
+  std::unordered_set<std::string> produced_tensors;
+  for (auto &op : operators) {
+    size_t input_size = static_cast<size_t>(op->InputSize());
+    if (op->OutputSize() == 1 && input_size > 1) {
+      Tensor *output = op->Output(0);
+      std::vector<std::pair<std::string, index_t>> candidates;
+      index_t total_bytes = 0;
+      bool valid = output->memory_type() == MemoryType::CPU_BUFFER;
+      for (size_t i = 0; i < input_size && valid; ++i) {
+        const Tensor *input = op->Input(i);
+        const index_t offset = op->InputOffsetInOutput(i);
+        valid = offset == total_bytes && input->raw_size() > 0;
+        total_bytes += input->raw_size();
+        auto tensor_name = input->name();
+        auto iter = tensor_refs.find(tensor_name);
+        if (valid && !input->is_weight() &&
+            produced_tensors.count(tensor_name) > 0 &&
+            iter != tensor_refs.end() && iter->second->refs == 1 &&
+            iter->second->tensor == input &&
+            input->dtype() == output->dtype() &&
+            input->memory_type() == output->memory_type() &&
+            input->GetCurRuntime() == output->GetCurRuntime()) {
+          candidates.emplace_back(tensor_name, offset);
+        }
+      }
+      if (valid && total_bytes == output->raw_size()) {
+        for (auto &candidate : candidates) {
+          slice_infos.emplace(candidate.first,
+                              SliceInfo{output, candidate.second});
+        }
+      }
+    }
+
+    size_t output_size = static_cast<size_t>(op->OutputSize());
+    for (size_t i = 0; i < output_size; ++i) {
+      produced_tensors.insert(op->Output(i)->name());
+    }
+  }
+
+  // Nested slices are not supported, keep the outer ones.
+  for (auto iter = slice_infos.begin(); iter != slice_infos.end();) {
+    if (slice_infos.count(iter->second.parent->name()) > 0) {
+      iter = slice_infos.erase(iter);
+    } else {
+      ++iter;
+    }
+  }
+
+  return slice_infos;
+}
+
+// Find the input whose buffer the op's output can take over, see
+// Operation::CanOverwriteInput. The input must be produced by the net, have
+// the size of the output and not be read after the op.
+std::shared_ptr<TensorRef> FindOverwritableInput(
+    Operation *op, const TensorRefMap &tensor_refs,
+    const SliceInfoMap &slice_infos) {
+  if (op->OutputSize() != 1) {
+    return nullptr;
+  }
+  const Tensor *output = op->Output(0);
+  if (output->memory_type() != MemoryType::CPU_BUFFER) {
+    return nullptr;
+  }
+  size_t input_size = static_cast<size_t>(op->InputSize());
+  for (size_t i = 0; i < input_size; ++i) {
+    const Tensor *input = op->Input(i);
+    auto tensor_name = input->name();
+    if (!op->CanOverwriteInput(i) || input->is_weight() ||
+        slice_infos.count(tensor_name) > 0) {
+      continue;
+    }
+    auto iter = tensor_refs.find(tensor_name);
+    if (iter != tensor_refs.end() && iter->second->refs == 1 &&
+        iter->second->buffer != nullptr && !iter->second->buffer_moved &&
+        input->dtype() == output->dtype() &&
+        input->memory_type() == output->memory_type() &&
+        input->GetCurRuntime() == output->GetCurRuntime() &&
+        input->size() == output->size()) {
+      return iter->second;
+    }
+  }
+  return nullptr;
+}
+
+void ReallyAllocateSlices(const TensorRefMap &tensor_refs,
+                          const SliceInfoMap &slice_infos) {
+  for (auto &slice_info : slice_infos) {
+    Tensor *tensor = tensor_refs.at(slice_info.first)->tensor;
+    Tensor *parent = slice_info.second.parent;
+    VLOG(3) << "ReallyAllocateSlices, tensor " << tensor->name()
+            << " is a slice of " << parent->name()
+            << " at offset " << slice_info.second.offset;
+    tensor->GetCurRuntime()->AllocateBufferForTensor(
+        tensor, RENT_SLICE, parent->UnderlyingBuffer(),
+        slice_info.second.offset);
+  }
+}
 }  // namespace
 
 template<>
 MaceStatus AllocateTensorMemory<SERIAL_OPT>(const OperationArray &operators) {
-  std::unordered_map<std::string, std::shared_ptr<TensorRef>> tensor_refs;
+  TensorRefMap tensor_refs;
   // Collect the refs of input tensor
   for (auto &op : operators) {
     size_t input_size = static_cast<size_t>(op->InputSize());
@@ -225,6 +344,9 @@ MaceStatus AllocateTensorMemory<SERIAL_OPT>(const OperationArray &operators) {
     }
   }
 
+  const SliceInfoMap slice_infos = CollectSliceInfos(operators, tensor_refs);
+  std::unordered_set<std::string> early_allocated_tensors;
+
   BufferList used_buf_list;
   BufferList free_buf_list;
 
@@ -245,9 +367,36 @@ MaceStatus AllocateTensorMemory<SERIAL_OPT>(const OperationArray &operators) {
       std::shared_ptr<TensorRef> tensor_ref = tensor_refs.at(tensor_name);
       // The reused tensor does not need to allocate buffer
       auto essential_tensor_name = tensor_ref->tensor->name();
-      if (tensor_name == essential_tensor_name) {
-        SimulateAllocateBuffer(tensor_refs.at(tensor_name),
-                               &used_buf_list, &free_buf_list);
+      if (slice_infos.count(tensor_name) > 0) {
+        // The slice lives in its parent's buffer, which is allocated now.
+        Tensor *parent = slice_infos.at(tensor_name).parent;
+        auto parent_name = parent->name();
+        if (tensor_refs.count(parent_name) == 0) {
+          tensor_refs.emplace(parent_name,
+                              std::make_shared<TensorRef>(parent));
+          VLOG(2) << "tensor " << parent_name << " is model's output";
+        }
+        if (early_allocated_tensors.count(parent_name) == 0) {
+          SimulateAllocateBuffer(tensor_refs.at(parent_name),
+                                 &used_buf_list, &free_buf_list);
+          early_allocated_tensors.insert(parent_name);
+        }
+        VLOG(2) << "tensor " << tensor_name << " is a slice of "
+                << parent_name;
+      } else if (early_allocated_tensors.count(tensor_name) > 0) {
+        VLOG(2) << "tensor " << tensor_name << " is allocated for its slices";
+      } else if (tensor_name == essential_tensor_name) {
+        auto input_ref = FindOverwritableInput(op.get(), tensor_refs,
+                                               slice_infos);
+        if (input_ref != nullptr) {
+          VLOG(2) << "tensor " << tensor_name << " is written in place of "
+                  << input_ref->tensor->name();
+          tensor_ref->buffer = input_ref->buffer;
+          input_ref->buffer_moved = true;
+        } else {
+          SimulateAllocateBuffer(tensor_refs.at(tensor_name),
+                                 &used_buf_list, &free_buf_list);
+        }
       } else {
         VLOG(2) << "tensor " << tensor_name << " reuse the "
                 << essential_tensor_name;
@@ -269,11 +418,14 @@ MaceStatus AllocateTensorMemory<SERIAL_OPT>(const OperationArray &operators) {
       int ref_num = tensor_refs.at(tensor_name)->refs;
       MACE_CHECK(ref_num > 0);
       tensor_refs[tensor_name]->refs = ref_num - 1;
+      if (slice_infos.count(tensor_name) > 0) {
+        continue;
+      }
       if (tensor_refs[tensor_name]->buffer == nullptr) {
         VLOG(3) << "find a model input: " << tensor_name;
         continue;
       }
-      if (ref_num == 1) {
+      if (ref_num == 1 && !tensor_refs[tensor_name]->buffer_moved) {
         SimulateDeleteBuffer(tensor_refs[tensor_name],
                              &used_buf_list, &free_buf_list);
       }
@@ -281,6 +433,7 @@ MaceStatus AllocateTensorMemory<SERIAL_OPT>(const OperationArray &operators) {
   }
 
   ReallyAllocateBuffer(tensor_refs);
+  ReallyAllocateSlices(tensor_refs, slice_infos);
 
   return MaceStatus::MACE_SUCCESS;
 }
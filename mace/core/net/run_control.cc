@@ -0,0 +1,186 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mace/core/net/run_control.h"
+
+#include <utility>
+#include <vector>
+
+#include "mace/core/proto/arg_helper.h"
+#include "mace/core/tensor.h"
+#include "mace/proto/mace.pb.h"
+#include "mace/utils/logging.h"
+
+namespace mace {
+
+namespace {
+// Reorder a tensor in the CPU internal NCHWc to NCHW.
+void UnpackNCHWc(const float *input, const std::vector<int64_t> &shape,
+                 int64_t channels, float *output) {
+  const int64_t batch = shape[0];
+  const int64_t blocks = shape[1];
+  const int64_t image_size = shape[2] * shape[3];
+  const int64_t block = shape[4];
+  for (int64_t b = 0; b < batch; ++b) {
+    for (int64_t c = 0; c < channels; ++c) {
+      const float *src =
+          input + (b * blocks + c / block) * image_size * block + c % block;
+      float *dst = output + (b * channels + c) * image_size;
+      for (int64_t i = 0; i < image_size; ++i) {
+        dst[i] = src[i * block];
+      }
+    }
+  }
+}
+
+// Transpose a 4-D tensor, the dim i of the output is the dim dims[i] of the
+// input.
+void Transpose4D(const float *input, const std::vector<int64_t> &shape,
+                 const std::vector<int> &dims, float *output) {
+  int64_t strides[4] = {0, 0, 0, 1};
+  for (int i = 2; i >= 0; --i) {
+    strides[i] = strides[i + 1] * shape[i + 1];
+  }
+  const int64_t s0 = strides[dims[0]];
+  const int64_t s1 = strides[dims[1]];
+  const int64_t s2 = strides[dims[2]];
+  const int64_t s3 = strides[dims[3]];
+  for (int64_t i0 = 0; i0 < shape[dims[0]]; ++i0) {
+    for (int64_t i1 = 0; i1 < shape[dims[1]]; ++i1) {
+      for (int64_t i2 = 0; i2 < shape[dims[2]]; ++i2) {
+        const float *src = input + i0 * s0 + i1 * s1 + i2 * s2;
+        for (int64_t i3 = 0; i3 < shape[dims[3]]; ++i3) {
+          *output++ = src[i3 * s3];
+        }
+      }
+    }
+  }
+}
+}  // namespace
+
+void RunControl::BeginRun() {
+  begin_micros_ = latency_budget_micros_ > 0 ? NowMicros() : 0;
+  exited_ = false;
+  exit_checkpoint_.clear();
+  produced_.clear();
+  skipped_outputs_.clear();
+}
+
+bool RunControl::ShouldExitAt(const std::string &name,
+                              const Tensor *tensor) const {
+  auto iter = checkpoints_.find(name);
+  if (iter == checkpoints_.end()) {
+    return false;
+  }
+  if (latency_budget_micros_ > 0 &&
+      NowMicros() - begin_micros_ >= latency_budget_micros_) {
+    VLOG(1) << "Latency budget is exhausted at checkpoint " << name;
+    return true;
+  }
+  if (!iter->second) {
+    return false;
+  }
+  if (tensor->dtype() != DT_FLOAT) {
+    LOG(WARNING) << "Checkpoint " << name << " is not a float tensor, "
+                 << "its predicate is ignored";
+    return false;
+  }
+
+  Tensor::MappingGuard guard(tensor);
+  const std::vector<index_t> &tensor_shape = tensor->shape();
+  std::vector<int64_t> shape(tensor_shape.begin(), tensor_shape.end());
+  DataFormat data_format = tensor->data_format();
+  const float *tensor_data = tensor->data<float>();
+  // The tensor is only copied if its layout differs from the model, the
+  // predicate only reads it during the call.
+  std::vector<float> nchw_data;
+  std::vector<float> transposed_data;
+  auto format_iter = checkpoint_formats_.find(name);
+  if (data_format == DataFormat::NCHWc) {
+    if (format_iter == checkpoint_formats_.end() ||
+        format_iter->second.channels <= 0) {
+      LOG(WARNING) << "The channels of checkpoint " << name << " are "
+                   << "unknown, its predicate is ignored";
+      return false;
+    }
+    const int64_t channels = format_iter->second.channels;
+    nchw_data.resize(shape[0] * channels * shape[2] * shape[3]);
+    UnpackNCHWc(tensor_data, shape, channels, nchw_data.data());
+    shape = {shape[0], channels, shape[2], shape[3]};
+    data_format = DataFormat::NCHW;
+    tensor_data = nchw_data.data();
+  }
+  if (format_iter != checkpoint_formats_.end() && shape.size() == 4) {
+    const DataFormat model_format = format_iter->second.data_format;
+    std::vector<int> dst_dims;
+    if (data_format == DataFormat::NCHW &&
+        model_format == DataFormat::NHWC) {
+      dst_dims = {0, 2, 3, 1};
+    } else if (data_format == DataFormat::NHWC &&
+        model_format == DataFormat::NCHW) {
+      dst_dims = {0, 3, 1, 2};
+    }
+    if (!dst_dims.empty()) {
+      transposed_data.resize(shape[0] * shape[1] * shape[2] * shape[3]);
+      Transpose4D(tensor_data, shape, dst_dims, transposed_data.data());
+      shape = {shape[dst_dims[0]], shape[dst_dims[1]], shape[dst_dims[2]],
+               shape[dst_dims[3]]};
+      data_format = model_format;
+      tensor_data = transposed_data.data();
+    }
+  }
+
+  std::shared_ptr<void> data(const_cast<float *>(tensor_data),
+                             [](void *) {});
+  MaceTensor mace_tensor(shape, data, data_format);
+  return iter->second(mace_tensor);
+}
+
+void RunControl::SetCheckpointFormats(const NetDef &net_def) {
+  for (auto &op_def : net_def.op()) {
+    DataFormat data_format = static_cast<DataFormat>(
+        ProtoArgHelper::GetOptionalArg<OperatorDef, int>(
+            op_def, "data_format", static_cast<int>(DataFormat::NONE)));
+    // The 4-D tensors of the AUTO ops are NHWC in the model, the
+    // NetDefAdapter transposes them to the format of the runtime.
+    if (data_format == DataFormat::AUTO) {
+      data_format = DataFormat::NHWC;
+    }
+    for (int i = 0; i < op_def.output_size(); ++i) {
+      const std::string &name = op_def.output(i);
+      if (checkpoints_.count(name) == 0) {
+        continue;
+      }
+      CheckpointFormat &format = checkpoint_formats_[name];
+      format.data_format = data_format;
+      format.channels = 0;
+      if ((data_format == DataFormat::NHWC ||
+           data_format == DataFormat::NCHW) &&
+          i < op_def.output_shape_size() &&
+          op_def.output_shape(i).dims_size() == 4) {
+        format.channels = op_def.output_shape(i).dims(
+            data_format == DataFormat::NHWC ? 3 : 1);
+      }
+    }
+  }
+}
+
+void RunControl::Exit(const std::string &checkpoint,
+                      std::unordered_set<std::string> &&produced) {
+  exited_ = true;
+  exit_checkpoint_ = checkpoint;
+  produced_ = std::move(produced);
+}
+
+}  // namespace mace
@@ -0,0 +1,153 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MACE_CORE_NET_RUN_CONTROL_H_
+#define MACE_CORE_NET_RUN_CONTROL_H_
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>  // NOLINT(build/c++11)
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "mace/port/env.h"
+#include "mace/public/mace.h"
+#include "mace/utils/macros.h"
+
+namespace mace {
+
+class NetDef;
+class Tensor;
+
+// The cancellation and the deadline of the run in progress of an engine,
+// the nets check it between ops and stop the run if it is cancelled or the
+// deadline has passed. It also holds the checkpoints at which the run could
+// exit early with the outputs computed so far.
+class RunControl {
+ public:
+  RunControl() : run_id_(0), cancelled_(false), deadline_micros_(0),
+                 latency_budget_micros_(0), begin_micros_(0),
+                 exited_(false) {}
+
+  // Start the run, deadline_micros is compared with NowMicros, 0 means no
+  // deadline.
+  void Start(uint64_t run_id, int64_t deadline_micros) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    run_id_ = run_id;
+    cancelled_ = false;
+    deadline_micros_ = deadline_micros;
+  }
+
+  void Finish() {
+    Start(0, 0);
+  }
+
+  // Cancel the run if it is still in progress.
+  void Cancel(uint64_t run_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (run_id_ == run_id) {
+      cancelled_ = true;
+    }
+  }
+
+  MaceStatus Check() const {
+    if (cancelled_) {
+      return MaceStatus(MaceStatus::MACE_CANCELLED, "run is cancelled");
+    }
+    const int64_t deadline_micros = deadline_micros_;
+    if (deadline_micros > 0 && NowMicros() >= deadline_micros) {
+      return MaceStatus(MaceStatus::MACE_DEADLINE_EXCEEDED,
+                        "run is past its deadline");
+    }
+    return MaceStatus::MACE_SUCCESS;
+  }
+
+  void SetCheckpoints(
+      const std::map<std::string, CheckpointPredicate> &checkpoints,
+      int64_t latency_budget_micros) {
+    checkpoints_ = checkpoints;
+    latency_budget_micros_ = latency_budget_micros;
+  }
+
+  bool has_checkpoints() const {
+    return !checkpoints_.empty();
+  }
+
+  // Record the data formats of the checkpoint tensors in the model, the
+  // predicates get them in these formats even if the CPU ops compute them
+  // in NCHW or NCHWc.
+  void SetCheckpointFormats(const NetDef &net_def);
+
+  // Called by the engine at the beginning of each run.
+  void BeginRun();
+
+  // Whether the run exits after the op producing the checkpoint tensor.
+  bool ShouldExitAt(const std::string &name, const Tensor *tensor) const;
+
+  // Record the early exit, produced are the tensors computed by the net.
+  void Exit(const std::string &checkpoint,
+            std::unordered_set<std::string> &&produced);
+
+  bool exited() const {
+    return exited_;
+  }
+
+  const std::string &exit_checkpoint() const {
+    return exit_checkpoint_;
+  }
+
+  // Whether the tensor is computed, always true if the run does not exit.
+  bool Produced(const std::string &name) const {
+    return !exited_ || produced_.count(name) > 0;
+  }
+
+  // The outputs which are not computed because of the early exit.
+  void SkipOutput(const std::string &name) {
+    skipped_outputs_.insert(name);
+  }
+
+  const std::set<std::string> &skipped_outputs() const {
+    return skipped_outputs_;
+  }
+
+ private:
+  std::mutex mutex_;
+  uint64_t run_id_;
+  std::atomic<bool> cancelled_;
+  std::atomic<int64_t> deadline_micros_;
+
+  struct CheckpointFormat {
+    DataFormat data_format;
+    // The channels of a 4-D tensor, 0 if unknown.
+    int64_t channels;
+  };
+
+  std::map<std::string, CheckpointPredicate> checkpoints_;
+  std::map<std::string, CheckpointFormat> checkpoint_formats_;
+  int64_t latency_budget_micros_;
+  int64_t begin_micros_;
+  bool exited_;
+  std::string exit_checkpoint_;
+  std::unordered_set<std::string> produced_;
+  std::set<std::string> skipped_outputs_;
+
+  MACE_DISABLE_COPY_AND_ASSIGN(RunControl);
+};
+
+}  // namespace mace
+
+#endif  // MACE_CORE_NET_RUN_CONTROL_H_
@@ -22,6 +22,7 @@
 
 #include "mace/core/future.h"
 #include "mace/core/net/allocate_strategy.h"
+#include "mace/core/net/run_control.h"
 #include "mace/core/ops/op_init_context.h"
 #include "mace/core/ops/op_context.h"
 #include "mace/core/registry/ops_registry.h"
@@ -41,11 +42,13 @@ SerialNet::SerialNet(const OpRegistry *op_registry,
                      const NetDef *net_def,
                      Workspace *ws,
                      Runtime *target_runtime,
-                     Runtime *cpu_runtime)
+                     Runtime *cpu_runtime,
+                     RunControl *run_control)
     : BaseNet(),
       ws_(ws),
       target_runtime_(target_runtime),
-      cpu_runtime_(cpu_runtime) {
+      cpu_runtime_(cpu_runtime),
+      run_control_(run_control) {
   MACE_LATENCY_LOGGER(1, "Constructing SerialNet");
 
   OpConstructContext construct_context(ws_);
@@ -107,6 +110,9 @@ MaceStatus SerialNet::Run(RunMetadata *run_metadata,
       // Fake warm up is only used for OpenCL runtime.
       continue;
     }
+    if (run_control_ != nullptr) {
+      MACE_RETURN_IF_ERROR(run_control_->Check());
+    }
     MACE_LATENCY_LOGGER(1, "Running operator ", op->debug_def().name(),
                         "<", runtime_type, ", ", op->debug_def().type(),
                         ", ",
@@ -222,6 +228,26 @@ MaceStatus SerialNet::Run(RunMetadata *run_metadata,
         }
       }
     }
+
+    if (run_control_ != nullptr && run_control_->has_checkpoints() &&
+        !fake_warmup) {
+      for (int i = 0; i < op->OutputSize(); ++i) {
+        const std::string &output_name = op->debug_def().output(i);
+        if (!run_control_->ShouldExitAt(output_name, op->Output(i))) {
+          continue;
+        }
+        std::unordered_set<std::string> produced;
+        for (auto produced_iter = operators_.begin();
+             produced_iter != iter + 1; ++produced_iter) {
+          for (auto &name : (*produced_iter)->debug_def().output()) {
+            produced.insert(name);
+          }
+        }
+        VLOG(1) << "Exit the run at checkpoint " << output_name;
+        run_control_->Exit(output_name, std::move(produced));
+        return MaceStatus::MACE_SUCCESS;
+      }
+    }
   }
 
   return MaceStatus::MACE_SUCCESS;
@@ -28,6 +28,7 @@ namespace mace {
 
 class Workspace;
 class OpRegistry;
+class RunControl;
 
 class SerialNet : public BaseNet {
  public:
@@ -35,7 +36,8 @@ class SerialNet : public BaseNet {
             const NetDef *net_def,
             Workspace *ws,
             Runtime *target_runtime,
-            Runtime *cpu_runtime);
+            Runtime *cpu_runtime,
+            RunControl *run_control = nullptr);
   virtual ~SerialNet();
 
   MaceStatus Init() override;
@@ -50,6 +52,9 @@ class SerialNet : public BaseNet {
   Runtime *target_runtime_;
   // CPU is base device.
   Runtime *cpu_runtime_;
+  // Checked before each op and at the checkpoints to stop the run early,
+  // could be nullptr.
+  RunControl *run_control_;
   std::vector<std::unique_ptr<Operation>> operators_;
 
  protected:
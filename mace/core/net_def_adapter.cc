@@ -14,6 +14,8 @@
 
 #include "mace/core/net_def_adapter.h"
 
+#include <algorithm>
+#include <atomic>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -29,6 +31,8 @@
 namespace mace {
 
 namespace {
+std::atomic<int64_t> adapted_net_count(0);
+
 struct FilterRulerInfo {
   const int filter_idx;
   const std::vector<int> nhwc_oihw;
@@ -154,17 +158,134 @@ void BuildTransposeOpDef(
   }
 }
 
+std::vector<index_t> NCHWcShape(const std::vector<index_t> &nchw_shape) {
+  MACE_CHECK(nchw_shape.size() == 4);
+  return {nchw_shape[0], RoundUpDiv(nchw_shape[1], kNCHWcBlock),
+          nchw_shape[2], nchw_shape[3], kNCHWcBlock};
+}
+
+void BuildReorderOpDef(
+    const std::string &input_name,
+    const std::string &output_name,
+    const std::vector<index_t> &output_shape,
+    const index_t channels,
+    const DataFormat dst_df,
+    const DataType dt,
+    OperatorDef *op_def) {
+  std::string op_name = "mace_node_" + output_name;
+  op_def->set_name(op_name);
+  op_def->set_type("Reorder");
+  op_def->add_input(input_name);
+  op_def->add_output(output_name);
+  op_def->set_device_type(RT_CPU);
+  SetProtoArg<int>(op_def, "channels", static_cast<int>(channels));
+  SetProtoArg<int>(op_def, "data_format", static_cast<int>(dst_df));
+  SetProtoArg<int>(op_def, "T", static_cast<int>(dt));
+  SetProtoArg<int>(op_def, OutputMemoryTypeTagName(), CPU_BUFFER);
+  OutputShape *shape = op_def->add_output_shape();
+  for (auto value : output_shape) {
+    shape->add_dims(value);
+  }
+}
+
+void BuildCastOpDef(
+    const std::string &input_name,
+    const std::string &output_name,
+    const std::vector<index_t> &output_shape,
+    const DataType src_dt,
+    const DataType dst_dt,
+    const DataFormat data_format,
+    OperatorDef *op_def) {
+  std::string op_name = "mace_node_" + output_name;
+  op_def->set_name(op_name);
+  op_def->set_type("Cast");
+  op_def->add_input(input_name);
+  op_def->add_output(output_name);
+  op_def->add_output_type(dst_dt);
+  op_def->set_device_type(RT_CPU);
+  SetProtoArg<int>(op_def, "T", static_cast<int>(src_dt));
+  SetProtoArg<int>(op_def, "data_format", static_cast<int>(data_format));
+  SetProtoArg<int>(op_def, OutputMemoryTypeTagName(), CPU_BUFFER);
+  if (!output_shape.empty()) {
+    OutputShape *shape = op_def->add_output_shape();
+    for (auto value : output_shape) {
+      shape->add_dims(value);
+    }
+  }
+}
+
+bool IsFloatDataType(const DataType dt) {
+  return dt == DT_FLOAT || dt == DT_FLOAT16 || dt == DT_BFLOAT16;
+}
+
+// The ops which run in the lower precision of a mixed precision net unless
+// they are sensitive to it, the other ops follow their first input.
+bool IsComputeBoundOp(const std::string &op_type) {
+  static const std::unordered_set<std::string> kComputeBoundOps = {
+      "Conv2D", "Deconv2D", "DepthwiseConv2d", "DepthwiseDeconv2d",
+      "DynamicLSTM", "FullyConnected", "MatMul"};
+  return kComputeBoundOps.count(op_type) > 0;
+}
+
+// The ops accumulating statistics over many elements lose too much in the
+// lower precision by default.
+float DefaultPrecisionSensitivity(const std::string &op_type) {
+  static const std::unordered_set<std::string> kSensitiveOps = {
+      "GroupNorm", "InstanceNorm", "LpNorm", "MVNorm", "Reduce", "Softmax",
+      "SqrDiffMean", "TargetRMSNorm"};
+  return kSensitiveOps.count(op_type) > 0 ? 1.f : 0.f;
+}
+
+// Let the op output the tensor as new_name, and its consumers read it.
+void RenameOpOutput(const std::string &name,
+                    const std::string &new_name,
+                    int op_idx,
+                    const std::vector<int> &consumer_op_indices,
+                    NetDef *net_def) {
+  auto op_def = net_def->mutable_op(op_idx);
+  int output_size = op_def->output_size();
+  for (int i = 0; i < output_size; ++i) {
+    if (op_def->output(i) == name) {
+      op_def->set_output(i, new_name);
+    }
+  }
+  for (int idx : consumer_op_indices) {
+    auto consumer_op_def = net_def->mutable_op(idx);
+    int input_size = consumer_op_def->input_size();
+    for (int i = 0; i < input_size; ++i) {
+      if (consumer_op_def->input(i) == name) {
+        consumer_op_def->set_input(i, new_name);
+      }
+    }
+  }
+}
+
 }  // namespace
 
 NetDefAdapter::NetDefAdapter(const OpRegistry *op_registry,
                              const Workspace *ws)
-    : op_registry_(op_registry), ws_(ws) {}
+    : op_registry_(op_registry), ws_(ws), mixed_data_type_(DT_FLOAT),
+      precision_tolerance_(0.f) {}
+
+void NetDefAdapter::SetMixedPrecision(
+    const DataType data_type,
+    const std::map<std::string, float> &sensitivities,
+    const float tolerance) {
+  mixed_data_type_ = data_type;
+  op_sensitivities_ = sensitivities;
+  precision_tolerance_ = tolerance;
+}
+
+int64_t NetDefAdapter::AdaptedNetCount() {
+  return adapted_net_count;
+}
 
 MaceStatus NetDefAdapter::AdaptNetDef(const NetDef *net_def,
                                       Runtime *target_runtime,
                                       Runtime *cpu_runtime,
                                       NetDef *target_net_def) {
   MACE_LATENCY_LOGGER(1, "Adapting original NetDef");
+  ++adapted_net_count;
   // Copy from original op_def, leave ops alone.
   target_net_def->mutable_arg()->CopyFrom(net_def->arg());
   target_net_def->mutable_tensors()->CopyFrom(net_def->tensors());
@@ -187,6 +308,11 @@ MaceStatus NetDefAdapter::AdaptNetDef(const NetDef *net_def,
 
   const auto mem_type = target_runtime->GetBaseMemoryType();
   const auto runtime_type = target_runtime->GetRuntimeType();
+  // Mixed precision is only for the float nets run on CPU.
+  if (runtime_type != RuntimeType::RT_CPU || is_quantized_model ||
+      (net_def->data_type() != DT_FLOAT && net_def->data_type() != DT_HALF)) {
+    mixed_data_type_ = DT_FLOAT;
+  }
   DataFormat expected_data_format =
       GetDefaultDataFormat(runtime_type, is_quantized_model);
   int input_size = target_net_def->input_info_size();
@@ -222,6 +348,9 @@ MaceStatus NetDefAdapter::AdaptNetDef(const NetDef *net_def,
         input_data_format, input_shape, -1));
   }
 
+  // NCHWc is only used by CPU nets of float ops.
+  const bool enable_nchwc =
+      runtime_type == RuntimeType::RT_CPU && !is_quantized_model;
   DataFormat op_output_data_format;
   MemoryType op_output_mem_type;
   for (int idx = 0; idx < net_def->op_size(); ++idx) {
@@ -237,7 +366,7 @@ MaceStatus NetDefAdapter::AdaptNetDef(const NetDef *net_def,
                                            &op_def));
 
     // Adapt data type
-    MACE_RETURN_IF_ERROR(this->AdaptDataType(&context, &op_def));
+    MACE_RETURN_IF_ERROR(this->AdaptDataType(&context, output_map, &op_def));
 
     auto runtime_type = static_cast<RuntimeType>(op_def.device_type());
     if (runtime_type == RuntimeType::RT_OPENCL) {
@@ -248,7 +377,8 @@ MaceStatus NetDefAdapter::AdaptNetDef(const NetDef *net_def,
                                                  &tensor_shape_map,
                                                  &transformed_set,
                                                  &op_output_data_format,
-                                                 target_net_def));
+                                                 target_net_def,
+                                                 enable_nchwc));
       MACE_RETURN_IF_ERROR(this->AdaptMemoryType(&context,
                                                  &op_def,
                                                  &output_map,
@@ -271,7 +401,15 @@ MaceStatus NetDefAdapter::AdaptNetDef(const NetDef *net_def,
                                                  &tensor_shape_map,
                                                  &transformed_set,
                                                  &op_output_data_format,
-                                                 target_net_def));
+                                                 target_net_def,
+                                                 enable_nchwc));
+      if (mixed_data_type_ != DT_FLOAT) {
+        MACE_RETURN_IF_ERROR(this->AddCastOpForDataType(&output_map,
+                                                        &tensor_shape_map,
+                                                        &transformed_set,
+                                                        target_net_def,
+                                                        &op_def));
+      }
     }
     input_size = op_def.input_size();
     for (int i = 0; i < input_size; ++i) {
@@ -306,6 +444,18 @@ MaceStatus NetDefAdapter::AdaptNetDef(const NetDef *net_def,
               target_net_def->op_size()));
       tensor_shape_map.emplace(op_def.output(out_idx), output_shape);
     }
+    if (op_output_data_format == DataFormat::NCHWc) {
+      // The output shapes are used to allocate the blocked tensors.
+      for (int i = 0; i < op_def.output_shape_size(); ++i) {
+        auto raw_output_shape = op_def.mutable_output_shape(i);
+        auto output_shape = NCHWcShape(std::vector<index_t>(
+            raw_output_shape->dims().begin(), raw_output_shape->dims().end()));
+        raw_output_shape->clear_dims();
+        for (auto dim : output_shape) {
+          raw_output_shape->add_dims(dim);
+        }
+      }
+    }
     // Add op to target net
     target_net_def->add_op()->CopyFrom(op_def);
   }
@@ -334,23 +484,10 @@ MaceStatus NetDefAdapter::AdaptNetDef(const NetDef *net_def,
         std::string t_output_name = TransformedName(output_info.name(),
                                                     "mem_type",
                                                     target_mem_type);
-        auto output_op_def = target_net_def->mutable_op(
-            internal_output_info.op_idx);
-        int output_size = output_op_def->output_size();
-        for (int i = 0; i < output_size; ++i) {
-          if (output_op_def->output(i) == output_info.name()) {
-            output_op_def->set_output(i, t_output_name);
-          }
-        }
-        for (int idx : internal_output_info.consumer_op_indices) {
-          auto consumer_op_def = target_net_def->mutable_op(idx);
-          int input_size = consumer_op_def->input_size();
-          for (int i = 0; i < input_size; ++i) {
-            if (consumer_op_def->input(i) == output_info.name()) {
-              consumer_op_def->set_input(i, t_output_name);
-            }
-          }
-        }
+        RenameOpOutput(output_info.name(), t_output_name,
+                       internal_output_info.op_idx,
+                       internal_output_info.consumer_op_indices,
+                       target_net_def);
         auto transformed_op_def = target_net_def->add_op();
         OpsUtils::BuildTransformOpDef(
             t_output_name,
@@ -372,6 +509,41 @@ MaceStatus NetDefAdapter::AdaptNetDef(const NetDef *net_def,
                          target_mem_type);
       }
     }
+  } else {
+    for (auto &output_info : net_def->output_info()) {
+      auto &internal_output_info = output_map.at(output_info.name());
+      if (mixed_data_type_ != DT_FLOAT &&
+          internal_output_info.dtype == mixed_data_type_) {
+        // Cast the outputs of the lower precision ops back to float.
+        std::string t_output_name = TransformedName(
+            output_info.name(), "data_type",
+            static_cast<int>(mixed_data_type_));
+        RenameOpOutput(output_info.name(), t_output_name,
+                       internal_output_info.op_idx,
+                       internal_output_info.consumer_op_indices,
+                       target_net_def);
+        BuildCastOpDef(t_output_name, output_info.name(),
+                       internal_output_info.shape, mixed_data_type_,
+                       DT_FLOAT, internal_output_info.data_format,
+                       target_net_def->add_op());
+        continue;
+      }
+      // Reorder the outputs in NCHWc back to NCHW.
+      if (internal_output_info.data_format != DataFormat::NCHWc) {
+        continue;
+      }
+      std::string t_output_name = TransformedName(
+          output_info.name(), "data_format",
+          static_cast<int>(DataFormat::NCHWc));
+      RenameOpOutput(output_info.name(), t_output_name,
+                     internal_output_info.op_idx,
+                     internal_output_info.consumer_op_indices,
+                     target_net_def);
+      BuildReorderOpDef(t_output_name, output_info.name(),
+                        internal_output_info.shape,
+                        internal_output_info.shape[1], DataFormat::NCHW,
+                        internal_output_info.dtype, target_net_def->add_op());
+    }
   }
 
   VLOG(3) << DebugString(target_net_def);
@@ -421,9 +593,9 @@ MaceStatus NetDefAdapter::AdaptDevice(OpConditionContext *context,
 }
 
 MaceStatus NetDefAdapter::AdaptDataType(OpConditionContext *context,
+                                        const TensorInfoMap &output_map,
                                         OperatorDef *op_def) {
   MACE_UNUSED(context);
-  // Where to add logic to support mixing precision
   // Adjust data type of op ran on CPU
   DataType dtype = static_cast<DataType>(
       ProtoArgHelper::GetOptionalArg<OperatorDef, int>(
@@ -431,6 +603,90 @@ MaceStatus NetDefAdapter::AdaptDataType(OpConditionContext *context,
   auto runtime_type = static_cast<RuntimeType>(op_def->device_type());
   if (runtime_type == RuntimeType::RT_CPU && dtype == DT_HALF) {
     SetProtoArg<int>(op_def, "T", static_cast<int>(DataType::DT_FLOAT));
+    dtype = DT_FLOAT;
+  }
+  // Mixing precision, the casts of the inputs are added by
+  // AddCastOpForDataType once the data format is adapted.
+  if (runtime_type == RuntimeType::RT_CPU && dtype == DT_FLOAT &&
+      mixed_data_type_ != DT_FLOAT) {
+    dtype = SelectOpDataType(*op_def, output_map);
+    if (dtype != DT_FLOAT) {
+      VLOG(2) << "Run op " << op_def->name() << " in data type " << dtype;
+      SetProtoArg<int>(op_def, "T", static_cast<int>(dtype));
+    }
+  }
+  return MaceStatus::MACE_SUCCESS;
+}
+
+DataType NetDefAdapter::SelectOpDataType(
+    const OperatorDef &op_def, const TensorInfoMap &output_map) const {
+  // The ops with explicit output types, e.g. Cast, keep them.
+  if (op_def.output_type_size() > 0 ||
+      !op_registry_->IsRegistered(op_def.type(), RuntimeType::RT_CPU,
+                                  mixed_data_type_)) {
+    return DT_FLOAT;
+  }
+  auto sensitivity = op_sensitivities_.find(op_def.name());
+  if (sensitivity == op_sensitivities_.end()) {
+    sensitivity = op_sensitivities_.find(op_def.type());
+  }
+  if (sensitivity != op_sensitivities_.end()) {
+    return sensitivity->second <= precision_tolerance_ ?
+           mixed_data_type_ : DT_FLOAT;
+  }
+  if (DefaultPrecisionSensitivity(op_def.type()) > precision_tolerance_) {
+    return DT_FLOAT;
+  }
+  if (IsComputeBoundOp(op_def.type())) {
+    return mixed_data_type_;
+  }
+  // Follow the first input to avoid the casts around the cheap ops.
+  for (auto &input : op_def.input()) {
+    auto input_info = output_map.find(input);
+    if (input_info != output_map.end() &&
+        IsFloatDataType(input_info->second.dtype)) {
+      return input_info->second.dtype == mixed_data_type_ ?
+             mixed_data_type_ : DT_FLOAT;
+    }
+  }
+  return DT_FLOAT;
+}
+
+MaceStatus NetDefAdapter::AddCastOpForDataType(
+    TensorInfoMap *output_map, TensorShapeMap *tensor_shape_map,
+    std::unordered_set<std::string> *transformed_set, NetDef *target_net_def,
+    OperatorDef *op_def) {
+  DataType dtype = static_cast<DataType>(
+      ProtoArgHelper::GetOptionalArg<OperatorDef, int>(
+          *op_def, "T", static_cast<int>(DT_FLOAT)));
+  if (!IsFloatDataType(dtype)) {
+    return MaceStatus::MACE_SUCCESS;
+  }
+  // The weights are cast once by the CPU flow, see CastConstForCPU.
+  int input_size = op_def->input_size();
+  for (int i = 0; i < input_size; ++i) {
+    auto iter = output_map->find(op_def->input(i));
+    if (iter == output_map->end() || iter->second.dtype == dtype ||
+        !IsFloatDataType(iter->second.dtype)) {
+      continue;
+    }
+    std::string transformed_name = TransformedName(
+        op_def->input(i), "data_type", static_cast<int>(dtype));
+    if (transformed_set->count(transformed_name) == 0) {
+      const InternalOutputInfo input_info = iter->second;
+      OperatorDef *cast_op_def = target_net_def->add_op();
+      BuildCastOpDef(op_def->input(i), transformed_name, input_info.shape,
+                     input_info.dtype, dtype, input_info.data_format,
+                     cast_op_def);
+      iter->second.consumer_op_indices.push_back(
+          target_net_def->op_size() - 1);
+      output_map->emplace(transformed_name, InternalOutputInfo(
+          CPU_BUFFER, dtype, input_info.data_format, input_info.shape,
+          target_net_def->op_size() - 1));
+      tensor_shape_map->emplace(transformed_name, input_info.shape);
+      transformed_set->insert(transformed_name);
+    }
+    op_def->set_input(i, transformed_name);
   }
   return MaceStatus::MACE_SUCCESS;
 }
@@ -443,7 +699,8 @@ MaceStatus NetDefAdapter::AdaptDataFormat(
     TensorShapeMap *tensor_shape_map,
     std::unordered_set<std::string> *transformed_set,
     DataFormat *op_output_df,
-    NetDef *target_net_def) {
+    NetDef *target_net_def,
+    bool enable_nchwc) {
   VLOG(3) << "Adapt data format for op " << op_def->name();
   DataFormat op_data_format =
       static_cast<DataFormat>(ProtoArgHelper::GetOptionalArg<OperatorDef, int>(
@@ -492,12 +749,31 @@ MaceStatus NetDefAdapter::AdaptDataFormat(
       }
     }
   }
-  *op_output_df = op_data_format;
 
+  int input_size = op_def->input_size();
+  std::vector<DataFormat> producer_data_formats(input_size, DataFormat::NONE);
+  for (int i = 0; i < input_size; ++i) {
+    if (output_map->count(op_def->input(i)) == 1) {
+      producer_data_formats[i] = output_map->at(op_def->input(i)).data_format;
+    }
+  }
+  context->SetInputDataFormats(producer_data_formats);
   auto inputs_data_format = op_registry_->InputsDataFormat(op_def->type(),
                                                            context);
+  if (std::count(inputs_data_format.begin(), inputs_data_format.end(),
+                 DataFormat::NCHWc) > 0) {
+    if (enable_nchwc && op_data_format == DataFormat::NCHW &&
+        CanUseNCHWc(op_def, inputs_data_format, *output_map)) {
+      op_data_format = DataFormat::NCHWc;
+      SetProtoArg<int>(op_def, "data_format", static_cast<int>(op_data_format));
+    } else {
+      std::replace(inputs_data_format.begin(), inputs_data_format.end(),
+                   DataFormat::NCHWc, DataFormat::NCHW);
+    }
+  }
+  *op_output_df = op_data_format;
+
   DataFormat src_df, dst_df;
-  int input_size = op_def->input_size();
   for (int i = 0; i < input_size; ++i) {
     if (output_map->count(op_def->input(i)) == 0) {
       // Check this input is const tensor(filter)
@@ -511,6 +787,19 @@ MaceStatus NetDefAdapter::AdaptDataFormat(
     src_df = output_map->at(op_def->input(i)).data_format;
     dst_df = inputs_data_format[i];
 
+    if (dst_df == DataFormat::NCHWc) {
+      if (src_df != DataFormat::NCHWc) {
+        AddReorderOpForDataFormat(output_map, tensor_shape_map,
+                                  transformed_set, target_net_def, op_def, i,
+                                  DataFormat::NCHWc);
+      }
+      continue;
+    } else if (src_df == DataFormat::NCHWc) {
+      AddReorderOpForDataFormat(output_map, tensor_shape_map, transformed_set,
+                                target_net_def, op_def, i, DataFormat::NCHW);
+      src_df = DataFormat::NCHW;
+    }
+
     const std::vector<int> dst_dims =
         GetDstDimsFromTransposeRuler(output_map, op_def, i, src_df, dst_df);
     if (dst_dims.size() > 0) {
@@ -733,6 +1022,79 @@ MaceStatus NetDefAdapter::AddTranposeOpForDataFormat(
   return MaceStatus::MACE_SUCCESS;
 }
 
+bool NetDefAdapter::CanUseNCHWc(
+    const OperatorDef *op_def,
+    const std::vector<DataFormat> &inputs_data_format,
+    const TensorInfoMap &output_map) {
+  auto runtime_type = static_cast<RuntimeType>(op_def->device_type());
+  auto dtype = static_cast<DataType>(
+      ProtoArgHelper::GetOptionalArg<OperatorDef, int>(
+          *op_def, "T", static_cast<int>(DT_FLOAT)));
+  if (runtime_type != RuntimeType::RT_CPU || dtype != DT_FLOAT) {
+    return false;
+  }
+  // The logical shapes are needed to reorder the tensors back.
+  if (op_def->output_shape_size() != op_def->output_size()) {
+    return false;
+  }
+  for (auto &output_shape : op_def->output_shape()) {
+    if (output_shape.dims_size() != 4) {
+      return false;
+    }
+  }
+  int input_size = op_def->input_size();
+  for (int i = 0; i < input_size; ++i) {
+    if (inputs_data_format[i] != DataFormat::NCHWc) {
+      continue;
+    }
+    if (output_map.count(op_def->input(i)) == 0) {
+      return false;
+    }
+    auto &input_info = output_map.at(op_def->input(i));
+    if (input_info.shape.size() != 4 || input_info.dtype != DT_FLOAT ||
+        input_info.mem_type != CPU_BUFFER ||
+        (input_info.data_format != DataFormat::NCHW &&
+            input_info.data_format != DataFormat::NCHWc)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+MaceStatus NetDefAdapter::AddReorderOpForDataFormat(
+    TensorInfoMap *output_map, TensorShapeMap *tensor_shape_map,
+    std::unordered_set<std::string> *transformed_set, NetDef *target_net_def,
+    OperatorDef *op_def, const int i, const DataFormat dst_df) {
+  auto &input_info = output_map->at(op_def->input(i));
+  MACE_CHECK(input_info.shape.size() == 4,
+             "The logical shape of ", op_def->input(i), " is unknown");
+  std::string transformed_name = TransformedName(
+      op_def->input(i), "data_format", static_cast<int>(dst_df));
+  if (transformed_set->count(transformed_name) == 0) {
+    VLOG(1) << "Add Reorder operation for " << op_def->name()
+            << " to reorder its tensor " << op_def->input(i)
+            << " to data format " << static_cast<int>(dst_df);
+    const auto &shape = input_info.shape;
+    BuildReorderOpDef(op_def->input(i), transformed_name,
+                      dst_df == DataFormat::NCHWc ? NCHWcShape(shape) : shape,
+                      shape[1], dst_df, input_info.dtype,
+                      target_net_def->add_op());
+    // Update tensor consumer information
+    input_info.consumer_op_indices.push_back(target_net_def->op_size() - 1);
+    // Update output information map, the shape is kept logical
+    output_map->emplace(transformed_name, InternalOutputInfo(
+        CPU_BUFFER, input_info.dtype, dst_df, shape,
+        target_net_def->op_size() - 1));
+    // Update tensor shape map
+    tensor_shape_map->emplace(transformed_name, shape);
+    // Record transformed tensors
+    transformed_set->insert(transformed_name);
+  }
+  // Update original op_def's input
+  op_def->set_input(i, transformed_name);
+  return MaceStatus::MACE_SUCCESS;
+}
+
 std::string NetDefAdapter::DebugString(const NetDef *net_def) {
   std::stringstream sstream;
   auto RuntimeTypeToStrFunc = [](RuntimeType runtime_type) -> std::string {
@@ -760,6 +1122,8 @@ std::string NetDefAdapter::DebugString(const NetDef *net_def) {
       return "NHWC";
     } else if (type == DataFormat::NCHW) {
       return "NCHW";
+    } else if (type == DataFormat::NCHWc) {
+      return "NCHWc";
     } else if (type == DataFormat::NONE) {
       return "NONE";
     } else if (type == DataFormat::AUTO) {
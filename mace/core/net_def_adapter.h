@@ -14,6 +14,7 @@
 
 #ifndef MACE_CORE_NET_DEF_ADAPTER_H_
 #define MACE_CORE_NET_DEF_ADAPTER_H_
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -42,12 +43,19 @@ class Workspace;
 ///    with float data type.
 ///    while the inputs and outputs are DataFormat::NHWC for
 ///    other situation(ran on GPU, quantization, DSP)
+///    The float CPU ops may also run in DataFormat::NCHWc if they ask for it,
+///    the tensors of which have 5-D shapes, while the output shapes kept in
+///    the adapter are logical NCHW. Reorder ops are added at the edges.
 ///
 /// 2. Op with DataFormat::AUTO stands for inputs must have
 ///    fixed format (NHWC or NCHW), determined at runtime.
 ///
 /// 3. if Op with DataFormat::AUTO, the arguments of this op
 ///    is formatted to NHWC.
+///
+/// 4. The CPU ops of a float net run in DataType::DT_FLOAT, unless mixed
+///    precision is set, then some of them run in the lower precision and
+///    Cast ops are added where the precision of a tensor changes.
 ///////////////////////////////////////////////////////////////////////////////
 class NetDefAdapter {
  public:
@@ -66,6 +74,16 @@ class NetDefAdapter {
                          Runtime *cpu_runtime,
                          NetDef *target_net_def);
 
+  // Run the float CPU ops in data_type where the precision allows, see
+  // MaceEngineConfig::SetCPUMixedPrecision. DT_FLOAT disables it.
+  void SetMixedPrecision(const DataType data_type,
+                         const std::map<std::string, float> &sensitivities,
+                         const float tolerance);
+
+  // The number of the nets adapted by AdaptNetDef in the process, which the
+  // tests use to check that a cached net is not adapted again.
+  static int64_t AdaptedNetCount();
+
  public:
   NetDefAdapter(const NetDefAdapter &) = delete;
   NetDefAdapter(const NetDefAdapter &&) = delete;
@@ -101,6 +119,7 @@ class NetDefAdapter {
                          const NetDef *net_def,
                          OperatorDef *op);
   MaceStatus AdaptDataType(OpConditionContext *context,
+                           const TensorInfoMap &output_map,
                            OperatorDef *op);
   MaceStatus AdaptDataFormat(
       OpConditionContext *context,
@@ -110,7 +129,8 @@ class NetDefAdapter {
       TensorShapeMap *tensor_shape_map,
       std::unordered_set<std::string> *transformed_set,
       DataFormat *op_output_df,
-      NetDef *target_net_def);
+      NetDef *target_net_def,
+      bool enable_nchwc);
 
   MaceStatus AdaptMemoryType(
       OpConditionContext *context,
@@ -130,18 +150,40 @@ class NetDefAdapter {
       std::unordered_set<std::string> *transformed_set, NetDef *target_net_def,
       OperatorDef *op_def, const int i, const DataFormat dst_df,
       const std::vector<int> &dst_dims);
+
+  // Whether the op could run in the CPU internal DataFormat::NCHWc.
+  bool CanUseNCHWc(const OperatorDef *op_def,
+                   const std::vector<DataFormat> &inputs_data_format,
+                   const TensorInfoMap &output_map);
+
+  MaceStatus AddReorderOpForDataFormat(
+      TensorInfoMap *output_map, TensorShapeMap *tensor_shape_map,
+      std::unordered_set<std::string> *transformed_set, NetDef *target_net_def,
+      OperatorDef *op_def, const int i, const DataFormat dst_df);
 #ifdef MACE_ENABLE_OPENCL
   std::string BuildImageToBufferOp(
       TensorInfoMap *output_map, TensorShapeMap *tensor_shape_map,
       std::unordered_set<std::string> *transformed_set, NetDef *target_net_def,
       OperatorDef *op_def, const int i, const InternalOutputInfo &input_info);
 #endif
+  // The data type of a float CPU op in the mixed precision net.
+  DataType SelectOpDataType(const OperatorDef &op_def,
+                            const TensorInfoMap &output_map) const;
+
+  MaceStatus AddCastOpForDataType(
+      TensorInfoMap *output_map, TensorShapeMap *tensor_shape_map,
+      std::unordered_set<std::string> *transformed_set, NetDef *target_net_def,
+      OperatorDef *op_def);
+
   std::string DebugString(const NetDef *net_def);
 
  private:
   const OpRegistry *op_registry_;
   const Workspace *ws_;
   NetOptimizer net_optimizer_;
+  DataType mixed_data_type_;
+  std::map<std::string, float> op_sensitivities_;
+  float precision_tolerance_;
 };
 
 }  // namespace mace
@@ -15,6 +15,7 @@
 #include "mace/core/ops/op_condition_context.h"
 
 #include "mace/core/proto/arg_helper.h"
+#include "mace/core/workspace.h"
 #include "mace/proto/mace.pb.h"
 #include "mace/utils/logging.h"
 
@@ -32,6 +33,7 @@ void OpConditionContext::set_operator_def(
     const OperatorDef *operator_def) {
   operator_def_ = operator_def;
   input_data_types_.clear();
+  input_data_formats_.clear();
 }
 
 void OpConditionContext::SetInputInfo(size_t idx,
@@ -97,4 +99,32 @@ BufferContentType OpConditionContext::GetInputBufferContentType(
   return input_buffer_types_[idx];
 }
 
+void OpConditionContext::SetInputDataFormats(
+    const std::vector<DataFormat> &data_formats) {
+  input_data_formats_ = data_formats;
+}
+
+DataFormat OpConditionContext::GetInputDataFormat(size_t idx) const {
+  if (idx >= input_data_formats_.size()) {
+    return DataFormat::NONE;
+  }
+  return input_data_formats_[idx];
+}
+
+bool OpConditionContext::InputsInDataFormat(DataFormat data_format) const {
+  int input_size = operator_def_->input_size();
+  bool has_input = false;
+  for (int i = 0; i < input_size; ++i) {
+    const Tensor *tensor = ws_->GetTensor(operator_def_->input(i));
+    if (tensor != nullptr && tensor->is_weight()) {
+      continue;
+    }
+    if (GetInputDataFormat(i) != data_format) {
+      return false;
+    }
+    has_input = true;
+  }
+  return has_input;
+}
+
 }  // namespace mace
@@ -71,6 +71,13 @@ class OpConditionContext {
   void SetInputBufferContentType(size_t idx, BufferContentType buffer_type);
   BufferContentType GetInputBufferContentType(size_t idx) const;
 
+  // The data formats of the inputs as produced by the former ops, set by the
+  // NetDefAdapter before it selects the data formats the op wants.
+  void SetInputDataFormats(const std::vector<DataFormat> &data_formats);
+  DataFormat GetInputDataFormat(size_t idx) const;
+  // Whether all the non-const inputs are produced in the data format.
+  bool InputsInDataFormat(DataFormat data_format) const;
+
  private:
   const OperatorDef *operator_def_;
   const Workspace *ws_;
@@ -81,6 +88,7 @@ class OpConditionContext {
   std::vector<DataType> input_data_types_;
   MemoryType output_mem_type_;  // there is only one output memory type now.
   std::vector<BufferContentType> input_buffer_types_;
+  std::vector<DataFormat> input_data_formats_;
 };
 }  // namespace mace
 
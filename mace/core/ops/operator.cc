@@ -128,6 +128,16 @@ int Operation::ReuseTensorMapId(size_t output_idx) const {
   return -1;
 }
 
+index_t Operation::InputOffsetInOutput(size_t input_idx) const {
+  MACE_UNUSED(input_idx);
+  return -1;
+}
+
+bool Operation::CanOverwriteInput(size_t input_idx) const {
+  MACE_UNUSED(input_idx);
+  return false;
+}
+
 BufferContentType Operation::GetInputTensorContentType(size_t idx) const {
   MACE_UNUSED(idx);
   return BufferContentType::IN_OUT_CHANNEL;
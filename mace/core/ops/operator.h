@@ -90,6 +90,13 @@ class Operation {
   virtual MaceStatus Forward(OpContext *context);
   virtual MaceStatus Run(OpContext *context) = 0;
   virtual int ReuseTensorMapId(size_t output_idx) const;
+  // Byte offset in Output(0) where the input can be produced in place, so
+  // the op doesn't need to copy it. -1 means the input needs its own buffer.
+  virtual index_t InputOffsetInOutput(size_t input_idx) const;
+  // Whether Output(0) can share the buffer of the input when the input is
+  // not read after the op, so that the op runs in place. The op must read
+  // an element before it writes the output at the same offset.
+  virtual bool CanOverwriteInput(size_t input_idx) const;
 
   const OperatorDef &debug_def() const {
     MACE_CHECK(has_debug_def(), "operator_def was null!");
@@ -69,7 +69,7 @@ DelegatorCreator OpDelegatorRegistry::GetCreator(
   }
 
   DelegatorInfo info = key;
-  if (key.impl_type == ImplType::NEON) {
+  if (key.impl_type != ImplType::REF) {
     if (info.tag != kDefaultTag) {
       info.tag = kDefaultTag;
       if (registry_.count(info) > 0) {
@@ -100,6 +100,19 @@ MaceStatus OpRegistry::Register(
   return MaceStatus::MACE_SUCCESS;
 }
 
+bool OpRegistry::IsRegistered(const std::string &op_type,
+                              const RuntimeType runtime_type,
+                              const DataType dt) const {
+  if (registry_.count(op_type) == 0) {
+    return false;
+  }
+  std::string key = OpKeyBuilder(op_type)
+      .Runtime(runtime_type)
+      .TypeConstraint("T", dt)
+      .Build();
+  return registry_.at(op_type)->creators.count(key) > 0;
+}
+
 const std::set<RuntimeType> OpRegistry::AvailableRuntimes(
     const std::string &op_type, OpConditionContext *context) const {
   MACE_CHECK(registry_.count(op_type) != 0,
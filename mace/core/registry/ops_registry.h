@@ -45,6 +45,11 @@ class OpRegistry {
 
   MaceStatus Register(const OpConditionBuilder &builder);
 
+  // Whether the op has a kernel of the data type on the runtime.
+  bool IsRegistered(const std::string &op_type,
+                    const RuntimeType runtime_type,
+                    const DataType dt) const;
+
   const std::set<RuntimeType> AvailableRuntimes(
       const std::string &op_type, OpConditionContext *context) const;
 
@@ -70,6 +70,12 @@ bool Runtime::CanReuseBuffer(
   MACE_UNUSED(content_param);
   auto size_bytes = std::accumulate(shape.begin(), shape.end(),
                                     1, std::multiplies<index_t>());
+  if (buffer->is_slice()) {
+    // A slice can't grow over its neighbours in the parent buffer, and the
+    // consumers of a slice, such as Concat, expect it at its planned offset
+    // with its planned size, so only reuse it when the size is unchanged.
+    return size_bytes == buffer->size();
+  }
   MemoryManager *memory_manager = GetMemoryManager(buffer->mem_type);
   auto real_shape = memory_manager->GetMemoryRealSize(buffer->memory<void>());
   MACE_CHECK(real_shape.size() == 1, "Only support dim 1");
@@ -30,6 +30,22 @@ namespace mace {
 
 typedef int64_t index_t;
 
+// The channel block of DataFormat::NCHWc, it is the float SIMD width the
+// CPU kernels are built for.
+#if defined(__AVX512F__)
+constexpr index_t kNCHWcBlock = 16;
+#elif defined(__AVX2__) && defined(__FMA__)
+constexpr index_t kNCHWcBlock = 8;
+#else
+constexpr index_t kNCHWcBlock = 4;
+#endif
+
+// The x86 CPU keeps the fp16 weights of the GEMV ops and converts them to
+// float while they are loaded, which needs F16C (implied by AVX-512).
+#if defined(MACE_ENABLE_X86) && (defined(__F16C__) || defined(__AVX512F__))
+#define MACE_ENABLE_X86_HALF_WEIGHTS
+#endif
+
 using half = half_float::half;
 
 bool DataTypeCanUseMemcpy(DataType dt);
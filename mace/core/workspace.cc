@@ -14,6 +14,7 @@
 
 #include "mace/core/workspace.h"
 
+#include <algorithm>
 #include <unordered_set>
 #include <utility>
 
@@ -42,6 +43,41 @@ void DequantizeTensor(Runtime *runtime,
                            dequantized_data);
 }
 
+// Fill the tensor with the const tensor converted to its data type.
+void FillModelTensor(Runtime *runtime, const unsigned char *model_data,
+                     const ConstTensor &const_tensor, bool is_quantize_model,
+                     Tensor *tensor) {
+  const DataType dst_data_type = tensor->dtype();
+  if (runtime->GetRuntimeType() == RuntimeType::RT_CPU &&
+      const_tensor.data_type() == DataType::DT_HALF &&
+      dst_data_type == DataType::DT_FLOAT) {
+    // uncompress the weights of fp16
+    auto org_data = reinterpret_cast<const half *>(
+        model_data + const_tensor.offset());
+    float *dst_data = tensor->mutable_data<float>();
+    for (int i = 0; i < const_tensor.data_size(); ++i) {
+      dst_data[i] = half_float::half_cast<float>(org_data[i]);
+    }
+  } else if (!is_quantize_model && const_tensor.quantized()) {
+    // uncompress the weights of uint8
+    if (dst_data_type != DT_FLOAT) {
+      DequantizeTensor<half>(runtime,
+                             model_data,
+                             const_tensor,
+                             tensor);
+    } else {
+      DequantizeTensor<float>(runtime,
+                              model_data,
+                              const_tensor,
+                              tensor);
+    }
+  } else {
+    tensor->CopyBytes(model_data + const_tensor.offset(),
+                      const_tensor.data_size() *
+                          GetEnumTypeSize(const_tensor.data_type()));
+  }
+}
+
 }  // namespace
 
 Workspace::Workspace(const OpDelegatorRegistry *registry, BaseFlow *flow) :
@@ -101,7 +137,8 @@ std::vector<std::string> Workspace::Tensors() const {
 
 MaceStatus Workspace::LoadModelTensor(const NetDef &net_def, Runtime *runtime,
                                       const unsigned char *model_data,
-                                      const index_t model_data_size) {
+                                      const index_t model_data_size,
+                                      bool share_const_tensors) {
   // When model has no weight, return immediately. Otherwise,
   // `MakeSliceBuffer` will try to map nullptr when running on GPU.
   if (model_data == nullptr && model_data_size == 0) {
@@ -117,9 +154,13 @@ MaceStatus Workspace::LoadModelTensor(const NetDef &net_def, Runtime *runtime,
                valid_data_size, " should be smaller than ", model_data_size);
   }
 
-  const RuntimeType runtime_type = runtime->GetRuntimeType();
   auto slice_parent = runtime->MakeSliceBuffer(net_def, model_data,
                                                valid_data_size);
+  if (share_const_tensors) {
+    diffused_buffer_ = true;
+    return LoadSharedModelTensor(net_def, runtime, model_data,
+                                 model_data_size, slice_parent != nullptr);
+  }
   diffused_buffer_ = (slice_parent == nullptr);
   if (diffused_buffer_) {
     bool is_quantize_model = NetDefHelper::IsQuantizedModel(net_def);
@@ -145,33 +186,8 @@ MaceStatus Workspace::LoadModelTensor(const NetDef &net_def, Runtime *runtime,
       MACE_CHECK(tensor_end <= model_data_size, "tensor_end (", tensor_end,
                  ") should <= ", model_data_size);
 
-      if (runtime_type == RuntimeType::RT_CPU &&
-          const_tensor.data_type() == DataType::DT_HALF) {
-        // uncompress the weights of fp16
-        auto org_data = reinterpret_cast<const half *>(
-            model_data + const_tensor.offset());
-        float *dst_data = tensor->mutable_data<float>();
-        for (int i = 0; i < const_tensor.data_size(); ++i) {
-          dst_data[i] = half_float::half_cast<float>(org_data[i]);
-        }
-      } else if (!is_quantize_model && const_tensor.quantized()) {
-        // uncompress the weights of uint8
-        if (dst_data_type != DT_FLOAT) {
-          DequantizeTensor<half>(runtime,
-                                 model_data,
-                                 const_tensor,
-                                 tensor.get());
-        } else {
-          DequantizeTensor<float>(runtime,
-                                  model_data,
-                                  const_tensor,
-                                  tensor.get());
-        }
-      } else {
-        tensor->CopyBytes(model_data + const_tensor.offset(),
-                          const_tensor.data_size() *
-                              GetEnumTypeSize(const_tensor.data_type()));
-      }
+      FillModelTensor(runtime, model_data, const_tensor, is_quantize_model,
+                      tensor.get());
 
       tensor_map_[const_tensor.name()] = std::move(tensor);
     }
@@ -201,6 +217,76 @@ MaceStatus Workspace::LoadModelTensor(const NetDef &net_def, Runtime *runtime,
   return MaceStatus::MACE_SUCCESS;
 }
 
+MaceStatus Workspace::LoadSharedModelTensor(const NetDef &net_def,
+                                            Runtime *runtime,
+                                            const unsigned char *model_data,
+                                            const index_t model_data_size,
+                                            bool zero_copy) {
+  MACE_CHECK(runtime->GetRuntimeType() == RuntimeType::RT_CPU,
+             "Only the CPU const tensors can be shared");
+  ConstTensorRegistry *registry = ConstTensorRegistry::Get();
+  // The tensors used in place are referenced from the mapped file, so its
+  // pages are shared with the other processes.
+  std::shared_ptr<port::ReadOnlyMemoryRegion> mapped_file;
+  if (zero_copy) {
+    mapped_file = registry->FindMappedFile(model_data);
+  }
+  bool is_quantize_model = NetDefHelper::IsQuantizedModel(net_def);
+  index_t shared_count = 0;
+  for (const auto &const_tensor : net_def.tensors()) {
+    MACE_LATENCY_LOGGER(2, "Load tensor ", const_tensor.name());
+    std::vector<index_t> dims;
+    for (const index_t d : const_tensor.dims()) {
+      dims.push_back(d);
+    }
+    const index_t tensor_end = const_tensor.offset() +
+        const_tensor.data_size() * GetEnumTypeSize(const_tensor.data_type());
+    MACE_CHECK(tensor_end <= model_data_size, "tensor_end (", tensor_end,
+               ") should <= ", model_data_size);
+
+    auto dst_data_type = runtime->GetComputeDataType(net_def, const_tensor);
+    auto tensor = make_unique<Tensor>(
+        runtime, dst_data_type, dims, true, const_tensor.name());
+    tensor->SetScale(const_tensor.scale());
+    tensor->SetZeroPoint(const_tensor.zero_point());
+    const std::string key =
+        ConstTensorRegistry::Key(const_tensor, dst_data_type, model_data);
+    auto shared = registry->Find(key);
+    bool allocated = false;
+    if (shared != nullptr) {
+      ++shared_count;
+    } else {
+      const index_t bytes = std::max<index_t>(tensor->raw_size(), 1);
+      if (mapped_file != nullptr) {
+        shared = std::make_shared<SharedConstTensor>(
+            model_data + const_tensor.offset(), bytes, mapped_file);
+      } else {
+        shared = std::make_shared<SharedConstTensor>(bytes);
+        MACE_RETURN_IF_ERROR(runtime->AllocateBufferForTensor(
+            tensor.get(), RENT_SLICE, shared->buffer(), 0));
+        FillModelTensor(runtime, model_data, const_tensor, is_quantize_model,
+                        tensor.get());
+        allocated = true;
+      }
+      // Another engine may have registered the same tensor meanwhile.
+      auto registered = registry->Insert(key, shared);
+      allocated &= (registered == shared);
+      shared = registered;
+    }
+    if (!allocated) {
+      MACE_RETURN_IF_ERROR(runtime->AllocateBufferForTensor(
+          tensor.get(), RENT_SLICE, shared->buffer(), 0));
+    }
+
+    shared_const_tensors_[const_tensor.name()] = shared;
+    tensor_map_[const_tensor.name()] = std::move(tensor);
+  }
+  VLOG(1) << "Share " << shared_count << " of " << net_def.tensors_size()
+          << " const tensors with the other engines";
+
+  return MaceStatus::MACE_SUCCESS;
+}
+
 MaceStatus Workspace::AddQuantizeInfoForOutputTensor(
     const mace::NetDef &net_def, Runtime *runtime) {
   // add quantize info for output tensors.
@@ -230,6 +316,7 @@ void Workspace::RemoveUnusedBuffer() {
   while (iter != end_iter) {
     auto old_iter = iter++;
     if (old_iter->second->unused()) {
+      shared_const_tensors_.erase(old_iter->first);
       tensor_map_.erase(old_iter);
     }
   }
@@ -296,6 +383,7 @@ void Workspace::RemoveAndReloadBuffer(const NetDef &net_def,
 void Workspace::RemoveTensor(const std::string &name) {
   auto iter = tensor_map_.find(name);
   if (iter != tensor_map_.end()) {
+    shared_const_tensors_.erase(name);
     tensor_map_.erase(iter);
   }
 }
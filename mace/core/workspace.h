@@ -17,9 +17,11 @@
 
 #include <map>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 
+#include "mace/core/memory/const_tensor_registry.h"
 #include "mace/core/runtime/runtime.h"
 #include "mace/core/tensor.h"
 #include "mace/public/mace.h"
@@ -56,9 +58,13 @@ class Workspace {
 
   std::vector<std::string> Tensors() const;
 
+  // With share_const_tensors, the CPU const tensors are taken from the
+  // ConstTensorRegistry, and the model data is unused unless it is a file
+  // mapped by the registry.
   MaceStatus LoadModelTensor(const NetDef &net_def, Runtime *runtime,
                              const unsigned char *model_data,
-                             const index_t model_data_size);
+                             const index_t model_data_size,
+                             bool share_const_tensors = false);
 
   MaceStatus AddQuantizeInfoForOutputTensor(const NetDef &net_def,
                                             Runtime *runtime);
@@ -76,8 +82,16 @@ class Workspace {
   MaceStatus ReleaseIntermediateBuffer(Runtime **runtimes, size_t size,
                                        Runtime *cpu_runtime);
 
+ private:
+  MaceStatus LoadSharedModelTensor(const NetDef &net_def, Runtime *runtime,
+                                   const unsigned char *model_data,
+                                   const index_t model_data_size,
+                                   bool zero_copy);
+
  private:
   TensorMap tensor_map_;
+  std::unordered_map<std::string, std::shared_ptr<SharedConstTensor>>
+      shared_const_tensors_;
   std::unique_ptr<Buffer> tensor_buffer_;
   bool diffused_buffer_;
 
@@ -0,0 +1,138 @@
+// Copyright 2021 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mace/flows/cpu/cast_const.h"
+
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include <utility>
+
+#include "mace/core/proto/arg_helper.h"
+#include "mace/core/workspace.h"
+#include "mace/proto/mace.pb.h"
+#include "mace/utils/transpose.h"
+
+namespace mace {
+
+namespace {
+const char *kCastSuffix = "_cast_to_";
+
+bool IsLowPrecisionType(const DataType dt) {
+#ifdef MACE_ENABLE_BFLOAT16
+  if (dt == DT_BFLOAT16) {
+    return true;
+  }
+#endif  // MACE_ENABLE_BFLOAT16
+#ifdef MACE_ENABLE_FP16
+  if (dt == DT_FLOAT16) {
+    return true;
+  }
+#endif  // MACE_ENABLE_FP16
+  MACE_UNUSED(dt);
+  return false;
+}
+
+template<typename DstT>
+void CastTensorData(mace::utils::ThreadPool *thread_pool,
+                    const Tensor *src, Tensor *dst) {
+  DstT *dst_data = dst->mutable_data<DstT>();
+  if (src->dtype() == DT_FLOAT) {
+    ops::CopyDataBetweenDiffType(thread_pool, src->data<float>(), dst_data,
+                                 src->size());
+  } else {
+    const half *src_data = src->data<half>();
+    thread_pool->Compute1D([=](index_t start, index_t end, index_t step) {
+      for (index_t i = start; i < end; i += step) {
+        dst_data[i] = static_cast<DstT>(half_float::half_cast<float>(
+            src_data[i]));
+      }
+    }, 0, src->size(), 1);
+  }
+}
+
+void CastTensor(mace::utils::ThreadPool *thread_pool,
+                const Tensor *src, Tensor *dst) {
+  switch (dst->dtype()) {
+#ifdef MACE_ENABLE_BFLOAT16
+    case DT_BFLOAT16:
+      CastTensorData<BFloat16>(thread_pool, src, dst);
+      break;
+#endif  // MACE_ENABLE_BFLOAT16
+#ifdef MACE_ENABLE_FP16
+    case DT_FLOAT16:
+      CastTensorData<float16_t>(thread_pool, src, dst);
+      break;
+#endif  // MACE_ENABLE_FP16
+    default:
+      LOG(FATAL) << "Unsupported data type: " << dst->dtype();
+  }
+}
+}  // namespace
+
+MaceStatus CastConstForCPU(
+    mace::utils::ThreadPool *thread_pool,
+    Workspace *ws,
+    Runtime *runtime,
+    NetDef *net_def) {
+  std::unordered_set<std::string> cast_inputs;
+  for (int i = 0; i < net_def->op_size(); ++i) {
+    OperatorDef *op_def = net_def->mutable_op(i);
+    if (static_cast<RuntimeType>(op_def->device_type()) !=
+        RuntimeType::RT_CPU) {
+      continue;
+    }
+    const DataType dst_dt = static_cast<DataType>(
+        ProtoArgHelper::GetOptionalArg<OperatorDef, int>(
+            *op_def, "T", static_cast<int>(DT_FLOAT)));
+    if (!IsLowPrecisionType(dst_dt)) {
+      continue;
+    }
+    for (int j = 0; j < op_def->input_size(); ++j) {
+      const std::string input_name = op_def->input(j);
+      Tensor *input = ws->GetTensor(input_name);
+      if (input == nullptr || !input->is_weight() ||
+          input->memory_type() != CPU_BUFFER ||
+          (input->dtype() != DT_FLOAT && input->dtype() != DT_HALF)) {
+        continue;
+      }
+      const std::string output_name =
+          MakeString(input_name, kCastSuffix, static_cast<int>(dst_dt));
+      if (ws->GetTensor(output_name) == nullptr) {
+        std::unique_ptr<Tensor> output = make_unique<Tensor>(
+            runtime, dst_dt, CPU_BUFFER, input->shape(), true, output_name);
+        runtime->AllocateBufferForTensor(output.get(), RENT_PRIVATE);
+        input->Map(true);
+        CastTensor(thread_pool, input, output.get());
+        ws->AddTensor(output_name, std::move(output));
+      }
+      op_def->set_input(j, output_name);
+      cast_inputs.insert(input_name);
+    }
+  }
+
+  // The source weights only read by the lower precision ops are not needed.
+  for (auto &op_def : net_def->op()) {
+    for (auto &input : op_def.input()) {
+      cast_inputs.erase(input);
+    }
+  }
+  for (auto &input_name : cast_inputs) {
+    ws->GetTensor(input_name)->MarkUnused();
+  }
+  return MaceStatus::MACE_SUCCESS;
+}
+
+}  // namespace mace
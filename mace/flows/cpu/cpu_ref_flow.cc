@@ -14,6 +14,8 @@
 
 
 #include "mace/flows/cpu/cpu_ref_flow.h"
+#include "mace/flows/cpu/cast_const.h"
+#include "mace/flows/cpu/init_cache.h"
 #include "mace/flows/cpu/transpose_const.h"
 
 #include "mace/core/flow/flow_registry.h"
@@ -21,6 +23,9 @@
 #include "mace/core/net/serial_net.h"
 #include "mace/core/workspace.h"
 #include "mace/proto/mace.pb.h"
+#include "mace/utils/mace_engine_config.h"
+#include "mace/utils/memory.h"
+#include "mace/utils/string_util.h"
 
 namespace mace {
 
@@ -36,23 +41,68 @@ MaceStatus CpuRefFlow::Init(const NetDef *net_def,
   MACE_RETURN_IF_ERROR(BaseFlow::Init(net_def, model_data, model_data_size,
                                       model_data_unused));
 
+  // The weights bound to a NUMA node or on huge pages are per engine.
+  const bool share_const_tensors =
+      config_impl_->const_tensor_sharing() &&
+      main_runtime_->GetRuntimeType() == RuntimeType::RT_CPU &&
+      config_impl_->cpu_numa_node() < 0 &&
+      config_impl_->cpu_huge_page_policy() == HUGE_PAGE_NONE;
   MACE_RETURN_IF_ERROR(ws_->LoadModelTensor(
-      *net_def, main_runtime_, model_data, model_data_size));
+      *net_def, main_runtime_, model_data, model_data_size,
+      share_const_tensors));
 
   NetDef adapted_net_def;
-  NetDefAdapter net_def_adapter(op_registry_, ws_.get());
-  net_def_adapter.AdaptNetDef(net_def, main_runtime_,
-                              cpu_runtime_, &adapted_net_def);
-  if (!is_quantized_model_) {
-    TransposeConstForCPU(&cpu_runtime_->thread_pool(), ws_.get(), cpu_runtime_,
-                         &adapted_net_def);
+  const DataType mixed_data_type = static_cast<DataType>(
+      config_impl_->cpu_mixed_precision_data_type());
+  std::unique_ptr<InitCache> init_cache;
+  const std::string init_cache_path = config_impl_->init_cache_path();
+  if (!init_cache_path.empty()) {
+    std::string adapter_options;
+    if (mixed_data_type != DT_FLOAT) {
+      adapter_options = MakeString(
+          "mixed_precision_", static_cast<int>(mixed_data_type), "_",
+          config_impl_->op_precision_tolerance());
+      for (auto &sensitivity : config_impl_->op_precision_sensitivities()) {
+        adapter_options += MakeString("_", sensitivity.first, "_",
+                                      sensitivity.second);
+      }
+    }
+    init_cache = make_unique<InitCache>(init_cache_path, *net_def,
+                                        main_runtime_, adapter_options);
+  }
+  if (init_cache != nullptr && init_cache->Load(&adapted_net_def)) {
+    if (!is_quantized_model_) {
+      MACE_RETURN_IF_ERROR(RetransposeConstForCPU(
+          &cpu_runtime_->thread_pool(), ws_.get(), cpu_runtime_,
+          &adapted_net_def));
+    }
+  } else {
+    NetDefAdapter net_def_adapter(op_registry_, ws_.get());
+    net_def_adapter.SetMixedPrecision(
+        mixed_data_type, config_impl_->op_precision_sensitivities(),
+        config_impl_->op_precision_tolerance());
+    net_def_adapter.AdaptNetDef(net_def, main_runtime_,
+                                cpu_runtime_, &adapted_net_def);
+    if (!is_quantized_model_) {
+      TransposeConstForCPU(&cpu_runtime_->thread_pool(), ws_.get(),
+                           cpu_runtime_, &adapted_net_def);
+    }
+    if (init_cache != nullptr) {
+      init_cache->Save(adapted_net_def);
+    }
+  }
+  if (!is_quantized_model_ && mixed_data_type != DT_FLOAT) {
+    MACE_RETURN_IF_ERROR(CastConstForCPU(
+        &cpu_runtime_->thread_pool(), ws_.get(), cpu_runtime_,
+        &adapted_net_def));
   }
   // Init model
   net_ = std::unique_ptr<BaseNet>(new SerialNet(op_registry_,
                                                 &adapted_net_def,
                                                 ws_.get(),
                                                 main_runtime_,
-                                                cpu_runtime_));
+                                                cpu_runtime_,
+                                                run_control_));
   if (model_data_unused != nullptr) {
     *model_data_unused = ws_->diffused_buffer();
   }
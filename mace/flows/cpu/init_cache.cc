@@ -0,0 +1,86 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mace/flows/cpu/init_cache.h"
+
+#include <string>
+#include <vector>
+
+#include "mace/core/runtime/runtime.h"
+#include "mace/port/env.h"
+#include "mace/utils/logging.h"
+#include "mace/utils/string_util.h"
+
+namespace mace {
+
+namespace {
+const char *kVersionKey = "version";
+const char *kNetDefKey = "adapted_net_def";
+}  // namespace
+
+InitCache::InitCache(const std::string &dir, const NetDef &net_def,
+                     Runtime *runtime, const std::string &adapter_options) {
+  std::string net_def_str;
+  net_def.SerializeToString(&net_def_str);
+  net_def_str += adapter_options;
+  const uint32_t crc = CalculateCRC32(
+      reinterpret_cast<const unsigned char *>(net_def_str.data()),
+      net_def_str.size());
+  file_path_ = MakeString(dir, "/mace_init_cache_", crc, "_",
+                          net_def_str.size(), "_",
+                          static_cast<int>(runtime->GetRuntimeType()), "_",
+                          static_cast<int>(runtime->GetUsedMemoryType()),
+                          ".data");
+  storage_.reset(new FileStorage(file_path_));
+}
+
+bool InitCache::Load(NetDef *adapted_net_def) {
+  if (storage_->Load() != 0) {
+    return false;
+  }
+  const std::vector<unsigned char> *version = storage_->Find(kVersionKey);
+  const std::vector<unsigned char> *net_def = storage_->Find(kNetDefKey);
+  if (version == nullptr || net_def == nullptr ||
+      std::string(version->begin(), version->end()) != MaceVersion()) {
+    LOG(WARNING) << "Ignore the init cache of another version: " << file_path_;
+    return false;
+  }
+  if (!adapted_net_def->ParseFromArray(net_def->data(),
+                                       static_cast<int>(net_def->size()))) {
+    LOG(WARNING) << "Failed to parse the init cache: " << file_path_;
+    adapted_net_def->Clear();
+    return false;
+  }
+  VLOG(1) << "Load the adapted NetDef from " << file_path_;
+  return true;
+}
+
+MaceStatus InitCache::Save(const NetDef &adapted_net_def) {
+  std::string net_def_str;
+  adapted_net_def.SerializeToString(&net_def_str);
+  const std::string version = MaceVersion();
+  storage_->Clear();
+  storage_->Insert(kVersionKey, std::vector<unsigned char>(version.begin(),
+                                                           version.end()));
+  storage_->Insert(kNetDefKey, std::vector<unsigned char>(
+      net_def_str.begin(), net_def_str.end()));
+  if (storage_->Flush() != 0) {
+    LOG(WARNING) << "Failed to write the init cache: " << file_path_;
+    return MaceStatus::MACE_RUNTIME_ERROR;
+  }
+  VLOG(1) << "Save the adapted NetDef to " << file_path_;
+  return MaceStatus::MACE_SUCCESS;
+}
+
+}  // namespace mace
@@ -0,0 +1,50 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MACE_FLOWS_CPU_INIT_CACHE_H_
+#define MACE_FLOWS_CPU_INIT_CACHE_H_
+
+#include <memory>
+#include <string>
+
+#include "mace/core/kv_storage.h"
+#include "mace/proto/mace.pb.h"
+#include "mace/public/mace.h"
+
+namespace mace {
+
+class Runtime;
+
+// Stores the NetDef adapted by the CPU flows in a file of the init cache
+// directory, so the next initialization of the same model can skip
+// NetDefAdapter. The file name is derived from the original NetDef and the
+// runtime, the MACE version is checked when loading.
+class InitCache {
+ public:
+  // The options changing how the NetDef is adapted are a part of the key.
+  InitCache(const std::string &dir, const NetDef &net_def, Runtime *runtime,
+            const std::string &adapter_options);
+
+  // Return false if there is no valid cache for the NetDef.
+  bool Load(NetDef *adapted_net_def);
+  MaceStatus Save(const NetDef &adapted_net_def);
+
+ private:
+  std::unique_ptr<KVStorage> storage_;
+  std::string file_path_;
+};
+
+}  // namespace mace
+
+#endif  // MACE_FLOWS_CPU_INIT_CACHE_H_
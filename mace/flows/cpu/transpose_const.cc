@@ -28,6 +28,8 @@
 namespace mace {
 
 namespace {
+const char *kConstUsedByCpuSuffix = "_const_used_by_cpu";
+
 static std::vector<index_t> GetTensorStride(const Tensor *tensor) {
     int32_t ndim = static_cast<int32_t>(tensor->dim_size());
     std::vector<index_t> stride(ndim, 1);
@@ -57,6 +59,12 @@ MaceStatus DoTransposeConstForCPU(
   DataType dst_dt = static_cast<DataType>(
             ProtoArgHelper::GetOptionalArg<OperatorDef, int>(
                 *op_def, "T", static_cast<int>(DataType::DT_FLOAT)));
+  // The weights of the lower precision ops in a mixed precision net keep
+  // their type here, CastConstForCPU converts them later.
+  if (dst_dt != DT_FLOAT && dst_dt != DT_HALF &&
+      (src_dt == DT_FLOAT || src_dt == DT_HALF)) {
+    dst_dt = src_dt;
+  }
   MACE_CHECK((src_dt == DT_FLOAT || src_dt == DT_HALF) &&
              (dst_dt == DT_FLOAT || dst_dt == DT_HALF),
              "Only support transform DT_FLOAT or DT_HALF,",
@@ -90,7 +98,7 @@ MaceStatus DoTransposeConstForCPU(
       output_shape[i] = input_shape[dims[i]];
     }
   }
-  std::string output_name = input_name + std::string("_const_used_by_cpu");
+  std::string output_name = input_name + kConstUsedByCpuSuffix;
   Tensor *output = ws->GetTensor(output_name);
   MACE_CHECK(output == nullptr || output->shape() == output_shape,
              output_name, " should not exist, ",
@@ -227,4 +235,33 @@ MaceStatus TransposeConstForCPU(
   return MaceStatus::MACE_SUCCESS;
 }
 
+MaceStatus RetransposeConstForCPU(
+    mace::utils::ThreadPool *thread_pool,
+    Workspace *ws,
+    Runtime *runtime,
+    NetDef *net_def) {
+  const std::string suffix = kConstUsedByCpuSuffix;
+  int num_ops = net_def->op_size();
+  for (int idx = 0; idx < num_ops; ++idx) {
+    OperatorDef *op_def = net_def->mutable_op(idx);
+    for (int input_idx = 0; input_idx < op_def->input_size(); ++input_idx) {
+      const std::string &input_name = op_def->input(input_idx);
+      if (input_name.size() <= suffix.size() ||
+          input_name.compare(input_name.size() - suffix.size(),
+                             suffix.size(), suffix) != 0) {
+        continue;
+      }
+      std::string src_name =
+          input_name.substr(0, input_name.size() - suffix.size());
+      Tensor *tensor = ws->GetTensor(src_name);
+      MACE_CHECK(tensor != nullptr && tensor->is_weight(),
+                 "Can not find the weight ", src_name, " of ", input_name);
+      op_def->set_input(input_idx, src_name);
+      MACE_RETURN_IF_ERROR(DoTransposeConstForCPU(thread_pool, ws, runtime,
+                                                 op_def, input_idx));
+    }
+  }
+  return MaceStatus::MACE_SUCCESS;
+}
+
 }  // namespace mace
@@ -26,6 +26,14 @@ MaceStatus TransposeConstForCPU(
     Runtime *runtime,
     NetDef *net_def);
 
+// Create the tensors of a NetDef which has been processed by
+// TransposeConstForCPU before, e.g. one loaded from the init cache.
+MaceStatus RetransposeConstForCPU(
+    mace::utils::ThreadPool *thread_pool,
+    Workspace *ws,
+    Runtime *runtime,
+    NetDef *net_def);
+
 }  // namespace mace
 
 #endif  // MACE_FLOWS_CPU_TRANSPOSE_CONST_H_
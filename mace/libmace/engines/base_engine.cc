@@ -23,6 +23,7 @@
 
 #include "mace/core/flow/base_flow.h"
 #include "mace/core/flow/flow_registry.h"
+#include "mace/core/memory/const_tensor_registry.h"
 #include "mace/core/memory/rpcmem/rpcmem.h"
 #include "mace/core/registry/ops_registry.h"
 #include "mace/core/registry/op_delegator_registry.h"
@@ -37,12 +38,32 @@
 
 namespace mace {
 
+namespace {
+std::unique_ptr<utils::ThreadPool> CreateThreadPool(
+    const MaceEngineCfgImpl *config) {
+  if (config->cpu_numa_node() >= 0) {
+    int thread_count = config->num_threads();
+    std::vector<size_t> cores;
+    if (utils::GetNumaNodeCoresToUse(config->cpu_numa_node(), &thread_count,
+                                     &cores) == MaceStatus::MACE_SUCCESS) {
+      // The calling thread is bound to the node by the CPU runtime.
+      return make_unique<utils::ThreadPool>(cores);
+    }
+    LOG(WARNING) << "Ignore NUMA node " << config->cpu_numa_node();
+  }
+  return make_unique<utils::ThreadPool>(config->num_threads(),
+                                        config->cpu_affinity_policy());
+}
+}  // namespace
+
 BaseEngine::BaseEngine(const MaceEngineConfig &config)
-    : thread_pool_(new utils::ThreadPool(config.impl_->num_threads(),
-                                         config.impl_->cpu_affinity_policy())),
+    : thread_pool_(CreateThreadPool(config.impl_.get())),
       model_data_(nullptr), op_registry_(new OpRegistry),
       op_delegator_registry_(new OpDelegatorRegistry),
-      config_impl_(config.impl_) {
+      config_impl_(config.impl_),
+      run_control_(std::make_shared<RunControl>()) {
+  run_control_->SetCheckpoints(config_impl_->checkpoints(),
+                               config_impl_->checkpoint_latency_budget());
 #ifdef MACE_ENABLE_RPCMEM
   runtime_context_ = make_unique<IonRuntimeContext>(
       thread_pool_.get(), rpcmem_factory::CreateRpcmem());
@@ -81,9 +102,7 @@ MaceStatus BaseEngine::Init(
     const std::string &model_data_file, BaseEngine *tutor) {
   VLOG(3) << "Loading Model Data";
 
-  auto fs = GetFileSystem();
-  MACE_RETURN_IF_ERROR(fs->NewReadOnlyMemoryRegionFromFile(
-      model_data_file.c_str(), &model_data_));
+  MACE_RETURN_IF_ERROR(MapModelDataFile(model_data_file));
 
   bool model_data_unused = false;
   MACE_RETURN_IF_ERROR(Init(
@@ -127,9 +146,7 @@ MaceStatus BaseEngine::Init(
     const std::string &model_data_file) {
   VLOG(3) << "Loading Model Data";
 
-  auto fs = GetFileSystem();
-  MACE_RETURN_IF_ERROR(fs->NewReadOnlyMemoryRegionFromFile(
-      model_data_file.c_str(), &model_data_));
+  MACE_RETURN_IF_ERROR(MapModelDataFile(model_data_file));
 
   bool model_data_unused = false;
   MACE_RETURN_IF_ERROR(Init(
@@ -144,6 +161,19 @@ MaceStatus BaseEngine::Init(
   return MaceStatus::MACE_SUCCESS;
 }
 
+MaceStatus BaseEngine::MapModelDataFile(const std::string &model_data_file) {
+  if (config_impl_->const_tensor_sharing()) {
+    // The engines of the process share the mapping and the weights in it.
+    return ConstTensorRegistry::Get()->MapFile(model_data_file, &model_data_);
+  }
+
+  auto fs = GetFileSystem();
+  std::unique_ptr<port::ReadOnlyMemoryRegion> model_data;
+  MACE_RETURN_IF_ERROR(fs->NewReadOnlyMemoryRegionFromFile(
+      model_data_file.c_str(), &model_data));
+  model_data_ = std::move(model_data);
+  return MaceStatus::MACE_SUCCESS;
+}
 
 MaceStatus BaseEngine::BeforeInit() {
   return MaceStatus::MACE_SUCCESS;
@@ -185,8 +215,21 @@ std::vector<RuntimeType> BaseEngine::GetRuntimeTypes() {
 MaceStatus BaseEngine::Forward(const std::map<std::string, MaceTensor> &inputs,
                                std::map<std::string, MaceTensor> *outputs,
                                RunMetadata *run_metadata) {
+  // The early exit state is shared by the runs of the engine, so it is only
+  // touched when there are checkpoints, which the engines running requests
+  // concurrently drop.
+  const bool has_checkpoints = run_control_->has_checkpoints();
+  if (has_checkpoints) {
+    run_control_->BeginRun();
+  }
   MACE_RETURN_IF_ERROR(BeforeRun());
   MACE_RETURN_IF_ERROR(Run(inputs, outputs, run_metadata));
+  if (has_checkpoints) {
+    // Remove the outputs which are not computed because of an early exit.
+    for (auto &name : run_control_->skipped_outputs()) {
+      outputs->erase(name);
+    }
+  }
   return AfterRun();
 }
 
@@ -208,6 +251,10 @@ MaceStatus BaseEngine::AfterRun() {
   return MaceStatus::MACE_SUCCESS;
 }
 
+std::shared_ptr<RunControl> BaseEngine::run_control() const {
+  return run_control_;
+}
+
 BaseEngine::~BaseEngine() {}
 
 }  // namespace mace
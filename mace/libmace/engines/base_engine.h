@@ -20,6 +20,7 @@
 #include <string>
 #include <vector>
 
+#include "mace/core/net/run_control.h"
 #include "mace/core/registry/op_delegator_registry.h"
 #include "mace/core/registry/ops_registry.h"
 #include "mace/core/runtime/runtime.h"
@@ -79,6 +80,10 @@ class BaseEngine {
   RuntimesMap &GetRuntimesOfTutor(BaseEngine *tutor);
   std::vector<RuntimeType> GetRuntimeTypes();
 
+  // Cancels the run in progress or sets its deadline, only checked by the
+  // engines running the flows in the calling thread.
+  std::shared_ptr<RunControl> run_control() const;
+
  protected:
   virtual MaceStatus BeforeRun();
   virtual MaceStatus Run(const std::map<std::string, MaceTensor> &inputs,
@@ -86,13 +91,17 @@ class BaseEngine {
                          RunMetadata *run_metadata) = 0;
   virtual MaceStatus AfterRun();
 
+ private:
+  MaceStatus MapModelDataFile(const std::string &model_data_file);
+
  protected:
   std::unique_ptr<utils::ThreadPool> thread_pool_;
   std::unique_ptr<RuntimeContext> runtime_context_;
-  std::unique_ptr<port::ReadOnlyMemoryRegion> model_data_;
+  std::shared_ptr<port::ReadOnlyMemoryRegion> model_data_;
   std::unique_ptr<OpRegistry> op_registry_;
   std::unique_ptr<OpDelegatorRegistry> op_delegator_registry_;
   std::shared_ptr<MaceEngineCfgImpl> config_impl_;
+  std::shared_ptr<RunControl> run_control_;
   RuntimesMap runtimes_;
 
   MACE_DISABLE_COPY_AND_ASSIGN(BaseEngine);
@@ -15,12 +15,17 @@
 
 #include "mace/libmace/engines/engine_registry.h"
 
+#include "mace/libmace/engines/pipeline_engine.h"
 #include "mace/libmace/engines/serial_engine.h"
+#include "mace/utils/mace_engine_config.h"
 #include "mace/utils/memory.h"
 
 namespace mace {
 
 std::unique_ptr<BaseEngine> SmartCreateEngine(const MaceEngineConfig &config) {
+  if (config.impl_->pipeline_enabled()) {
+    return make_unique<PipelineEngine>(config);
+  }
   return make_unique<SerialEngine>(config);
 }
 
@@ -0,0 +1,595 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mace/libmace/engines/pipeline_engine.h"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "mace/core/proto/arg_helper.h"
+#include "mace/core/runtime/runtime.h"
+#include "mace/core/runtime/runtime_registry.h"
+#include "mace/port/env.h"
+#include "mace/utils/mace_engine_config.h"
+#include "mace/utils/memory.h"
+
+namespace mace {
+
+constexpr int PipelineEngine::kNumSlots;
+
+struct PipelineEngine::Request {
+  Request(const std::map<std::string, MaceTensor> *in,
+          std::map<std::string, MaceTensor> *out,
+          RunMetadata *metadata, size_t stage_num)
+      : inputs(in), outputs(out), run_metadata(metadata),
+        slots(stage_num, -1), status(MaceStatus::MACE_SUCCESS),
+        done(false) {}
+
+  const std::map<std::string, MaceTensor> *inputs;
+  std::map<std::string, MaceTensor> *outputs;
+  RunMetadata *run_metadata;
+  // the slot of each flow's outputs used by this request
+  std::vector<int> slots;
+  MaceStatus status;
+
+  bool done;
+  std::mutex mutex;
+  std::condition_variable cond;
+};
+
+namespace {
+RuntimeType GetNetRuntimeType(MaceEngineCfgImpl *config_impl,
+                              const NetDef *net_def) {
+  auto runtime_type = config_impl->runtime_type(net_def->name());
+  if (runtime_type != RuntimeType::RT_NONE) {
+    SetProtoArg(const_cast<NetDef *>(net_def), "runtime_type",
+                static_cast<int>(runtime_type));
+  }
+  return static_cast<RuntimeType>(ProtoArgHelper::GetOptionalArg<NetDef, int>(
+      *net_def, "runtime_type", static_cast<int>(RuntimeType::RT_NONE)));
+}
+}  // namespace
+
+PipelineEngine::PipelineEngine(const MaceEngineConfig &config)
+    : BaseEngine(config),
+      queue_capacity_(config_impl_->pipeline_queue_capacity()),
+      running_requests_(0), inter_mem_released_(false) {
+  LOG(INFO) << "Creating PipelineEngine, MACE version: " << MaceVersion();
+  // Several threads may run at once, the checkpoints are ignored.
+  run_control_->SetCheckpoints({}, 0);
+}
+
+PipelineEngine::~PipelineEngine() {
+  StopWorkers();
+}
+
+// @Deprecated, will be removed in future version
+MaceStatus PipelineEngine::Init(
+    const NetDef *net_def, const std::vector<std::string> &input_nodes,
+    const std::vector<std::string> &output_nodes,
+    const unsigned char *model_data,
+    const int64_t model_data_size, bool *model_data_unused) {
+  MACE_RETURN_IF_ERROR(BaseEngine::Init(net_def, input_nodes, output_nodes,
+                                        model_data, model_data_size,
+                                        model_data_unused));
+
+  auto multi_net_def = MultiNetDef();
+  mace::NetDef *tmp_net_def = multi_net_def.add_net_def();
+  *tmp_net_def = *net_def;
+  return DoInit(&multi_net_def, input_nodes, output_nodes, model_data,
+                model_data_size, model_data_unused);
+}
+
+MaceStatus PipelineEngine::Init(const MultiNetDef *multi_net_def,
+                                const std::vector<std::string> &input_nodes,
+                                const std::vector<std::string> &output_nodes,
+                                const unsigned char *model_data,
+                                const int64_t model_data_size,
+                                bool *model_data_unused,
+                                BaseEngine *tutor) {
+  if (tutor != nullptr) {
+    LOG(ERROR) << "PipelineEngine can not share runtimes with a tutor";
+    return MaceStatus::MACE_INVALID_ARGS;
+  }
+  MACE_RETURN_IF_ERROR(BaseEngine::Init(multi_net_def, input_nodes,
+                                        output_nodes, model_data,
+                                        model_data_size, model_data_unused,
+                                        tutor));
+
+  return DoInit(multi_net_def, input_nodes, output_nodes, model_data,
+                model_data_size, model_data_unused);
+}
+
+MaceStatus PipelineEngine::BeforeRun() {
+  // The runtimes are prepared by the workers, see RunStage.
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus PipelineEngine::Run(
+    const std::map<std::string, MaceTensor> &inputs,
+    std::map<std::string, MaceTensor> *outputs,
+    RunMetadata *run_metadata) {
+  if (stages_.empty()) {
+    return MaceStatus(MaceStatus::MACE_RUNTIME_ERROR,
+                      "the pipeline engine is not initialized");
+  }
+  {
+    std::unique_lock<std::mutex> lock(run_mutex_);
+    if (inter_mem_released_) {
+      MACE_RETURN_IF_ERROR(DoAllocateIntermediateBuffer());
+    }
+    ++running_requests_;
+  }
+
+  Request request(&inputs, outputs, run_metadata, stages_.size());
+  stages_[0]->queue->Push(&request);
+  {
+    std::unique_lock<std::mutex> lock(request.mutex);
+    request.cond.wait(lock, [&request] { return request.done; });
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(run_mutex_);
+    if (--running_requests_ == 0) {
+      idle_cond_.notify_all();
+    }
+  }
+  return request.status;
+}
+
+MaceStatus PipelineEngine::AfterRun() {
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus PipelineEngine::FakeWarmup() {
+  for (auto &stage : stages_) {
+    MACE_RETURN_IF_ERROR(stage->flow->FakeWarmup());
+  }
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus PipelineEngine::ReleaseIntermediateBuffer() {
+  std::unique_lock<std::mutex> lock(run_mutex_);
+  if (inter_mem_released_) {
+    return MaceStatus::MACE_SUCCESS;
+  }
+  idle_cond_.wait(lock, [this] { return running_requests_ == 0; });
+  for (auto &stage : stages_) {
+    stage->cpu_runtime->ReleaseIntermediateBuffer(this);
+    if (stage->runtime != stage->cpu_runtime) {
+      stage->runtime->ReleaseIntermediateBuffer(this);
+    }
+  }
+  inter_mem_released_ = true;
+
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus PipelineEngine::AllocateIntermediateBuffer() {
+  std::unique_lock<std::mutex> lock(run_mutex_);
+  return DoAllocateIntermediateBuffer();
+}
+
+MaceStatus PipelineEngine::DoAllocateIntermediateBuffer() {
+  if (!inter_mem_released_) {
+    return MaceStatus::MACE_SUCCESS;
+  }
+  for (auto &stage : stages_) {
+    MACE_RETURN_IF_ERROR(stage->flow->AllocateIntermediateBuffer());
+    stage->cpu_runtime->OnAllocateIntermediateBuffer(this);
+    if (stage->runtime != stage->cpu_runtime) {
+      stage->runtime->OnAllocateIntermediateBuffer(this);
+    }
+  }
+  inter_mem_released_ = false;
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus PipelineEngine::CreateStages(const NetDefMap &net_defs) {
+  auto runtime_registry = make_unique<RuntimeRegistry>();
+  RegisterAllRuntimes(runtime_registry.get());
+
+  std::vector<RuntimeType> runtime_types;
+  int cpu_stage_num = 0;
+  for (auto i = net_defs.begin(); i != net_defs.end(); ++i) {
+    auto runtime_type = GetNetRuntimeType(config_impl_.get(), i->second);
+    MACE_CHECK(runtime_type != RuntimeType::RT_NONE,
+               "no runtime type specified");
+    runtime_types.push_back(runtime_type);
+    cpu_stage_num += (runtime_type == RuntimeType::RT_CPU);
+  }
+
+  // Split the CPU threads (and the cores they are bound to) between the CPU
+  // flows, the other flows only run a few CPU ops with a single thread.
+  int thread_num = config_impl_->num_threads();
+  std::vector<float> cpu_max_freqs;
+  std::vector<size_t> cores;
+  if (port::Env::Default()->GetCPUMaxFreq(&cpu_max_freqs)
+      != MaceStatus::MACE_SUCCESS) {
+    LOG(ERROR) << "Fail to get cpu max frequencies";
+  }
+  if (config_impl_->cpu_numa_node() < 0 ||
+      utils::GetNumaNodeCoresToUse(config_impl_->cpu_numa_node(),
+                                   &thread_num, &cores)
+          != MaceStatus::MACE_SUCCESS) {
+    utils::GetCPUCoresToUse(cpu_max_freqs,
+                            config_impl_->cpu_affinity_policy(),
+                            &thread_num, &cores);
+  }
+
+  int cpu_stage_idx = 0;
+  for (auto i = net_defs.begin(); i != net_defs.end(); ++i) {
+    const NetDef *net_def = i->second;
+    const RuntimeType runtime_type = runtime_types[stages_.size()];
+    auto stage = make_unique<Stage>();
+    if (runtime_type == RuntimeType::RT_CPU) {
+      const int begin = cpu_stage_idx * thread_num / cpu_stage_num;
+      const int end = std::max(
+          begin + 1, (cpu_stage_idx + 1) * thread_num / cpu_stage_num);
+      ++cpu_stage_idx;
+      if (cores.empty()) {
+        stage->thread_pool = make_unique<utils::ThreadPool>(
+            end - begin, CPUAffinityPolicy::AFFINITY_NONE);
+      } else {
+        for (int k = begin; k < end; ++k) {
+          stage->cpu_cores.push_back(cores[k % cores.size()]);
+        }
+        stage->thread_pool = make_unique<utils::ThreadPool>(stage->cpu_cores);
+      }
+    } else {
+      stage->thread_pool = make_unique<utils::ThreadPool>(
+          1, CPUAffinityPolicy::AFFINITY_NONE);
+    }
+    stage->thread_pool->Init();
+#ifdef MACE_ENABLE_RPCMEM
+    stage->runtime_context = make_unique<IonRuntimeContext>(
+        stage->thread_pool.get(),
+        static_cast<IonRuntimeContext *>(runtime_context_.get())->rpcmem);
+#else
+    stage->runtime_context =
+        make_unique<RuntimeContext>(stage->thread_pool.get());
+#endif  // MACE_ENABLE_RPCMEM
+
+    // Every flow has its own runtimes, so the flows never share the
+    // intermediate buffers, which are in use at the same time.
+    auto cpu_runtime = SmartCreateRuntime(
+        runtime_registry.get(), RuntimeType::RT_CPU,
+        stage->runtime_context.get());
+    MACE_RETURN_IF_ERROR(cpu_runtime->Init(config_impl_.get(), CPU_BUFFER));
+    stage->cpu_runtime = std::move(cpu_runtime);
+    runtimes_.emplace((RuntimeType::RT_CPU << 16) | CPU_BUFFER,
+                      stage->cpu_runtime);
+    if (runtime_type == RuntimeType::RT_CPU) {
+      stage->runtime = stage->cpu_runtime;
+    } else {
+      auto runtime = SmartCreateRuntime(runtime_registry.get(), runtime_type,
+                                        stage->runtime_context.get());
+      auto mem_type_i =
+          static_cast<MemoryType>(ProtoArgHelper::GetOptionalArg<NetDef, int>(
+              *net_def, "opencl_mem_type",
+              static_cast<int>(MemoryType::MEMORY_NONE)));
+      MACE_CHECK(mem_type_i != MemoryType::MEMORY_NONE,
+                 "no mem type specified");
+      MACE_RETURN_IF_ERROR(runtime->Init(config_impl_.get(), mem_type_i));
+      stage->runtime = std::move(runtime);
+      auto sub_type = SmartGetRuntimeSubType(runtime_type,
+                                             stage->runtime_context.get());
+      runtimes_.emplace((runtime_type << 16) | sub_type, stage->runtime);
+    }
+    stages_.push_back(std::move(stage));
+  }
+
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus PipelineEngine::CreateAndInitFlows(
+    const NetDefMap &net_defs, const unsigned char *model_data,
+    const int64_t model_data_size, bool *model_data_unused) {
+  auto flow_registry = make_unique<FlowRegistry>();
+  RegisterAllFlows(flow_registry.get());
+
+  bool flows_data_unused = true;
+  size_t stage_idx = 0;
+  for (auto i = net_defs.begin(); i != net_defs.end(); ++i) {
+    const NetDef *net_def = i->second;
+    Stage *stage = stages_[stage_idx++].get();
+    VLOG(1) << "CreateAndInitFlows, name: " << net_def->name()
+            << ", infer_order: " << net_def->infer_order()
+            << ", runtime: " << stage->runtime->GetRuntimeType();
+
+    auto flow_context = make_unique<FlowContext>(
+        config_impl_.get(), op_registry_.get(), op_delegator_registry_.get(),
+        stage->cpu_runtime.get(), stage->runtime.get(),
+        stage->thread_pool.get(), this);
+    DataType data_type = static_cast<DataType>(net_def->data_type());
+    FlowSubType sub_type = (data_type == DataType::DT_BFLOAT16) ?
+                           FlowSubType::FW_SUB_BF16 : FlowSubType::FW_SUB_REF;
+    stage->flow = flow_registry->CreateFlow(stage->runtime->GetRuntimeType(),
+                                            sub_type, flow_context.get());
+    bool data_unused = false;
+    const auto data_offset = net_def->data_offset();
+    auto data_size = net_def->data_size();
+    if (data_size == 0) {  // Compatible with old version of NetDef
+      data_size = model_data_size;
+    }
+    MACE_CHECK(data_offset + data_size <= model_data_size);
+    MACE_RETURN_IF_ERROR(stage->flow->Init(
+        net_def, model_data + data_offset, data_size, &data_unused));
+    flows_data_unused &= data_unused;
+  }
+
+  if (model_data_unused != nullptr) {
+    *model_data_unused = flows_data_unused;
+  }
+
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus PipelineEngine::CreateTensorsForStages(
+    const NetDefMap &net_defs, const std::vector<std::string> &glb_in_nodes,
+    const std::vector<std::string> &glb_out_nodes) {
+  MACE_CHECK(stages_.size() == net_defs.size());
+
+  // The outputs passed between flows: key -> (producer, output name)
+  std::unordered_map<std::string, std::pair<int, std::string>> inter_outputs;
+  std::vector<std::string> out_nodes = glb_out_nodes;
+  int stage_idx = 0;
+  for (auto iter = net_defs.begin(); iter != net_defs.end(); ++iter) {
+    const NetDef *net_def = iter->second;
+    Stage *stage = stages_[stage_idx].get();
+    stage->slot_outputs.resize(kNumSlots);
+    for (int i = 0; i < net_def->output_info_size(); ++i) {
+      const InputOutputInfo &output_info = net_def->output_info(i);
+      const auto &output_name = output_info.name();
+      auto find_iter = std::find(out_nodes.begin(), out_nodes.end(),
+                                 output_name);
+      if (find_iter != out_nodes.end()) {
+        out_nodes.erase(find_iter);
+        stage->model_outputs.push_back(output_name);
+        continue;
+      }
+
+      const auto &output_alias = output_info.alias();
+      const auto &output_key =
+          output_alias.empty() ? output_name : output_alias;
+      inter_outputs.emplace(output_key,
+                            std::make_pair(stage_idx, output_name));
+      const auto &output_dims = output_info.dims();
+      std::vector<int64_t> output_shape(output_dims.begin(),
+                                        output_dims.end());
+      const auto bytes = std::accumulate(
+          output_shape.begin(), output_shape.end(), 1,
+          std::multiplies<int64_t>()) *
+          GetEnumTypeSize(output_info.data_type());
+      auto data_format = static_cast<DataFormat>(output_info.data_format());
+      for (int s = 0; s < kNumSlots; ++s) {
+        std::shared_ptr<void> buffer(new int8_t[bytes],
+                                     std::default_delete<int8_t[]>());
+        stage->slot_buffers.push_back(buffer);
+        stage->slot_outputs[s].emplace(
+            output_name, MaceTensor(output_shape, buffer, data_format));
+      }
+    }
+    ++stage_idx;
+  }
+  MACE_CHECK(out_nodes.empty(), "can not find output in model: ",
+             MakeString(out_nodes));
+
+  // A flow's slot is given back after the last flow reading it has run.
+  std::vector<int> last_consumers(stages_.size());
+  std::iota(last_consumers.begin(), last_consumers.end(), 0);
+  std::vector<std::string> in_nodes = glb_in_nodes;
+  stage_idx = 0;
+  for (auto iter = net_defs.begin(); iter != net_defs.end(); ++iter) {
+    const NetDef *net_def = iter->second;
+    Stage *stage = stages_[stage_idx].get();
+    for (int i = 0; i < net_def->input_info_size(); ++i) {
+      const auto &input_name = net_def->input_info(i).name();
+      StageInput input = {input_name, -1, ""};
+      auto inter_iter = inter_outputs.find(input_name);
+      if (inter_iter != inter_outputs.end()) {
+        input.producer = inter_iter->second.first;
+        input.producer_output = inter_iter->second.second;
+        MACE_CHECK(input.producer < stage_idx,
+                   "flow's input is produced by a later flow: ", input_name);
+        last_consumers[input.producer] = stage_idx;
+      } else {
+        auto find_iter = std::find(in_nodes.begin(), in_nodes.end(),
+                                   input_name);
+        if (find_iter != in_nodes.end()) {
+          in_nodes.erase(find_iter);
+        } else {
+          MACE_CHECK(std::find(glb_in_nodes.begin(), glb_in_nodes.end(),
+                               input_name) != glb_in_nodes.end() ||
+                     std::find(glb_out_nodes.begin(), glb_out_nodes.end(),
+                               input_name) != glb_out_nodes.end(),
+                     "Can not find flow's input: ", input_name);
+        }
+      }
+      stage->inputs.push_back(input);
+    }
+    ++stage_idx;
+  }
+  MACE_CHECK(in_nodes.empty(), "can not find input in model: ",
+             MakeString(in_nodes));
+
+  for (size_t i = 0; i < stages_.size(); ++i) {
+    Stage *stage = stages_[i].get();
+    if (!stage->slot_buffers.empty()) {
+      stages_[last_consumers[i]]->released_producers.push_back(i);
+      stage->free_slots =
+          make_unique<utils::BoundedQueue<int>>(kNumSlots);
+      for (int s = 0; s < kNumSlots; ++s) {
+        stage->free_slots->Push(s);
+      }
+    }
+    stage->queue = make_unique<utils::BoundedQueue<Request *>>(
+        static_cast<size_t>(queue_capacity_));
+  }
+
+  return MaceStatus::MACE_SUCCESS;
+}
+
+void PipelineEngine::StartWorkers() {
+  for (size_t i = 0; i < stages_.size(); ++i) {
+    stages_[i]->worker = std::thread(&PipelineEngine::WorkerLoop, this, i);
+  }
+}
+
+void PipelineEngine::StopWorkers() {
+  // Stop the workers in order, so the requests still in the queues can run
+  // to the end.
+  for (auto &stage : stages_) {
+    if (stage->queue != nullptr) {
+      stage->queue->Close();
+    }
+    if (stage->worker.joinable()) {
+      stage->worker.join();
+    }
+  }
+}
+
+void PipelineEngine::WorkerLoop(size_t stage_idx) {
+  Stage *stage = stages_[stage_idx].get();
+  if (!stage->cpu_cores.empty()) {
+    if (port::Env::Default()->SchedSetAffinity(stage->cpu_cores)
+        != MaceStatus::MACE_SUCCESS) {
+      LOG(ERROR) << "Failed to sched set affinity for flow: "
+                 << stage->flow->GetName();
+    }
+  }
+
+  Request *request = nullptr;
+  while (stage->queue->Pop(&request)) {
+    // A failed request still goes through every flow to give back its slots.
+    if (request->status == MaceStatus::MACE_SUCCESS) {
+      request->status = RunStage(stage, stage_idx, request);
+    }
+    for (int producer : stage->released_producers) {
+      const int slot = request->slots[producer];
+      if (slot >= 0) {
+        stages_[producer]->free_slots->Push(slot);
+      }
+    }
+
+    if (stage_idx + 1 < stages_.size()) {
+      stages_[stage_idx + 1]->queue->Push(request);
+    } else {
+      std::unique_lock<std::mutex> lock(request->mutex);
+      request->done = true;
+      request->cond.notify_all();
+    }
+  }
+}
+
+MaceStatus PipelineEngine::RunStage(Stage *stage, size_t stage_idx,
+                                    Request *request) {
+  MaceTensorInfo outputs;
+  int slot = -1;
+  if (stage->free_slots != nullptr) {
+    MACE_CHECK(stage->free_slots->Pop(&slot));
+    request->slots[stage_idx] = slot;
+    outputs = stage->slot_outputs[slot];
+  }
+  for (auto &name : stage->model_outputs) {
+    auto iter = request->outputs->find(name);
+    if (iter == request->outputs->end()) {
+      LOG(ERROR) << "Output tensor not found: " << name;
+      return MaceStatus::MACE_INVALID_ARGS;
+    }
+    outputs.emplace(name, iter->second);
+  }
+
+  MaceTensorInfo inputs;
+  for (auto &input : stage->inputs) {
+    if (input.producer >= 0) {
+      const int producer_slot = request->slots[input.producer];
+      inputs.emplace(input.name, stages_[input.producer]->slot_outputs[
+          producer_slot].at(input.producer_output));
+      continue;
+    }
+    auto iter = request->inputs->find(input.name);
+    if (iter == request->inputs->end()) {
+      iter = request->outputs->find(input.name);
+      if (iter == request->outputs->end()) {
+        LOG(ERROR) << "Input tensor not found: " << input.name;
+        return MaceStatus::MACE_INVALID_ARGS;
+      }
+    }
+    inputs.emplace(input.name, iter->second);
+  }
+
+  Runtime *cpu_runtime = stage->cpu_runtime.get();
+  Runtime *runtime = stage->runtime.get();
+  MACE_RETURN_IF_ERROR(runtime->BeforeRun(config_impl_.get()));
+  if (runtime != cpu_runtime) {
+    MACE_RETURN_IF_ERROR(cpu_runtime->BeforeRun(config_impl_.get()));
+  }
+  VLOG(1) << "start run flow: " << stage->flow->GetName();
+  MACE_RETURN_IF_ERROR(stage->flow->Run(inputs, &outputs,
+                                        request->run_metadata));
+  MACE_RETURN_IF_ERROR(runtime->AfterRun());
+  runtime->OnIntermediateBufferUsed(this);
+  if (runtime != cpu_runtime) {
+    MACE_RETURN_IF_ERROR(cpu_runtime->AfterRun());
+    cpu_runtime->OnIntermediateBufferUsed(this);
+  }
+
+  // Keep the output shapes for the following flows and the caller.
+  if (slot >= 0) {
+    for (auto &output : stage->slot_outputs[slot]) {
+      output.second = outputs.at(output.first);
+    }
+  }
+  for (auto &name : stage->model_outputs) {
+    request->outputs->find(name)->second = outputs.at(name);
+  }
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus PipelineEngine::DoInit(
+    const MultiNetDef *multi_net_def,
+    const std::vector<std::string> &input_nodes,
+    const std::vector<std::string> &output_nodes,
+    const unsigned char *model_data, const int64_t model_data_size,
+    bool *model_data_unused) {
+  VLOG(1) << "Initializing PipelineEngine";
+
+  NetDefMap net_defs;
+  const auto net_def_num = multi_net_def->net_def_size();
+  for (int i = 0; i < net_def_num; ++i) {
+    const NetDef &net_def = multi_net_def->net_def(i);
+    net_defs.emplace(net_def.infer_order(), &net_def);
+  }
+  MACE_CHECK(!net_defs.empty(), "no net_def in the model");
+
+  MACE_RETURN_IF_ERROR(CreateStages(net_defs));
+  MACE_RETURN_IF_ERROR(CreateAndInitFlows(net_defs, model_data,
+                                          model_data_size,
+                                          model_data_unused));
+  MACE_RETURN_IF_ERROR(CreateTensorsForStages(net_defs, input_nodes,
+                                              output_nodes));
+  StartWorkers();
+
+  return MaceStatus::MACE_SUCCESS;
+}
+
+}  // namespace mace
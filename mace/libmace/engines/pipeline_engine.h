@@ -0,0 +1,147 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MACE_LIBMACE_ENGINES_PIPELINE_ENGINE_H_
+#define MACE_LIBMACE_ENGINES_PIPELINE_ENGINE_H_
+
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <map>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <thread>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "mace/core/flow/base_flow.h"
+#include "mace/core/runtime/runtime_context.h"
+#include "mace/libmace/engines/base_engine.h"
+#include "mace/public/mace.h"
+#include "mace/utils/bounded_queue.h"
+
+namespace mace {
+
+// Runs every flow of a MultiNetDef on its own worker thread, thread pool and
+// runtimes, requests are handed from one flow to the next by bounded queues.
+// Run can be called from several threads, the requests overlap in different
+// flows and each caller waits until its request leaves the last flow.
+class PipelineEngine : public BaseEngine {
+ public:
+  explicit PipelineEngine(const MaceEngineConfig &config);
+
+  ~PipelineEngine();
+
+  MaceStatus Init(const MultiNetDef *net_def,
+                  const std::vector<std::string> &input_nodes,
+                  const std::vector<std::string> &output_nodes,
+                  const unsigned char *model_data,
+                  const int64_t model_data_size,
+                  bool *model_data_unused = nullptr,
+                  BaseEngine *tutor = nullptr) override;
+
+  // @Deprecated, will be removed in future version
+  MaceStatus Init(const NetDef *net_def,
+                  const std::vector<std::string> &input_nodes,
+                  const std::vector<std::string> &output_nodes,
+                  const unsigned char *model_data,
+                  const int64_t model_data_size,
+                  bool *model_data_unused = nullptr) override;
+
+  MaceStatus ReleaseIntermediateBuffer() override;
+  MaceStatus AllocateIntermediateBuffer() override;
+
+ protected:
+  MaceStatus BeforeRun() override;
+  MaceStatus Run(const std::map<std::string, MaceTensor> &inputs,
+                 std::map<std::string, MaceTensor> *outputs,
+                 RunMetadata *run_metadata) override;
+  MaceStatus AfterRun() override;
+  MaceStatus FakeWarmup() override;
+
+ private:
+  typedef std::map<std::string, MaceTensor> MaceTensorInfo;
+  typedef std::map<int, const NetDef *> NetDefMap;
+
+  // The tensors between flows are double buffered, so a flow can write the
+  // outputs of a request while the next flow reads those of the previous one.
+  static constexpr int kNumSlots = 2;
+
+  struct Request;
+
+  struct StageInput {
+    std::string name;
+    // -1 if it is an input of the whole model
+    int producer;
+    std::string producer_output;
+  };
+
+  struct Stage {
+    std::unique_ptr<utils::ThreadPool> thread_pool;
+    std::unique_ptr<RuntimeContext> runtime_context;
+    std::shared_ptr<Runtime> cpu_runtime;
+    std::shared_ptr<Runtime> runtime;
+    std::unique_ptr<BaseFlow> flow;
+    std::vector<size_t> cpu_cores;
+
+    std::vector<StageInput> inputs;
+    std::vector<std::string> model_outputs;
+    // outputs consumed by the other flows, one copy per slot
+    std::vector<MaceTensorInfo> slot_outputs;
+    std::vector<std::shared_ptr<void>> slot_buffers;
+    // the flows whose slot is given back after this flow runs
+    std::vector<int> released_producers;
+
+    std::unique_ptr<utils::BoundedQueue<Request *>> queue;
+    std::unique_ptr<utils::BoundedQueue<int>> free_slots;
+    std::thread worker;
+  };
+
+  MaceStatus DoInit(const MultiNetDef *multi_net_def,
+                    const std::vector<std::string> &input_nodes,
+                    const std::vector<std::string> &output_nodes,
+                    const unsigned char *model_data,
+                    const int64_t model_data_size,
+                    bool *model_data_unused);
+
+  MaceStatus CreateStages(const NetDefMap &net_defs);
+
+  MaceStatus CreateAndInitFlows(const NetDefMap &net_defs,
+                                const unsigned char *model_data,
+                                const int64_t model_data_size,
+                                bool *model_data_unused);
+
+  MaceStatus CreateTensorsForStages(
+      const NetDefMap &net_defs, const std::vector<std::string> &input_nodes,
+      const std::vector<std::string> &output_nodes);
+
+  MaceStatus DoAllocateIntermediateBuffer();
+  void StartWorkers();
+  void StopWorkers();
+  void WorkerLoop(size_t stage_idx);
+  MaceStatus RunStage(Stage *stage, size_t stage_idx, Request *request);
+
+ private:
+  std::vector<std::unique_ptr<Stage>> stages_;
+  int queue_capacity_;
+
+  std::mutex run_mutex_;
+  std::condition_variable idle_cond_;
+  int running_requests_;
+  bool inter_mem_released_;
+
+  MACE_DISABLE_COPY_AND_ASSIGN(PipelineEngine);
+};
+
+}  // namespace mace
+
+#endif  // MACE_LIBMACE_ENGINES_PIPELINE_ENGINE_H_
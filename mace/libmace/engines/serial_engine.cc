@@ -253,7 +253,8 @@ MaceStatus SerialEngine::CreateAndInitFlows(
 
     auto flow_context = make_unique<FlowContext>(
         config_impl_.get(), op_registry_.get(), op_delegator_registry_.get(),
-        cpu_runtime_.get(), runtime.get(), thread_pool_.get(), this);
+        cpu_runtime_.get(), runtime.get(), thread_pool_.get(), this,
+        run_control_.get());
     DataType data_type = static_cast<DataType>(net_def->data_type());
     FlowSubType sub_type = (data_type == DataType::DT_BFLOAT16) ?
                            FlowSubType::FW_SUB_BF16 : FlowSubType::FW_SUB_REF;
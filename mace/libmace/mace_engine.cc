@@ -12,6 +12,14 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <condition_variable>  // NOLINT(build/c++11)
+#include <deque>
+#include <mutex>  // NOLINT(build/c++11)
+#include <thread>  // NOLINT(build/c++11)
+#include <utility>
+
 #include "mace/libmace/engines/base_engine.h"
 #include "mace/libmace/engines/engine_registry.h"
 #include "mace/port/logger.h"
@@ -23,12 +31,97 @@
 
 namespace mace {
 
+class RunFuture::Impl {
+ public:
+  Impl(uint64_t run_id, int64_t deadline_micros,
+       const std::map<std::string, MaceTensor> &inputs,
+       std::map<std::string, MaceTensor> *outputs,
+       std::function<void(const MaceStatus &)> callback,
+       std::shared_ptr<RunControl> run_control)
+      : run_id_(run_id), deadline_micros_(deadline_micros), inputs_(inputs),
+        outputs_(outputs), callback_(std::move(callback)),
+        run_control_(std::move(run_control)), cancelled_(false),
+        finished_(false) {}
+
+  uint64_t run_id() const { return run_id_; }
+  int64_t deadline_micros() const { return deadline_micros_; }
+  const std::map<std::string, MaceTensor> &inputs() const { return inputs_; }
+  std::map<std::string, MaceTensor> *outputs() const { return outputs_; }
+  bool cancelled() const { return cancelled_; }
+
+  void Cancel() {
+    cancelled_ = true;
+    run_control_->Cancel(run_id_);
+  }
+
+  // The callback is called before the waiters are woken up.
+  void Finish(const MaceStatus &status) {
+    if (callback_) {
+      callback_(status);
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    status_ = status;
+    finished_ = true;
+    finished_cond_.notify_all();
+  }
+
+  MaceStatus Wait() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    finished_cond_.wait(lock, [this] { return finished_; });
+    return status_;
+  }
+
+  bool WaitFor(int64_t timeout_us) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return finished_cond_.wait_for(lock, std::chrono::microseconds(timeout_us),
+                                   [this] { return finished_; });
+  }
+
+ private:
+  const uint64_t run_id_;
+  const int64_t deadline_micros_;
+  const std::map<std::string, MaceTensor> inputs_;
+  std::map<std::string, MaceTensor> *outputs_;
+  std::function<void(const MaceStatus &)> callback_;
+  std::shared_ptr<RunControl> run_control_;
+  std::atomic<bool> cancelled_;
+
+  std::mutex mutex_;
+  std::condition_variable finished_cond_;
+  bool finished_;
+  MaceStatus status_;
+
+  MACE_DISABLE_COPY_AND_ASSIGN(Impl);
+};
+
+RunFuture::RunFuture() = default;
+
+RunFuture::~RunFuture() = default;
+
+MaceStatus RunFuture::Wait() const {
+  if (impl_ == nullptr) {
+    return MaceStatus(MaceStatus::MACE_INVALID_ARGS, "no run to wait for");
+  }
+  return impl_->Wait();
+}
+
+bool RunFuture::WaitFor(int64_t timeout_us) const {
+  return impl_ == nullptr || impl_->WaitFor(timeout_us);
+}
+
+void RunFuture::Cancel() {
+  if (impl_ != nullptr) {
+    impl_->Cancel();
+  }
+}
+
 class MaceEngine::Impl {
  public:
   explicit Impl(const MaceEngineConfig &config)
-      : engine_(SmartCreateEngine(config)) {}
+      : engine_(SmartCreateEngine(config)), async_stopped_(false),
+        last_run_id_(0) {}
 
-  ~Impl() {}
+  ~Impl();
 
   MaceStatus Init(const MultiNetDef *net_def,
                   const std::vector<std::string> &input_nodes,
@@ -64,16 +157,48 @@ class MaceEngine::Impl {
                  std::map<std::string, MaceTensor> *outputs,
                  RunMetadata *run_metadata);
 
+  std::shared_ptr<RunFuture::Impl> RunAsync(
+      const std::map<std::string, MaceTensor> &inputs,
+      std::map<std::string, MaceTensor> *outputs,
+      int64_t timeout_us,
+      std::function<void(const MaceStatus &)> callback);
+
   MaceStatus ReleaseIntermediateBuffer();
 
   std::vector<RuntimeType> GetRuntimeTypes();
 
+ private:
+  void AsyncWorkerLoop();
+
  private:
   std::unique_ptr<BaseEngine> engine_;
 
+  // The executor of RunAsync, started by the first request.
+  std::mutex async_mutex_;
+  std::condition_variable async_cond_;
+  std::deque<std::shared_ptr<RunFuture::Impl>> async_requests_;
+  std::shared_ptr<RunFuture::Impl> async_running_;
+  std::thread async_worker_;
+  bool async_stopped_;
+  uint64_t last_run_id_;
+
   MACE_DISABLE_COPY_AND_ASSIGN(Impl);
 };
 
+MaceEngine::Impl::~Impl() {
+  {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    async_stopped_ = true;
+    if (async_running_ != nullptr) {
+      async_running_->Cancel();
+    }
+    async_cond_.notify_all();
+  }
+  if (async_worker_.joinable()) {
+    async_worker_.join();
+  }
+}
+
 MaceStatus MaceEngine::Impl::Init(const MultiNetDef *multi_net_def,
                                   const std::vector<std::string> &input_nodes,
                                   const std::vector<std::string> &output_nodes,
@@ -142,6 +267,72 @@ MaceStatus MaceEngine::Impl::Run(
   return engine_->Forward(inputs, outputs, run_metadata);
 }
 
+std::shared_ptr<RunFuture::Impl> MaceEngine::Impl::RunAsync(
+    const std::map<std::string, MaceTensor> &inputs,
+    std::map<std::string, MaceTensor> *outputs,
+    int64_t timeout_us,
+    std::function<void(const MaceStatus &)> callback) {
+  const int64_t deadline_micros =
+      timeout_us > 0 ? NowMicros() + timeout_us : 0;
+  std::lock_guard<std::mutex> lock(async_mutex_);
+  auto request = std::make_shared<RunFuture::Impl>(
+      ++last_run_id_, deadline_micros, inputs, outputs, std::move(callback),
+      engine_->run_control());
+  async_requests_.push_back(request);
+  if (!async_worker_.joinable()) {
+    async_worker_ = std::thread(&MaceEngine::Impl::AsyncWorkerLoop, this);
+  }
+  async_cond_.notify_one();
+  return request;
+}
+
+void MaceEngine::Impl::AsyncWorkerLoop() {
+  std::shared_ptr<RunControl> run_control = engine_->run_control();
+  while (true) {
+    std::shared_ptr<RunFuture::Impl> request;
+    {
+      std::unique_lock<std::mutex> lock(async_mutex_);
+      async_cond_.wait(lock, [this] {
+        return async_stopped_ || !async_requests_.empty();
+      });
+      if (async_stopped_) {
+        break;
+      }
+      request = async_requests_.front();
+      async_requests_.pop_front();
+      async_running_ = request;
+    }
+
+    // A cancellation before Start is seen by cancelled(), one after it by
+    // the run control.
+    run_control->Start(request->run_id(), request->deadline_micros());
+    MaceStatus run_status = request->cancelled() ?
+        MaceStatus(MaceStatus::MACE_CANCELLED, "run is cancelled") :
+        run_control->Check();
+    if (run_status == MaceStatus::MACE_SUCCESS) {
+      run_status = engine_->Forward(request->inputs(), request->outputs(),
+                                    nullptr);
+    }
+    run_control->Finish();
+    {
+      std::lock_guard<std::mutex> lock(async_mutex_);
+      async_running_.reset();
+    }
+    request->Finish(run_status);
+  }
+
+  // Drop the requests left when the engine is destroyed.
+  std::deque<std::shared_ptr<RunFuture::Impl>> requests;
+  {
+    std::lock_guard<std::mutex> lock(async_mutex_);
+    requests.swap(async_requests_);
+  }
+  for (auto &request : requests) {
+    request->Finish(MaceStatus(MaceStatus::MACE_CANCELLED,
+                               "engine is destroyed"));
+  }
+}
+
 MaceStatus MaceEngine::Impl::ReleaseIntermediateBuffer() {
   return engine_->ReleaseIntermediateBuffer();
 }
@@ -211,6 +402,17 @@ MaceStatus MaceEngine::Run(const std::map<std::string, MaceTensor> &inputs,
   return impl_->Run(inputs, outputs, nullptr);
 }
 
+RunFuture MaceEngine::RunAsync(
+    const std::map<std::string, MaceTensor> &inputs,
+    std::map<std::string, MaceTensor> *outputs,
+    int64_t timeout_us,
+    std::function<void(const MaceStatus &)> callback) {
+  RunFuture future;
+  future.impl_ = impl_->RunAsync(inputs, outputs, timeout_us,
+                                 std::move(callback));
+  return future;
+}
+
 // Deprecated, will be removed in future version.
 MaceStatus MaceEngine::Init(const NetDef *net_def,
                             const std::vector<std::string> &input_nodes,
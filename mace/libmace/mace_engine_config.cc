@@ -25,6 +25,9 @@ namespace mace {
 MaceEngineCfgImpl::MaceEngineCfgImpl()
     : num_threads_(-1),
       cpu_affinity_policy_(CPUAffinityPolicy::AFFINITY_NONE),
+      cpu_numa_node_(-1),
+      cpu_huge_page_policy_(CPUHugePagePolicy::HUGE_PAGE_NONE),
+      const_tensor_sharing_(false),
       opencl_context_(nullptr),
       gpu_priority_hint_(GPUPriorityHint::PRIORITY_LOW),
       gpu_perf_hint_(GPUPerfHint::PERF_NORMAL),
@@ -37,7 +40,12 @@ MaceEngineCfgImpl::MaceEngineCfgImpl()
       accelerator_storage_file_(""),
       apu_boost_hint_(100),
       apu_preference_hint_(
-        APUPreferenceHint::NEURON_PREFER_FAST_SINGLE_ANSWER) {}
+        APUPreferenceHint::NEURON_PREFER_FAST_SINGLE_ANSWER),
+      pipeline_enabled_(false),
+      pipeline_queue_capacity_(2),
+      cpu_mixed_precision_data_type_(IDT_FLOAT),
+      op_precision_tolerance_(0.f),
+      checkpoint_latency_budget_(0) {}
 
 void MaceEngineCfgImpl::SetRuntimeType(const RuntimeType runtime_type,
                                        const char *sub_graph_name) {
@@ -52,6 +60,18 @@ CPUAffinityPolicy MaceEngineCfgImpl::cpu_affinity_policy() const {
   return cpu_affinity_policy_;
 }
 
+int MaceEngineCfgImpl::cpu_numa_node() const {
+  return cpu_numa_node_;
+}
+
+CPUHugePagePolicy MaceEngineCfgImpl::cpu_huge_page_policy() const {
+  return cpu_huge_page_policy_;
+}
+
+bool MaceEngineCfgImpl::const_tensor_sharing() const {
+  return const_tensor_sharing_;
+}
+
 std::shared_ptr<OpenclContext> MaceEngineCfgImpl::opencl_context() const {
   return opencl_context_;
 }
@@ -100,6 +120,44 @@ APUPreferenceHint MaceEngineCfgImpl::apu_preference_hint() const {
   return apu_preference_hint_;
 }
 
+bool MaceEngineCfgImpl::pipeline_enabled() const {
+  return pipeline_enabled_;
+}
+
+int MaceEngineCfgImpl::pipeline_queue_capacity() const {
+  return pipeline_queue_capacity_;
+}
+
+std::string MaceEngineCfgImpl::init_cache_path() const {
+  return init_cache_path_;
+}
+
+std::string MaceEngineCfgImpl::cpu_tuning_parameter_path() const {
+  return cpu_tuning_parameter_path_;
+}
+
+const std::map<std::string, CheckpointPredicate> &
+MaceEngineCfgImpl::checkpoints() const {
+  return checkpoints_;
+}
+
+IDataType MaceEngineCfgImpl::cpu_mixed_precision_data_type() const {
+  return cpu_mixed_precision_data_type_;
+}
+
+const std::map<std::string, float> &
+MaceEngineCfgImpl::op_precision_sensitivities() const {
+  return op_precision_sensitivities_;
+}
+
+float MaceEngineCfgImpl::op_precision_tolerance() const {
+  return op_precision_tolerance_;
+}
+
+int64_t MaceEngineCfgImpl::checkpoint_latency_budget() const {
+  return checkpoint_latency_budget_;
+}
+
 RuntimeType MaceEngineCfgImpl::runtime_type(
     const std::string &sub_graph_name) const {
   if (runtime_map_.count(sub_graph_name) == 0) {
@@ -133,6 +191,21 @@ MaceStatus MaceEngineCfgImpl::SetCPUThreadPolicy(
   return MaceStatus::MACE_SUCCESS;
 }
 
+MaceStatus MaceEngineCfgImpl::SetCPUNumaNode(int node) {
+  cpu_numa_node_ = node;
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus MaceEngineCfgImpl::SetCPUHugePagePolicy(CPUHugePagePolicy policy) {
+  cpu_huge_page_policy_ = policy;
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus MaceEngineCfgImpl::SetConstTensorSharing(bool enable) {
+  const_tensor_sharing_ = enable;
+  return MaceStatus::MACE_SUCCESS;
+}
+
 MaceStatus MaceEngineCfgImpl::SetHexagonToUnsignedPD() {
   bool ret = false;
 #ifdef MACE_ENABLE_HEXAGON
@@ -191,6 +264,62 @@ MaceStatus MaceEngineCfgImpl::SetAPUHints(
   return ret ? MaceStatus::MACE_SUCCESS : MaceStatus::MACE_RUNTIME_ERROR;
 }
 
+MaceStatus MaceEngineCfgImpl::SetPipelineExecution(bool enable,
+                                                  int queue_capacity) {
+  if (queue_capacity <= 0) {
+    LOG(ERROR) << "Pipeline queue capacity should > 0, got " << queue_capacity;
+    return MaceStatus::MACE_INVALID_ARGS;
+  }
+  pipeline_enabled_ = enable;
+  pipeline_queue_capacity_ = queue_capacity;
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus MaceEngineCfgImpl::SetInitCachePath(const std::string &path) {
+  init_cache_path_ = path;
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus MaceEngineCfgImpl::SetCPUTuningParameterPath(
+    const std::string &path) {
+  cpu_tuning_parameter_path_ = path;
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus MaceEngineCfgImpl::SetCPUMixedPrecision(
+    IDataType data_type,
+    const std::map<std::string, float> &sensitivities,
+    float tolerance) {
+  if (data_type != IDT_FLOAT && data_type != IDT_FLOAT16 &&
+      data_type != IDT_BFLOAT16) {
+    return MaceStatus(MaceStatus::MACE_INVALID_ARGS,
+                      "unsupported mixed precision data type");
+  }
+  cpu_mixed_precision_data_type_ = data_type;
+  op_precision_sensitivities_ = sensitivities;
+  op_precision_tolerance_ = tolerance;
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus MaceEngineCfgImpl::AddCheckpoint(const std::string &tensor_name,
+                                            CheckpointPredicate predicate) {
+  if (tensor_name.empty()) {
+    return MaceStatus(MaceStatus::MACE_INVALID_ARGS,
+                      "checkpoint tensor name is empty");
+  }
+  checkpoints_[tensor_name] = predicate;
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus MaceEngineCfgImpl::SetCheckpointLatencyBudget(int64_t budget_us) {
+  if (budget_us < 0) {
+    return MaceStatus(MaceStatus::MACE_INVALID_ARGS,
+                      "checkpoint latency budget is negative");
+  }
+  checkpoint_latency_budget_ = budget_us;
+  return MaceStatus::MACE_SUCCESS;
+}
+
 MaceEngineConfig::MaceEngineConfig() : impl_(new MaceEngineCfgImpl()) {}
 
 MaceEngineConfig::~MaceEngineConfig() = default;
@@ -222,6 +351,18 @@ MaceStatus MaceEngineConfig::SetCPUThreadPolicy(
   return impl_->SetCPUThreadPolicy(num_threads_hint, policy);
 }
 
+MaceStatus MaceEngineConfig::SetCPUNumaNode(int node) {
+  return impl_->SetCPUNumaNode(node);
+}
+
+MaceStatus MaceEngineConfig::SetCPUHugePagePolicy(CPUHugePagePolicy policy) {
+  return impl_->SetCPUHugePagePolicy(policy);
+}
+
+MaceStatus MaceEngineConfig::SetConstTensorSharing(bool enable) {
+  return impl_->SetConstTensorSharing(enable);
+}
+
 MaceStatus MaceEngineConfig::SetHexagonToUnsignedPD() {
   return impl_->SetHexagonToUnsignedPD();
 }
@@ -251,4 +392,34 @@ MaceStatus MaceEngineConfig::SetAPUHints(
   return impl_->SetAPUHints(boost_hint, preference_hint);
 }
 
+MaceStatus MaceEngineConfig::SetPipelineExecution(bool enable,
+                                                 int queue_capacity) {
+  return impl_->SetPipelineExecution(enable, queue_capacity);
+}
+
+MaceStatus MaceEngineConfig::SetInitCachePath(const std::string &path) {
+  return impl_->SetInitCachePath(path);
+}
+
+MaceStatus MaceEngineConfig::SetCPUTuningParameterPath(
+    const std::string &path) {
+  return impl_->SetCPUTuningParameterPath(path);
+}
+
+MaceStatus MaceEngineConfig::SetCPUMixedPrecision(
+    IDataType data_type,
+    const std::map<std::string, float> &sensitivities,
+    float tolerance) {
+  return impl_->SetCPUMixedPrecision(data_type, sensitivities, tolerance);
+}
+
+MaceStatus MaceEngineConfig::AddCheckpoint(const std::string &tensor_name,
+                                           CheckpointPredicate predicate) {
+  return impl_->AddCheckpoint(tensor_name, predicate);
+}
+
+MaceStatus MaceEngineConfig::SetCheckpointLatencyBudget(int64_t budget_us) {
+  return impl_->SetCheckpointLatencyBudget(budget_us);
+}
+
 }  // namespace mace
@@ -146,6 +146,26 @@ void RegisterActivation(OpRegistry *op_registry) {
                   return {RuntimeType::RT_CPU};
                 }
                 return {RuntimeType::RT_CPU, RuntimeType::RT_OPENCL};
+              })
+          .SetInputsDataFormatSelector(
+              [](OpConditionContext *context) -> std::vector<DataFormat> {
+                auto op = context->operator_def();
+                DataFormat op_data_format = static_cast<DataFormat>(
+                    ProtoArgHelper::GetOptionalArg<OperatorDef, int>(
+                        *op, "data_format",
+                        static_cast<int>(DataFormat::NONE)));
+                std::vector<DataFormat> inputs_data_format(
+                    op->input_size(), op_data_format);
+                // Element-wise activations keep the NCHWc of the input,
+                // PRELU has channel-wise alpha.
+                auto type = ops::StringToActivationType(
+                    ProtoArgHelper::GetOptionalArg<OperatorDef, std::string>(
+                        *op, "activation", "NOOP"));
+                if (type != PRELU &&
+                    context->InputsInDataFormat(DataFormat::NCHWc)) {
+                  inputs_data_format[0] = DataFormat::NCHWc;
+                }
+                return inputs_data_format;
               }));
 }
 
@@ -12,18 +12,120 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#if defined(MACE_ENABLE_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
 #include <algorithm>
 #include <functional>
 #include <limits>
 #include <memory>
+#include <numeric>
+#include <utility>
 #include <vector>
 
 #include "mace/core/ops/operator.h"
 #include "mace/core/registry/ops_registry.h"
+#include "mace/ops/common/top_k.h"
 
 namespace mace {
 namespace ops {
 
+namespace {
+constexpr index_t kArgReduceBlockSize = 256;
+
+// The index of the last max value.
+template<typename T>
+index_t ArgMaxOfRow(const T *input, const index_t size) {
+  index_t idx = 0;
+  T max_value = input[0];
+  for (index_t i = 1; i < size; ++i) {
+    if (input[i] >= max_value) {
+      max_value = input[i];
+      idx = i;
+    }
+  }
+  return idx;
+}
+
+// The index of the first min value.
+template<typename T>
+index_t ArgMinOfRow(const T *input, const index_t size) {
+  index_t idx = 0;
+  T min_value = input[0];
+  for (index_t i = 1; i < size; ++i) {
+    if (input[i] < min_value) {
+      min_value = input[i];
+      idx = i;
+    }
+  }
+  return idx;
+}
+
+// Find the max or min value with SIMD first, then search for its index.
+inline float ReduceMaxOrMin(const float *input, const index_t size,
+                            const bool is_max) {
+  float result = input[0];
+  index_t i = 0;
+#if defined(MACE_ENABLE_NEON)
+  if (size >= 4) {
+    float32x4_t vresult = vld1q_f32(input);
+    for (i = 4; i + 3 < size; i += 4) {
+      float32x4_t v = vld1q_f32(input + i);
+      vresult = is_max ? vmaxq_f32(vresult, v) : vminq_f32(vresult, v);
+    }
+    float32x2_t vhalf = is_max
+        ? vpmax_f32(vget_low_f32(vresult), vget_high_f32(vresult))
+        : vpmin_f32(vget_low_f32(vresult), vget_high_f32(vresult));
+    vhalf = is_max ? vpmax_f32(vhalf, vhalf) : vpmin_f32(vhalf, vhalf);
+    result = vget_lane_f32(vhalf, 0);
+  }
+#elif defined(__SSE__)
+  if (size >= 4) {
+    __m128 vresult = _mm_loadu_ps(input);
+    for (i = 4; i + 3 < size; i += 4) {
+      __m128 v = _mm_loadu_ps(input + i);
+      vresult = is_max ? _mm_max_ps(vresult, v) : _mm_min_ps(vresult, v);
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, vresult);
+    result = is_max ? std::max(std::max(lanes[0], lanes[1]),
+                               std::max(lanes[2], lanes[3]))
+                    : std::min(std::min(lanes[0], lanes[1]),
+                               std::min(lanes[2], lanes[3]));
+  }
+#endif
+  for (; i < size; ++i) {
+    result = is_max ? std::max(result, input[i]) : std::min(result, input[i]);
+  }
+  return result;
+}
+
+template<>
+index_t ArgMaxOfRow<float>(const float *input, const index_t size) {
+  const float max_value = ReduceMaxOrMin(input, size, true);
+  for (index_t i = size - 1; i > 0; --i) {
+    if (input[i] == max_value) {
+      return i;
+    }
+  }
+  return 0;
+}
+
+template<>
+index_t ArgMinOfRow<float>(const float *input, const index_t size) {
+  const float min_value = ReduceMaxOrMin(input, size, false);
+  for (index_t i = 0; i < size; ++i) {
+    if (input[i] == min_value) {
+      return i;
+    }
+  }
+  return 0;
+}
+}  // namespace
+
 template<RuntimeType D, class T>
 class ArgMaxOp : public Operation {
  public:
@@ -40,81 +142,166 @@ class ArgMaxOp : public Operation {
         keep_dims_(Operation::GetOptionalArg<bool>("keepdims", true)) {}
 
   MaceStatus Run(OpContext *context) override {
-    MACE_UNUSED(context);
     const Tensor *input = this->Input(0);
     Tensor *output = this->Output(0);
 
     const auto input_dim_size = input->dim_size();
     MACE_CHECK(input_dim_size > 0, "ArgMax input should not be a scalar");
     const auto axis_value = GetAxisValue(input_dim_size);
+    MACE_CHECK(axis_value >= 0 && axis_value < input_dim_size,
+               "axis is out of bound: ", axis_value);
     MACE_RETURN_IF_ERROR(ResizeOutputTensor(output, input, axis_value));
 
-    auto input_data = input->data<T>();
-
-    int axis_dim = 0;
-    int axis_dist = 0;
     const auto &input_shape = input->shape();
-    if (axis_value != 0) {
+    index_t outer_size = 0;
+    index_t axis_dim = 0;
+    index_t inner_size = 0;
+    if (has_axis_) {
+      outer_size = std::accumulate(input_shape.begin(),
+                                   input_shape.begin() + axis_value,
+                                   1, std::multiplies<index_t>());
       axis_dim = input->dim(axis_value);
-      axis_dist = std::accumulate(input_shape.begin() + axis_value,
-                                  input_shape.end(),
-                                  1, std::multiplies<int>()) / axis_dim;
+      inner_size = std::accumulate(input_shape.begin() + axis_value + 1,
+                                   input_shape.end(),
+                                   1, std::multiplies<index_t>());
     } else {
-      axis_dim = input->dim(0);
-      axis_dist = 1;
+      // Caffe without axis selects over each batch.
+      outer_size = input->dim(0);
+      axis_dim = input->size() / outer_size;
+      inner_size = 1;
     }
-    const auto output_loop = input->size() / axis_dim;
-
-    for (int i = 0; i < output_loop; i += 1) {
-      std::vector<std::pair<T, int>> input_data_vector(axis_dim);
-      const auto axis_base = i / axis_dist * axis_dim;
-      const auto axis_offset = i % axis_dist;
-      for (int d = 0; d < axis_dim; ++d) {
-        const auto input_idx = (axis_base + d) * axis_dist + axis_offset;
-        input_data_vector[d] = std::make_pair(input_data[input_idx], d);
-      }
+    MACE_CHECK(top_k_ > 0 && top_k_ <= axis_dim,
+               "top_k should be in range [1, ", axis_dim, "]");
 
-      if (argmin_) {
-        std::partial_sort(input_data_vector.begin(),
-                          input_data_vector.begin() + top_k_,
-                          input_data_vector.end(),
-                          std::less<std::pair<T, int>>());
+    const T *input_data = input->data<T>();
+    utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+    if (top_k_ == 1 && has_axis_) {
+      if (out_val_) {
+        ArgReduce(&thread_pool, input_data, outer_size, axis_dim, inner_size,
+                  nullptr, output->mutable_data<T>());
       } else {
-        std::partial_sort(input_data_vector.begin(),
-                          input_data_vector.begin() + top_k_,
-                          input_data_vector.end(),
-                          std::greater<std::pair<T, int>>());
+        ArgReduce(&thread_pool, input_data, outer_size, axis_dim, inner_size,
+                  output->mutable_data<int32_t>(), nullptr);
       }
+      return MaceStatus::MACE_SUCCESS;
+    }
 
-      if (!out_val_) {
-        auto output_data = output->mutable_data<int32_t>();
-        const auto top_k_base = i / axis_dist * top_k_;
-        for (int j = 0; j < top_k_; ++j) {
-          const auto output_idx = (top_k_base + j) * axis_dist + axis_offset;
-          output_data[output_idx] = input_data_vector[j].second;
-        }
-      } else if (has_axis_) {  // Produces max/min value per axis
-        auto output_data = output->mutable_data<T>();
-        const auto top_k_base = i / axis_dist * top_k_;
-        for (int j = 0; j < top_k_; ++j) {
-          auto output_idx = (top_k_base + j) * axis_dist + axis_offset;
-          output_data[output_idx] = input_data_vector[j].first;
+    const index_t top_k = top_k_;
+    const bool argmin = argmin_;
+    const bool out_val = out_val_;
+    const bool has_axis = has_axis_;
+    int32_t *output_index =
+        out_val_ ? nullptr : output->mutable_data<int32_t>();
+    T *output_value = out_val_ ? output->mutable_data<T>() : nullptr;
+    thread_pool.Compute1D([=](index_t start, index_t end, index_t step) {
+      std::vector<std::pair<T, int>> selected;
+      for (index_t i = start; i < end; i += step) {
+        const index_t outer_idx = i / inner_size;
+        const index_t inner_idx = i % inner_size;
+        const T *in = input_data + outer_idx * axis_dim * inner_size
+            + inner_idx;
+        if (argmin) {
+          common::SelectTopK(in, axis_dim, inner_size, top_k,
+                             std::less<std::pair<T, int>>(), &selected);
+        } else {
+          common::SelectTopK(in, axis_dim, inner_size, top_k,
+                             std::greater<std::pair<T, int>>(), &selected);
         }
-      } else {  // Produces max_ind and max/min value
-        auto output_data = output->mutable_data<T>();
-        const auto top_k_base_pos = 2 * i * top_k_;
-        const auto top_k_base_value = top_k_base_pos + top_k_;
-        for (int j = 0; j < top_k_; ++j) {
-          output_data[top_k_base_pos + j] = input_data_vector[j].second;
-          output_data[top_k_base_value + j] = input_data_vector[j].first;
+
+        const index_t top_k_base = outer_idx * top_k;
+        if (!out_val) {
+          for (index_t j = 0; j < top_k; ++j) {
+            const index_t output_idx =
+                (top_k_base + j) * inner_size + inner_idx;
+            output_index[output_idx] = selected[j].second;
+          }
+        } else if (has_axis) {  // Produces max/min value per axis
+          for (index_t j = 0; j < top_k; ++j) {
+            const index_t output_idx =
+                (top_k_base + j) * inner_size + inner_idx;
+            output_value[output_idx] = selected[j].first;
+          }
+        } else {  // Produces max_ind and max/min value
+          const index_t top_k_base_pos = 2 * i * top_k;
+          const index_t top_k_base_value = top_k_base_pos + top_k;
+          for (index_t j = 0; j < top_k; ++j) {
+            output_value[top_k_base_pos + j] = selected[j].second;
+            output_value[top_k_base_value + j] = selected[j].first;
+          }
         }
       }
-    }
+    }, 0, outer_size * inner_size, 1, 0, static_cast<int>(axis_dim));
 
     return MaceStatus::MACE_SUCCESS;
   }
 
  private:
+  // Find the max (or min) value and its index along the axis. Ties resolve
+  // like the sort of (value, index) pairs: the last max or the first min.
+  void ArgReduce(utils::ThreadPool *thread_pool,
+                 const T *input,
+                 const index_t outer_size,
+                 const index_t axis_dim,
+                 const index_t inner_size,
+                 int32_t *output_index,
+                 T *output_value) {
+    const bool argmin = argmin_;
+    if (inner_size == 1) {
+      thread_pool->Compute1D([=](index_t start, index_t end, index_t step) {
+        for (index_t i = start; i < end; i += step) {
+          const T *in = input + i * axis_dim;
+          const index_t idx = argmin ? ArgMinOfRow(in, axis_dim)
+                                     : ArgMaxOfRow(in, axis_dim);
+          if (output_index != nullptr) {
+            output_index[i] = static_cast<int32_t>(idx);
+          } else {
+            output_value[i] = in[idx];
+          }
+        }
+      }, 0, outer_size, 1, 0, static_cast<int>(axis_dim));
+      return;
+    }
+
+    // Reduce rows of the axis into a block of running results, so that the
+    // inner loop reads contiguous memory.
+    const index_t block_size = kArgReduceBlockSize;
+    thread_pool->Compute2D([=](index_t start0, index_t end0, index_t step0,
+                               index_t start1, index_t end1, index_t step1) {
+      T best[kArgReduceBlockSize];
+      int32_t best_idx[kArgReduceBlockSize];
+      for (index_t o = start0; o < end0; o += step0) {
+        const T *in = input + o * axis_dim * inner_size;
+        for (index_t b = start1; b < end1; b += step1) {
+          const index_t size = std::min(block_size, inner_size - b);
+          for (index_t j = 0; j < size; ++j) {
+            best[j] = in[b + j];
+            best_idx[j] = 0;
+          }
+          for (index_t d = 1; d < axis_dim; ++d) {
+            const T *row = in + d * inner_size + b;
+            for (index_t j = 0; j < size; ++j) {
+              const bool better = argmin ? row[j] < best[j]
+                                         : row[j] >= best[j];
+              if (better) {
+                best[j] = row[j];
+                best_idx[j] = static_cast<int32_t>(d);
+              }
+            }
+          }
+          const index_t out_offset = o * inner_size + b;
+          for (index_t j = 0; j < size; ++j) {
+            if (output_index != nullptr) {
+              output_index[out_offset + j] = best_idx[j];
+            } else {
+              output_value[out_offset + j] = best[j];
+            }
+          }
+        }
+      }
+    }, 0, outer_size, 1, 0, inner_size, block_size,
+       0, 0, static_cast<int>(axis_dim * block_size));
+  }
+
   int GetAxisValue(const index_t input_dim_size) {
     const Tensor *axis = this->InputSize() == 2 ? this->Input(1) : nullptr;
     int axis_value = 0;
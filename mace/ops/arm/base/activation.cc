@@ -17,6 +17,7 @@
 #include <algorithm>
 
 #include "mace/ops/arm/base/common_neon.h"
+#include "mace/ops/common/transcendental.h"
 
 namespace mace {
 namespace ops {
@@ -234,6 +235,36 @@ void Activation<T>::ActivateSigmoid(utils::ThreadPool *thread_pool,
       0, input_size, 1);
 }
 
+template<>
+void Activation<float>::ActivateTanh(utils::ThreadPool *thread_pool,
+                                     const Tensor *input,
+                                     Tensor *output) {
+  const float *input_data = input->data<float>();
+  float *output_data = output->mutable_data<float>();
+
+  thread_pool->Compute1D(
+      [=](index_t start, index_t end, index_t step) {
+        MACE_UNUSED(step);
+        VectorTanh(input_data + start, output_data + start, end - start);
+      },
+      0, input->size(), 1);
+}
+
+template<>
+void Activation<float>::ActivateSigmoid(utils::ThreadPool *thread_pool,
+                                        const Tensor *input,
+                                        Tensor *output) {
+  const float *input_data = input->data<float>();
+  float *output_data = output->mutable_data<float>();
+
+  thread_pool->Compute1D(
+      [=](index_t start, index_t end, index_t step) {
+        MACE_UNUSED(step);
+        VectorSigmoid(input_data + start, output_data + start, end - start);
+      },
+      0, input->size(), 1);
+}
+
 template<typename T>
 void Activation<T>::ActivateHardSigmoid(utils::ThreadPool *thread_pool,
                                     const Tensor *input,
@@ -17,6 +17,8 @@
 #include <memory>
 #include <vector>
 
+#include "mace/ops/common/deconv_2d.h"
+
 namespace mace {
 namespace ops {
 namespace arm {
@@ -53,52 +55,14 @@ MaceStatus Deconv2dGeneral<T>::Compute(const OpContext *context,
   const index_t out_width = out_shape[3];
   const index_t in_height = in_shape[2];
   const index_t in_width = in_shape[3];
-  const index_t out_img_size = out_height * out_width;
-  const index_t in_img_size = in_height * in_width;
-  const index_t kernel_h = filter->dim(2);
-  const index_t kernel_w = filter->dim(3);
-
-  const int kernel_size = static_cast<int>(kernel_h * kernel_w);
-  std::vector<index_t> index_map(kernel_size, 0);
-  for (index_t i = 0; i < kernel_h; ++i) {
-    for (index_t j = 0; j < kernel_w; ++j) {
-      index_map[i * kernel_w + j] = i * out_width + j;
-    }
-  }
-
   const index_t batch = in_shape[0];
   const index_t out_channels = out_shape[1];
   const index_t in_channels = in_shape[1];
 
-  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
-
-  thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
-                            index_t start1, index_t end1, index_t step1) {
-    for (index_t b = start0; b < end0; b += step0) {
-      for (index_t oc = start1; oc < end1; oc += step1) {
-        T *out_base =
-            padded_out_data + (b * out_channels + oc) * out_img_size;
-        for (index_t i = 0; i < in_height; ++i) {
-          for (index_t j = 0; j < in_width; ++j) {
-            const index_t out_offset =
-                i * strides_[0] * out_width + j * strides_[1];
-            for (int ic = 0; ic < in_channels; ++ic) {
-              const index_t input_idx =
-                  (b * in_channels + ic) * in_img_size + i * in_width + j;
-              const T val = input_data[input_idx];
-              const index_t kernel_offset =
-                  (oc * in_channels + ic) * kernel_size;
-              for (int k = 0; k < kernel_size; ++k) {
-                const index_t out_idx = out_offset + index_map[k];
-                const index_t kernel_idx = kernel_offset + k;
-                out_base[out_idx] += val * filter_data[kernel_idx];
-              }
-            }
-          }
-        }
-      }
-    }
-  }, 0, batch, 1, 0, out_channels, 1);
+  Deconv2dGemmCol2im(context, input_data, filter_data, batch, in_channels,
+                     in_height, in_width, out_channels, out_height, out_width,
+                     filter->dim(2), filter->dim(3), strides_[0], strides_[1],
+                     1, padded_out_data);
 
   UnPadOutput(*out_tensor, out_pad_size, output);
 
@@ -17,8 +17,6 @@
 
 #include "mace/ops/arm/base/deconv_2d.h"
 
-// TODO(liutuo): optimize it
-
 namespace mace {
 namespace ops {
 namespace arm {
@@ -14,6 +14,8 @@
 
 #include "mace/ops/arm/base/depthwise_deconv_2d_general.h"
 
+#include "mace/ops/common/deconv_2d.h"
+
 namespace mace {
 namespace ops {
 namespace arm {
@@ -140,56 +142,10 @@ MaceStatus GroupDeconv2dGeneral<T>::Compute(const OpContext *context,
   MACE_CHECK(in_channels % group_ == 0 && out_channels % group_ == 0,
              "invalid input/output channel and group.");
 
-  const index_t out_img_size = out_height * out_width;
-  const index_t in_img_size = in_height * in_width;
-  const index_t kernel_h = filter->dim(2);
-  const index_t kernel_w = filter->dim(3);
-
-  const int kernel_size = kernel_h * kernel_w;
-  std::vector<int> index_map(kernel_size, 0);
-  for (int i = 0; i < kernel_h; ++i) {
-    for (int j = 0; j < kernel_w; ++j) {
-      index_map[i * kernel_w + j] = i * out_width + j;
-    }
-  }
-
-  const int in_channels_g = in_channels / group_;
-  const int out_channels_g = out_channels / group_;
-
-  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
-
-  thread_pool.Compute3D([=](index_t start0, index_t end0, index_t step0,
-                            index_t start1, index_t end1, index_t step1,
-                            index_t start2, index_t end2, index_t step2) {
-    for (index_t b = start0; b < end0; b += step0) {
-      for (index_t g = start1; g < end1; g += step1) {
-        for (index_t p = start2; p < end2; p += step2) {
-          const index_t out_base =
-              ((b * group_ + g) * out_channels_g + p) * out_img_size;
-          for (index_t i = 0; i < in_height; ++i) {
-            for (index_t j = 0; j < in_width; ++j) {
-              const index_t out_offset =
-                  i * strides_[0] * out_width + j * strides_[1];
-              for (int q = 0; q < in_channels_g; ++q) {
-                const index_t in_base =
-                    ((b * group_ + g) * in_channels_g + q) * in_img_size;
-                const index_t in_offset =
-                    in_base + i * in_width + j;
-                const float val = input_data[in_offset];
-                const index_t k_offset =
-                    ((p * group_ + g) * in_channels_g + q) * kernel_size;
-                for (int k = 0; k < kernel_size; ++k) {
-                  const index_t out_idx = out_base + out_offset + index_map[k];
-                  const float w = filter_data[k_offset + k];
-                  padded_out_data[out_idx] += val * w;
-                }
-              }
-            }
-          }
-        }
-      }
-    }
-  }, 0, batch, 1, 0, group_, 1, 0, out_channels_g, 1);
+  Deconv2dGemmCol2im(context, input_data, filter_data, batch, in_channels,
+                     in_height, in_width, out_channels, out_height, out_width,
+                     filter->dim(2), filter->dim(3), strides_[0], strides_[1],
+                     group_, padded_out_data);
 
   UnPadOutput(*out_tensor, out_pad_size, output);
 
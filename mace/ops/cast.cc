@@ -14,6 +14,7 @@
 
 #include "mace/core/ops/operator.h"
 #include "mace/core/registry/ops_registry.h"
+#include "mace/utils/transpose.h"
 
 #if defined(MACE_ENABLE_NEON) && defined(__ANDROID__)
 #include <arm_neon.h>
@@ -22,6 +23,40 @@
 namespace mace {
 namespace ops {
 
+namespace {
+template <typename SrcType, typename DstType>
+void CastData(utils::ThreadPool *thread_pool, const SrcType *src,
+              DstType *dst, const index_t size) {
+  MACE_UNUSED(thread_pool);
+  for (index_t i = 0; i < size; ++i) {
+    dst[i] = static_cast<DstType>(src[i]);
+  }
+}
+
+#ifdef MACE_ENABLE_BFLOAT16
+// BFloat16 has several conversion operators, so it is cast through float.
+template <typename DstType>
+void CastData(utils::ThreadPool *thread_pool, const BFloat16 *src,
+              DstType *dst, const index_t size) {
+  MACE_UNUSED(thread_pool);
+  for (index_t i = 0; i < size; ++i) {
+    dst[i] = static_cast<DstType>(static_cast<float>(src[i]));
+  }
+}
+
+// The casts at the precision boundaries of the mixed precision nets.
+void CastData(utils::ThreadPool *thread_pool, const float *src,
+              BFloat16 *dst, const index_t size) {
+  CopyDataBetweenDiffType(thread_pool, src, dst, size);
+}
+
+void CastData(utils::ThreadPool *thread_pool, const BFloat16 *src,
+              float *dst, const index_t size) {
+  CopyDataBetweenDiffType(thread_pool, src, dst, size);
+}
+#endif  // MACE_ENABLE_BFLOAT16
+}  // namespace
+
 template <RuntimeType D, typename SrcType>
 class CastOp : public Operation {
  public:
@@ -29,7 +64,6 @@ class CastOp : public Operation {
       : Operation(context) {}
 
   MaceStatus Run(OpContext *context) override {
-    MACE_UNUSED(context);
     const Tensor *input = this->Input(INPUT);
     Tensor *output = this->Output(OUTPUT);
     MACE_RETURN_IF_ERROR(output->ResizeLike(input))
@@ -37,11 +71,8 @@ class CastOp : public Operation {
     auto dst_dtype = output->dtype();
 
 #define MACE_CAST_COPY \
-    auto output_data = output->mutable_data<T>();                       \
-    auto input_data = input->data<SrcType>();                           \
-    for (index_t i = 0; i < output->size(); ++i) {                      \
-      output_data[i] = static_cast<T>(input_data[i]);                   \
-    }
+    CastData(&context->runtime()->thread_pool(), input->data<SrcType>(), \
+             output->mutable_data<T>(), output->size());
 
     MACE_RUN_WITH_TYPE_ENUM(dst_dtype, MACE_CAST_COPY);
 
@@ -56,6 +87,7 @@ class CastOp : public Operation {
 void RegisterCast(OpRegistry *op_registry) {
   MACE_REGISTER_OP(op_registry, "Cast", CastOp, RuntimeType::RT_CPU, float);
   MACE_REGISTER_OP(op_registry, "Cast", CastOp, RuntimeType::RT_CPU, int32_t);
+  MACE_REGISTER_BF16_OP(op_registry, "Cast", CastOp, RuntimeType::RT_CPU);
 #if defined(MACE_ENABLE_NEON) && defined(__ANDROID__)
   MACE_REGISTER_OP(op_registry, "Cast", CastOp,
                    RuntimeType::RT_CPU, float16_t);
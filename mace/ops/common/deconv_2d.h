@@ -0,0 +1,130 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MACE_OPS_COMMON_DECONV_2D_H_
+#define MACE_OPS_COMMON_DECONV_2D_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "mace/core/ops/op_context.h"
+#include "mace/core/types.h"
+#include "mace/utils/math.h"
+
+namespace mace {
+namespace ops {
+
+// The number of input pixels of a column tile of Deconv2dGemmCol2im.
+constexpr index_t kDeconvColTileSize = 256;
+
+// Transposed convolution of NCHW input as GEMM + col2im. For every output
+// channel, the columns of a tile of input rows are
+//   col[kernel_h * kernel_w, tile] = filter^T * input[in_channels_g, tile],
+// which is then scattered to the output (col2im). The work is split over the
+// output channels and the row tiles; the tiles of one channel are run in two
+// waves (even and odd) when the kernel is larger than the stride, so that the
+// output rows written by the tiles of one wave do not overlap.
+// The filter is [out_channels_g, group, in_channels_g, kernel_h, kernel_w],
+// the output has the padded size and must be cleared before.
+template<typename T>
+void Deconv2dGemmCol2im(const OpContext *context,
+                        const T *input_data,
+                        const T *filter_data,
+                        const index_t batch,
+                        const index_t in_channels,
+                        const index_t in_height,
+                        const index_t in_width,
+                        const index_t out_channels,
+                        const index_t out_height,
+                        const index_t out_width,
+                        const index_t kernel_h,
+                        const index_t kernel_w,
+                        const int stride_h,
+                        const int stride_w,
+                        const int group,
+                        T *output_data) {
+  const index_t in_img_size = in_height * in_width;
+  const index_t out_img_size = out_height * out_width;
+  const index_t kernel_size = kernel_h * kernel_w;
+  const index_t in_channels_g = in_channels / group;
+  const index_t out_channels_g = out_channels / group;
+
+  // The tiles of one wave are disjoint if a tile covers at least
+  // (kernel_h - stride_h) output rows.
+  const index_t min_tile_rows = (kernel_h - 1) / stride_h;
+  const index_t tile_rows = std::min(
+      in_height, std::max(std::max<index_t>(min_tile_rows, 1),
+                          kDeconvColTileSize / in_width));
+  const index_t tiles = RoundUpDiv(in_height, tile_rows);
+  const index_t waves = (kernel_h > stride_h && tiles > 1) ? 2 : 1;
+
+  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+
+  for (index_t wave = 0; wave < waves; ++wave) {
+    thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                              index_t start1, index_t end1, index_t step1) {
+      std::vector<float> col(kernel_size * tile_rows * in_width);
+      for (index_t n = start0; n < end0; n += step0) {
+        const index_t b = n / out_channels;
+        const index_t oc = n % out_channels;
+        const index_t g = oc / out_channels_g;
+        const index_t p = oc % out_channels_g;
+        const T *in_base =
+            input_data + (b * in_channels + g * in_channels_g) * in_img_size;
+        const T *filter_base =
+            filter_data + (p * group + g) * in_channels_g * kernel_size;
+        T *out_base = output_data + n * out_img_size;
+
+        for (index_t t = start1; t < end1; t += step1) {
+          const index_t h_begin = t * tile_rows;
+          const index_t h_end = std::min(h_begin + tile_rows, in_height);
+          const index_t cols = (h_end - h_begin) * in_width;
+          std::fill_n(col.begin(), kernel_size * cols, 0.f);
+
+          // GEMM as rank-1 updates, one input channel at a time.
+          for (index_t q = 0; q < in_channels_g; ++q) {
+            const T *in_row = in_base + q * in_img_size + h_begin * in_width;
+            const T *w = filter_base + q * kernel_size;
+            for (index_t k = 0; k < kernel_size; ++k) {
+              const float wk = w[k];
+              float *col_row = col.data() + k * cols;
+              for (index_t c = 0; c < cols; ++c) {
+                col_row[c] += wk * static_cast<float>(in_row[c]);
+              }
+            }
+          }
+
+          // col2im
+          for (index_t kh = 0; kh < kernel_h; ++kh) {
+            for (index_t kw = 0; kw < kernel_w; ++kw) {
+              const float *col_row = col.data() + (kh * kernel_w + kw) * cols;
+              for (index_t h = h_begin; h < h_end; ++h) {
+                const float *src = col_row + (h - h_begin) * in_width;
+                T *out_row = out_base + (h * stride_h + kh) * out_width + kw;
+                for (index_t w = 0; w < in_width; ++w) {
+                  out_row[w * stride_w] += src[w];
+                }
+              }
+            }
+          }
+        }
+      }
+    }, 0, batch * out_channels, 1, wave, tiles, waves);
+  }
+}
+
+}  // namespace ops
+}  // namespace mace
+
+#endif  // MACE_OPS_COMMON_DECONV_2D_H_
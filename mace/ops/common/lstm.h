@@ -19,9 +19,11 @@
 #ifndef MACE_OPS_COMMON_LSTM_H_
 #define MACE_OPS_COMMON_LSTM_H_
 
+#include <algorithm>
+
 #include "mace/core/ops/op_context.h"
 #include "mace/core/types.h"
-#include "mace/utils/math.h"
+#include "mace/ops/common/transcendental.h"
 
 namespace mace {
 namespace ops {
@@ -46,38 +48,61 @@ void LSTMNonlinearKernel(const OpContext *context,
 
   utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
 
+  // The cells are computed in blocks with the vectorized sigmoid and tanh.
+  const index_t kBlock = 64;
   thread_pool.Compute1D([=](index_t start, index_t end, index_t step) {
-    if (prev_data == nullptr) {
-      for (index_t c = start; c < end; c += step) {
-        float i_part = input_data[c];
-        float c_part = input_data[c + 2 * cell_dim];
-        float o_part = input_data[c + 3 * cell_dim];
-        float w_oc = params_data[c + params_stride * 2];
-        float i_t = ScalarSigmoid(i_part);
-        float c_t = i_t * i_scale * std::tanh(c_part);
-        float o_t = ScalarSigmoid(o_part + w_oc * c_t);
-        float m_t = o_t * o_scale * std::tanh(c_t);
-        output_cell[c] = c_t;
-        output_data[c] = m_t;
+    MACE_UNUSED(step);
+    float i_t[kBlock];
+    float f_t[kBlock];
+    float c_t[kBlock];
+    float o_t[kBlock];
+    float tanh_t[kBlock];
+    for (index_t b = start; b < end; b += kBlock) {
+      const index_t len = std::min(kBlock, end - b);
+      const T *i_part = input_data + b;
+      const T *f_part = i_part + cell_dim;
+      const T *c_part = i_part + 2 * cell_dim;
+      const T *o_part = i_part + 3 * cell_dim;
+      const T *w_ic = params_data + b;
+      const T *w_fc = w_ic + params_stride;
+      const T *w_oc = w_ic + params_stride * 2;
+      const T *c_prev = prev_data == nullptr ? nullptr : prev_data + b;
+
+      for (index_t j = 0; j < len; ++j) {
+        tanh_t[j] = c_part[j];
+      }
+      if (c_prev == nullptr) {
+        for (index_t j = 0; j < len; ++j) {
+          i_t[j] = i_part[j];
+        }
+      } else {
+        for (index_t j = 0; j < len; ++j) {
+          const float c = c_prev[j];
+          i_t[j] = i_part[j] + w_ic[j] * c;
+          f_t[j] = f_part[j] + w_fc[j] * c;
+        }
+        VectorSigmoid(f_t, f_t, len);
+      }
+      VectorSigmoid(i_t, i_t, len);
+      VectorTanh(tanh_t, tanh_t, len);
+
+      for (index_t j = 0; j < len; ++j) {
+        c_t[j] = i_t[j] * i_scale * tanh_t[j];
+      }
+      if (c_prev != nullptr) {
+        for (index_t j = 0; j < len; ++j) {
+          c_t[j] += f_t[j] * f_scale * c_prev[j];
+        }
       }
-    } else {
-      for (index_t c = start; c < end; c += step) {
-        float i_part = input_data[c];
-        float f_part = input_data[c + cell_dim];
-        float c_part = input_data[c + 2 * cell_dim];
-        float o_part = input_data[c + 3 * cell_dim];
-        float c_prev = prev_data[c];
-        float w_ic = params_data[c];
-        float w_fc = params_data[c + params_stride];
-        float w_oc = params_data[c + params_stride * 2];
-        float i_t = ScalarSigmoid(i_part + w_ic * c_prev);
-        float f_t = ScalarSigmoid(f_part + w_fc * c_prev);
-        float c_t =
-            f_t * f_scale * c_prev + i_t * i_scale * std::tanh(c_part);
-        float o_t = ScalarSigmoid(o_part + w_oc * c_t);
-        float m_t = o_t * o_scale * std::tanh(c_t);
-        output_cell[c] = c_t;
-        output_data[c] = m_t;
+      for (index_t j = 0; j < len; ++j) {
+        o_t[j] = o_part[j] + w_oc[j] * c_t[j];
+      }
+      VectorSigmoid(o_t, o_t, len);
+      VectorTanh(c_t, tanh_t, len);
+
+      for (index_t j = 0; j < len; ++j) {
+        output_cell[b + j] = c_t[j];
+        output_data[b + j] = o_t[j] * o_scale * tanh_t[j];
       }
     }
   }, 0, cell_dim, 1);
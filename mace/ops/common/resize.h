@@ -0,0 +1,219 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef MACE_OPS_COMMON_RESIZE_H_
+#define MACE_OPS_COMMON_RESIZE_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "mace/core/ops/op_context.h"
+#include "mace/core/types.h"
+#include "mace/ops/common/simd.h"
+#include "mace/utils/logging.h"
+
+namespace mace {
+namespace ops {
+
+// The most taps of an axis, 4 for bicubic.
+const index_t kMaxResizeTaps = 4;
+
+// The input taps of the output positions along one axis of a separable
+// resize: output i is the sum of the inputs indices[i * taps + k] weighted
+// by weights[i * taps + k] for k < taps.
+struct ResizeAxisTable {
+  index_t taps;
+  std::vector<index_t> indices;
+  std::vector<float> weights;
+
+  void Reset(const index_t out_size, const index_t num_taps) {
+    taps = num_taps;
+    indices.resize(out_size * num_taps);
+    weights.resize(out_size * num_taps);
+  }
+};
+
+// The tables of both axes and the image sizes they are built for. An op
+// keeps them to reuse while the sizes don't change.
+struct ResizeTables {
+  index_t in_height;
+  index_t in_width;
+  index_t out_height;
+  index_t out_width;
+  ResizeAxisTable ys;
+  ResizeAxisTable xs;
+
+  ResizeTables()
+      : in_height(-1), in_width(-1), out_height(-1), out_width(-1) {}
+
+  // Returns true if the tables are not built for the sizes, and records the
+  // sizes for the tables the caller builds then.
+  bool NeedBuild(const index_t in_h, const index_t in_w,
+                 const index_t out_h, const index_t out_w) {
+    if (in_h == in_height && in_w == in_width && out_h == out_height &&
+        out_w == out_width) {
+      return false;
+    }
+    in_height = in_h;
+    in_width = in_w;
+    out_height = out_h;
+    out_width = out_w;
+    return true;
+  }
+};
+
+template<int Taps, typename T>
+inline void ResizeHorizontalTaps(const T *src,
+                                 const index_t *indices,
+                                 const float *weights,
+                                 const index_t size,
+                                 float *dst) {
+  for (index_t x = 0; x < size; ++x) {
+    float sum = weights[0] * static_cast<float>(src[indices[0]]);
+    for (int k = 1; k < Taps; ++k) {
+      sum += weights[k] * static_cast<float>(src[indices[k]]);
+    }
+    dst[x] = sum;
+    indices += Taps;
+    weights += Taps;
+  }
+}
+
+// Resize an input row along the width into float.
+template<typename T>
+inline void ResizeHorizontal(const T *src,
+                             const ResizeAxisTable &xs,
+                             const index_t size,
+                             float *dst) {
+  const index_t *indices = xs.indices.data();
+  const float *weights = xs.weights.data();
+  switch (xs.taps) {
+    case 1:
+      ResizeHorizontalTaps<1>(src, indices, weights, size, dst);
+      break;
+    case 2:
+      ResizeHorizontalTaps<2>(src, indices, weights, size, dst);
+      break;
+    case 4:
+      ResizeHorizontalTaps<4>(src, indices, weights, size, dst);
+      break;
+    default:
+      LOG(FATAL) << "Unsupported resize taps: " << xs.taps;
+  }
+}
+
+// dst[x] = sum of weights[k] * rows[k][x] for k < taps.
+template<typename T>
+inline void ResizeVertical(const float *const *rows,
+                           const float *weights,
+                           const index_t taps,
+                           const index_t size,
+                           T *dst) {
+  for (index_t x = 0; x < size; ++x) {
+    float sum = weights[0] * rows[0][x];
+    for (index_t k = 1; k < taps; ++k) {
+      sum += weights[k] * rows[k][x];
+    }
+    dst[x] = static_cast<T>(sum);
+  }
+}
+
+inline void ResizeVertical(const float *const *rows,
+                           const float *weights,
+                           const index_t taps,
+                           const index_t size,
+                           float *dst) {
+  VecF vec_weights[kMaxResizeTaps];
+  for (index_t k = 0; k < taps; ++k) {
+    vec_weights[k] = VecSet1(weights[k]);
+  }
+  index_t x = 0;
+  for (; x + kVecFLanes <= size; x += kVecFLanes) {
+    VecF sum = VecMul(vec_weights[0], VecLoad(rows[0] + x));
+    for (index_t k = 1; k < taps; ++k) {
+      sum = VecFma(sum, vec_weights[k], VecLoad(rows[k] + x));
+    }
+    VecStore(dst + x, sum);
+  }
+  for (; x < size; ++x) {
+    float sum = weights[0] * rows[0][x];
+    for (index_t k = 1; k < taps; ++k) {
+      sum += weights[k] * rows[k][x];
+    }
+    dst[x] = sum;
+  }
+}
+
+// Resize the NCHW images, seen as planes of [in_height, in_width], by the
+// tables: the input rows are resized horizontally into float, then the
+// output rows are blended from them vertically with SIMD. The output rows
+// are split among the threads, and a thread keeps the input rows its last
+// output row read, which the next output rows mostly read again.
+template<typename T>
+inline void ResizeImageSeparable(const OpContext *context,
+                                 const T *input,
+                                 const index_t planes,
+                                 const ResizeTables &tables,
+                                 T *output) {
+  const index_t in_height = tables.in_height;
+  const index_t in_width = tables.in_width;
+  const index_t out_height = tables.out_height;
+  const index_t out_width = tables.out_width;
+  const ResizeAxisTable &ys = tables.ys;
+  const ResizeAxisTable &xs = tables.xs;
+  const index_t taps = ys.taps;
+  MACE_CHECK(taps <= kMaxResizeTaps, "Unsupported resize taps: ", taps);
+
+  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+  thread_pool.Compute2D([=, &ys, &xs](index_t start0, index_t end0,
+                                      index_t step0, index_t start1,
+                                      index_t end1, index_t step1) {
+    std::vector<float> row_buffer(taps * out_width);
+    std::vector<index_t> cached_rows(taps);
+    const float *rows[kMaxResizeTaps];
+    for (index_t p = start0; p < end0; p += step0) {
+      const T *in_plane = input + p * in_height * in_width;
+      T *out_plane = output + p * out_height * out_width;
+      std::fill(cached_rows.begin(), cached_rows.end(), -1);
+      for (index_t y = start1; y < end1; y += step1) {
+        const index_t *row_indices = ys.indices.data() + y * taps;
+        for (index_t k = 0; k < taps; ++k) {
+          const index_t in_y = row_indices[k];
+          index_t slot = std::find(cached_rows.begin(), cached_rows.end(),
+                                   in_y) - cached_rows.begin();
+          if (slot == taps) {
+            // Replace a row that this output row does not read.
+            slot = 0;
+            while (std::find(row_indices, row_indices + taps,
+                             cached_rows[slot]) != row_indices + taps) {
+              ++slot;
+            }
+            cached_rows[slot] = in_y;
+            ResizeHorizontal(in_plane + in_y * in_width, xs, out_width,
+                             row_buffer.data() + slot * out_width);
+          }
+          rows[k] = row_buffer.data() + slot * out_width;
+        }
+        ResizeVertical(rows, ys.weights.data() + y * taps, taps, out_width,
+                       out_plane + y * out_width);
+      }
+    }
+  }, 0, planes, 1, 0, out_height, 1);
+}
+
+}  // namespace ops
+}  // namespace mace
+
+#endif  // MACE_OPS_COMMON_RESIZE_H_
@@ -0,0 +1,168 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MACE_OPS_COMMON_SIMD_H_
+#define MACE_OPS_COMMON_SIMD_H_
+
+#include <cmath>
+#include <cstring>
+
+#if defined(MACE_ENABLE_NEON)
+#include <arm_neon.h>
+#elif defined(MACE_ENABLE_X86)
+#include "mace/ops/x86/common_x86.h"
+#endif
+
+#include "mace/core/types.h"
+
+namespace mace {
+namespace ops {
+
+// The float vector primitives of the target: NEON, the x86 ones of
+// common_x86.h, or scalar. If an operand is NaN, the x86 and scalar min and
+// max return the second operand, while the NEON ones return NaN. VecDiv is
+// exact, VecFastDiv may be a few ulps off where there is no vector division.
+#if defined(MACE_ENABLE_NEON)
+typedef float32x4_t VecF;
+const int kVecFLanes = 4;
+
+inline VecF VecLoad(const float *ptr) { return vld1q_f32(ptr); }
+inline void VecStore(float *ptr, VecF v) { vst1q_f32(ptr, v); }
+inline VecF VecZero() { return vdupq_n_f32(0.f); }
+inline VecF VecSet1(float v) { return vdupq_n_f32(v); }
+inline VecF VecAdd(VecF a, VecF b) { return vaddq_f32(a, b); }
+inline VecF VecSub(VecF a, VecF b) { return vsubq_f32(a, b); }
+inline VecF VecMul(VecF a, VecF b) { return vmulq_f32(a, b); }
+inline VecF VecMax(VecF a, VecF b) { return vmaxq_f32(a, b); }
+inline VecF VecMin(VecF a, VecF b) { return vminq_f32(a, b); }
+inline VecF VecAbs(VecF v) { return vabsq_f32(v); }
+#if defined(__aarch64__)
+inline VecF VecFma(VecF acc, VecF a, VecF b) { return vfmaq_f32(acc, a, b); }
+inline VecF VecDiv(VecF a, VecF b) { return vdivq_f32(a, b); }
+inline VecF VecFastDiv(VecF a, VecF b) { return vdivq_f32(a, b); }
+inline VecF VecRound(VecF v) { return vrndnq_f32(v); }
+#else
+inline VecF VecFma(VecF acc, VecF a, VecF b) { return vmlaq_f32(acc, a, b); }
+// armv7 NEON has no division, divide the lanes one by one.
+inline VecF VecDiv(VecF a, VecF b) {
+  float x[4];
+  float y[4];
+  vst1q_f32(x, a);
+  vst1q_f32(y, b);
+  for (int i = 0; i < 4; ++i) {
+    x[i] /= y[i];
+  }
+  return vld1q_f32(x);
+}
+// The reciprocal estimate refined by two Newton-Raphson steps.
+inline VecF VecFastDiv(VecF a, VecF b) {
+  VecF r = vrecpeq_f32(b);
+  r = vmulq_f32(vrecpsq_f32(b, r), r);
+  r = vmulq_f32(vrecpsq_f32(b, r), r);
+  return vmulq_f32(a, r);
+}
+// floor(v + 0.5)
+inline VecF VecRound(VecF v) {
+  const VecF h = vaddq_f32(v, vdupq_n_f32(0.5f));
+  const VecF t = vcvtq_f32_s32(vcvtq_s32_f32(h));
+  const uint32x4_t greater = vcgtq_f32(t, h);
+  return vsubq_f32(t, vbslq_f32(greater, vdupq_n_f32(1.f), vdupq_n_f32(0.f)));
+}
+#endif  // __aarch64__
+inline VecF VecPow2(VecF n) {
+  const int32x4_t e = vaddq_s32(vcvtq_s32_f32(n), vdupq_n_s32(127));
+  return vreinterpretq_f32_s32(vshlq_n_s32(e, 23));
+}
+inline VecF VecFrexp(VecF v, VecF *e) {
+  const uint32x4_t bits = vreinterpretq_u32_f32(v);
+  *e = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(bits, 23)),
+                               vdupq_n_s32(126)));
+  return vreinterpretq_f32_u32(vorrq_u32(
+      vandq_u32(bits, vdupq_n_u32(0x007fffff)), vdupq_n_u32(0x3f000000)));
+}
+inline VecF VecSelectLess(VecF a, VecF b, VecF x, VecF y) {
+  return vbslq_f32(vcltq_f32(a, b), x, y);
+}
+#elif defined(MACE_ENABLE_X86)
+using x86::VecF;
+using x86::kVecFLanes;
+using x86::VecLoad;
+using x86::VecStore;
+using x86::VecZero;
+using x86::VecSet1;
+using x86::VecAdd;
+using x86::VecSub;
+using x86::VecMul;
+using x86::VecDiv;
+using x86::VecMax;
+using x86::VecMin;
+using x86::VecAbs;
+using x86::VecFma;
+using x86::VecRound;
+using x86::VecPow2;
+using x86::VecFrexp;
+using x86::VecSelectLess;
+inline VecF VecFastDiv(VecF a, VecF b) { return VecDiv(a, b); }
+#else
+typedef float VecF;
+const int kVecFLanes = 1;
+
+inline VecF VecLoad(const float *ptr) { return *ptr; }
+inline void VecStore(float *ptr, VecF v) { *ptr = v; }
+inline VecF VecZero() { return 0.f; }
+inline VecF VecSet1(float v) { return v; }
+inline VecF VecAdd(VecF a, VecF b) { return a + b; }
+inline VecF VecSub(VecF a, VecF b) { return a - b; }
+inline VecF VecMul(VecF a, VecF b) { return a * b; }
+inline VecF VecDiv(VecF a, VecF b) { return a / b; }
+inline VecF VecFastDiv(VecF a, VecF b) { return a / b; }
+inline VecF VecMax(VecF a, VecF b) { return a > b ? a : b; }
+inline VecF VecMin(VecF a, VecF b) { return a < b ? a : b; }
+inline VecF VecAbs(VecF v) { return std::abs(v); }
+inline VecF VecFma(VecF acc, VecF a, VecF b) { return acc + a * b; }
+inline VecF VecRound(VecF v) { return std::nearbyint(v); }
+inline VecF VecPow2(VecF n) {
+  if (std::isnan(n)) {
+    return n;
+  }
+  const int32_t bits = (static_cast<int32_t>(n) + 127) << 23;
+  float r;
+  memcpy(&r, &bits, sizeof(r));
+  return r;
+}
+inline VecF VecFrexp(VecF v, VecF *e) {
+  uint32_t bits;
+  memcpy(&bits, &v, sizeof(bits));
+  *e = static_cast<float>(static_cast<int32_t>(bits >> 23) - 126);
+  bits = (bits & 0x007fffff) | 0x3f000000;
+  float m;
+  memcpy(&m, &bits, sizeof(m));
+  return m;
+}
+inline VecF VecSelectLess(VecF a, VecF b, VecF x, VecF y) {
+  return a < b ? x : y;
+}
+#endif
+
+// Round down, the lanes with |v| >= 2^23 are integers already.
+inline VecF VecFloor(VecF v) {
+  const VecF r = VecRound(v);
+  const VecF down = VecSub(r, VecSelectLess(v, r, VecSet1(1.f), VecZero()));
+  return VecSelectLess(VecAbs(v), VecSet1(8388608.f), down, v);
+}
+
+}  // namespace ops
+}  // namespace mace
+
+#endif  // MACE_OPS_COMMON_SIMD_H_
@@ -0,0 +1,80 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MACE_OPS_COMMON_TOP_K_H_
+#define MACE_OPS_COMMON_TOP_K_H_
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "mace/core/types.h"
+
+namespace mace {
+namespace ops {
+namespace common {
+
+// Use a bounded heap when k is this many times smaller than n, otherwise
+// select with nth_element.
+constexpr index_t kHeapSelectRatio = 8;
+
+// Select the k best of the n values read from input with the given stride.
+// A (value, index) pair is better than another if comp returns true, comp
+// should be a strict total order so the result is deterministic. The
+// selected pairs are stored in *selected, sorted from the best one.
+template<typename T, typename Compare>
+void SelectTopK(const T *input,
+                const index_t n,
+                const index_t stride,
+                const index_t k,
+                Compare comp,
+                std::vector<std::pair<T, int>> *selected) {
+  selected->clear();
+  if (k <= 0) {
+    return;
+  }
+  if (k * kHeapSelectRatio <= n) {
+    // The front of the heap is the worst of the best k seen so far, most
+    // values are rejected with a single comparison against it.
+    for (index_t i = 0; i < k; ++i) {
+      selected->emplace_back(input[i * stride], static_cast<int>(i));
+    }
+    std::make_heap(selected->begin(), selected->end(), comp);
+    for (index_t i = k; i < n; ++i) {
+      std::pair<T, int> candidate(input[i * stride], static_cast<int>(i));
+      if (comp(candidate, selected->front())) {
+        std::pop_heap(selected->begin(), selected->end(), comp);
+        selected->back() = candidate;
+        std::push_heap(selected->begin(), selected->end(), comp);
+      }
+    }
+    std::sort_heap(selected->begin(), selected->end(), comp);
+  } else {
+    for (index_t i = 0; i < n; ++i) {
+      selected->emplace_back(input[i * stride], static_cast<int>(i));
+    }
+    if (k < n) {
+      std::nth_element(selected->begin(), selected->begin() + k,
+                       selected->end(), comp);
+      selected->resize(k);
+    }
+    std::sort(selected->begin(), selected->end(), comp);
+  }
+}
+
+}  // namespace common
+}  // namespace ops
+}  // namespace mace
+
+#endif  // MACE_OPS_COMMON_TOP_K_H_
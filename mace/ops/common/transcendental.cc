@@ -0,0 +1,228 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "mace/ops/common/transcendental.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "mace/ops/common/simd.h"
+
+namespace mace {
+namespace ops {
+
+namespace {
+const float kInf = std::numeric_limits<float>::infinity();
+// exp(x) is 0 below kExpLo after the smallest normal, and inf above kExpHi.
+const float kExpLo = -87.3365447f;
+const float kExpHi = 88.7228317f;
+
+// exp of the x clamped to [kExpLo, kExpHi]: x = n * ln2 + r, and exp(r) by
+// the Cephes polynomial.
+inline VecF ExpClamped(VecF x) {
+  x = VecMin(VecSet1(kExpHi), VecMax(VecSet1(kExpLo), x));
+  // n is at most 127 for the 2^n of a normal float, then r is within
+  // [-0.35, 0.69] instead of [-0.35, 0.35] near kExpHi.
+  const VecF n = VecMin(VecRound(VecMul(x, VecSet1(1.44269504088896341f))),
+                        VecSet1(127.f));
+  // ln2 in two parts to keep r exact.
+  VecF r = VecFma(x, n, VecSet1(-0.693359375f));
+  r = VecFma(r, n, VecSet1(2.12194440e-4f));
+
+  VecF p = VecSet1(1.9875691500e-4f);
+  p = VecFma(VecSet1(1.3981999507e-3f), p, r);
+  p = VecFma(VecSet1(8.3334519073e-3f), p, r);
+  p = VecFma(VecSet1(4.1665795894e-2f), p, r);
+  p = VecFma(VecSet1(1.6666665459e-1f), p, r);
+  p = VecFma(VecSet1(5.0000001201e-1f), p, r);
+  const VecF y = VecAdd(VecFma(r, p, VecMul(r, r)), VecSet1(1.f));
+  return VecMul(y, VecPow2(n));
+}
+
+inline VecF Exp(VecF x) {
+  const VecF y = VecSelectLess(x, VecSet1(kExpLo), VecZero(), ExpClamped(x));
+  return VecSelectLess(VecSet1(kExpHi), x, VecSet1(kInf), y);
+}
+
+// x = m * 2^e with m in [sqrt(0.5), sqrt(2)), and log(m) by the Cephes
+// polynomial.
+inline VecF Log(VecF x) {
+  const float kMinNormal = std::numeric_limits<float>::min();
+  const VecF one = VecSet1(1.f);
+  // Scale the denormals to normals.
+  const VecF scaled = VecSelectLess(x, VecSet1(kMinNormal),
+                                    VecMul(x, VecSet1(8388608.f)), x);
+  VecF e;
+  VecF m = VecFrexp(scaled, &e);
+  e = VecAdd(e, VecSelectLess(x, VecSet1(kMinNormal), VecSet1(-23.f),
+                              VecZero()));
+  const VecF sqrt_half = VecSet1(0.707106781186547524f);
+  e = VecSelectLess(m, sqrt_half, VecSub(e, one), e);
+  m = VecSelectLess(m, sqrt_half, VecSub(VecAdd(m, m), one), VecSub(m, one));
+
+  const VecF z = VecMul(m, m);
+  VecF p = VecSet1(7.0376836292e-2f);
+  p = VecFma(VecSet1(-1.1514610310e-1f), p, m);
+  p = VecFma(VecSet1(1.1676998740e-1f), p, m);
+  p = VecFma(VecSet1(-1.2420140846e-1f), p, m);
+  p = VecFma(VecSet1(1.4249322787e-1f), p, m);
+  p = VecFma(VecSet1(-1.6668057665e-1f), p, m);
+  p = VecFma(VecSet1(2.0000714765e-1f), p, m);
+  p = VecFma(VecSet1(-2.4999993993e-1f), p, m);
+  p = VecFma(VecSet1(3.3333331174e-1f), p, m);
+  VecF y = VecMul(VecMul(p, m), z);
+  y = VecFma(y, e, VecSet1(-2.12194440e-4f));
+  y = VecFma(y, z, VecSet1(-0.5f));
+  VecF r = VecAdd(m, y);
+  r = VecFma(r, e, VecSet1(0.693359375f));
+
+  // log(0) = -inf, log(x < 0) = NaN, log(inf) = inf and log(NaN) = NaN.
+  r = VecSelectLess(VecZero(), x, r, VecSet1(-kInf));
+  r = VecSelectLess(x, VecZero(), VecSet1(std::nanf("")), r);
+  return VecSelectLess(x, VecSet1(kInf), r, x);
+}
+
+// The rational approximation of Eigen, tanh(x) is 1 in float for the
+// |x| > 7.9.
+inline VecF Tanh(VecF x) {
+  const float kBound = 7.90531110763549805f;
+  x = VecMin(VecSet1(kBound), VecMax(VecSet1(-kBound), x));
+  const VecF x2 = VecMul(x, x);
+  VecF p = VecSet1(-2.76076847742355e-16f);
+  p = VecFma(VecSet1(2.00018790482477e-13f), p, x2);
+  p = VecFma(VecSet1(-8.60467152213735e-11f), p, x2);
+  p = VecFma(VecSet1(5.12229709037114e-08f), p, x2);
+  p = VecFma(VecSet1(1.48572235717979e-05f), p, x2);
+  p = VecFma(VecSet1(6.37261928875436e-04f), p, x2);
+  p = VecFma(VecSet1(4.89352455891786e-03f), p, x2);
+  VecF q = VecSet1(1.19825839466702e-06f);
+  q = VecFma(VecSet1(1.18534705686654e-04f), q, x2);
+  q = VecFma(VecSet1(2.26843463243900e-03f), q, x2);
+  q = VecFma(VecSet1(4.89352518554385e-03f), q, x2);
+  return VecFastDiv(VecMul(p, x), q);
+}
+
+// exp(-x) does not overflow to inf for the clamp, so there is no inf / inf.
+inline VecF Sigmoid(VecF x) {
+  const VecF one = VecSet1(1.f);
+  return VecFastDiv(one, VecAdd(one, ExpClamped(VecSub(VecZero(), x))));
+}
+
+// The Taylor series below 0.5, and the formula 7.1.26 of Abramowitz and
+// Stegun otherwise.
+inline VecF Erf(VecF x) {
+  const VecF one = VecSet1(1.f);
+  const VecF a = VecMax(x, VecSub(VecZero(), x));
+  const VecF t = VecFastDiv(one, VecFma(one, VecSet1(0.3275911f), a));
+  VecF p = VecSet1(1.061405429f);
+  p = VecFma(VecSet1(-1.453152027f), p, t);
+  p = VecFma(VecSet1(1.421413741f), p, t);
+  p = VecFma(VecSet1(-0.284496736f), p, t);
+  p = VecFma(VecSet1(0.254829592f), p, t);
+  const VecF e = Exp(VecSub(VecZero(), VecMul(a, a)));
+  VecF large = VecSub(one, VecMul(VecMul(p, t), e));
+  large = VecSelectLess(x, VecZero(), VecSub(VecZero(), large), large);
+
+  const VecF x2 = VecMul(x, x);
+  VecF s = VecSet1(-1.f / 1320);
+  s = VecFma(VecSet1(1.f / 216), s, x2);
+  s = VecFma(VecSet1(-1.f / 42), s, x2);
+  s = VecFma(VecSet1(1.f / 10), s, x2);
+  s = VecFma(VecSet1(-1.f / 3), s, x2);
+  s = VecFma(one, s, x2);
+  const VecF small = VecMul(VecMul(s, x), VecSet1(1.12837916709551257f));
+  return VecSelectLess(a, VecSet1(0.5f), small, large);
+}
+
+// The tail is computed in a zero padded vector, so that all the elements
+// have the same result wherever they are.
+template<VecF (*F)(VecF)>
+void Apply(const float *src, float *dst, const index_t size) {
+  index_t i = 0;
+  for (; i + kVecFLanes <= size; i += kVecFLanes) {
+    VecStore(dst + i, F(VecLoad(src + i)));
+  }
+  if (i < size) {
+    float tile[kVecFLanes] = {0.f};
+    std::copy(src + i, src + size, tile);
+    VecStore(tile, F(VecLoad(tile)));
+    std::copy(tile, tile + size - i, dst + i);
+  }
+}
+
+// base_at(i) and exponent_at(i) are the elements of the base and exponent.
+template<typename BaseAt, typename ExponentAt>
+void Pow(const BaseAt &base_at, const ExponentAt &exponent_at, float *dst,
+         const index_t size) {
+  float base[kVecFLanes];
+  float exponent[kVecFLanes];
+  float result[kVecFLanes];
+  for (index_t i = 0; i < size; i += kVecFLanes) {
+    const index_t len = std::min(static_cast<index_t>(kVecFLanes), size - i);
+    for (index_t j = 0; j < kVecFLanes; ++j) {
+      base[j] = j < len ? base_at(i + j) : 1.f;
+      exponent[j] = j < len ? exponent_at(i + j) : 1.f;
+    }
+    VecStore(result, Exp(VecMul(VecLoad(exponent), Log(VecLoad(base)))));
+    for (index_t j = 0; j < len; ++j) {
+      const bool by_log = base[j] > 0.f && base[j] < kInf &&
+          std::abs(exponent[j]) < kInf;
+      dst[i + j] = by_log ? result[j] : std::pow(base[j], exponent[j]);
+    }
+  }
+}
+}  // namespace
+
+void VectorExp(const float *src, float *dst, const index_t size) {
+  Apply<Exp>(src, dst, size);
+}
+
+void VectorLog(const float *src, float *dst, const index_t size) {
+  Apply<Log>(src, dst, size);
+}
+
+void VectorTanh(const float *src, float *dst, const index_t size) {
+  Apply<Tanh>(src, dst, size);
+}
+
+void VectorSigmoid(const float *src, float *dst, const index_t size) {
+  Apply<Sigmoid>(src, dst, size);
+}
+
+void VectorErf(const float *src, float *dst, const index_t size) {
+  Apply<Erf>(src, dst, size);
+}
+
+void VectorPow(const float *base, const float *exponent, float *dst,
+               const index_t size) {
+  Pow([base](index_t i) { return base[i]; },
+      [exponent](index_t i) { return exponent[i]; }, dst, size);
+}
+
+void VectorPow(const float *base, const float exponent, float *dst,
+               const index_t size) {
+  Pow([base](index_t i) { return base[i]; },
+      [exponent](index_t) { return exponent; }, dst, size);
+}
+
+void VectorPow(const float base, const float *exponent, float *dst,
+               const index_t size) {
+  Pow([base](index_t) { return base; },
+      [exponent](index_t i) { return exponent[i]; }, dst, size);
+}
+
+}  // namespace ops
+}  // namespace mace
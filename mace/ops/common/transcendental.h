@@ -0,0 +1,50 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef MACE_OPS_COMMON_TRANSCENDENTAL_H_
+#define MACE_OPS_COMMON_TRANSCENDENTAL_H_
+
+#include "mace/core/types.h"
+
+namespace mace {
+namespace ops {
+
+// Element-wise transcendental functions of float arrays, evaluated with
+// polynomial approximations on the widest SIMD of the target (NEON, SSE2,
+// AVX2 or AVX-512) and in the same way for the tail. The relative error of
+// exp and log and the absolute error of tanh, sigmoid and erf are within
+// 4e-7. inf and NaN are handled as the std functions do, but exp flushes
+// the results below the smallest normal float to 0. dst may be the same as
+// src.
+void VectorExp(const float *src, float *dst, const index_t size);
+void VectorLog(const float *src, float *dst, const index_t size);
+void VectorTanh(const float *src, float *dst, const index_t size);
+void VectorSigmoid(const float *src, float *dst, const index_t size);
+void VectorErf(const float *src, float *dst, const index_t size);
+
+// dst[i] = pow(base, exponent) of an element-wise base and exponent, or of
+// a scalar one. It is exp(exponent * log(base)) for a finite positive base,
+// the other elements fall back to std::pow.
+void VectorPow(const float *base, const float *exponent, float *dst,
+               const index_t size);
+void VectorPow(const float *base, const float exponent, float *dst,
+               const index_t size);
+void VectorPow(const float base, const float *exponent, float *dst,
+               const index_t size);
+
+}  // namespace ops
+}  // namespace mace
+
+#endif  // MACE_OPS_COMMON_TRANSCENDENTAL_H_
@@ -12,7 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <functional>
 #include <memory>
+#include <vector>
 
 #include "mace/core/ops/operator.h"
 #include "mace/core/registry/ops_registry.h"
@@ -59,13 +62,7 @@ class ConcatOp<RuntimeType::RT_CPU, T> : public ConcatOpBase {
             "has_data_format", 0) == 1) {}
 
   MaceStatus Run(OpContext *context) override {
-    MACE_UNUSED(context);
-    int axis = FormatAxis();
-    if (has_data_format_ && this->Input(0)->dim_size() == 4) {
-      if (axis == 3) axis = 1;
-      else if (axis == 2) axis = 3;
-      else if (axis == 1) axis = 2;
-    }
+    const int axis = DataFormatAxis(FormatAxis());
     const std::vector<const Tensor *> &inputs = this->Inputs();
     Tensor *output = this->Output(0);
     const Tensor *input0 = inputs.front();
@@ -97,26 +94,130 @@ class ConcatOp<RuntimeType::RT_CPU, T> : public ConcatOpBase {
 
     T *output_ptr = output->mutable_data<T>();
     std::vector<const T *> input_ptrs(inputs.size(), nullptr);
+    std::vector<index_t> output_offsets(inputs_count, 0);
     for (size_t i = 0; i < inputs_count; ++i) {
       input_ptrs[i] = inputs[i]->data<T>();
+      if (i > 0) {
+        output_offsets[i] = output_offsets[i - 1] + outer_sizes[i - 1];
+      }
     }
-    for (int inner_idx = 0; inner_idx < inner_size; ++inner_idx) {
+    const index_t output_outer_size =
+        output_offsets.back() + outer_sizes.back();
+    const bool can_use_memcpy = DataTypeCanUseMemcpy(DataTypeToEnum<T>::v());
+
+    // An input planned as a slice of the output, see InputOffsetInOutput,
+    // stays at its planned offset when the inputs in front of it change
+    // their sizes at runtime, so copy the inputs overlapping the output
+    // aside before writing to the output.
+    std::less<const T *> less;
+    const T *output_end = output_ptr + output->size();
+    std::vector<size_t> staged_inputs;
+    index_t staged_size = 0;
+    for (size_t i = 0; i < inputs_count; ++i) {
+      const T *input_end = input_ptrs[i] + inputs[i]->size();
+      const bool in_place =
+          inner_size == 1 && input_ptrs[i] == output_ptr + output_offsets[i];
+      if (!in_place && less(input_ptrs[i], output_end) &&
+          less(output_ptr, input_end)) {
+        staged_inputs.push_back(i);
+        staged_size += inputs[i]->size();
+      }
+    }
+    std::unique_ptr<Buffer> staged_buffer;
+    if (!staged_inputs.empty()) {
+      MemInfo mem_info(output->memory_type(), DataTypeToEnum<T>::v(),
+                       {staged_size});
+      staged_buffer = context->runtime()->ObtainBuffer(mem_info, RENT_SCRATCH);
+      T *staged_ptr = staged_buffer->mutable_data<T>();
+      for (size_t i : staged_inputs) {
+        std::copy(input_ptrs[i], input_ptrs[i] + inputs[i]->size(),
+                  staged_ptr);
+        input_ptrs[i] = staged_ptr;
+        staged_ptr += inputs[i]->size();
+      }
+    }
+
+    utils::ThreadPool
+        &thread_pool = context->runtime()->thread_pool();
+    if (inner_size == 1) {
+      // Concat along the outermost axis: every input is one contiguous
+      // block, so split each block across threads.
       for (size_t i = 0; i < inputs_count; ++i) {
-        if (DataTypeCanUseMemcpy(DataTypeToEnum<T>::v())) {
-          memcpy(output_ptr, input_ptrs[i], outer_sizes[i] * sizeof(T));
-          output_ptr += outer_sizes[i];
-          input_ptrs[i] += outer_sizes[i];
-        } else {
-          for (index_t k = 0; k < outer_sizes[i]; ++k) {
-            *output_ptr++ = *input_ptrs[i]++;
-          }
+        const T *input_ptr = input_ptrs[i];
+        T *output_base = output_ptr + output_offsets[i];
+        if (input_ptr == output_base) {
+          // The input was produced in place, see InputOffsetInOutput.
+          continue;
         }
+        thread_pool.Compute1D([=](index_t start, index_t end, index_t step) {
+          MACE_UNUSED(step);
+          if (can_use_memcpy) {
+            memcpy(output_base + start, input_ptr + start,
+                   (end - start) * sizeof(T));
+          } else {
+            std::copy(input_ptr + start, input_ptr + end, output_base + start);
+          }
+        }, 0, outer_sizes[i], 1, 0, 1);
       }
+    } else {
+      const index_t *outer_sizes_ptr = outer_sizes.data();
+      const index_t *output_offsets_ptr = output_offsets.data();
+      const T *const *input_ptrs_ptr = input_ptrs.data();
+      thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                                index_t start1, index_t end1, index_t step1) {
+        for (index_t inner_idx = start0; inner_idx < end0;
+             inner_idx += step0) {
+          for (index_t i = start1; i < end1; i += step1) {
+            const index_t outer_size = outer_sizes_ptr[i];
+            const T *in = input_ptrs_ptr[i] + inner_idx * outer_size;
+            T *out = output_ptr + inner_idx * output_outer_size
+                + output_offsets_ptr[i];
+            if (can_use_memcpy) {
+              memcpy(out, in, outer_size * sizeof(T));
+            } else {
+              std::copy(in, in + outer_size, out);
+            }
+          }
+        }
+      }, 0, inner_size, 1, 0, inputs_count, 1, 0, 0,
+         output_outer_size / inputs_count);
     }
 
     return MaceStatus::MACE_SUCCESS;
   }
 
+  index_t InputOffsetInOutput(size_t input_idx) const override {
+    const Tensor *input0 = inputs_[0];
+    const int32_t input_dims = input0->dim_size();
+    int axis = axis_ < 0 ? axis_ + input_dims : axis_;
+    if (axis < 0 || axis >= input_dims) {
+      return -1;
+    }
+    axis = DataFormatAxis(axis);
+    // Only the concatenation along the outermost axis keeps every input as
+    // one contiguous block of the output.
+    for (int i = 0; i < axis; ++i) {
+      if (input0->dim(i) != 1) {
+        return -1;
+      }
+    }
+    index_t offset = 0;
+    for (size_t i = 0; i < input_idx; ++i) {
+      offset += inputs_[i]->raw_size();
+    }
+    return offset;
+  }
+
+ private:
+  int DataFormatAxis(int axis) const {
+    if (has_data_format_ && inputs_[0]->dim_size() == 4) {
+      if (axis == 3) return 1;
+      else if (axis == 2) return 3;
+      else if (axis == 1) return 2;
+    }
+    return axis;
+  }
+
  private:
   bool has_data_format_;
 };
@@ -21,6 +21,7 @@
 #include <memory>
 #include <string>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 #include "mace/core/future.h"
@@ -33,13 +34,14 @@
 #include "mace/ops/delegator/activation.h"
 #include "mace/ops/delegator/bias_add.h"
 #include "mace/ops/delegator/conv_2d.h"
+#include "mace/runtimes/cpu/cpu_runtime.h"
 #include "mace/utils/memory.h"
 #include "mace/utils/math.h"
+#include "mace/utils/string_util.h"
 
 #ifdef MACE_ENABLE_QUANTIZE
 #include "mace/ops/common/gemmlowp_util.h"
 #include "mace/ops/arm/q8/quantization_util.h"
-#include "mace/runtimes/cpu/cpu_runtime.h"
 #endif  // MACE_ENABLE_QUANTIZE
 
 #ifdef MACE_ENABLE_OPENCL
@@ -86,99 +88,210 @@ class Conv2dOp<RuntimeType::RT_CPU, T> : public ConvPool2dOpBase {
     Tensor *output = this->Output(OUTPUT);
 
     if (conv2d_delegator_ == nullptr) {
-      auto tag = MACE_DELEGATOR_KEY(Conv2d,
-                                    RuntimeType::RT_CPU, T, kCpuImplType);
-      if (kCpuImplType == NEON) {
-        // the following params are used to decide which conv delegator to use
-        const index_t stride_h = strides_[0];
-        const index_t stride_w = strides_[1];
-        const index_t dilation_h = dilations_[0];
-        const index_t dilation_w = dilations_[1];
-        const index_t filter_h = filter->dim(2);
-        const index_t filter_w = filter->dim(3);
-        const index_t input_channels = input->dim(1);
-        const index_t channels = filter->dim(0);
-        // NOTE: delegator is fixed after first round of running,
-        // although winograd depends on input params.
-        // We do not support changeable filter for now.
-        if (filter_h == 1 && filter_w == 1 && stride_h == 1 && stride_w == 1
-            && dilation_h == 1 && dilation_w == 1) {
-          tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
-                                      kCpuImplType, K1x1);
-        } else if (filter_h == 3 && filter_w == 3
-            && stride_h == 1 && stride_w == 1 && dilation_h == 1
-            && dilation_w == 1) {
-          if (input_channels >= 8 && channels >= 8) {
-            tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
-                                        kCpuImplType, K3x3Winograd);
-          } else {
-            tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
-                                        kCpuImplType, K3x3S1);
-          }
-        } else if (filter_h == 3 && filter_w == 3
-            && stride_h == 2 && stride_w == 2 && dilation_h == 1
-            && dilation_w == 1) {
-          tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
-                                      kCpuImplType, K3x3S2);
-        } else if (filter_h == 5 && filter_w == 5
-            && stride_h == 1 && stride_w == 1 && dilation_h == 1
-            && dilation_w == 1) {
-          tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
-                                      kCpuImplType, K5x5S1);
-        } else if (filter_h == 7 && filter_w == 7
-            && stride_h == 1 && stride_w == 1 && dilation_h == 1
-            && dilation_w == 1) {
-          tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
-                                      kCpuImplType, K7x7S1);
-        } else if (filter_h == 7 && filter_w == 7
-            && stride_h == 2 && stride_w == 2 && dilation_h == 1
-            && dilation_w == 1) {
-          tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
-                                      kCpuImplType, K7x7S2);
-        } else if (filter_h == 7 && filter_w == 7
-            && stride_h == 3 && stride_w == 3 && dilation_h == 1
-            && dilation_w == 1) {
-          tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
-                                      kCpuImplType, K7x7S3);
-        } else if (filter_h == 1 && filter_w == 7
-            && stride_h == 1 && stride_w == 1 && dilation_h == 1
-            && dilation_w == 1) {
-          tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
-                                      kCpuImplType, K1x7S1);
-        } else if (filter_h == 7 && filter_w == 1
-            && stride_h == 1 && stride_w == 1 && dilation_h == 1
-            && dilation_w == 1) {
-          tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
-                                      kCpuImplType, K7x1S1);
-        } else if (filter_h == 1 && filter_w == 15
-            && stride_h == 1 && stride_w == 1 && dilation_h == 1
-            && dilation_w == 1) {
+      MACE_RETURN_IF_ERROR(
+          CreateConv2dDelegator(context, input, filter, output));
+    } else {
+      ComputeConv2d(context, conv2d_delegator_.get(), tile_count_per_thread_,
+                    input, filter, output);
+    }
+    bias_add_delegator_->Compute(context, output, bias, output);
+    activation_delegator_->Compute(context, output, output);
+
+    return MaceStatus::MACE_SUCCESS;
+  }
+
+ private:
+  // The conv delegators which could compute the input, the first one is
+  // chosen by the shape heuristics.
+  std::vector<DelegatorInfo> Conv2dCandidates(const Tensor *input,
+                                              const Tensor *filter) {
+    auto tag = MACE_DELEGATOR_KEY(Conv2d,
+                                  RuntimeType::RT_CPU, T, kCpuImplType);
+    if (kCpuImplType == NEON) {
+      // the following params are used to decide which conv delegator to use
+      const index_t stride_h = strides_[0];
+      const index_t stride_w = strides_[1];
+      const index_t dilation_h = dilations_[0];
+      const index_t dilation_w = dilations_[1];
+      const index_t filter_h = filter->dim(2);
+      const index_t filter_w = filter->dim(3);
+      const index_t input_channels = input->dim(1);
+      const index_t channels = filter->dim(0);
+      // NOTE: delegator is fixed after first round of running,
+      // although winograd depends on input params.
+      // We do not support changeable filter for now.
+      if (filter_h == 1 && filter_w == 1 && stride_h == 1 && stride_w == 1
+          && dilation_h == 1 && dilation_w == 1) {
+        tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
+                                    kCpuImplType, K1x1);
+      } else if (filter_h == 3 && filter_w == 3
+          && stride_h == 1 && stride_w == 1 && dilation_h == 1
+          && dilation_w == 1) {
+        if (input_channels >= 8 && channels >= 8) {
           tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
-                                      kCpuImplType, K1x15S1);
-        } else if (filter_h == 15 && filter_w == 1
-            && stride_h == 1 && stride_w == 1 && dilation_h == 1
-            && dilation_w == 1) {
+                                      kCpuImplType, K3x3Winograd);
+        } else {
           tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
-                                      kCpuImplType, K15x1S1);
+                                      kCpuImplType, K3x3S1);
         }
+      } else if (filter_h == 3 && filter_w == 3
+          && stride_h == 2 && stride_w == 2 && dilation_h == 1
+          && dilation_w == 1) {
+        tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
+                                    kCpuImplType, K3x3S2);
+      } else if (filter_h == 5 && filter_w == 5
+          && stride_h == 1 && stride_w == 1 && dilation_h == 1
+          && dilation_w == 1) {
+        tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
+                                    kCpuImplType, K5x5S1);
+      } else if (filter_h == 7 && filter_w == 7
+          && stride_h == 1 && stride_w == 1 && dilation_h == 1
+          && dilation_w == 1) {
+        tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
+                                    kCpuImplType, K7x7S1);
+      } else if (filter_h == 7 && filter_w == 7
+          && stride_h == 2 && stride_w == 2 && dilation_h == 1
+          && dilation_w == 1) {
+        tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
+                                    kCpuImplType, K7x7S2);
+      } else if (filter_h == 7 && filter_w == 7
+          && stride_h == 3 && stride_w == 3 && dilation_h == 1
+          && dilation_w == 1) {
+        tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
+                                    kCpuImplType, K7x7S3);
+      } else if (filter_h == 1 && filter_w == 7
+          && stride_h == 1 && stride_w == 1 && dilation_h == 1
+          && dilation_w == 1) {
+        tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
+                                    kCpuImplType, K1x7S1);
+      } else if (filter_h == 7 && filter_w == 1
+          && stride_h == 1 && stride_w == 1 && dilation_h == 1
+          && dilation_w == 1) {
+        tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
+                                    kCpuImplType, K7x1S1);
+      } else if (filter_h == 1 && filter_w == 15
+          && stride_h == 1 && stride_w == 1 && dilation_h == 1
+          && dilation_w == 1) {
+        tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
+                                    kCpuImplType, K1x15S1);
+      } else if (filter_h == 15 && filter_w == 1
+          && stride_h == 1 && stride_w == 1 && dilation_h == 1
+          && dilation_w == 1) {
+        tag = MACE_DELEGATOR_KEY_EX(Conv2d, RuntimeType::RT_CPU, T,
+                                    kCpuImplType, K15x1S1);
+      }
+    }
+    std::vector<DelegatorInfo> candidates = {tag};
+    // Only float has all the NEON delegators.
+    if (kCpuImplType == NEON && std::is_same<T, float>::value) {
+      const bool is_3x3s1 = filter->dim(2) == 3 && filter->dim(3) == 3
+          && strides_[0] == 1 && strides_[1] == 1
+          && dilations_[0] == 1 && dilations_[1] == 1;
+      if (is_3x3s1) {
+        const auto winograd = MACE_DELEGATOR_KEY_EX(
+            Conv2d, RuntimeType::RT_CPU, T, kCpuImplType, K3x3Winograd);
+        const auto direct = MACE_DELEGATOR_KEY_EX(
+            Conv2d, RuntimeType::RT_CPU, T, kCpuImplType, K3x3S1);
+        candidates.push_back(tag == winograd ? direct : winograd);
+      }
+      const auto general = MACE_DELEGATOR_KEY(Conv2d, RuntimeType::RT_CPU,
+                                              T, kCpuImplType);
+      if (!(tag == general)) {
+        candidates.push_back(general);
       }
-      delegator::Conv2dParam param(strides_, dilations_,
-                                   paddings_, padding_type_);
-      conv2d_delegator_ = delegator::Conv2d::Create(context->workspace(),
-                                                    tag, param);
     }
+    return candidates;
+  }
 
-    conv2d_delegator_->Compute(context, input, filter, output);
-    bias_add_delegator_->Compute(context, output, bias, output);
-    activation_delegator_->Compute(context, output, output);
+  // Choose the conv delegator and the tile count per thread, by the CPU
+  // tuner if it is enabled, and compute the output with them.
+  MaceStatus CreateConv2dDelegator(OpContext *context, const Tensor *input,
+                                   const Tensor *filter, Tensor *output) {
+    const std::vector<DelegatorInfo> candidates =
+        Conv2dCandidates(input, filter);
+    const delegator::Conv2dParam param(strides_, dilations_,
+                                       paddings_, padding_type_);
+    CpuRuntime *cpu_runtime = CpuRuntime::Get(context);
+    if (!cpu_runtime->IsTunerEnabled()) {
+      conv2d_delegator_ = delegator::Conv2d::Create(context->workspace(),
+                                                    candidates[0], param);
+      conv2d_delegator_->Compute(context, input, filter, output);
+      return MaceStatus::MACE_SUCCESS;
+    }
 
+    // params: [candidate index, tile count per thread], a tile count of 0
+    // is the default of the thread pool.
+    const size_t thread_count =
+        context->runtime()->thread_pool().thread_count();
+    auto normalize = [&candidates](const std::vector<uint32_t> &params) {
+      if (params.size() != 2 || params[0] >= candidates.size()) {
+        return std::vector<uint32_t>{0, 0};
+      }
+      return params;
+    };
+    auto generator = [&candidates, thread_count]() {
+      std::vector<uint32_t> tile_counts = {0};
+      if (thread_count > 1) {
+        tile_counts = {1, 2, 4, 8};
+      }
+      std::vector<std::vector<uint32_t>> results;
+      for (uint32_t i = 0; i < candidates.size(); ++i) {
+        for (uint32_t tile_count : tile_counts) {
+          results.push_back({i, tile_count});
+        }
+      }
+      return results;
+    };
+    std::vector<std::unique_ptr<delegator::Conv2d>> delegators(
+        candidates.size());
+    auto func = [&](const std::vector<uint32_t> &tuning_params) {
+      const std::vector<uint32_t> params = normalize(tuning_params);
+      auto &conv2d_delegator = delegators[params[0]];
+      if (conv2d_delegator == nullptr) {
+        conv2d_delegator = delegator::Conv2d::Create(
+            context->workspace(), candidates[params[0]], param);
+      }
+      ComputeConv2d(context, conv2d_delegator.get(), params[1],
+                    input, filter, output);
+      return MaceStatus::MACE_SUCCESS;
+    };
+    const std::string key = MakeString(
+        "Conv2D_CPU_", static_cast<int>(DataTypeToEnum<T>::value), "_",
+        MakeString(input->shape()), "_", MakeString(filter->shape()), "_",
+        MakeString(strides_), "_", MakeString(dilations_), "_",
+        MakeString(paddings_), "_", static_cast<int>(padding_type_), "_",
+        thread_count);
+    MaceStatus conv2d_status = MaceStatus::MACE_SUCCESS;
+    const std::vector<uint32_t> params = normalize(cpu_runtime->TuneOrRun(
+        key, {0, 0}, generator, func, &conv2d_status));
+    MACE_RETURN_IF_ERROR(conv2d_status);
+    conv2d_delegator_ = std::move(delegators[params[0]]);
+    tile_count_per_thread_ = params[1];
     return MaceStatus::MACE_SUCCESS;
   }
 
+  void ComputeConv2d(OpContext *context,
+                     delegator::Conv2d *conv2d_delegator,
+                     int tile_count_per_thread,
+                     const Tensor *input,
+                     const Tensor *filter,
+                     Tensor *output) {
+    if (tile_count_per_thread <= 0) {
+      conv2d_delegator->Compute(context, input, filter, output);
+      return;
+    }
+    utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+    const int default_tile_count = thread_pool.tile_count_per_thread();
+    thread_pool.SetTileCountPerThread(tile_count_per_thread);
+    conv2d_delegator->Compute(context, input, filter, output);
+    thread_pool.SetTileCountPerThread(default_tile_count);
+  }
+
  private:
   std::unique_ptr<delegator::Activation> activation_delegator_;
   std::unique_ptr<delegator::BiasAdd> bias_add_delegator_;
   std::unique_ptr<delegator::Conv2d> conv2d_delegator_;
+  int tile_count_per_thread_ = 0;
 
  private:
   MACE_OP_INPUT_TAGS(INPUT, FILTER, BIAS);
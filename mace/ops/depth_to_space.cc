@@ -37,7 +37,6 @@ class DepthToSpaceOp<RT_CPU, T> : public Operation {
         mode_(Operation::GetOptionalArg<std::string>("mode", "DCR")) {}
 
   MaceStatus Run(OpContext *context) override {
-    MACE_UNUSED(context);
     const Tensor *input = this->Input(0);
     Tensor *output = this->Output(0);
     MACE_CHECK(input->dim_size() == 4, "input dim should be 4");
@@ -60,57 +59,40 @@ class DepthToSpaceOp<RT_CPU, T> : public Operation {
     const T *input_ptr = input->data<T>();
     T *output_ptr = output->mutable_data<T>();
 
-    if (mode_ == "DCR") {
-      for (index_t b = 0; b < batch_size; ++b) {
-        for (index_t d = 0; d < output_depth; ++d) {
-          for (index_t h = 0; h < output_height; ++h) {
-            const index_t in_h = h / block_size_;
-            const index_t offset_h = (h % block_size_);
-            for (int w = 0; w < output_width; ++w) {
-              const index_t in_w = w / block_size_;
-              const index_t offset_w = w % block_size_;
-              const index_t offset_d =
-                  (offset_h * block_size_ + offset_w) * output_depth;
-
-              const index_t in_d = d + offset_d;
-              const index_t o_index =
-                  ((b * output_depth + d) * output_height + h) * output_width +
-                  w;
-              const index_t i_index =
-                  ((b * input_depth + in_d) * input_height + in_h) *
-                      input_width +
-                  in_w;
-              output_ptr[o_index] = input_ptr[i_index];
-            }
-          }
-        }
-      }
-    } else {  // CRD
-      for (index_t b = 0; b < batch_size; ++b) {
-        for (index_t d = 0; d < output_depth; ++d) {
-          for (index_t h = 0; h < output_height; ++h) {
-            const index_t in_h = h / block_size_;
-            const index_t offset_h = (h % block_size_);
-            for (int w = 0; w < output_width; ++w) {
-              const index_t in_w = w / block_size_;
-              const index_t offset_w = w % block_size_;
-              const index_t block_offset_d = offset_h * block_size_ + offset_w;
-              const index_t in_d =
-                  d * (block_size_ * block_size_) + block_offset_d;
-
-              const index_t o_index =
-                  ((b * output_depth + d) * output_height + h) * output_width +
-                  w;
-              const index_t i_index =
-                  ((b * input_depth + in_d) * input_height + in_h) *
-                      input_width +
-                  in_w;
-              output_ptr[o_index] = input_ptr[i_index];
+    const int block_size = block_size_;
+    const bool is_dcr = mode_ == "DCR";
+    utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+    // Each output row interleaves block_size input rows, so copy row by row
+    // and parallelize over (batch, depth) planes and rows.
+    thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                              index_t start1, index_t end1, index_t step1) {
+      for (index_t bd = start0; bd < end0; bd += step0) {
+        const index_t b = bd / output_depth;
+        const index_t d = bd % output_depth;
+        for (index_t h = start1; h < end1; h += step1) {
+          const index_t in_h = h / block_size;
+          const index_t offset_h = h % block_size;
+          T *out_row = output_ptr + (bd * output_height + h) * output_width;
+          for (index_t offset_w = 0; offset_w < block_size; ++offset_w) {
+            const index_t block_offset_d = offset_h * block_size + offset_w;
+            const index_t in_d = is_dcr
+                ? d + block_offset_d * output_depth
+                : d * block_size * block_size + block_offset_d;
+            const T *in_row = input_ptr
+                + ((b * input_depth + in_d) * input_height + in_h)
+                    * input_width;
+            if (block_size == 1) {
+              memcpy(out_row, in_row, input_width * sizeof(T));
+            } else {
+              for (index_t in_w = 0; in_w < input_width; ++in_w) {
+                out_row[in_w * block_size + offset_w] = in_row[in_w];
+              }
             }
           }
         }
       }
-    }
+    }, 0, batch_size * output_depth, 1, 0, output_height, 1, 0, 0,
+       output_width);
 
     return MaceStatus::MACE_SUCCESS;
   }
@@ -117,6 +117,11 @@ class DepthwiseConv2dOp<RuntimeType::RT_CPU, T> : public DepthwiseConv2dOpBase {
           tag = MACE_DELEGATOR_KEY_EX(DepthwiseConv2d, RuntimeType::RT_CPU, T,
                                       kCpuImplType, K3x3S2);
         }
+      } else if (kCpuImplType == X86 && filter->dim(0) == 1) {
+        // The NCHWc kernel handles all the filter sizes, strides and
+        // dilations of multiplier 1.
+        tag = MACE_DELEGATOR_KEY(DepthwiseConv2d, RuntimeType::RT_CPU, T,
+                                 kCpuImplType);
       }
       delegator::Conv2dParam param(strides_, dilations_,
                                    paddings_, padding_type_);
@@ -124,6 +129,9 @@ class DepthwiseConv2dOp<RuntimeType::RT_CPU, T> : public DepthwiseConv2dOpBase {
           context->workspace(), tag, param);
     }
 
+    MACE_CHECK(input->data_format() != DataFormat::NCHWc ||
+                   kCpuImplType == X86,
+               "NCHWc depthwise conv needs the x86 kernel");
     depthwise_conv2d_delegator_->Compute(context, input, filter, output);
     bias_add_delegator_->Compute(context, output, bias, output);
     activation_delegator_->Compute(context, output, output);
@@ -424,7 +432,28 @@ void RegisterDepthwiseConv2d(OpRegistry *op_registry) {
           }));
 #endif  // MACE_ENABLE_OPENCL
 
+#ifdef MACE_ENABLE_X86
+  // The x86 kernel of multiplier 1 runs in NCHWc.
+  MACE_REGISTER_OP_CONDITION(
+      op_registry,
+      OpConditionBuilder("DepthwiseConv2d").SetInputsDataFormatSelector(
+          [](OpConditionContext *context) -> std::vector<DataFormat> {
+            auto op = context->operator_def();
+            DataFormat op_data_format = static_cast<DataFormat>(
+                ProtoArgHelper::GetOptionalArg<OperatorDef, int>(
+                    *op, "data_format", static_cast<int>(DataFormat::NONE)));
+            const Tensor *filter = op->input_size() > 1 ?
+                context->workspace()->GetTensor(op->input(1)) : nullptr;
+            if (op_data_format == DataFormat::NCHW && filter != nullptr &&
+                filter->is_weight() && filter->dim_size() == 4 &&
+                filter->dim(0) == 1) {
+              op_data_format = DataFormat::NCHWc;
+            }
+            return {op_data_format, DataFormat::OIHW, DataFormat::NONE};
+          }));
+#else
   RegisterFilterDataFormat(op_registry, "DepthwiseConv2d");
+#endif  // MACE_ENABLE_X86
 }
 
 }  // namespace ops
@@ -20,6 +20,12 @@
 #include <utility>
 #include <vector>
 
+#if defined(MACE_ENABLE_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
 #include "mace/core/ops/operator.h"
 #include "mace/core/quantize.h"
 #include "mace/core/registry/ops_registry.h"
@@ -39,59 +45,193 @@ struct BBox {
 };
 
 namespace {
-inline float overlap(const BBox &a, const BBox &b) {
-  if (a.xmin > b.xmax || a.xmax < b.xmin || a.ymin > b.ymax ||
-      a.ymax < b.ymin) {
-    return 0.f;
+inline bool cmp(const BBox &a, const BBox &b) {
+  return a.confidence > b.confidence;
+}
+
+// The boxes of NMS stored by coordinate, so that the IoU of a candidate
+// against them can be computed four at a time.
+class NmsBoxes {
+ public:
+  explicit NmsBoxes(const int capacity) {
+    // Padded to a multiple of 4 for the vectorized loop.
+    const int padded = (capacity + 3) & ~3;
+    xmin_.resize(padded);
+    ymin_.resize(padded);
+    xmax_.resize(padded);
+    ymax_.resize(padded);
+    area_.resize(padded);
+    size_ = 0;
   }
-  float overlap_w = std::min(a.xmax, b.xmax) - std::max(a.xmin, b.xmin);
-  float overlap_h = std::min(a.ymax, b.ymax) - std::max(a.ymin, b.ymin);
-  return overlap_w * overlap_h;
+
+  void Add(const BBox &box, const float area) {
+    xmin_[size_] = box.xmin;
+    ymin_[size_] = box.ymin;
+    xmax_[size_] = box.xmax;
+    ymax_[size_] = box.ymax;
+    area_[size_] = area;
+    ++size_;
+  }
+
+  // Whether the IoU between box and any of the first count boxes is greater
+  // than threshold.
+  bool Overlaps(const BBox &box, const float area, const float threshold,
+                const int count) const {
+    int j = 0;
+#if defined(MACE_ENABLE_NEON)
+    const float32x4_t vxmin = vdupq_n_f32(box.xmin);
+    const float32x4_t vymin = vdupq_n_f32(box.ymin);
+    const float32x4_t vxmax = vdupq_n_f32(box.xmax);
+    const float32x4_t vymax = vdupq_n_f32(box.ymax);
+    const float32x4_t varea = vdupq_n_f32(area);
+    const float32x4_t vthreshold = vdupq_n_f32(threshold);
+    const float32x4_t vzero = vdupq_n_f32(0.f);
+    for (; j + 3 < count; j += 4) {
+      float32x4_t w = vsubq_f32(vminq_f32(vxmax, vld1q_f32(&xmax_[j])),
+                                vmaxq_f32(vxmin, vld1q_f32(&xmin_[j])));
+      float32x4_t h = vsubq_f32(vminq_f32(vymax, vld1q_f32(&ymax_[j])),
+                                vmaxq_f32(vymin, vld1q_f32(&ymin_[j])));
+      float32x4_t inter = vmulq_f32(vmaxq_f32(w, vzero), vmaxq_f32(h, vzero));
+      float32x4_t uni = vsubq_f32(vaddq_f32(varea, vld1q_f32(&area_[j])),
+                                  inter);
+      uint32x4_t over = vcgtq_f32(inter, vmulq_f32(vthreshold, uni));
+      uint32x2_t over2 = vorr_u32(vget_low_u32(over), vget_high_u32(over));
+      if (vget_lane_u32(vpmax_u32(over2, over2), 0) != 0) {
+        return true;
+      }
+    }
+#elif defined(__SSE__)
+    const __m128 vxmin = _mm_set1_ps(box.xmin);
+    const __m128 vymin = _mm_set1_ps(box.ymin);
+    const __m128 vxmax = _mm_set1_ps(box.xmax);
+    const __m128 vymax = _mm_set1_ps(box.ymax);
+    const __m128 varea = _mm_set1_ps(area);
+    const __m128 vthreshold = _mm_set1_ps(threshold);
+    const __m128 vzero = _mm_setzero_ps();
+    for (; j + 3 < count; j += 4) {
+      __m128 w = _mm_sub_ps(_mm_min_ps(vxmax, _mm_loadu_ps(&xmax_[j])),
+                            _mm_max_ps(vxmin, _mm_loadu_ps(&xmin_[j])));
+      __m128 h = _mm_sub_ps(_mm_min_ps(vymax, _mm_loadu_ps(&ymax_[j])),
+                            _mm_max_ps(vymin, _mm_loadu_ps(&ymin_[j])));
+      __m128 inter = _mm_mul_ps(_mm_max_ps(w, vzero), _mm_max_ps(h, vzero));
+      __m128 uni = _mm_sub_ps(_mm_add_ps(varea, _mm_loadu_ps(&area_[j])),
+                              inter);
+      __m128 over = _mm_cmpgt_ps(inter, _mm_mul_ps(vthreshold, uni));
+      if (_mm_movemask_ps(over) != 0) {
+        return true;
+      }
+    }
+#endif
+    for (; j < count; ++j) {
+      float w = std::min(box.xmax, xmax_[j]) - std::max(box.xmin, xmin_[j]);
+      float h = std::min(box.ymax, ymax_[j]) - std::max(box.ymin, ymin_[j]);
+      float inter = std::max(w, 0.f) * std::max(h, 0.f);
+      float uni = area + area_[j] - inter;
+      if (inter > threshold * uni) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  int size() const {
+    return size_;
+  }
+
+ private:
+  std::vector<float> xmin_;
+  std::vector<float> ymin_;
+  std::vector<float> xmax_;
+  std::vector<float> ymax_;
+  std::vector<float> area_;
+  int size_;
+};
+
+inline float BoxArea(const BBox &box) {
+  return std::max(0.f, box.xmax - box.xmin) *
+      std::max(0.f, box.ymax - box.ymin);
 }
 
+// Greedy NMS, bboxes should be sorted by confidence in descending order.
 void NmsSortedBboxes(const std::vector<BBox> &bboxes,
                      const float nms_threshold,
-                     const int top_k,
-                     std::vector<BBox> *sorted_boxes) {
-  const int n = std::min(top_k, static_cast<int>(bboxes.size()));
-  std::vector<int> picked;
-
-  std::vector<float> areas(n);
+                     std::vector<BBox> *picked_boxes) {
+  const int n = static_cast<int>(bboxes.size());
+  NmsBoxes picked(n);
   for (int i = 0; i < n; ++i) {
-    const BBox &r = bboxes[i];
-    float width = std::max(0.f, r.xmax - r.xmin);
-    float height = std::max(0.f, r.ymax - r.ymin);
-    areas[i] = width * height;
+    const BBox &box = bboxes[i];
+    const float area = BoxArea(box);
+    if (!picked.Overlaps(box, area, nms_threshold, picked.size())) {
+      picked_boxes->push_back(box);
+      picked.Add(box, area);
+    }
   }
+}
 
-  for (int i = 0; i < n; ++i) {
-    const BBox &a = bboxes[i];
-    int keep = 1;
-    for (size_t j = 0; j < picked.size(); ++j) {
-      const BBox &b = bboxes[picked[j]];
-
-      float inter_area = overlap(a, b);
-      float union_area = areas[i] + areas[picked[j]] - inter_area;
-      MACE_CHECK(union_area > 0, "union_area should be greater than 0");
-      if (inter_area / union_area > nms_threshold) {
-        keep = 0;
-        break;
-      }
+// Fast NMS of the sorted boxes of all the classes at once: a box is
+// suppressed if its IoU with any box of higher confidence of its class is
+// greater than nms_threshold, whether that box is kept or not. That is the
+// column max of the upper triangular IoU matrix of each class, which does
+// not depend on the other columns, so the columns of all the classes are
+// split over the threads. It suppresses a bit more than greedy NMS.
+void FastNmsSortedBboxes(utils::ThreadPool *thread_pool,
+                         const std::vector<std::vector<BBox>> &class_bboxes,
+                         const float nms_threshold,
+                         std::vector<std::vector<BBox>> *class_picked_boxes) {
+  const int num_classes = static_cast<int>(class_bboxes.size());
+  std::vector<std::unique_ptr<NmsBoxes>> class_boxes(num_classes);
+  std::vector<index_t> offsets(num_classes + 1, 0);
+  for (int c = 0; c < num_classes; ++c) {
+    const std::vector<BBox> &bboxes = class_bboxes[c];
+    class_boxes[c] = make_unique<NmsBoxes>(static_cast<int>(bboxes.size()));
+    for (const BBox &box : bboxes) {
+      class_boxes[c]->Add(box, BoxArea(box));
     }
+    offsets[c + 1] = offsets[c] + static_cast<index_t>(bboxes.size());
+  }
 
-    if (keep) {
-      picked.push_back(i);
-      sorted_boxes->push_back(bboxes[i]);
+  std::vector<uint8_t> suppressed(offsets[num_classes]);
+  const std::vector<BBox> *class_bboxes_ptr = class_bboxes.data();
+  const std::unique_ptr<NmsBoxes> *class_boxes_ptr = class_boxes.data();
+  const index_t *offsets_ptr = offsets.data();
+  uint8_t *suppressed_ptr = suppressed.data();
+  thread_pool->Compute1D([=](index_t start, index_t end, index_t step) {
+    for (index_t k = start; k < end; k += step) {
+      const int c = static_cast<int>(
+          std::upper_bound(offsets_ptr, offsets_ptr + num_classes + 1, k) -
+          offsets_ptr) - 1;
+      const int j = static_cast<int>(k - offsets_ptr[c]);
+      const BBox &box = class_bboxes_ptr[c][j];
+      suppressed_ptr[k] =
+          class_boxes_ptr[c]->Overlaps(box, BoxArea(box), nms_threshold, j);
+    }
+  }, 0, offsets[num_classes], 1);
+
+  for (int c = 0; c < num_classes; ++c) {
+    const std::vector<BBox> &bboxes = class_bboxes[c];
+    for (size_t j = 0; j < bboxes.size(); ++j) {
+      if (!suppressed[offsets[c] + j]) {
+        (*class_picked_boxes)[c].push_back(bboxes[j]);
+      }
     }
   }
 }
 
-inline bool cmp(const BBox &a, const BBox &b) {
-  return a.confidence > b.confidence;
+// Keep the top_k boxes of highest confidence, sorted in descending order.
+// A negative top_k keeps all the boxes.
+void SortTopK(const int top_k, std::vector<BBox> *bboxes) {
+  if (top_k >= 0 && top_k < static_cast<int>(bboxes->size())) {
+    std::partial_sort(bboxes->begin(), bboxes->begin() + top_k,
+                      bboxes->end(), cmp);
+    bboxes->resize(top_k);
+  } else {
+    std::sort(bboxes->begin(), bboxes->end(), cmp);
+  }
 }
 }  // namespace
 
-int DetectionOutput_CLA(const float *loc_ptr,
+int DetectionOutput_CLA(utils::ThreadPool *thread_pool,
+                        const float *loc_ptr,
                         const float *conf_ptr,
                         const float *pbox_ptr,
                         const int num_prior,
@@ -100,68 +240,79 @@ int DetectionOutput_CLA(const float *loc_ptr,
                         const int top_k,
                         const int keep_top_k,
                         const float confidence_threshold,
+                        const bool fast_nms,
                         std::vector<BBox> *bbox_rects) {
   MACE_CHECK(keep_top_k > 0, "keep_top_k should be greater than 0");
   std::vector<float> bboxes(4 * num_prior);
-  for (int i = 0; i < num_prior; ++i) {
-    int index = i * 4;
-    const float *lc = loc_ptr + index;
-    const float *pb = pbox_ptr + index;
-    const float *var = pb + num_prior * 4;
-
-    float pb_w = pb[2] - pb[0];
-    float pb_h = pb[3] - pb[1];
-    float pb_cx = (pb[0] + pb[2]) * 0.5f;
-    float pb_cy = (pb[1] + pb[3]) * 0.5f;
-
-    float bbox_cx = var[0] * lc[0] * pb_w + pb_cx;
-    float bbox_cy = var[1] * lc[1] * pb_h + pb_cy;
-    float bbox_w = std::exp(var[2] * lc[2]) * pb_w;
-    float bbox_h = std::exp(var[3] * lc[3]) * pb_h;
-
-    bboxes[0 + index] = bbox_cx - bbox_w * 0.5f;
-    bboxes[1 + index] = bbox_cy - bbox_h * 0.5f;
-    bboxes[2 + index] = bbox_cx + bbox_w * 0.5f;
-    bboxes[3 + index] = bbox_cy + bbox_h * 0.5f;
-  }
+  float *bboxes_ptr = bboxes.data();
+  thread_pool->Compute1D([=](index_t start, index_t end, index_t step) {
+    for (index_t i = start; i < end; i += step) {
+      index_t index = i * 4;
+      const float *lc = loc_ptr + index;
+      const float *pb = pbox_ptr + index;
+      const float *var = pb + num_prior * 4;
+
+      float pb_w = pb[2] - pb[0];
+      float pb_h = pb[3] - pb[1];
+      float pb_cx = (pb[0] + pb[2]) * 0.5f;
+      float pb_cy = (pb[1] + pb[3]) * 0.5f;
+
+      float bbox_cx = var[0] * lc[0] * pb_w + pb_cx;
+      float bbox_cy = var[1] * lc[1] * pb_h + pb_cy;
+      float bbox_w = std::exp(var[2] * lc[2]) * pb_w;
+      float bbox_h = std::exp(var[3] * lc[3]) * pb_h;
+
+      bboxes_ptr[0 + index] = bbox_cx - bbox_w * 0.5f;
+      bboxes_ptr[1 + index] = bbox_cy - bbox_h * 0.5f;
+      bboxes_ptr[2 + index] = bbox_cx + bbox_w * 0.5f;
+      bboxes_ptr[3 + index] = bbox_cy + bbox_h * 0.5f;
+    }
+  }, 0, num_prior, 1, 0, 32);
+
   // Start from 1 to ignore background class
+  std::vector<std::vector<BBox>> class_candidates(num_classes);
+  std::vector<std::vector<BBox>> class_picked_boxes(num_classes);
+  std::vector<BBox> *class_candidates_ptr = class_candidates.data();
+  std::vector<BBox> *class_picked_ptr = class_picked_boxes.data();
+  thread_pool->Compute1D([=](index_t start, index_t end, index_t step) {
+    for (index_t i = start; i < end; i += step) {
+      // Filter by confidence threshold before sorting
+      std::vector<BBox> &candidates = class_candidates_ptr[i];
+      for (int j = 0; j < num_prior; ++j) {
+        float confidence = conf_ptr[j * num_classes + i];
+        if (confidence > confidence_threshold) {
+          BBox c = {bboxes_ptr[0 + j * 4],
+                    bboxes_ptr[1 + j * 4],
+                    bboxes_ptr[2 + j * 4],
+                    bboxes_ptr[3 + j * 4],
+                    static_cast<int>(i),
+                    confidence};
+          candidates.push_back(c);
+        }
+      }
+      SortTopK(top_k, &candidates);
 
-  for (int i = 1; i < num_classes; ++i) {
-    // Filter by confidence threshold
-    std::vector<BBox> class_bbox_rects;
-    for (int j = 0; j < num_prior; ++j) {
-      float confidence = conf_ptr[j * num_classes + i];
-      if (confidence > confidence_threshold) {
-        BBox c = {bboxes[0 + j * 4],
-                  bboxes[1 + j * 4],
-                  bboxes[2 + j * 4],
-                  bboxes[3 + j * 4],
-                  i,
-                  confidence};
-        class_bbox_rects.push_back(c);
+      // Apply nms
+      if (!fast_nms) {
+        NmsSortedBboxes(candidates, nms_threshold, class_picked_ptr + i);
       }
     }
-    std::sort(class_bbox_rects.begin(), class_bbox_rects.end(), cmp);
-
-    // Apply nms
-    std::vector<BBox> sorted_boxes;
-    NmsSortedBboxes(class_bbox_rects, nms_threshold,
-                    std::min(top_k, static_cast<int>(class_bbox_rects.size())),
-                    &sorted_boxes);
-    // Gather
-    bbox_rects->insert(bbox_rects->end(), sorted_boxes.begin(),
-                       sorted_boxes.end());
+  }, 1, num_classes, 1, 0, num_prior);
+  if (fast_nms) {
+    FastNmsSortedBboxes(thread_pool, class_candidates, nms_threshold,
+                        &class_picked_boxes);
   }
 
-  std::sort(bbox_rects->begin(), bbox_rects->end(), cmp);
+  // Gather
+  for (int i = 1; i < num_classes; ++i) {
+    bbox_rects->insert(bbox_rects->end(), class_picked_boxes[i].begin(),
+                       class_picked_boxes[i].end());
+  }
 
   // Output
-  int num_detected = keep_top_k < static_cast<int>(bbox_rects->size())
-                         ? keep_top_k
-                         : static_cast<int>(bbox_rects->size());
-  bbox_rects->resize(num_detected);
+  SortTopK(keep_top_k, bbox_rects);
 
-  return num_detected;
+  return static_cast<int>(bbox_rects->size());
 }
 }  // namespace mace
 
@@ -188,10 +339,10 @@ class DetectionOutputOp<RuntimeType::RT_CPU, T> : public DetectionOutput {
         nms_top_k_(Operation::GetOptionalArg<int>("nms_top_k", 100)),
         keep_top_k_(Operation::GetOptionalArg<int>("keep_top_k", 100)),
         confidence_threshold_(
-            Operation::GetOptionalArg<float>("confidence_threshold", 0.05f)) {}
+            Operation::GetOptionalArg<float>("confidence_threshold", 0.05f)),
+        fast_nms_(Operation::GetOptionalArg<int>("fast_nms", 0) == 1) {}
 
   MaceStatus Run(OpContext *context) override {
-    MACE_UNUSED(context);
     Tensor *output = this->Output(0);
 
     auto *loc_t = this->Input(0);
@@ -211,9 +362,10 @@ class DetectionOutputOp<RuntimeType::RT_CPU, T> : public DetectionOutput {
 
     std::vector<BBox> bbox_rects;
 
-    DetectionOutput_CLA(loc_ptr, conf_ptr, pbox_ptr, num_prior, num_classes_,
+    DetectionOutput_CLA(&context->runtime()->thread_pool(), loc_ptr,
+                        conf_ptr, pbox_ptr, num_prior, num_classes_,
                         nms_threshold_, nms_top_k_, keep_top_k_,
-                        confidence_threshold_, &bbox_rects);
+                        confidence_threshold_, fast_nms_, &bbox_rects);
 
     output->Clear();
     std::vector<index_t> output_shape = {1, 1,
@@ -226,6 +378,7 @@ class DetectionOutputOp<RuntimeType::RT_CPU, T> : public DetectionOutput {
     for (int i = 0; i < output_len; ++i) {
       auto *row = output_ptr + i * 7;
       auto &b = bbox_rects[i];
+      row[0] = 0;
       row[1] = b.label;
       row[2] = b.confidence;
       row[3] = b.xmin;
@@ -243,6 +396,7 @@ class DetectionOutputOp<RuntimeType::RT_CPU, T> : public DetectionOutput {
   int nms_top_k_;
   int keep_top_k_;
   float confidence_threshold_;
+  bool fast_nms_;
 };
 
 
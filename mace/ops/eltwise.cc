@@ -22,6 +22,7 @@
 #include <cmath>
 #include <functional>
 #include <memory>
+#include <numeric>
 #include <set>
 #include <utility>
 #include <vector>
@@ -32,6 +33,8 @@
 #include "mace/core/tensor.h"
 #include "mace/utils/memory.h"
 #include "mace/core/quantize.h"
+#include "mace/ops/common/simd.h"
+#include "mace/ops/common/transcendental.h"
 #ifdef MACE_ENABLE_OPENCL
 #include "mace/ops/opencl/image/eltwise.h"
 #include "mace/runtimes/opencl/transform/buffer_transformer.h"
@@ -40,910 +43,426 @@
 namespace mace {
 namespace ops {
 
-inline index_t GetIndex(const std::vector<index_t> &shape,
-                        const std::vector<index_t> &index) {
-  index_t idx = 0;
-  for (size_t i = 0; i < shape.size(); ++i) {
-    if (shape[i] > 1) {
-      idx = idx * shape[i] + index[i];
-    }
+// dst[i] = pow(base, exponent) of the element-wise or scalar base and
+// exponent, the float ones are vectorized.
+template<typename T, typename DstType>
+inline void PowArray(const T *base, const T *exponent, DstType *dst,
+                     const index_t size) {
+  for (index_t i = 0; i < size; ++i) {
+    dst[i] = std::pow(base[i], exponent[i]);
   }
-  return idx;
 }
 
-inline void IncreaseIndex(const std::vector<index_t> &shape,
-                          std::vector<index_t> *index) {
-  for (index_t i = static_cast<index_t>(shape.size()) - 1; i >= 0; --i) {
-    ++(*index)[i];
-    if ((*index)[i] >= shape[i]) {
-      (*index)[i] -= shape[i];
-    } else {
-      break;
-    }
+template<typename T, typename DstType>
+inline void PowArray(const T *base, const T exponent, DstType *dst,
+                     const index_t size) {
+  for (index_t i = 0; i < size; ++i) {
+    dst[i] = std::pow(base[i], exponent);
   }
 }
 
 template<typename T, typename DstType>
-inline void TensorGeneralBroadcastEltwise(
-    const OpContext *context,
-    const EltwiseType type,
-    const T *input0,
-    const T *input1,
-    const std::vector<float> &coeff,
-    const bool swapped,
+inline void PowArray(const T base, const T *exponent, DstType *dst,
+                     const index_t size) {
+  for (index_t i = 0; i < size; ++i) {
+    dst[i] = std::pow(base, exponent[i]);
+  }
+}
+
+inline void PowArray(const float *base, const float *exponent, float *dst,
+                     const index_t size) {
+  VectorPow(base, exponent, dst, size);
+}
+
+inline void PowArray(const float *base, const float exponent, float *dst,
+                     const index_t size) {
+  VectorPow(base, exponent, dst, size);
+}
+
+inline void PowArray(const float base, const float *exponent, float *dst,
+                     const index_t size) {
+  VectorPow(base, exponent, dst, size);
+}
+
+// The output shape of a broadcast with the dims of size 1 dropped and the
+// adjacent dims broadcasting the same inputs merged, so the innermost dim is
+// as long as possible. The strides are in elements, 0 if the input is
+// broadcast along the dim, and the innermost ones are 0 or 1.
+struct BroadcastDims {
+  std::vector<index_t> dims;
+  std::vector<index_t> strides0;
+  std::vector<index_t> strides1;
+};
+
+// The input shapes are of the rank of the output shape.
+inline BroadcastDims CollapseBroadcastDims(
     const std::vector<index_t> &input0_shape,
     const std::vector<index_t> &input1_shape,
-    const std::vector<index_t> &output_shape,
-    DstType *output) {
-  MACE_UNUSED(context);
+    const std::vector<index_t> &output_shape) {
+  BroadcastDims collapsed;
+  index_t size0 = 1;
+  index_t size1 = 1;
+  bool last_broadcast0 = false;
+  bool last_broadcast1 = false;
+  for (index_t i = static_cast<index_t>(output_shape.size()) - 1; i >= 0;
+       --i) {
+    if (output_shape[i] == 1) {
+      continue;
+    }
+    const bool broadcast0 = input0_shape[i] == 1;
+    const bool broadcast1 = input1_shape[i] == 1;
+    if (!collapsed.dims.empty() && broadcast0 == last_broadcast0 &&
+        broadcast1 == last_broadcast1) {
+      collapsed.dims.back() *= output_shape[i];
+    } else {
+      collapsed.dims.push_back(output_shape[i]);
+      collapsed.strides0.push_back(broadcast0 ? 0 : size0);
+      collapsed.strides1.push_back(broadcast1 ? 0 : size1);
+      last_broadcast0 = broadcast0;
+      last_broadcast1 = broadcast1;
+    }
+    size0 *= input0_shape[i];
+    size1 *= input1_shape[i];
+  }
+  if (collapsed.dims.empty()) {
+    collapsed.dims.push_back(1);
+    collapsed.strides0.push_back(1);
+    collapsed.strides1.push_back(1);
+  }
+  std::reverse(collapsed.dims.begin(), collapsed.dims.end());
+  std::reverse(collapsed.strides0.begin(), collapsed.strides0.end());
+  std::reverse(collapsed.strides1.begin(), collapsed.strides1.end());
+  return collapsed;
+}
 
-  const index_t output_size = std::accumulate(
-      output_shape.begin(), output_shape.end(), 1, std::multiplies<index_t>());
-  std::vector<index_t> out_index(output_shape.size(), 0);
+// out[i] = a[i * stride_a] op b[i * stride_b] for a row of the innermost
+// dim. The unary types use a only.
+template<typename T, typename DstType>
+inline void EltwiseRow(const EltwiseType type,
+                       const std::vector<float> &coeff,
+                       const T *a,
+                       const index_t stride_a,
+                       const T *b,
+                       const index_t stride_b,
+                       DstType *out,
+                       const index_t size) {
   switch (type) {
     case SUM:
       if (coeff.empty()) {
-        for (index_t i = 0; i < output_size; ++i) {
-          const index_t idx0 = GetIndex(input0_shape, out_index);
-          const index_t idx1 = GetIndex(input1_shape, out_index);
-          output[i] = input0[idx0] + input1[idx1];
-          IncreaseIndex(output_shape, &out_index);
+        for (index_t i = 0; i < size; ++i) {
+          out[i] = a[i * stride_a] + b[i * stride_b];
         }
       } else {
-        std::vector<float> coeff_copy = coeff;
-        if (swapped) {
-          std::swap(coeff_copy[0], coeff_copy[1]);
-        }
-        for (index_t i = 0; i < output_size; ++i) {
-          const index_t idx0 = GetIndex(input0_shape, out_index);
-          const index_t idx1 = GetIndex(input1_shape, out_index);
-          output[i] =
-              input0[idx0] * coeff_copy[0] + input1[idx1] * coeff_copy[1];
-          IncreaseIndex(output_shape, &out_index);
+        for (index_t i = 0; i < size; ++i) {
+          out[i] = a[i * stride_a] * coeff[0] + b[i * stride_b] * coeff[1];
         }
       }
       break;
     case SUB:
-      if (!swapped) {
-        for (index_t i = 0; i < output_size; ++i) {
-          const index_t idx0 = GetIndex(input0_shape, out_index);
-          const index_t idx1 = GetIndex(input1_shape, out_index);
-          output[i] = input0[idx0] - input1[idx1];
-          IncreaseIndex(output_shape, &out_index);
-        }
-      } else {
-        for (index_t i = 0; i < output_size; ++i) {
-          const index_t idx0 = GetIndex(input0_shape, out_index);
-          const index_t idx1 = GetIndex(input1_shape, out_index);
-          output[i] = input1[idx1] - input0[idx0];
-          IncreaseIndex(output_shape, &out_index);
-        }
+      for (index_t i = 0; i < size; ++i) {
+        out[i] = a[i * stride_a] - b[i * stride_b];
       }
       break;
     case PROD:
-      for (index_t i = 0; i < output_size; ++i) {
-        const index_t idx0 = GetIndex(input0_shape, out_index);
-        const index_t idx1 = GetIndex(input1_shape, out_index);
-        output[i] = input0[idx0] * input1[idx1];
-        IncreaseIndex(output_shape, &out_index);
+      for (index_t i = 0; i < size; ++i) {
+        out[i] = a[i * stride_a] * b[i * stride_b];
       }
       break;
     case DIV:
-      if (!swapped) {
-        for (index_t i = 0; i < output_size; ++i) {
-          const index_t idx0 = GetIndex(input0_shape, out_index);
-          const index_t idx1 = GetIndex(input1_shape, out_index);
-          output[i] = input0[idx0] / input1[idx1];
-          IncreaseIndex(output_shape, &out_index);
-        }
-      } else {
-        for (index_t i = 0; i < output_size; ++i) {
-          const index_t idx0 = GetIndex(input0_shape, out_index);
-          const index_t idx1 = GetIndex(input1_shape, out_index);
-          output[i] = input1[idx1] / input0[idx0];
-          IncreaseIndex(output_shape, &out_index);
-        }
+      for (index_t i = 0; i < size; ++i) {
+        out[i] = a[i * stride_a] / b[i * stride_b];
       }
       break;
     case FLOOR_DIV:
-      if (!swapped) {
-        for (index_t i = 0; i < output_size; ++i) {
-          const index_t idx0 = GetIndex(input0_shape, out_index);
-          const index_t idx1 = GetIndex(input1_shape, out_index);
-          output[i] = std::floor(input0[idx0] / input1[idx1]);
-          IncreaseIndex(output_shape, &out_index);
-        }
-      } else {
-        for (index_t i = 0; i < output_size; ++i) {
-          const index_t idx0 = GetIndex(input0_shape, out_index);
-          const index_t idx1 = GetIndex(input1_shape, out_index);
-          output[i] = std::floor(input1[idx1] / input0[idx0]);
-          IncreaseIndex(output_shape, &out_index);
-        }
+      for (index_t i = 0; i < size; ++i) {
+        out[i] = std::floor(a[i * stride_a] / b[i * stride_b]);
       }
       break;
     case MIN:
-      for (index_t i = 0; i < output_size; ++i) {
-        const index_t idx0 = GetIndex(input0_shape, out_index);
-        const index_t idx1 = GetIndex(input1_shape, out_index);
-        output[i] = std::min(input1[idx1], input0[idx0]);
-        IncreaseIndex(output_shape, &out_index);
+      for (index_t i = 0; i < size; ++i) {
+        out[i] = std::min(a[i * stride_a], b[i * stride_b]);
       }
       break;
     case MAX:
-      for (index_t i = 0; i < output_size; ++i) {
-        const index_t idx0 = GetIndex(input0_shape, out_index);
-        const index_t idx1 = GetIndex(input1_shape, out_index);
-        output[i] = std::max(input1[idx1], input0[idx0]);
-        IncreaseIndex(output_shape, &out_index);
+      for (index_t i = 0; i < size; ++i) {
+        out[i] = std::max(a[i * stride_a], b[i * stride_b]);
       }
       break;
     case SQR_DIFF:
-      for (index_t i = 0; i < output_size; ++i) {
-        const index_t idx0 = GetIndex(input0_shape, out_index);
-        const index_t idx1 = GetIndex(input1_shape, out_index);
-        output[i] = std::pow(input1[idx1] - input0[idx0], 2.f);
-        IncreaseIndex(output_shape, &out_index);
+      for (index_t i = 0; i < size; ++i) {
+        out[i] = std::pow(a[i * stride_a] - b[i * stride_b], 2.f);
       }
       break;
     case POW:
-      if (!swapped) {
-        for (index_t i = 0; i < output_size; ++i) {
-          const index_t idx0 = GetIndex(input0_shape, out_index);
-          const index_t idx1 = GetIndex(input1_shape, out_index);
-          output[i] = std::pow(input0[idx0], input1[idx1]);
-          IncreaseIndex(output_shape, &out_index);
-        }
+      if (stride_a == 0) {
+        PowArray(a[0], b, out, size);
+      } else if (stride_b == 0) {
+        PowArray(a, b[0], out, size);
       } else {
-        for (index_t i = 0; i < output_size; ++i) {
-          const index_t idx0 = GetIndex(input0_shape, out_index);
-          const index_t idx1 = GetIndex(input1_shape, out_index);
-          output[i] = std::pow(input1[idx1], input0[idx0]);
-          IncreaseIndex(output_shape, &out_index);
-        }
+        PowArray(a, b, out, size);
+      }
+      break;
+    case NEG:
+      for (index_t i = 0; i < size; ++i) {
+        out[i] = -a[i * stride_a];
+      }
+      break;
+    case ABS:
+      for (index_t i = 0; i < size; ++i) {
+        out[i] = std::fabs(a[i * stride_a]);
       }
       break;
     case EQUAL:
-      for (index_t i = 0; i < output_size; ++i) {
-        const index_t idx0 = GetIndex(input0_shape, out_index);
-        const index_t idx1 = GetIndex(input1_shape, out_index);
-        output[i] = input1[idx1] == input0[idx0];
-        IncreaseIndex(output_shape, &out_index);
+      for (index_t i = 0; i < size; ++i) {
+        out[i] = a[i * stride_a] == b[i * stride_b];
       }
       break;
     case NOT_EQUAL:
-      for (index_t i = 0; i < output_size; ++i) {
-        const index_t idx0 = GetIndex(input0_shape, out_index);
-        const index_t idx1 = GetIndex(input1_shape, out_index);
-        output[i] = input1[idx1] != input0[idx0];
-        IncreaseIndex(output_shape, &out_index);
+      for (index_t i = 0; i < size; ++i) {
+        out[i] = a[i * stride_a] != b[i * stride_b];
+      }
+      break;
+    case CLIP:
+      for (index_t i = 0; i < size; ++i) {
+        out[i] = std::fmaxf(coeff[0], std::fminf(coeff[1], a[i * stride_a]));
+      }
+      break;
+    case SIGN:
+      for (index_t i = 0; i < size; ++i) {
+        out[i] = Sign(a[i * stride_a]);
       }
       break;
     default:LOG(FATAL) << "Eltwise op not support type " << type;
   }
 }
 
-template<typename T, typename DstType>
-inline void TensorBroadcastEltwise(const OpContext *context,
-                                   const EltwiseType type,
-                                   const T *input0,
-                                   const T *input1,
-                                   const std::vector<float> &coeff,
-                                   const index_t diff_size,
-                                   const index_t common_size,
-                                   const bool swapped,
-                                   DstType *output) {
-  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+struct VecSumOp {
+  VecF operator()(VecF a, VecF b) const { return VecAdd(a, b); }
+};
 
-  thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
-                            index_t start1, index_t end1, index_t step1) {
-    switch (type) {
-      case SUM:
-        if (coeff.empty()) {
-          for (index_t d = start0; d < end0; d += step0) {
-            index_t offset = d * common_size;
-            for (index_t i = start1; i < end1; i += step1) {
-              output[i + offset] = input0[i + offset] + input1[i];
-            }
-          }
-        } else {
-          std::vector<float> coeff_copy = coeff;
-          if (swapped) {
-            std::swap(coeff_copy[0], coeff_copy[1]);
-          }
-          for (index_t d = start0; d < end0; d += step0) {
-            index_t offset = d * common_size;
-            for (index_t i = start1; i < end1; i += step1) {
-              output[i + offset] = input0[i + offset] * coeff_copy[0] +
-                                   input1[i] * coeff_copy[1];
-            }
-          }
-        }
-        break;
-      case SUB:
-        if (!swapped) {
-          for (index_t d = start0; d < end0; d += step0) {
-            index_t offset = d * common_size;
-            for (index_t i = start1; i < end1; i += step1) {
-              output[i + offset] = input0[i + offset] - input1[i];
-            }
-          }
-        } else {
-          for (index_t d = start0; d < end0; d += step0) {
-            index_t offset = d * common_size;
-            for (index_t i = start1; i < end1; i += step1) {
-              output[i + offset] = input1[i] - input0[i + offset];
-            }
-          }
-        }
-        break;
-      case PROD:
-        for (index_t d = start0; d < end0; d += step0) {
-          index_t offset = d * common_size;
-          for (index_t i = start1; i < end1; i += step1) {
-            output[i + offset] = input0[i + offset] * input1[i];
-          }
-        }
-        break;
-      case DIV:
-        if (!swapped) {
-          for (index_t d = start0; d < end0; d += step0) {
-            index_t offset = d * common_size;
-            for (index_t i = start1; i < end1; i += step1) {
-              output[i + offset] = input0[i + offset] / input1[i];
-            }
-          }
-        } else {
-          for (index_t d = start0; d < end0; d += step0) {
-            index_t offset = d * common_size;
-            for (index_t i = start1; i < end1; i += step1) {
-              output[i + offset] = input1[i] / input0[i + offset];
-            }
-          }
-        }
-        break;
-      case FLOOR_DIV:
-        if (!swapped) {
-          for (index_t d = start0; d < end0; d += step0) {
-            index_t offset = d * common_size;
-            for (index_t i = start1; i < end1; i += step1) {
-              output[i + offset] = std::floor(input0[i + offset] / input1[i]);
-            }
-          }
-        } else {
-          for (index_t d = start0; d < end0; d += step0) {
-            index_t offset = d * common_size;
-            for (index_t i = start1; i < end1; i += step1) {
-              output[i + offset] = std::floor(input1[i] / input0[i + offset]);
-            }
-          }
-        }
-        break;
-      case MIN:
-        for (index_t d = start0; d < end0; d += step0) {
-          index_t offset = d * common_size;
-          for (index_t i = start1; i < end1; i += step1) {
-            output[i + offset] = std::min(input0[i + offset], input1[i]);
-          }
-        }
-        break;
-      case MAX:
-        for (index_t d = start0; d < end0; d += step0) {
-          index_t offset = d * common_size;
-          for (index_t i = start1; i < end1; i += step1) {
-            output[i + offset] = std::max(input0[i + offset], input1[i]);
-          }
-        }
-        break;
-      case SQR_DIFF:
-        for (index_t d = start0; d < end0; d += step0) {
-          index_t offset = d * common_size;
-          for (index_t i = start1; i < end1; i += step1) {
-            output[i + offset] = std::pow(input0[i + offset] - input1[i], 2.f);
-          }
-        }
-        break;
-      case POW:
-        if (!swapped) {
-          for (index_t d = start0; d < end0; d += step0) {
-            index_t offset = d * common_size;
-            for (index_t i = start1; i < end1; i += step1) {
-              output[i + offset] = std::pow(input0[i + offset], input1[i]);
-            }
-          }
-        } else {
-          for (index_t d = start0; d < end0; d += step0) {
-            index_t offset = d * common_size;
-            for (index_t i = start1; i < end1; i += step1) {
-              output[i + offset] = std::pow(input1[i], input0[i + offset]);
-            }
-          }
-        }
-        break;
-      case NEG:
-        for (index_t d = start0; d < end0; d += step0) {
-          index_t offset = d * common_size;
-          for (index_t i = start1; i < end1; i += step1) {
-            output[i + offset] = -input0[i + offset];
-          }
-        }
-        break;
-      case ABS:
-        for (index_t d = start0; d < end0; d += step0) {
-          index_t offset = d * common_size;
-          for (index_t i = start1; i < end1; i += step1) {
-            output[i + offset] = std::fabs(input0[i + offset]);
-          }
-        }
-        break;
-      case EQUAL:
-        for (index_t d = start0; d < end0; d += step0) {
-          index_t offset = d * common_size;
-          for (index_t i = start1; i < end1; i += step1) {
-            output[i + offset] = input0[i + offset] == input1[i];
-          }
-        }
-        break;
-      case NOT_EQUAL:
-        for (index_t d = start0; d < end0; d += step0) {
-          index_t offset = d * common_size;
-          for (index_t i = start1; i < end1; i += step1) {
-            output[i + offset] = input0[i + offset] != input1[i];
-          }
-        }
-        break;
-      case CLIP:
-        for (index_t d = start0; d < end0; d += step0) {
-          index_t offset = d * common_size;
-          for (index_t i = start1; i < end1; i += step1) {
-            output[i + offset] =
-                std::fmaxf(coeff[0], std::fminf(coeff[1], input0[i + offset]));
-          }
-        }
-        break;
-      case SIGN:
-        for (index_t d = start0; d < end0; d += step0) {
-          index_t offset = d * common_size;
-          for (index_t i = start1; i < end1; i += step1) {
-            output[i + offset] = Sign(input0[i + offset]);
-          }
-        }
-        break;
-      default:LOG(FATAL) << "Eltwise op not support type " << type;
-    }
-  }, 0, diff_size, 1, 0, common_size, 1);
-}
+struct VecSumCoeffOp {
+  VecF coeff0;
+  VecF coeff1;
+  VecF operator()(VecF a, VecF b) const {
+    return VecAdd(VecMul(a, coeff0), VecMul(b, coeff1));
+  }
+};
 
-// Multiplication is costly, so we specialize the following case.
-template<typename T, typename DstType>
-inline void TensorEltwise(const OpContext *context,
-                          const EltwiseType type,
-                          const T *input0,
-                          const T *input1,
-                          const std::vector<float> &coeff,
-                          const index_t size,
-                          const bool swapped,
-                          DstType *output) {
-  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+struct VecSubOp {
+  VecF operator()(VecF a, VecF b) const { return VecSub(a, b); }
+};
 
-  thread_pool.Compute1D([=](index_t start, index_t end, index_t step) {
-    switch (type) {
-      case SUM:
-        if (coeff.empty()) {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = input0[i] + input1[i];
-          }
-        } else {
-          std::vector<float> coeff_copy = coeff;
-          if (swapped) {
-            std::swap(coeff_copy[0], coeff_copy[1]);
-          }
-          for (index_t i = start; i < end; i += step) {
-            output[i] = input0[i] * coeff_copy[0] + input1[i] * coeff_copy[1];
-          }
-        }
-        break;
-      case SUB:
-        if (!swapped) {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = input0[i] - input1[i];
-          }
-        } else {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = input1[i] - input0[i];
-          }
-        }
-        break;
-      case PROD:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = input0[i] * input1[i];
-        }
-        break;
-      case DIV:
-        if (!swapped) {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = input0[i] / input1[i];
-          }
+struct VecProdOp {
+  VecF operator()(VecF a, VecF b) const { return VecMul(a, b); }
+};
 
-        } else {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = input1[i] / input0[i];
-          }
-        }
-        break;
-      case FLOOR_DIV:
-        if (!swapped) {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = std::floor(input0[i] / input1[i]);
-          }
-        } else {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = std::floor(input1[i] / input0[i]);
-          }
-        }
-        break;
-      case MIN:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = std::min(input0[i], input1[i]);
-        }
-        break;
-      case MAX:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = std::max(input0[i], input1[i]);
-        }
-        break;
-      case SQR_DIFF:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = std::pow(input0[i] - input1[i], 2.f);
-        }
-        break;
-      case POW:
-        if (!swapped) {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = std::pow(input0[i], input1[i]);
-          }
-        } else {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = std::pow(input1[i], input0[i]);
-          }
-        }
-        break;
-      case NEG:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = -input0[i];
-        }
-        break;
-      case ABS:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = std::fabs(input0[i]);
-        }
-        break;
-      case EQUAL:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = input0[i] == input1[i];
-        }
-        break;
-      case NOT_EQUAL:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = input0[i] != input1[i];
-        }
-        break;
-      case CLIP:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = std::fmaxf(coeff[0], std::fminf(coeff[1], input0[i]));
-        }
-        break;
-      case SIGN:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = Sign(input0[i]);
-        }
-        break;
-      default:LOG(FATAL) << "Eltwise op not support type " << type;
-    }
-  }, 0, size, 1);
-}
+struct VecDivOp {
+  VecF operator()(VecF a, VecF b) const { return VecDiv(a, b); }
+};
 
-// Multiplication is costly, so we specialize the following case.
-template<typename T, typename DstType>
-inline void TensorScalarEltwise(const OpContext *context,
-                                const EltwiseType type,
-                                const T *input0,
-                                const T input1,
-                                const std::vector<float> &coeff,
-                                const index_t size,
-                                const bool swapped,
-                                DstType *output) {
-  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+struct VecFloorDivOp {
+  VecF operator()(VecF a, VecF b) const { return VecFloor(VecDiv(a, b)); }
+};
 
-  thread_pool.Compute1D([=](index_t start, index_t end, index_t step) {
-    switch (type) {
-      case SUM:
-        if (coeff.empty()) {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = input0[i] + input1;
-          }
+struct VecMinOp {
+  VecF operator()(VecF a, VecF b) const { return VecMin(a, b); }
+};
 
-        } else {
-          std::vector<float> coeff_copy = coeff;
-          if (swapped) {
-            std::swap(coeff_copy[0], coeff_copy[1]);
-          }
-          for (index_t i = start; i < end; i += step) {
-            output[i] = input0[i] * coeff_copy[0] + input1 * coeff_copy[1];
-          }
-        }
-        break;
-      case SUB:
-        if (!swapped) {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = input0[i] - input1;
-          }
+struct VecMaxOp {
+  VecF operator()(VecF a, VecF b) const { return VecMax(a, b); }
+};
 
-        } else {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = input1 - input0[i];
-          }
-        }
-        break;
-      case PROD:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = input0[i] * input1;
-        }
-        break;
-      case DIV:
-        if (!swapped) {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = input0[i] / input1;
-          }
+struct VecSqrDiffOp {
+  VecF operator()(VecF a, VecF b) const {
+    const VecF diff = VecSub(a, b);
+    return VecMul(diff, diff);
+  }
+};
 
-        } else {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = input1 / input0[i];
-          }
-        }
-        break;
-      case FLOOR_DIV:
-        if (!swapped) {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = std::floor(input0[i] / input1);
-          }
-        } else {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = std::floor(input1 / input0[i]);
-          }
-        }
-        break;
-      case MIN:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = std::min(input0[i], input1);
-        }
+struct VecNegOp {
+  VecF operator()(VecF a, VecF) const { return VecMul(a, VecSet1(-1.f)); }
+};
 
-        break;
-      case MAX:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = std::max(input0[i], input1);
-        }
+struct VecAbsOp {
+  VecF operator()(VecF a, VecF) const { return VecAbs(a); }
+};
 
-        break;
-      case SQR_DIFF:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = std::pow(input0[i] - input1, 2.f);
-        }
+// fmaxf(min, fminf(max, a)), a NaN is clipped to max.
+struct VecClipOp {
+  VecF min;
+  VecF max;
+  VecF operator()(VecF a, VecF) const { return VecMax(VecMin(a, max), min); }
+};
 
-        break;
-      case POW:
-        if (!swapped) {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = std::pow(input0[i], input1);
-          }
-        } else {
-          for (index_t i = start; i < end; i += step) {
-            output[i] = std::pow(input1, input0[i]);
-          }
-        }
-        break;
-      case NEG:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = -input0[i];
-        }
-        break;
-      case ABS:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = std::fabs(input0[i]);
-        }
-        break;
-      case EQUAL:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = input0[i] == input1;
-        }
-        break;
-      case NOT_EQUAL:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = input0[i] != input1;
-        }
-        break;
-      case CLIP:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = std::fmaxf(coeff[0], std::fminf(coeff[1], input0[i]));
-        }
-        break;
-      case SIGN:
-        for (index_t i = start; i < end; i += step) {
-          output[i] = Sign(input0[i]);
-        }
-        break;
-      default:LOG(FATAL) << "Eltwise op not support type " << type;
+struct VecSignOp {
+  VecF operator()(VecF a, VecF) const {
+    const VecF zero = VecZero();
+    const VecF one = VecSet1(1.f);
+    return VecSub(VecSelectLess(zero, a, one, zero),
+                  VecSelectLess(a, zero, one, zero));
+  }
+};
+
+// The row of EltwiseRow with the strides known at compile time, the tail is
+// computed in a padded vector. An element of a or b is read before out is
+// written at its offset, so out may be a or b.
+template<index_t StrideA, index_t StrideB, typename Op>
+inline void VecEltwiseRow(const Op &op,
+                          const float *a,
+                          const float *b,
+                          float *out,
+                          const index_t size) {
+  const VecF a0 = VecSet1(a[0]);
+  const VecF b0 = VecSet1(b[0]);
+  index_t i = 0;
+  for (; i + kVecFLanes <= size; i += kVecFLanes) {
+    const VecF va = StrideA == 0 ? a0 : VecLoad(a + i);
+    const VecF vb = StrideB == 0 ? b0 : VecLoad(b + i);
+    VecStore(out + i, op(va, vb));
+  }
+  if (i < size) {
+    const index_t tail = size - i;
+    float tile_a[kVecFLanes] = {0};
+    float tile_b[kVecFLanes] = {0};
+    for (index_t j = 0; j < tail; ++j) {
+      tile_a[j] = a[(i + j) * StrideA];
+      tile_b[j] = b[(i + j) * StrideB];
+    }
+    VecStore(tile_a, op(VecLoad(tile_a), VecLoad(tile_b)));
+    std::copy(tile_a, tile_a + tail, out + i);
+  }
+}
+
+template<typename Op>
+inline void VecEltwiseRow(const Op &op,
+                          const float *a,
+                          const index_t stride_a,
+                          const float *b,
+                          const index_t stride_b,
+                          float *out,
+                          const index_t size) {
+  if (stride_a == 0) {
+    VecEltwiseRow<0, 1>(op, a, b, out, size);
+  } else if (stride_b == 0) {
+    VecEltwiseRow<1, 0>(op, a, b, out, size);
+  } else {
+    VecEltwiseRow<1, 1>(op, a, b, out, size);
+  }
+}
+
+// The float rows are vectorized.
+inline void EltwiseRow(const EltwiseType type,
+                       const std::vector<float> &coeff,
+                       const float *a,
+                       const index_t stride_a,
+                       const float *b,
+                       const index_t stride_b,
+                       float *out,
+                       const index_t size) {
+  switch (type) {
+    case SUM:
+      if (coeff.empty()) {
+        VecEltwiseRow(VecSumOp(), a, stride_a, b, stride_b, out, size);
+      } else {
+        const VecSumCoeffOp op = {VecSet1(coeff[0]), VecSet1(coeff[1])};
+        VecEltwiseRow(op, a, stride_a, b, stride_b, out, size);
+      }
+      break;
+    case SUB:
+      VecEltwiseRow(VecSubOp(), a, stride_a, b, stride_b, out, size);
+      break;
+    case PROD:
+      VecEltwiseRow(VecProdOp(), a, stride_a, b, stride_b, out, size);
+      break;
+    case DIV:
+      VecEltwiseRow(VecDivOp(), a, stride_a, b, stride_b, out, size);
+      break;
+    case FLOOR_DIV:
+      VecEltwiseRow(VecFloorDivOp(), a, stride_a, b, stride_b, out, size);
+      break;
+    case MIN:
+      VecEltwiseRow(VecMinOp(), a, stride_a, b, stride_b, out, size);
+      break;
+    case MAX:
+      VecEltwiseRow(VecMaxOp(), a, stride_a, b, stride_b, out, size);
+      break;
+    case SQR_DIFF:
+      VecEltwiseRow(VecSqrDiffOp(), a, stride_a, b, stride_b, out, size);
+      break;
+    case NEG:
+      VecEltwiseRow(VecNegOp(), a, stride_a, a, stride_a, out, size);
+      break;
+    case ABS:
+      VecEltwiseRow(VecAbsOp(), a, stride_a, a, stride_a, out, size);
+      break;
+    case CLIP: {
+      const VecClipOp op = {VecSet1(coeff[0]), VecSet1(coeff[1])};
+      VecEltwiseRow(op, a, stride_a, a, stride_a, out, size);
+      break;
     }
-  }, 0, size, 1);
+    case SIGN:
+      VecEltwiseRow(VecSignOp(), a, stride_a, a, stride_a, out, size);
+      break;
+    default:
+      EltwiseRow<float, float>(type, coeff, a, stride_a, b, stride_b, out,
+                               size);
+  }
 }
 
+// The element-wise op of the inputs broadcast to the output by the dims.
+// The rows of the innermost dim are split among the threads, and so are the
+// rows themselves if they are few.
 template<typename T, typename DstType>
-inline void TensorEltwisePerChannel(const OpContext *context,
-                                    const EltwiseType type,
-                                    const T *input0,
-                                    const T *input1,
-                                    const std::vector<float> &coeff,
-                                    const index_t batch0,
-                                    const index_t batch1,
-                                    const index_t channel,
-                                    const index_t image_size,
-                                    const bool swapped,
-                                    DstType *output) {
+inline void TensorBroadcastEltwise(const OpContext *context,
+                                   const EltwiseType type,
+                                   const std::vector<float> &coeff,
+                                   const BroadcastDims &dims,
+                                   const T *input0,
+                                   const T *input1,
+                                   DstType *output) {
+  const index_t outer_rank = static_cast<index_t>(dims.dims.size()) - 1;
+  const index_t row_size = dims.dims.back();
+  const index_t stride0 = dims.strides0.back();
+  const index_t stride1 = dims.strides1.back();
+  const index_t rows = std::accumulate(dims.dims.begin(),
+                                       dims.dims.end() - 1, index_t(1),
+                                       std::multiplies<index_t>());
   utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
 
-  thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
-                            index_t start1, index_t end1, index_t step1) {
-    switch (type) {
-      case SUM:
-        if (coeff.empty()) {
-          for (index_t b = start0; b < end0; b += step0) {
-            index_t offset = b * channel;
-            for (index_t c = start1; c < end1; c += step1) {
-              const T *in0_ptr = input0 + (offset + c) * image_size;
-              const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-              DstType *out_ptr = output + (offset + c) * image_size;
-              for (index_t i = 0; i < image_size; ++i) {
-                out_ptr[i] = in0_ptr[i] + in1_ptr[c];
-              }
-            }
-          }
-        } else {
-          std::vector<float> coeff_copy = coeff;
-          if (swapped) {
-            std::swap(coeff_copy[0], coeff_copy[1]);
-          }
-          for (index_t b = start0; b < end0; b += step0) {
-            index_t offset = b * channel;
-            for (index_t c = start1; c < end1; c += step1) {
-              const T *in0_ptr = input0 + (offset + c) * image_size;
-              const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-              DstType *out_ptr = output + (offset + c) * image_size;
-              for (index_t i = 0; i < image_size; ++i) {
-                out_ptr[i] =
-                    in0_ptr[i] * coeff_copy[0] + in1_ptr[c] * coeff_copy[1];
-              }
-            }
-          }
-        }
-        break;
-      case SUB:
-        if (!swapped) {
-          for (index_t b = start0; b < end0; b += step0) {
-            index_t offset = b * channel;
-            for (index_t c = start1; c < end1; c += step1) {
-              const T *in0_ptr = input0 + (offset + c) * image_size;
-              const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-              DstType *out_ptr = output + (offset + c) * image_size;
-              for (index_t i = 0; i < image_size; ++i) {
-                out_ptr[i] = in0_ptr[i] - in1_ptr[c];
-              }
-            }
-          }
-        } else {
-          for (index_t b = start0; b < end0; b += step0) {
-            index_t offset = b * channel;
-            for (index_t c = start1; c < end1; c += step1) {
-              const T *in0_ptr = input0 + (offset + c) * image_size;
-              const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-              DstType *out_ptr = output + (offset + c) * image_size;
-              for (index_t i = 0; i < image_size; ++i) {
-                out_ptr[i] = in1_ptr[c] - in0_ptr[i];
-              }
-            }
-          }
-        }
-        break;
-      case PROD:
-        for (index_t b = start0; b < end0; b += step0) {
-          index_t offset = b * channel;
-          for (index_t c = start1; c < end1; c += step1) {
-            const T *in0_ptr = input0 + (offset + c) * image_size;
-            const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-            DstType *out_ptr = output + (offset + c) * image_size;
-            for (index_t i = 0; i < image_size; ++i) {
-              out_ptr[i] = in0_ptr[i] * in1_ptr[c];
-            }
-          }
-        }
-        break;
-      case DIV:
-        if (!swapped) {
-          for (index_t b = start0; b < end0; b += step0) {
-            index_t offset = b * channel;
-            for (index_t c = start1; c < end1; c += step1) {
-              const T *in0_ptr = input0 + (offset + c) * image_size;
-              const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-              DstType *out_ptr = output + (offset + c) * image_size;
-              for (index_t i = 0; i < image_size; ++i) {
-                out_ptr[i] = in0_ptr[i] / in1_ptr[c];
-              }
-            }
-          }
-        } else {
-          for (index_t b = start0; b < end0; b += step0) {
-            index_t offset = b * channel;
-            for (index_t c = start1; c < end1; c += step1) {
-              const T *in0_ptr = input0 + (offset + c) * image_size;
-              const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-              DstType *out_ptr = output + (offset + c) * image_size;
-              for (index_t i = 0; i < image_size; ++i) {
-                out_ptr[i] = in1_ptr[c] / in0_ptr[i];
-              }
-            }
-          }
-        }
-        break;
-      case FLOOR_DIV:
-        if (!swapped) {
-          for (index_t b = start0; b < end0; b += step0) {
-            index_t offset = b * channel;
-            for (index_t c = start1; c < end1; c += step1) {
-              const T *in0_ptr = input0 + (offset + c) * image_size;
-              const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-              DstType *out_ptr = output + (offset + c) * image_size;
-              for (index_t i = 0; i < image_size; ++i) {
-                out_ptr[i] = std::floor(in0_ptr[i] / in1_ptr[c]);
-              }
-            }
-          }
-        } else {
-          for (index_t b = start0; b < end0; b += step0) {
-            index_t offset = b * channel;
-            for (index_t c = start1; c < end1; c += step1) {
-              const T *in0_ptr = input0 + (offset + c) * image_size;
-              const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-              DstType *out_ptr = output + (offset + c) * image_size;
-              for (index_t i = 0; i < image_size; ++i) {
-                out_ptr[i] = std::floor(in1_ptr[c] / in0_ptr[i]);
-              }
-            }
-          }
-        }
-        break;
-      case MIN:
-        for (index_t b = start0; b < end0; b += step0) {
-          index_t offset = b * channel;
-          for (index_t c = start1; c < end1; c += step1) {
-            const T *in0_ptr = input0 + (offset + c) * image_size;
-            const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-            DstType *out_ptr = output + (offset + c) * image_size;
-            for (index_t i = 0; i < image_size; ++i) {
-              out_ptr[i] = std::min(in0_ptr[i], in1_ptr[c]);
-            }
-          }
-        }
-        break;
-      case MAX:
-        for (index_t b = start0; b < end0; b += step0) {
-          index_t offset = b * channel;
-          for (index_t c = start1; c < end1; c += step1) {
-            const T *in0_ptr = input0 + (offset + c) * image_size;
-            const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-            DstType *out_ptr = output + (offset + c) * image_size;
-            for (index_t i = 0; i < image_size; ++i) {
-              out_ptr[i] = std::max(in0_ptr[i], in1_ptr[c]);
-            }
-          }
-        }
-        break;
-      case SQR_DIFF:
-        for (index_t b = start0; b < end0; b += step0) {
-          index_t offset = b * channel;
-          for (index_t c = start1; c < end1; c += step1) {
-            const T *in0_ptr = input0 + (offset + c) * image_size;
-            const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-            DstType *out_ptr = output + (offset + c) * image_size;
-            for (index_t i = 0; i < image_size; ++i) {
-              out_ptr[i] = std::pow(in0_ptr[i] - in1_ptr[c], 2.f);
-            }
-          }
-        }
-        break;
-      case POW:
-        if (!swapped) {
-          for (index_t b = start0; b < end0; b += step0) {
-            index_t offset = b * channel;
-            for (index_t c = start1; c < end1; c += step1) {
-              const T *in0_ptr = input0 + (offset + c) * image_size;
-              const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-              DstType *out_ptr = output + (offset + c) * image_size;
-              for (index_t i = 0; i < image_size; ++i) {
-                out_ptr[i] = std::pow(in0_ptr[i], in1_ptr[c]);
-              }
-            }
-          }
-        } else {
-          for (index_t b = start0; b < end0; b += step0) {
-            index_t offset = b * channel;
-            for (index_t c = start1; c < end1; c += step1) {
-              const T *in0_ptr = input0 + (offset + c) * image_size;
-              const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-              DstType *out_ptr = output + (offset + c) * image_size;
-              for (index_t i = 0; i < image_size; ++i) {
-                out_ptr[i] = std::pow(in1_ptr[c], in0_ptr[i]);
-              }
-            }
-          }
-        }
-        break;
-      case NEG:
-        for (index_t b = start0; b < end0; b += step0) {
-          index_t offset = b * channel;
-          for (index_t c = start1; c < end1; c += step1) {
-            DstType *out_ptr = output + (offset + c) * image_size;
-            for (index_t i = 0; i < image_size; ++i) {
-              out_ptr[i] = -input0[i];
-            }
-          }
-        }
-        break;
-      case ABS:
-        for (index_t b = start0; b < end0; b += step0) {
-          for (index_t c = start1; c < end1; c += step1) {
-            for (index_t i = 0; i < image_size; ++i) {
-              output[i] = std::fabs(input0[i]);
-            }
-          }
-        }
-        break;
-      case EQUAL:
-        for (index_t b = start0; b < end0; b += step0) {
-          index_t offset = b * channel;
-          for (index_t c = start1; c < end1; c += step1) {
-            const T *in0_ptr = input0 + (offset + c) * image_size;
-            const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-            DstType *out_ptr = output + (offset + c) * image_size;
-            for (index_t i = 0; i < image_size; ++i) {
-              out_ptr[i] = in0_ptr[i] == in1_ptr[c];
-            }
-          }
-        }
-        break;
-      case NOT_EQUAL:
-        for (index_t b = start0; b < end0; b += step0) {
-          index_t offset = b * channel;
-          for (index_t c = start1; c < end1; c += step1) {
-            const T *in0_ptr = input0 + (offset + c) * image_size;
-            const T *in1_ptr = input1 + (batch1 > 1 ? offset : 0);
-            DstType *out_ptr = output + (offset + c) * image_size;
-            for (index_t i = 0; i < image_size; ++i) {
-              out_ptr[i] = in0_ptr[i] != in1_ptr[c];
-            }
-          }
-        }
-        break;
-      case SIGN:
-        for (index_t b = start0; b < end0; b += step0) {
-          for (index_t c = start1; c < end1; c += step1) {
-            for (index_t i = 0; i < image_size; ++i) {
-              output[i] = Sign(input0[i]);
-            }
-          }
-        }
-        break;
-      default:LOG(FATAL) << "Eltwise op not support type " << type;
+  thread_pool.Compute2D([=, &coeff, &dims](index_t start0, index_t end0,
+                                            index_t step0, index_t start1,
+                                            index_t end1, index_t step1) {
+    MACE_UNUSED(step1);
+    for (index_t r = start0; r < end0; r += step0) {
+      index_t offset0 = start1 * stride0;
+      index_t offset1 = start1 * stride1;
+      index_t index = r;
+      for (index_t d = outer_rank - 1; d >= 0; --d) {
+        const index_t dim_index = index % dims.dims[d];
+        index /= dims.dims[d];
+        offset0 += dim_index * dims.strides0[d];
+        offset1 += dim_index * dims.strides1[d];
+      }
+      EltwiseRow(type, coeff, input0 + offset0, stride0, input1 + offset1,
+                 stride1, output + r * row_size + start1, end1 - start1);
     }
-  }, 0, batch0, 1, 0, channel, 1);
+  }, 0, rows, 1, 0, row_size, 1);
+}
+
+// The input, or its copy if it shares the buffer with the output (see
+// CanOverwriteInput) but is broadcast, as its elements would be read after
+// they are overwritten.
+template<typename T>
+inline const T *UnaliasedInput(const Tensor *input,
+                               const void *output_data,
+                               const index_t output_size,
+                               std::vector<T> *copy) {
+  const T *input_data = input->data<T>();
+  if (input_data == output_data && input->size() != output_size) {
+    copy->assign(input_data, input_data + input->size());
+    return copy->data();
+  }
+  return input_data;
 }
 
 template<RuntimeType D, class T>
@@ -995,6 +514,12 @@ class EltwiseOp : public Operation {
     }
   }
 
+  // The output has the type of the inputs, and every element is read
+  // before it is written.
+  bool CanOverwriteInput(size_t input_idx) const override {
+    return input_idx < 2 && !IsLogicalType(type_);
+  }
+
  private:
   template<typename DstType>
   MaceStatus DoEltwise(const OpContext *context,
@@ -1059,76 +584,40 @@ class EltwiseOp : public Operation {
       }
     }
 
-    const T *input0_ptr = input0->data<T>();
-    const T *input1_ptr = input1->data<T>();
-    if (has_data_format_ && input0->dim_size() == 4 && input1->dim_size() > 0) {
-      MACE_RETURN_IF_ERROR(output->ResizeLike(input0));
-      DstType *output_ptr = output->mutable_data<DstType>();
-      if (input1->dim_size() < input0->dim_size()) {
-        TensorEltwisePerChannel(context,
-                                type_,
-                                input0_ptr,
-                                input1_ptr,
-                                coeff_,
-                                input0->dim(0),
-                                input1->dim_size() == 1 ? 1 : input1->dim(0),
-                                input0->dim(1),
-                                input0->dim(2) * input0->dim(3),
-                                swapped,
-                                output_ptr);
-      } else if (input1->size() < input0->size()) {
-        TensorGeneralBroadcastEltwise(context,
-                                      type_, input0_ptr, input1_ptr, coeff_,
-                                      swapped, input0->shape(), input1->shape(),
-                                      output->shape(), output_ptr);
-      } else {
-        TensorEltwise(context,
-                      type_, input0_ptr, input1_ptr, coeff_, input0->size(),
-                      swapped, output_ptr);
-      }
+    const std::vector<index_t> &input0_shape = input0->shape();
+    std::vector<index_t> input1_shape;
+    if (has_data_format_ && input0->dim_size() == 4 &&
+        input1->dim_size() == 1) {
+      // Per channel of NCHW
+      input1_shape = {1, input1->dim(0), 1, 1};
     } else {
-      const std::vector<index_t> &input0_shape = input0->shape();
-      std::vector<index_t> input1_shape(rank_diff, 1);
+      input1_shape.assign(rank_diff, 1);
       input1_shape.insert(input1_shape.end(), input1->shape().begin(),
                           input1->shape().end());
-
-      std::vector<index_t> output_shape(input0->dim_size(), 0);
-      for (unsigned int i = 0; i < input0_shape.size(); ++i) {
-        output_shape[i] = std::max(input0_shape[i], input1_shape[i]);
-      }
-      MACE_RETURN_IF_ERROR(output->Resize(output_shape));
-      DstType *output_ptr = output->mutable_data<DstType>();
-
-      bool need_general_broadcast = false;
-      for (uint32_t i = 0; i < input1->dim_size(); ++i) {
-        if ((input0->dim(rank_diff + i) == 1 && input1->dim(i) > 1) ||
-            (input0->dim(rank_diff + i) > 1 && input1->dim(i) == 1)) {
-          need_general_broadcast = true;
-          break;
-        }
-      }
-
-      if (input1->size() == 1) {
-        TensorScalarEltwise(context,
-                            type_, input0_ptr, input1_ptr[0], coeff_,
-                            input0->size(), swapped, output_ptr);
-      } else if (input0_shape == input1_shape) {
-        TensorEltwise(context,
-                      type_, input0_ptr, input1_ptr, coeff_, input0->size(),
-                      swapped, output_ptr);
-      } else if (need_general_broadcast) {
-        TensorGeneralBroadcastEltwise(context,
-                                      type_, input0_ptr, input1_ptr, coeff_,
-                                      swapped, input0_shape, input1_shape,
-                                      output_shape, output_ptr);
-      } else {
-        index_t common_size = input1->size();
-        index_t diff_size = input0->size() / common_size;
-        TensorBroadcastEltwise(context,
-                               type_, input0_ptr, input1_ptr, coeff_,
-                               diff_size, common_size, swapped, output_ptr);
-      }
     }
+    std::vector<index_t> output_shape(input0_shape.size(), 0);
+    for (size_t i = 0; i < input0_shape.size(); ++i) {
+      output_shape[i] = std::max(input0_shape[i], input1_shape[i]);
+    }
+    MACE_RETURN_IF_ERROR(output->Resize(output_shape));
+    DstType *output_ptr = output->mutable_data<DstType>();
+
+    std::vector<T> input0_copy;
+    std::vector<T> input1_copy;
+    const T *input0_ptr = UnaliasedInput(input0, output_ptr, output->size(),
+                                         &input0_copy);
+    const T *input1_ptr = UnaliasedInput(input1, output_ptr, output->size(),
+                                         &input1_copy);
+    BroadcastDims dims;
+    // The binary types take the inputs in their original order.
+    if (swapped && !IsUnaryType(type_)) {
+      dims = CollapseBroadcastDims(input1_shape, input0_shape, output_shape);
+      std::swap(input0_ptr, input1_ptr);
+    } else {
+      dims = CollapseBroadcastDims(input0_shape, input1_shape, output_shape);
+    }
+    TensorBroadcastEltwise(context, type_, coeff_, dims, input0_ptr,
+                           input1_ptr, output_ptr);
 
     return MaceStatus::MACE_SUCCESS;
   }
@@ -1293,6 +782,35 @@ void RegisterEltwise(OpRegistry *op_registry) {
         }
         return {RuntimeType::RT_CPU, RuntimeType::RT_OPENCL};
       }));
+  MACE_REGISTER_OP_CONDITION(
+      op_registry, OpConditionBuilder("Eltwise").SetInputsDataFormatSelector(
+      [](OpConditionContext *context) -> std::vector<DataFormat> {
+        auto op = context->operator_def();
+        DataFormat op_data_format = static_cast<DataFormat>(
+            ProtoArgHelper::GetOptionalArg<OperatorDef, int>(
+                *op, "data_format", static_cast<int>(DataFormat::NONE)));
+        std::vector<DataFormat> inputs_data_format(op->input_size(),
+                                                   op_data_format);
+        auto type = static_cast<ops::EltwiseType>(
+            ProtoArgHelper::GetOptionalArg<OperatorDef, int>(
+                *op, "type", static_cast<int>(ops::EltwiseType::NONE)));
+        if (IsLogicalType(type) ||
+            !context->InputsInDataFormat(DataFormat::NCHWc)) {
+          return inputs_data_format;
+        }
+        // Keep NCHWc if there is nothing to broadcast but a scalar.
+        auto shape_info = context->tensor_shape_info();
+        auto ws = context->workspace();
+        for (int i = 0; i < op->input_size(); ++i) {
+          const Tensor *tensor = ws->GetTensor(op->input(i));
+          if ((tensor != nullptr && tensor->is_weight()) ||
+              shape_info->count(op->input(i)) == 0 ||
+              shape_info->at(op->input(i)) != shape_info->at(op->input(0))) {
+            return inputs_data_format;
+          }
+        }
+        return std::vector<DataFormat>(op->input_size(), DataFormat::NCHWc);
+      }));
 }
 
 }  // namespace ops
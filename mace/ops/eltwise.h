@@ -24,6 +24,11 @@ inline bool IsLogicalType(EltwiseType type) {
   return type == EQUAL || type == NOT_EQUAL;
 }
 
+// The types computed on input 0 only.
+inline bool IsUnaryType(EltwiseType type) {
+  return type == NEG || type == ABS || type == CLIP || type == SIGN;
+}
+
 template <typename T> int Sign(T val) {
   return (T(0) < val) - (val < T(0));
 }
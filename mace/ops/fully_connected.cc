@@ -22,6 +22,8 @@
 #include "mace/core/tensor.h"
 #include "mace/ops/activation.h"
 #include "mace/ops/delegator/activation.h"
+#include "mace/ops/delegator/bias_add.h"
+#include "mace/ops/delegator/gemm.h"
 #include "mace/ops/delegator/gemv.h"
 
 #ifdef MACE_ENABLE_OPENCL
@@ -35,6 +37,11 @@
 namespace mace {
 namespace ops {
 
+namespace {
+// From this batch size, the weight is reused across the batch by a GEMM.
+constexpr index_t kFullyConnectedGemmMinBatch = 4;
+}  // namespace
+
 class FullyConnectedOpBase : public Operation {
  public:
   explicit FullyConnectedOpBase(OpConstructContext *context)
@@ -77,10 +84,17 @@ class FullyConnectedOp<RuntimeType::RT_CPU, T> : public FullyConnectedOpBase {
         gemv_(delegator::Gemv::Create(
             context->workspace(),
             MACE_DELEGATOR_KEY(Gemv, RuntimeType::RT_CPU, T, kCpuImplType),
+            DelegatorParam())),
+        gemm_(delegator::Gemm::Create(
+            context->workspace(),
+            MACE_DELEGATOR_KEY(Gemm, RuntimeType::RT_CPU, T, kCpuImplType),
+            delegator::GemmParam())),
+        bias_add_delegator_(delegator::BiasAdd::Create(
+            context->workspace(),
+            MACE_DELEGATOR_KEY(BiasAdd, RuntimeType::RT_CPU, T, kCpuImplType),
             DelegatorParam())) {}
 
   MaceStatus Run(OpContext *context) override {
-    MACE_UNUSED(context);
     const Tensor *input = this->Input(INPUT);
     const Tensor *weight = this->Input(WEIGHT);  // OIHW
     const Tensor *bias = this->InputSize() >= 3 ? this->Input(BIAS) : nullptr;
@@ -104,16 +118,36 @@ class FullyConnectedOp<RuntimeType::RT_CPU, T> : public FullyConnectedOpBase {
     const index_t input_size = weight->dim(1) * weight->dim(2) * weight->dim(3);
     const index_t output_size = weight->dim(0);
 
-    gemv_->Compute(context,
-                   weight,
-                   input,
-                   bias,
-                   batch,
-                   output_size,
-                   input_size,
-                   false,
-                   true,
-                   output);
+    // fp16 weights (x86) are only read by the gemv, which blocks the batch.
+    if (batch >= kFullyConnectedGemmMinBatch &&
+        weight->dtype() == DataTypeToEnum<T>::value) {
+      // output[batch, output_size] = input[batch, input_size] * weight^T
+      gemm_->Compute(context,
+                     input,
+                     weight,
+                     1,
+                     batch,
+                     output_size,
+                     input_size,
+                     RowMajor,
+                     ColMajor,
+                     RowMajor,
+                     false,
+                     false,
+                     output);
+      bias_add_delegator_->Compute(context, output, bias, output);
+    } else {
+      gemv_->Compute(context,
+                     weight,
+                     input,
+                     bias,
+                     batch,
+                     output_size,
+                     input_size,
+                     false,
+                     true,
+                     output);
+    }
 
     activation_delegator_->Compute(context, output, output);
 
@@ -123,6 +157,8 @@ class FullyConnectedOp<RuntimeType::RT_CPU, T> : public FullyConnectedOpBase {
  private:
   std::unique_ptr<delegator::Activation> activation_delegator_;
   std::unique_ptr<delegator::Gemv> gemv_;
+  std::unique_ptr<delegator::Gemm> gemm_;
+  std::unique_ptr<delegator::BiasAdd> bias_add_delegator_;
 };
 
 #ifdef MACE_ENABLE_QUANTIZE
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <functional>
+#include <numeric>
+#include <vector>
 
 #include "mace/core/ops/operator.h"
 #include "mace/core/registry/ops_registry.h"
@@ -28,7 +31,6 @@ class GatherOp : public Operation {
         axis_(Operation::GetOptionalArg<int>("axis", 0)) {}
 
   MaceStatus Run(OpContext *context) override {
-    MACE_UNUSED(context);
     const Tensor *params = this->Input(PARAMS);
     const Tensor *indices = this->Input(INDICES);
     Tensor *output = this->Output(OUTPUT);
@@ -60,17 +62,25 @@ class GatherOp : public Operation {
                         params->shape().end(), 1, std::multiplies<index_t>());
     const index_t index_size = indices->size();
 
-    for (index_t l = 0; l < lhs_size; ++l) {
-      for (index_t idx = 0; idx < index_size; ++idx) {
-        MACE_ASSERT(indices_data[idx] < axis_dim_size, "idx out of bound: ",
-                    indices_data[idx]);
-        memcpy(
-            output_data + ((l * index_size) + idx) * rhs_size,
-            params_data + ((l * axis_dim_size) + indices_data[idx]) * rhs_size,
-            sizeof(T) * rhs_size);
-      }
+    for (index_t idx = 0; idx < index_size; ++idx) {
+      MACE_CHECK(indices_data[idx] >= 0 && indices_data[idx] < axis_dim_size,
+                 "idx out of bound: ", indices_data[idx]);
     }
 
+    utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+    thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                              index_t start1, index_t end1, index_t step1) {
+      for (index_t l = start0; l < end0; l += step0) {
+        for (index_t idx = start1; idx < end1; idx += step1) {
+          memcpy(
+              output_data + ((l * index_size) + idx) * rhs_size,
+              params_data
+                  + ((l * axis_dim_size) + indices_data[idx]) * rhs_size,
+              sizeof(T) * rhs_size);
+        }
+      }
+    }, 0, lhs_size, 1, 0, index_size, 1, 0, 0, rhs_size);
+
     output->SetScale(params->scale());
     output->SetZeroPoint(params->zero_point());
 
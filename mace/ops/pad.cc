@@ -12,8 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
-#include <vector>
+#include <algorithm>
 #include <memory>
+#include <vector>
 
 #include "mace/core/ops/operator.h"
 #ifdef MACE_ENABLE_QUANTIZE
@@ -76,7 +77,6 @@ class PadOp<RuntimeType::RT_CPU, T> : public Operation {
   }
 
   MaceStatus Run(OpContext *context) override {
-    MACE_UNUSED(context);
     const Tensor *input = this->Input(0);
     Tensor *output = this->Output(0);
     MACE_CHECK(
@@ -106,59 +106,79 @@ class PadOp<RuntimeType::RT_CPU, T> : public Operation {
     const index_t height = input->dim(2);
     const index_t width = input->dim(3);
 
-    if (type_ == PadType::CONSTANT) {
-      std::fill(output_ptr, output_ptr + output->size(), this->constant_value_);
+    const index_t o_batch = output->dim(0);
+    const index_t o_channel = output->dim(1);
+    const index_t o_height = output->dim(2);
+    const index_t o_width = output->dim(3);
+    const int *paddings = paddings_.data();
+    utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
 
-      for (index_t b = 0; b < batch; ++b) {
-        for (index_t c = 0; c < channel; ++c) {
-          for (index_t h = 0; h < height; ++h) {
-            const index_t in_offset = (((b * channel + c) * height) +
-                h) * width;
-            const index_t out_offset =
-                (((b + this->paddings_[0]) * output->dim(1)
-                    + (c + this->paddings_[2])) * output->dim(2)
-                    + (h + this->paddings_[4])) * output->dim(3)
-                    + this->paddings_[6];
-            memcpy(output_ptr + out_offset,
-                   input_ptr + in_offset,
-                   width * sizeof(T));
+    if (type_ == PadType::CONSTANT) {
+      const T constant_value = static_cast<T>(constant_value_);
+      // Each (batch, channel) plane is written exactly once: padded planes
+      // are filled, others get padded borders around memcpy-ed rows.
+      thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                                index_t start1, index_t end1, index_t step1) {
+        for (index_t b = start0; b < end0; b += step0) {
+          const index_t b_in = b - paddings[0];
+          for (index_t c = start1; c < end1; c += step1) {
+            const index_t c_in = c - paddings[2];
+            T *out_plane = output_ptr + (b * o_channel + c) * o_height
+                * o_width;
+            if (b_in < 0 || b_in >= batch || c_in < 0 || c_in >= channel) {
+              std::fill(out_plane, out_plane + o_height * o_width,
+                        constant_value);
+              continue;
+            }
+            const T *in_plane =
+                input_ptr + (b_in * channel + c_in) * height * width;
+            std::fill(out_plane, out_plane + paddings[4] * o_width,
+                      constant_value);
+            for (index_t h = 0; h < height; ++h) {
+              T *out_row = out_plane + (h + paddings[4]) * o_width;
+              std::fill(out_row, out_row + paddings[6], constant_value);
+              memcpy(out_row + paddings[6], in_plane + h * width,
+                     width * sizeof(T));
+              std::fill(out_row + paddings[6] + width, out_row + o_width,
+                        constant_value);
+            }
+            std::fill(out_plane + (paddings[4] + height) * o_width,
+                      out_plane + o_height * o_width, constant_value);
           }
         }
-      }
+      }, 0, o_batch, 1, 0, o_channel, 1, 0, 0, o_height * o_width);
     } else if (type_ == PadType::REFLECT || type_ == PadType::SYMMETRIC) {
-      const index_t o_batch = output->dim(0);
-      const index_t o_channel = output->dim(1);
-      const index_t o_height = output->dim(2);
-      const index_t o_width = output->dim(3);
       const int l_add = type_ == PadType::REFLECT ? 0 : -1;
       const int r_add = type_ == PadType::REFLECT ? -2 : -1;
 
-      for (index_t h = 0; h < o_height; ++h) {
-        index_t h_in = get_src_idx(h, height, paddings_[4], l_add, r_add);
-
-        for (index_t b = 0; b < o_batch; ++b) {
-          index_t b_in = get_src_idx(b, batch, paddings_[0], l_add, r_add);
-
-          for (index_t c = 0; c < o_channel; ++c) {
-            index_t c_in = get_src_idx(c, channel, paddings_[2], l_add, r_add);
-            const index_t in_offset =
-                (((b_in * channel + c_in) * height) + h_in) * width;
-            index_t out_offset =
-                (((b * o_channel + c) * o_height) + h) * o_width;
-
-            for (index_t i = 0, j = paddings_[6] + l_add;
-                 i < paddings_[6]; ++i, --j) {
-              output_ptr[out_offset++] = input_ptr[in_offset + j];
-            }
-            memcpy(output_ptr + out_offset, input_ptr + in_offset,
-                   width * sizeof(T));
-            out_offset += width;
-            for (index_t i = 0, j = width + r_add; i < paddings_[7]; ++i, --j) {
-              output_ptr[out_offset++] = input_ptr[in_offset + j];
+      thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                                index_t start1, index_t end1, index_t step1) {
+        for (index_t b = start0; b < end0; b += step0) {
+          index_t b_in = get_src_idx(b, batch, paddings[0], l_add, r_add);
+          for (index_t c = start1; c < end1; c += step1) {
+            index_t c_in = get_src_idx(c, channel, paddings[2], l_add, r_add);
+            for (index_t h = 0; h < o_height; ++h) {
+              index_t h_in = get_src_idx(h, height, paddings[4], l_add, r_add);
+              const index_t in_offset =
+                  (((b_in * channel + c_in) * height) + h_in) * width;
+              index_t out_offset =
+                  (((b * o_channel + c) * o_height) + h) * o_width;
+
+              for (index_t i = 0, j = paddings[6] + l_add;
+                   i < paddings[6]; ++i, --j) {
+                output_ptr[out_offset++] = input_ptr[in_offset + j];
+              }
+              memcpy(output_ptr + out_offset, input_ptr + in_offset,
+                     width * sizeof(T));
+              out_offset += width;
+              for (index_t i = 0, j = width + r_add;
+                   i < paddings[7]; ++i, --j) {
+                output_ptr[out_offset++] = input_ptr[in_offset + j];
+              }
             }
           }
         }
-      }
+      }, 0, o_batch, 1, 0, o_channel, 1, 0, 0, o_height * o_width);
     } else {
       LOG(FATAL) << "Pad op doesn't support type " << type_;
     }
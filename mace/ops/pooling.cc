@@ -253,18 +253,25 @@ class PoolingOp<RuntimeType::RT_CPU, float> : public PoolingOpBase {
     MACE_UNUSED(context);
     const Tensor *input_tensor = this->Input(0);
     Tensor *output_tensor = this->Output(0);
+    // NCHWc is pooled as NCHW of all the blocked channels.
+    const bool blocked = input_tensor->data_format() == DataFormat::NCHWc;
+    std::vector<index_t> nchw_shape = input_tensor->shape();
+    if (blocked) {
+      nchw_shape = {nchw_shape[0], nchw_shape[1] * nchw_shape[4],
+                    nchw_shape[2], nchw_shape[3]};
+    }
     std::vector<index_t> output_shape(4);
     std::vector<index_t> filter_shape = {
-        input_tensor->dim(1), input_tensor->dim(1), kernels_[0], kernels_[1]};
+        nchw_shape[1], nchw_shape[1], kernels_[0], kernels_[1]};
 
     std::vector<int> paddings(2);
     if (paddings_.empty()) {
       ops::CalcNCHWPaddingAndOutputSize(
-          input_tensor->shape().data(), filter_shape.data(), dilations_.data(),
+          nchw_shape.data(), filter_shape.data(), dilations_.data(),
           strides_.data(), padding_type_, output_shape.data(), paddings.data());
     } else {
       paddings = paddings_;
-      CalcNCHWOutputSize(input_tensor->shape().data(),
+      CalcNCHWOutputSize(nchw_shape.data(),
                          filter_shape.data(),
                          paddings_.data(),
                          dilations_.data(),
@@ -272,13 +279,23 @@ class PoolingOp<RuntimeType::RT_CPU, float> : public PoolingOpBase {
                          round_type_,
                          output_shape.data());
     }
+    int pad_hw[2] = {paddings[0] / 2, paddings[1] / 2};
+    if (blocked) {
+      MACE_RETURN_IF_ERROR(output_tensor->Resize(
+          {output_shape[0], input_tensor->dim(1), output_shape[2],
+           output_shape[3], input_tensor->dim(4)}));
+      PoolingNCHWc(context, input_tensor->data<float>(),
+                   input_tensor->shape().data(), output_tensor->shape().data(),
+                   kernels_.data(), strides_.data(), dilations_.data(), pad_hw,
+                   output_tensor->mutable_data<float>());
+      return MaceStatus::MACE_SUCCESS;
+    }
     MACE_RETURN_IF_ERROR(output_tensor->Resize(output_shape));
 
     const float *input = input_tensor->data<float>();
     MACE_CHECK(output_tensor->dtype() == DataTypeToEnum<float>::value);
     float *output = output_tensor->mutable_data<float>();
     const index_t *input_shape = input_tensor->shape().data();
-    int pad_hw[2] = {paddings[0] / 2, paddings[1] / 2};
 
     if (pooling_type_ == PoolingType::MAX) {
       MaxPooling(context,
@@ -308,6 +325,74 @@ class PoolingOp<RuntimeType::RT_CPU, float> : public PoolingOpBase {
   }
 
  private:
+  // The shapes are N, C/x, H, W, x, every tap pools the x lanes at once.
+  void PoolingNCHWc(const OpContext *context,
+                    const float *input,
+                    const index_t *in_shape,
+                    const index_t *out_shape,
+                    const int *filter_hw,
+                    const int *stride_hw,
+                    const int *dilation_hw,
+                    const int *pad_hw,
+                    float *output) {
+    const index_t blocks = in_shape[0] * in_shape[1];
+    const index_t in_height = in_shape[2];
+    const index_t in_width = in_shape[3];
+    const index_t out_height = out_shape[2];
+    const index_t out_width = out_shape[3];
+    const index_t block = in_shape[4];
+    MACE_CHECK(block == kNCHWcBlock);
+    const bool is_max = pooling_type_ == PoolingType::MAX;
+    MACE_CHECK(is_max || pooling_type_ == PoolingType::AVG);
+
+    utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+    thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                              index_t start1, index_t end1, index_t step1) {
+      float res[kNCHWcBlock];
+      for (index_t i = start0; i < end0; i += step0) {
+        const float *in_block = input + i * in_height * in_width * block;
+        for (index_t h = start1; h < end1; h += step1) {
+          float *out_row = output + (i * out_height + h) * out_width * block;
+          const index_t inh_base = h * stride_hw[0] - pad_hw[0];
+          for (index_t w = 0; w < out_width; ++w) {
+            const index_t inw_base = w * stride_hw[1] - pad_hw[1];
+            std::fill_n(res, kNCHWcBlock, is_max ?
+                std::numeric_limits<float>::lowest() : 0.f);
+            int count = 0;
+            for (int fh = 0; fh < filter_hw[0]; ++fh) {
+              const index_t inh = inh_base + fh * dilation_hw[0];
+              if (inh < 0 || inh >= in_height) {
+                continue;
+              }
+              for (int fw = 0; fw < filter_hw[1]; ++fw) {
+                const index_t inw = inw_base + fw * dilation_hw[1];
+                if (inw < 0 || inw >= in_width) {
+                  continue;
+                }
+                const float *in = in_block + (inh * in_width + inw) * block;
+                if (is_max) {
+                  for (index_t l = 0; l < kNCHWcBlock; ++l) {
+                    res[l] = std::max(res[l], in[l]);
+                  }
+                } else {
+                  for (index_t l = 0; l < kNCHWcBlock; ++l) {
+                    res[l] += in[l];
+                  }
+                }
+                ++count;
+              }
+            }
+            float *out = out_row + w * block;
+            const float scale = is_max ? 1.f : 1.f / count;
+            for (index_t l = 0; l < kNCHWcBlock; ++l) {
+              out[l] = res[l] * scale;
+            }
+          }
+        }
+      }
+    }, 0, blocks, 1, 0, out_height, 1);
+  }
+
   void MaxPoolingPad(const float *input,
                      int in_base,
                      int in_width,
@@ -911,6 +996,21 @@ void RegisterPooling(OpRegistry *op_registry) {
 #endif  // MACE_ENABLE_QUANTIZE
 
   MACE_REGISTER_GPU_OP(op_registry, "Pooling", PoolingOp);
+
+  MACE_REGISTER_OP_CONDITION(
+      op_registry,
+      OpConditionBuilder("Pooling").SetInputsDataFormatSelector(
+          [](OpConditionContext *context) -> std::vector<DataFormat> {
+            // The float kernel pools NCHWc inputs directly.
+            if (context->InputsInDataFormat(DataFormat::NCHWc)) {
+              return {DataFormat::NCHWc};
+            }
+            DataFormat op_data_format = static_cast<DataFormat>(
+                ProtoArgHelper::GetOptionalArg<OperatorDef, int>(
+                    *context->operator_def(), "data_format",
+                    static_cast<int>(DataFormat::NONE)));
+            return {op_data_format};
+          }));
 }
 
 }  // namespace ops
@@ -13,13 +13,52 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <cmath>
 
+#include "mace/ops/common/transcendental.h"
 #include "mace/ops/delegator/activation.h"
 
 namespace mace {
 namespace ops {
 namespace ref {
 
+namespace {
+template<typename T>
+void Tanh(utils::ThreadPool *thread_pool, const T *input, T *output,
+          const index_t size) {
+  MACE_UNUSED(thread_pool);
+  for (index_t i = 0; i < size; ++i) {
+    output[i] = std::tanh(input[i]);
+  }
+}
+
+template<typename T>
+void Sigmoid(utils::ThreadPool *thread_pool, const T *input, T *output,
+             const index_t size) {
+  MACE_UNUSED(thread_pool);
+  for (index_t i = 0; i < size; ++i) {
+    output[i] = 1 / (1 + std::exp(-input[i]));
+  }
+}
+
+// The float ones are vectorized and split over the threads.
+void Tanh(utils::ThreadPool *thread_pool, const float *input, float *output,
+          const index_t size) {
+  thread_pool->Compute1D([=](index_t start, index_t end, index_t step) {
+    MACE_UNUSED(step);
+    VectorTanh(input + start, output + start, end - start);
+  }, 0, size, 1);
+}
+
+void Sigmoid(utils::ThreadPool *thread_pool, const float *input,
+             float *output, const index_t size) {
+  thread_pool->Compute1D([=](index_t start, index_t end, index_t step) {
+    MACE_UNUSED(step);
+    VectorSigmoid(input + start, output + start, end - start);
+  }, 0, size, 1);
+}
+}  // namespace
+
 template<typename T>
 class Activation : public delegator::Activation {
  public:
@@ -53,7 +92,7 @@ template<typename T>
 void Activation<T>::DoActivation(const OpContext *context,
                                  const Tensor *input,
                                  Tensor *output) {
-  MACE_UNUSED(context);
+  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
   auto input_ptr = input->data<T>();
   auto output_ptr = output->mutable_data<T>();
   const index_t size = input->size();
@@ -88,17 +127,12 @@ void Activation<T>::DoActivation(const OpContext *context,
     }
 
     case TANH: {
-      for (index_t i = 0; i < size; ++i) {
-        *output_ptr++ = std::tanh(*input_ptr++);
-      }
-
+      Tanh(&thread_pool, input_ptr, output_ptr, size);
       break;
     }
 
     case SIGMOID: {
-      for (index_t i = 0; i < size; ++i) {
-        *output_ptr++ = 1 / (1 + std::exp(-(*input_ptr++)));
-      }
+      Sigmoid(&thread_pool, input_ptr, output_ptr, size);
       break;
     }
 
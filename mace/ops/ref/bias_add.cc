@@ -12,6 +12,8 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+
 #include "mace/ops/delegator/bias_add.h"
 
 namespace mace {
@@ -39,6 +41,10 @@ class BiasAdd : public delegator::BiasAdd {
                    const Tensor *input,
                    const Tensor *bias,
                    Tensor *output);
+  void AddBiasNCHWc(const OpContext *context,
+                    const Tensor *input,
+                    const Tensor *bias,
+                    Tensor *output);
 };
 
 template<typename T>
@@ -52,7 +58,9 @@ MaceStatus BiasAdd<T>::Compute(const OpContext *context,
     if (bias == nullptr) {
       output->Copy(*input);
     } else {
-      if (isNCHW) {
+      if (input->data_format() == DataFormat::NCHWc) {
+        AddBiasNCHWc(context, input, bias, output);
+      } else if (isNCHW) {
         AddBiasNCHW(context, input, bias, output);
       } else {
         AddBiasNHWC(context, input, bias, output);
@@ -60,7 +68,9 @@ MaceStatus BiasAdd<T>::Compute(const OpContext *context,
     }
   } else {
     if (bias != nullptr) {
-      if (isNCHW) {
+      if (input->data_format() == DataFormat::NCHWc) {
+        AddBiasNCHWc(context, input, bias, output);
+      } else if (isNCHW) {
         AddBiasNCHW(context, input, bias, output);
       } else {
         AddBiasNHWC(context, input, bias, output);
@@ -142,6 +152,40 @@ void BiasAdd<T>::AddBiasNHWC(const OpContext *context,
   }
 }
 
+template<typename T>
+void BiasAdd<T>::AddBiasNCHWc(const OpContext *context,
+                              const Tensor *input,
+                              const Tensor *bias,
+                              mace::Tensor *output) {
+  MACE_UNUSED(context);
+  auto input_data = input->data<T>();
+  auto bias_data = bias->data<T>();
+  auto output_data = output->mutable_data<T>();
+
+  // The shape is N, C/x, H, W, x, the padded channels are left alone.
+  const index_t batch = input->dim(0);
+  const index_t blocks = input->dim(1);
+  const index_t image_size = input->dim(2) * input->dim(3);
+  const index_t block = input->dim(4);
+  const index_t channels = bias->dim_size() == 1 ? bias->dim(0) : bias->dim(1);
+  MACE_CHECK(channels <= blocks * block);
+
+  const index_t bias_batch_stride = bias->dim_size() == 1 ? 0 : channels;
+  for (index_t b = 0; b < batch; ++b) {
+    for (index_t cb = 0; cb < blocks; ++cb) {
+      const index_t offset = (b * blocks + cb) * image_size * block;
+      const index_t valid = std::min(block, channels - cb * block);
+      const T *bias_ptr = bias_data + b * bias_batch_stride + cb * block;
+      for (index_t i = 0; i < image_size; ++i) {
+        for (index_t l = 0; l < valid; ++l) {
+          const index_t pos = offset + i * block + l;
+          output_data[pos] = input_data[pos] + bias_ptr[l];
+        }
+      }
+    }
+  }
+}
+
 void RegisterBiasAddDelegator(OpDelegatorRegistry *registry) {
   MACE_REGISTER_DELEGATOR(
       registry, BiasAdd<float>, DelegatorParam,
@@ -17,6 +17,7 @@
 #include <functional>
 #include <vector>
 
+#include "mace/ops/common/deconv_2d.h"
 #include "mace/ops/delegator/deconv_2d.h"
 #include "mace/utils/memory.h"
 
@@ -46,8 +47,6 @@ MaceStatus Deconv2d<T>::Compute(const OpContext *context,
                                 const Tensor *filter,
                                 const Tensor *output_shape,
                                 Tensor *output) {
-  MACE_UNUSED(context);
-
   std::vector<index_t> out_shape;
   if (output_shape) {
     MACE_CHECK(output_shape->size() == 4, "output shape should be 4-dims");
@@ -62,7 +61,7 @@ MaceStatus Deconv2d<T>::Compute(const OpContext *context,
                                  strides_,
                                  padding_type_,
                                  paddings_,
-                                 1,
+                                 group_,
                                  &out_shape,
                                  nullptr,
                                  &out_pad_size,
@@ -104,49 +103,19 @@ MaceStatus Deconv2d<T>::Compute(const OpContext *context,
   const index_t pad_out_width = padded_out_shape[3];
   const index_t in_height = in_shape[2];
   const index_t in_width = in_shape[3];
-  const index_t out_img_size = pad_out_height * pad_out_width;
-  const index_t in_img_size = in_height * in_width;
-  const index_t kernel_h = filter->dim(2);
-  const index_t kernel_w = filter->dim(3);
-  const int kernel_size = static_cast<int>(kernel_h * kernel_w);
   const index_t pad_top = out_pad_size[0] / 2;
   const index_t pad_left = out_pad_size[1] / 2;
 
-  std::vector<index_t> index_map(kernel_size, 0);
-  for (index_t i = 0; i < kernel_h; ++i) {
-    for (index_t j = 0; j < kernel_w; ++j) {
-      index_map[i * kernel_w + j] = i * pad_out_width + j;
-    }
-  }
-
   const index_t batch = in_shape[0];
   const index_t out_channels = out_shape[1];
   const index_t in_channels = in_shape[1];
+  MACE_CHECK(in_channels % group_ == 0 && out_channels % group_ == 0,
+             "invalid input/output channel and group.");
 
-  for (index_t b = 0; b < batch; ++b) {
-    for (index_t oc = 0; oc < out_channels; ++oc) {
-      T *out_base =
-          pad_out_data + (b * out_channels + oc) * out_img_size;
-      for (index_t i = 0; i < in_height; ++i) {
-        for (index_t j = 0; j < in_width; ++j) {
-          const index_t out_offset =
-              i * strides_[0] * pad_out_width + j * strides_[1];
-          for (index_t ic = 0; ic < in_channels; ++ic) {
-            const index_t input_idx =
-                (b * in_channels + ic) * in_img_size + i * in_width + j;
-            const float val = input_data[input_idx];
-            const index_t kernel_offset =
-                (oc * in_channels + ic) * kernel_size;
-            for (int k = 0; k < kernel_size; ++k) {
-              const index_t out_idx = out_offset + index_map[k];
-              const index_t kernel_idx = kernel_offset + k;
-              out_base[out_idx] += val * filter_data[kernel_idx];
-            }
-          }
-        }
-      }
-    }
-  }
+  Deconv2dGemmCol2im(context, input_data, filter_data, batch, in_channels,
+                     in_height, in_width, out_channels, pad_out_height,
+                     pad_out_width, filter->dim(2), filter->dim(3),
+                     strides_[0], strides_[1], group_, pad_out_data);
   if (out_tensor != output) {
     for (index_t i = 0; i < batch; ++i) {
       for (index_t j = 0; j < out_channels; ++j) {
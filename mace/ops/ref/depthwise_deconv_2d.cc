@@ -16,6 +16,7 @@
 #include <memory>
 #include <functional>
 
+#include "mace/ops/common/deconv_2d.h"
 #include "mace/ops/delegator/depthwise_deconv_2d.h"
 #include "mace/utils/memory.h"
 
@@ -61,8 +62,6 @@ MaceStatus DepthwiseDeconv2d<T>::Compute(const OpContext *context,
                                          const Tensor *filter,
                                          const Tensor *output_shape,
                                          Tensor *output) {
-  MACE_UNUSED(context);
-
   std::vector<index_t> out_shape;
   if (output_shape) {
     MACE_CHECK(output_shape->size() == 4, "output shape should be 4-dims");
@@ -136,27 +135,35 @@ MaceStatus DepthwiseDeconv2d<T>::Compute(const OpContext *context,
     }
   }
 
-  for (index_t b = 0; b < batch; ++b) {
-    for (index_t c = 0; c < channels; ++c) {
-      T *out_base =
-          pad_out_data + (b * channels + c) * out_img_size;
-      for (index_t i = 0; i < in_height; ++i) {
-        for (index_t j = 0; j < in_width; ++j) {
-          const index_t out_offset = i * GroupDeconv2d<T>::strides_[0] *
-              pad_out_width + j * GroupDeconv2d<T>::strides_[1];
-          const index_t input_idx =
-              (b * channels + c) * in_img_size + i * in_width + j;
-          const T val = input_data[input_idx];
-          const index_t kernel_offset = c * kernel_size;
-          for (int k = 0; k < kernel_size; ++k) {
-            const index_t out_idx = out_offset + index_map[k];
-            const index_t kernel_idx = kernel_offset + k;
-            out_base[out_idx] += val * filter_data[kernel_idx];
+  const int stride_h = GroupDeconv2d<T>::strides_[0];
+  const int stride_w = GroupDeconv2d<T>::strides_[1];
+  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+
+  thread_pool.Compute2D([=, &index_map](index_t start0, index_t end0,
+                                        index_t step0, index_t start1,
+                                        index_t end1, index_t step1) {
+    for (index_t b = start0; b < end0; b += step0) {
+      for (index_t c = start1; c < end1; c += step1) {
+        T *out_base =
+            pad_out_data + (b * channels + c) * out_img_size;
+        for (index_t i = 0; i < in_height; ++i) {
+          for (index_t j = 0; j < in_width; ++j) {
+            const index_t out_offset =
+                i * stride_h * pad_out_width + j * stride_w;
+            const index_t input_idx =
+                (b * channels + c) * in_img_size + i * in_width + j;
+            const float val = input_data[input_idx];
+            const index_t kernel_offset = c * kernel_size;
+            for (int k = 0; k < kernel_size; ++k) {
+              const index_t out_idx = out_offset + index_map[k];
+              const index_t kernel_idx = kernel_offset + k;
+              out_base[out_idx] += val * filter_data[kernel_idx];
+            }
           }
         }
       }
     }
-  }
+  }, 0, batch, 1, 0, channels, 1);
 
   if (out_tensor != output) {
     for (index_t i = 0; i < batch; ++i) {
@@ -182,8 +189,6 @@ MaceStatus GroupDeconv2d<T>::Compute(const OpContext *context,
                                      const Tensor *filter,
                                      const Tensor *output_shape,
                                      Tensor *output) {
-  MACE_UNUSED(context);
-
   std::vector<index_t> out_shape;
   if (output_shape) {
     MACE_CHECK(output_shape->size() == 4, "output shape should be 4-dims");
@@ -243,51 +248,15 @@ MaceStatus GroupDeconv2d<T>::Compute(const OpContext *context,
   const index_t pad_out_width = padded_out_shape[3];
   const index_t in_height = in_shape[2];
   const index_t in_width = in_shape[3];
-  const index_t out_img_size = pad_out_height * pad_out_width;
-  const index_t in_img_size = in_height * in_width;
-  const index_t kernel_h = filter->dim(2);
-  const index_t kernel_w = filter->dim(3);
-  const int kernel_size = static_cast<int>(kernel_h * kernel_w);
   const index_t pad_top = out_pad_size[0] / 2;
   const index_t pad_left = out_pad_size[1] / 2;
+  MACE_CHECK(in_channels % group_ == 0 && out_channels % group_ == 0,
+             "invalid input/output channel and group.");
 
-  std::vector<int> index_map(kernel_size, 0);
-  for (int i = 0; i < kernel_h; ++i) {
-    for (int j = 0; j < kernel_w; ++j) {
-      index_map[i * kernel_w + j] = i * out_width + j;
-    }
-  }
-
-  const int in_channels_g = in_channels / group_;
-  const int out_channels_g = out_channels / group_;
-  for (int b = 0; b < in_shape[0]; ++b) {
-    for (int g = 0; g < group_; ++g) {
-      for (int p = 0; p < out_channels_g; ++p) {
-        const index_t out_base =
-            ((b * group_ + g) * out_channels_g + p) * out_img_size;
-        for (int i = 0; i < in_height; ++i) {
-          for (int j = 0; j < in_width; ++j) {
-            const index_t out_offset =
-                i * strides_[0] * out_width + j * strides_[1];
-            for (int q = 0; q < in_channels_g; ++q) {
-              const index_t in_base =
-                  ((b * group_ + g) * in_channels_g + q) * in_img_size;
-              const index_t in_offset =
-                  in_base + i * in_width + j;
-              const float val = input_data[in_offset];
-              const index_t k_offset =
-                  ((p * group_ + g) * in_channels_g + q) * kernel_size;
-              for (int k = 0; k < kernel_size; ++k) {
-                const index_t out_idx = out_base + out_offset + index_map[k];
-                const float w = filter_data[k_offset + k];
-                pad_out_data[out_idx] += val * w;
-              }
-            }
-          }
-        }
-      }
-    }
-  }
+  Deconv2dGemmCol2im(context, input_data, filter_data, batch, in_channels,
+                     in_height, in_width, out_channels, pad_out_height,
+                     pad_out_width, filter->dim(2), filter->dim(3),
+                     strides_[0], strides_[1], group_, pad_out_data);
 
   if (out_tensor != output) {
     for (int i = 0; i < batch; ++i) {
@@ -318,6 +287,17 @@ void RegisterDepthwiseDeconv2dDelegator(OpDelegatorRegistry *registry) {
                          BFloat16, ImplType::REF));
 }
 
+void RegisterGroupDeconv2dDelegator(OpDelegatorRegistry *registry) {
+  MACE_REGISTER_DELEGATOR(
+      registry, GroupDeconv2d<float>, delegator::GroupDeconv2dParam,
+      MACE_DELEGATOR_KEY(GroupDeconv2d, RuntimeType::RT_CPU,
+                         float, ImplType::REF));
+  MACE_REGISTER_BF16_DELEGATOR(
+      registry, GroupDeconv2d<BFloat16>, delegator::GroupDeconv2dParam,
+      MACE_DELEGATOR_KEY(GroupDeconv2d, RuntimeType::RT_CPU,
+                         BFloat16, ImplType::REF));
+}
+
 }  // namespace ref
 }  // namespace ops
 }  // namespace mace
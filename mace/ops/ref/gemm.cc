@@ -14,6 +14,10 @@
 
 #include "mace/ops/delegator/gemm.h"
 
+#include <algorithm>
+
+#include "mace/utils/math.h"
+
 namespace mace {
 namespace ops {
 namespace ref {
@@ -68,11 +72,18 @@ MaceStatus Gemm<T>::Compute(const OpContext *context,
                             const bool lhs_batched,
                             const bool rhs_batched,
                             Tensor *output) {
-  MACE_UNUSED(context);
   const T *lhs_data = lhs->data<T>();
   const T *rhs_data = rhs->data<T>();
   T *output_data = output->mutable_data<T>();
 
+  // The output is computed in 4x4 blocks, the rows and columns past the end
+  // of the matrices are clamped to the last ones and not written back.
+  const index_t block_size = 4;
+  const index_t row_block_count = RoundUpDiv(rows, block_size);
+  const index_t col_block_count = RoundUpDiv(cols, block_size);
+
+  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+
   for (index_t b = 0; b < batch; ++b) {
     MatrixMap<const T>
         lhs_matrix
@@ -89,17 +100,53 @@ MaceStatus Gemm<T>::Compute(const OpContext *context,
     MatrixMap<T>
         output_matrix(output_data + b * rows * cols, output_major, rows, cols);
 
-    for (index_t r = 0; r < rows; ++r) {
-      for (index_t c = 0; c < cols; ++c) {
-        float sum = 0;
-        for (index_t d = 0; d < depth; ++d) {
-          sum += static_cast<float>(lhs_matrix(r, d)) *
-              static_cast<float>(rhs_matrix(d, c));
-        }  // d
-
-        *output_matrix.data(r, c) = sum;
-      }  // c
-    }  // r
+    const index_t lhs_depth_stride = lhs_matrix.cols_stride();
+    const index_t rhs_depth_stride = rhs_matrix.rows_stride();
+
+    thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                              index_t start1, index_t end1, index_t step1) {
+      for (index_t rb = start0; rb < end0; rb += step0) {
+        const index_t r_start = rb * block_size;
+        const index_t r_len = std::min(block_size, rows - r_start);
+        const T *lhs_ptr[block_size];
+        for (index_t i = 0; i < block_size; ++i) {
+          lhs_ptr[i] = lhs_matrix.data(
+              static_cast<int>(std::min(r_start + i, rows - 1)), 0);
+        }
+
+        for (index_t cb = start1; cb < end1; cb += step1) {
+          const index_t c_start = cb * block_size;
+          const index_t c_len = std::min(block_size, cols - c_start);
+          const T *rhs_ptr[block_size];
+          for (index_t j = 0; j < block_size; ++j) {
+            rhs_ptr[j] = rhs_matrix.data(
+                0, static_cast<int>(std::min(c_start + j, cols - 1)));
+          }
+
+          float sum[block_size][block_size] = {{0.f}};
+          for (index_t d = 0; d < depth; ++d) {
+            float l[block_size];
+            float r[block_size];
+            for (index_t i = 0; i < block_size; ++i) {
+              l[i] = lhs_ptr[i][d * lhs_depth_stride];
+              r[i] = rhs_ptr[i][d * rhs_depth_stride];
+            }
+            for (index_t i = 0; i < block_size; ++i) {
+              for (index_t j = 0; j < block_size; ++j) {
+                sum[i][j] += l[i] * r[j];
+              }
+            }
+          }  // d
+
+          for (index_t i = 0; i < r_len; ++i) {
+            for (index_t j = 0; j < c_len; ++j) {
+              *output_matrix.data(static_cast<int>(r_start + i),
+                                  static_cast<int>(c_start + j)) = sum[i][j];
+            }
+          }
+        }  // cb
+      }  // rb
+    }, 0, row_block_count, 1, 0, col_block_count, 1);
   }   // b
 
   return MaceStatus::MACE_SUCCESS;
@@ -15,6 +15,10 @@
 
 #include "mace/ops/delegator/gemv.h"
 
+#include <algorithm>
+
+#include "mace/utils/math.h"
+
 #if defined(MACE_ENABLE_QUANTIZE)
 #include "mace/core/quantize.h"
 #endif  // MACE_ENABLE_QUANTIZE
@@ -53,7 +57,6 @@ MaceStatus Gemv<T>::Compute(const OpContext *context,
                                 const bool lhs_batched,
                                 const bool rhs_batched,
                                 Tensor *output) {
-  MACE_UNUSED(context);
   const T *lhs_data = lhs->data<T>();
   const T *rhs_data = rhs->data<T>();
   const T *bias_data = nullptr;
@@ -63,19 +66,67 @@ MaceStatus Gemv<T>::Compute(const OpContext *context,
 
   T *output_data = output->mutable_data<T>();
 
-  for (index_t b = 0; b < batch; ++b) {
-    for (index_t h = 0; h < lhs_height; ++h) {
-      float sum = bias ? static_cast<float>(bias_data[h]) : 0.f;
-      for (index_t w = 0; w < lhs_width; ++w) {
-        sum += lhs_data[
-            static_cast<index_t>(lhs_batched) * b * lhs_height * lhs_width
-                + h * lhs_width + w]
-            * rhs_data[static_cast<index_t>(rhs_batched) * b * lhs_width + w];
-      }  // w
-
-      output_data[b * lhs_height + h] = sum;
-    }  // h
-  }   // b
+  // Each pass computes h_block_size rows, so that every element of rhs is
+  // loaded once for all of them.
+  const index_t h_block_size = 4;
+  const index_t h_block_count = RoundUpDiv(lhs_height, h_block_size);
+
+  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+
+  thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                            index_t start1, index_t end1, index_t step1) {
+    for (index_t b = start0; b < end0; b += step0) {
+      const T *rhs_ptr =
+          rhs_data + static_cast<index_t>(rhs_batched) * b * lhs_width;
+      const T *lhs_base = lhs_data
+          + static_cast<index_t>(lhs_batched) * b * lhs_height * lhs_width;
+      T *out_ptr = output_data + b * lhs_height;
+      for (index_t h_block_idx = start1; h_block_idx < end1;
+           h_block_idx += step1) {
+        const index_t h_start = h_block_idx * h_block_size;
+        const index_t h_len = std::min(h_block_size, lhs_height - h_start);
+        const T *lhs_ptr = lhs_base + h_start * lhs_width;
+
+        if (h_len == h_block_size) {
+          const T *lhs_ptr0 = lhs_ptr;
+          const T *lhs_ptr1 = lhs_ptr0 + lhs_width;
+          const T *lhs_ptr2 = lhs_ptr1 + lhs_width;
+          const T *lhs_ptr3 = lhs_ptr2 + lhs_width;
+          float sum0 = 0.f;
+          float sum1 = 0.f;
+          float sum2 = 0.f;
+          float sum3 = 0.f;
+          for (index_t w = 0; w < lhs_width; ++w) {
+            const float r = rhs_ptr[w];
+            sum0 += static_cast<float>(lhs_ptr0[w]) * r;
+            sum1 += static_cast<float>(lhs_ptr1[w]) * r;
+            sum2 += static_cast<float>(lhs_ptr2[w]) * r;
+            sum3 += static_cast<float>(lhs_ptr3[w]) * r;
+          }  // w
+          if (bias_data != nullptr) {
+            sum0 += bias_data[h_start];
+            sum1 += bias_data[h_start + 1];
+            sum2 += bias_data[h_start + 2];
+            sum3 += bias_data[h_start + 3];
+          }
+          out_ptr[h_start] = sum0;
+          out_ptr[h_start + 1] = sum1;
+          out_ptr[h_start + 2] = sum2;
+          out_ptr[h_start + 3] = sum3;
+        } else {
+          for (index_t h = 0; h < h_len; ++h) {
+            float sum = bias_data != nullptr ?
+                static_cast<float>(bias_data[h_start + h]) : 0.f;
+            for (index_t w = 0; w < lhs_width; ++w) {
+              sum += static_cast<float>(lhs_ptr[h * lhs_width + w])
+                  * static_cast<float>(rhs_ptr[w]);
+            }  // w
+            out_ptr[h_start + h] = sum;
+          }  // h
+        }
+      }  // h_block_idx
+    }  // b
+  }, 0, batch, 1, 0, h_block_count, 1);
 
   return MaceStatus::MACE_SUCCESS;
 }
@@ -24,6 +24,7 @@ extern void RegisterConv2dDelegator(OpDelegatorRegistry *registry);
 extern void RegisterDeconv2dDelegator(OpDelegatorRegistry *registry);
 extern void RegisterDepthwiseConv2dDelegator(OpDelegatorRegistry *registry);
 extern void RegisterDepthwiseDeconv2dDelegator(OpDelegatorRegistry *registry);
+extern void RegisterGroupDeconv2dDelegator(OpDelegatorRegistry *registry);
 extern void RegisterGemmDelegator(OpDelegatorRegistry *registry);
 extern void RegisterGemvDelegator(OpDelegatorRegistry *registry);
 
@@ -84,6 +85,15 @@ extern void RegisterGemvDelegator(OpDelegatorRegistry *registry);
 }  // namespace arm
 #endif  // MACE_ENABLE_NEON
 
+#ifdef MACE_ENABLE_X86
+namespace x86 {
+extern void RegisterConv2dDelegator(OpDelegatorRegistry *registry);
+extern void RegisterDepthwiseConv2dDelegator(OpDelegatorRegistry *registry);
+extern void RegisterGemmDelegator(OpDelegatorRegistry *registry);
+extern void RegisterGemvDelegator(OpDelegatorRegistry *registry);
+}  // namespace x86
+#endif  // MACE_ENABLE_X86
+
 void RegisterAllOpDelegators(OpDelegatorRegistry *registry) {
 #ifdef MACE_ENABLE_CPU
   ref::RegisterActivationDelegator(registry);
@@ -92,6 +102,7 @@ void RegisterAllOpDelegators(OpDelegatorRegistry *registry) {
   ref::RegisterDeconv2dDelegator(registry);
   ref::RegisterDepthwiseConv2dDelegator(registry);
   ref::RegisterDepthwiseDeconv2dDelegator(registry);
+  ref::RegisterGroupDeconv2dDelegator(registry);
   ref::RegisterGemmDelegator(registry);
   ref::RegisterGemvDelegator(registry);
 #ifdef MACE_ENABLE_QUANTIZE
@@ -137,6 +148,13 @@ void RegisterAllOpDelegators(OpDelegatorRegistry *registry) {
 #endif  // MACE_ENABLE_QUANTIZE
 
 #endif  // MACE_ENABLE_NEON
+
+#ifdef MACE_ENABLE_X86
+  x86::RegisterConv2dDelegator(registry);
+  x86::RegisterDepthwiseConv2dDelegator(registry);
+  x86::RegisterGemmDelegator(registry);
+  x86::RegisterGemvDelegator(registry);
+#endif  // MACE_ENABLE_X86
 #else
   MACE_UNUSED(registry);
 #endif  // MACE_ENABLE_CPU
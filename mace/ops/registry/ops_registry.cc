@@ -61,6 +61,7 @@ extern void RegisterPNorm(OpRegistry *op_registry);
 extern void RegisterPooling(OpRegistry *op_registry);
 extern void RegisterExtractImagePatches(OpRegistry *op_registry);
 extern void RegisterReduce(OpRegistry *op_registry);
+extern void RegisterReorder(OpRegistry *op_registry);
 extern void RegisterReplaceIndex(OpRegistry *op_registry);
 extern void RegisterPriorBox(OpRegistry *op_registry);
 extern void RegisterReshape(OpRegistry *op_registry);
@@ -85,6 +86,7 @@ extern void RegisterSubsample(OpRegistry *op_registry);
 extern void RegisterSumGroup(OpRegistry *op_registry);
 extern void RegisterTargetRMSNorm(OpRegistry *op_registry);
 extern void RegisterTile(OpRegistry *op_registry);
+extern void RegisterTopK(OpRegistry *op_registry);
 extern void RegisterTranspose(OpRegistry *op_registry);
 extern void RegisterUnstack(OpRegistry *op_registry);
 extern void RegisterUnsqueeze(OpRegistry *op_registry);
@@ -147,6 +149,7 @@ void RegisterAllOps(OpRegistry *registry) {
   ops::RegisterPooling(registry);
   ops::RegisterExtractImagePatches(registry);
   ops::RegisterReduce(registry);
+  ops::RegisterReorder(registry);
   ops::RegisterReplaceIndex(registry);
   ops::RegisterPriorBox(registry);
   ops::RegisterReshape(registry);
@@ -171,6 +174,7 @@ void RegisterAllOps(OpRegistry *registry) {
   ops::RegisterSumGroup(registry);
   ops::RegisterTargetRMSNorm(registry);
   ops::RegisterTile(registry);
+  ops::RegisterTopK(registry);
   ops::RegisterTranspose(registry);
   ops::RegisterUnstack(registry);
   ops::RegisterUnsqueeze(registry);
@@ -0,0 +1,121 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "mace/core/ops/operator.h"
+#include "mace/core/registry/ops_registry.h"
+#include "mace/utils/math.h"
+
+namespace mace {
+namespace ops {
+
+// Reorder the tensor between NCHW and the CPU internal NCHWc, it is added by
+// the NetDefAdapter at the edges of the ops running in NCHWc.
+template<RuntimeType D, class T>
+class ReorderOp;
+
+template<class T>
+class ReorderOp<RuntimeType::RT_CPU, T> : public Operation {
+ public:
+  explicit ReorderOp(OpConstructContext *context)
+      : Operation(context),
+        channels_(Operation::GetOptionalArg<int>("channels", 0)),
+        dst_data_format_(static_cast<DataFormat>(
+            Operation::GetOptionalArg<int>(
+                "data_format", static_cast<int>(DataFormat::NCHW)))) {}
+
+  MaceStatus Run(OpContext *context) override {
+    const Tensor *input = this->Input(0);
+    Tensor *output = this->Output(0);
+    const T *input_data = input->data<T>();
+    utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+
+    if (dst_data_format_ == DataFormat::NCHWc) {
+      MACE_CHECK(input->dim_size() == 4);
+      const index_t batch = input->dim(0);
+      const index_t channels = input->dim(1);
+      const index_t image_size = input->dim(2) * input->dim(3);
+      const index_t blocks = RoundUpDiv(channels, kNCHWcBlock);
+      MACE_RETURN_IF_ERROR(output->Resize(
+          {batch, blocks, input->dim(2), input->dim(3), kNCHWcBlock}));
+      T *output_data = output->mutable_data<T>();
+
+      thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                                index_t start1, index_t end1, index_t step1) {
+        for (index_t b = start0; b < end0; b += step0) {
+          for (index_t cb = start1; cb < end1; cb += step1) {
+            const index_t c_begin = cb * kNCHWcBlock;
+            const index_t valid = std::min(kNCHWcBlock, channels - c_begin);
+            T *dst = output_data + (b * blocks + cb) * image_size * kNCHWcBlock;
+            if (valid < kNCHWcBlock) {
+              memset(dst, 0, image_size * kNCHWcBlock * sizeof(T));
+            }
+            for (index_t l = 0; l < valid; ++l) {
+              const T *src =
+                  input_data + (b * channels + c_begin + l) * image_size;
+              for (index_t i = 0; i < image_size; ++i) {
+                dst[i * kNCHWcBlock + l] = src[i];
+              }
+            }
+          }
+        }
+      }, 0, batch, 1, 0, blocks, 1);
+    } else {
+      MACE_CHECK(dst_data_format_ == DataFormat::NCHW &&
+                 input->dim_size() == 5 && input->dim(4) == kNCHWcBlock);
+      const index_t batch = input->dim(0);
+      const index_t blocks = input->dim(1);
+      const index_t image_size = input->dim(2) * input->dim(3);
+      MACE_CHECK(channels_ > (blocks - 1) * kNCHWcBlock &&
+                 channels_ <= blocks * kNCHWcBlock,
+                 "channels ", channels_, " mismatch the blocks ", blocks);
+      const index_t channels = channels_;
+      MACE_RETURN_IF_ERROR(output->Resize(
+          {batch, channels, input->dim(2), input->dim(3)}));
+      T *output_data = output->mutable_data<T>();
+
+      thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                                index_t start1, index_t end1, index_t step1) {
+        for (index_t b = start0; b < end0; b += step0) {
+          for (index_t c = start1; c < end1; c += step1) {
+            const T *src = input_data +
+                ((b * blocks + c / kNCHWcBlock) * image_size) * kNCHWcBlock +
+                c % kNCHWcBlock;
+            T *dst = output_data + (b * channels + c) * image_size;
+            for (index_t i = 0; i < image_size; ++i) {
+              dst[i] = src[i * kNCHWcBlock];
+            }
+          }
+        }
+      }, 0, batch, 1, 0, channels, 1);
+    }
+
+    return MaceStatus::MACE_SUCCESS;
+  }
+
+ private:
+  const index_t channels_;
+  const DataFormat dst_data_format_;
+};
+
+void RegisterReorder(OpRegistry *op_registry) {
+  MACE_REGISTER_OP(op_registry, "Reorder", ReorderOp,
+                   RuntimeType::RT_CPU, float);
+}
+
+}  // namespace ops
+}  // namespace mace
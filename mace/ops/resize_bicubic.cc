@@ -20,6 +20,7 @@
 #include "mace/core/ops/operator.h"
 #include "mace/core/registry/ops_registry.h"
 #include "mace/ops/common/coordinate_transformation_mode.h"
+#include "mace/ops/common/resize.h"
 #include "mace/ops/common/utils.h"
 #ifdef MACE_ENABLE_OPENCL
 #include "mace/ops/opencl/image/resize_bicubic.h"
@@ -114,70 +115,29 @@ inline void GetWeightsAndIndices(
   }
 }
 
-inline float Interpolate1D(const std::vector<float> &weights,
-                           const std::vector<float> &values) {
-  return values[0] * weights[0] + values[1] * weights[1] +
-      values[2] * weights[2] + values[3] * weights[3];
-}
-
-inline void ResizeImage(
-    const OpContext *context,
-    const float *images,
-    const index_t batch_size,
-    const index_t in_height,
-    const index_t in_width,
-    const index_t out_height,
-    const index_t out_width,
-    const index_t channels,
-    const float height_scale,
-    const float width_scale,
+// The 4 taps of bicubic interpolation along an axis.
+inline void BuildCubicTable(
+    const index_t out_size,
+    const index_t in_size,
+    const float scale,
     const CoordinateTransformationMode coordinate_transformation_mode,
-    float *output) {
-  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
-  thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
-                            index_t start1, index_t end1, index_t step1) {
-    for (index_t b = start0; b < end0; b += step0) {
-      for (index_t y = start1; y < end1; y += step1) {
-        std::vector<float> y_weights;
-        std::vector<index_t> y_indices;
-        GetWeightsAndIndices(height_scale, coordinate_transformation_mode, y,
-                             out_height, in_height, &y_weights, &y_indices);
-        for (index_t x = 0; x < out_width; ++x) {
-          std::vector<float> x_weights;
-          std::vector<index_t> x_indices;
-          GetWeightsAndIndices(width_scale, coordinate_transformation_mode, x,
-                               out_width, in_width, &x_weights, &x_indices);
-
-          for (index_t c = 0; c < channels; ++c) {
-            // Use a 4x4 patch to compute the interpolated output value at
-            // (b, y, x, c).
-            const float *channel_input_ptr =
-                images + (b * channels + c) * in_height * in_width;
-            float *channel_output_ptr =
-                output + (b * channels + c) * out_height * out_width;
-            std::vector<float> coeff(4, 0.0);
-            for (index_t i = 0; i < 4; ++i) {
-              const std::vector<float> values = {
-                  channel_input_ptr[y_indices[i] * in_width + x_indices[0]],
-                  channel_input_ptr[y_indices[i] * in_width + x_indices[1]],
-                  channel_input_ptr[y_indices[i] * in_width + x_indices[2]],
-                  channel_input_ptr[y_indices[i] * in_width + x_indices[3]]};
-              coeff[i] = Interpolate1D(x_weights, values);
-            }
-            channel_output_ptr[y * out_width + x] =
-                Interpolate1D(y_weights, coeff);
-          }
-        }
-      }
-    }
-  }, 0, batch_size, 1, 0, out_height, 1);
+    ResizeAxisTable *table) {
+  table->Reset(out_size, 4);
+  std::vector<float> weights;
+  std::vector<index_t> indices;
+  for (index_t i = 0; i < out_size; ++i) {
+    GetWeightsAndIndices(scale, coordinate_transformation_mode, i, out_size,
+                         in_size, &weights, &indices);
+    std::copy(indices.begin(), indices.end(), table->indices.begin() + i * 4);
+    std::copy(weights.begin(), weights.end(), table->weights.begin() + i * 4);
+  }
 }
 
 template<RuntimeType D, class T>
 class ResizeBicubicOp;
 
-template<>
-class ResizeBicubicOp<RuntimeType::RT_CPU, float> : public Operation {
+template<typename T>
+class ResizeBicubicOp<RuntimeType::RT_CPU, T> : public Operation {
  public:
   explicit ResizeBicubicOp(OpConstructContext *context)
       : Operation(context),
@@ -213,8 +173,8 @@ class ResizeBicubicOp<RuntimeType::RT_CPU, float> : public Operation {
     std::vector<index_t> out_shape{batch, channels, out_height, out_width};
     MACE_RETURN_IF_ERROR(output->Resize(out_shape));
 
-    const float *input_data = input->data<float>();
-    float *output_data = output->mutable_data<float>();
+    const T *input_data = input->data<T>();
+    T *output_data = output->mutable_data<T>();
 
     if (out_height == in_height && out_width == in_width) {
       std::copy(input_data,
@@ -223,27 +183,19 @@ class ResizeBicubicOp<RuntimeType::RT_CPU, float> : public Operation {
       return MaceStatus::MACE_SUCCESS;
     }
 
-    float height_scale =
-        common::utils::CalculateResizeScale(in_height,
-                                            out_height,
-                                            align_corners_);
-    float width_scale =
-        common::utils::CalculateResizeScale(in_width,
-                                            out_width,
-                                            align_corners_);
+    if (tables_.NeedBuild(in_height, in_width, out_height, out_width)) {
+      const float height_scale = common::utils::CalculateResizeScale(
+          in_height, out_height, align_corners_);
+      const float width_scale = common::utils::CalculateResizeScale(
+          in_width, out_width, align_corners_);
+      BuildCubicTable(out_height, in_height, height_scale,
+                      coordinate_transformation_mode_, &tables_.ys);
+      BuildCubicTable(out_width, in_width, width_scale,
+                      coordinate_transformation_mode_, &tables_.xs);
+    }
 
-    ResizeImage(context,
-                input_data,
-                batch,
-                in_height,
-                in_width,
-                out_height,
-                out_width,
-                channels,
-                height_scale,
-                width_scale,
-                coordinate_transformation_mode_,
-                output_data);
+    ResizeImageSeparable(context, input_data, batch * channels, tables_,
+                         output_data);
 
     return MaceStatus::MACE_SUCCESS;
   }
@@ -252,6 +204,7 @@ class ResizeBicubicOp<RuntimeType::RT_CPU, float> : public Operation {
   bool align_corners_;
   CoordinateTransformationMode coordinate_transformation_mode_;
   std::vector<index_t> size_;
+  ResizeTables tables_;
 };
 
 #ifdef MACE_ENABLE_OPENCL
@@ -303,6 +256,8 @@ class ResizeBicubicOp<RuntimeType::RT_OPENCL, float> : public Operation {
 void RegisterResizeBicubic(OpRegistry *op_registry) {
   MACE_REGISTER_OP(op_registry, "ResizeBicubic", ResizeBicubicOp,
                    RuntimeType::RT_CPU, float);
+  MACE_REGISTER_BF16_OP(op_registry, "ResizeBicubic", ResizeBicubicOp,
+                        RuntimeType::RT_CPU);
 
   MACE_REGISTER_GPU_OP(op_registry, "ResizeBicubic", ResizeBicubicOp);
 
@@ -21,6 +21,7 @@
 #include "mace/utils/memory.h"
 #include "mace/core/quantize.h"
 #include "mace/ops/common/coordinate_transformation_mode.h"
+#include "mace/ops/common/resize.h"
 #include "mace/ops/common/utils.h"
 #ifdef MACE_ENABLE_OPENCL
 #include "mace/ops/opencl/image/resize_bilinear.h"
@@ -85,52 +86,24 @@ inline uint8_t ComputeLerp<uint8_t>(const uint8_t top_left,
   return Saturate<uint8_t>(roundf(top + (bottom - top) * y_lerp));
 }
 
-template<typename T>
-inline void ResizeImageNCHW(const OpContext *context,
-                            const T *images,
-                            const index_t batch_size,
-                            const index_t in_height,
-                            const index_t in_width,
-                            const index_t out_height,
-                            const index_t out_width,
-                            const index_t channels,
-                            const std::vector<CachedInterpolation> &xs_vec,
-                            const std::vector<CachedInterpolation> &ys,
-                            T *output) {
-  const CachedInterpolation *xs = xs_vec.data();
-
-  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
-
-  thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
-                            index_t start1, index_t end1, index_t step1) {
-    for (index_t b = start0; b < end0; b += step0) {
-      for (index_t c = start1; c < end1; c += step1) {
-        const T
-            *channel_input_ptr =
-            images + (b * channels + c) * in_height * in_width;
-        T *channel_output_ptr =
-            output + (b * channels + c) * out_height * out_width;
-        for (index_t y = 0; y < out_height; ++y) {
-          const T *y_lower_input_ptr =
-              channel_input_ptr + ys[y].lower * in_width;
-          const T *y_upper_input_ptr =
-              channel_input_ptr + ys[y].upper * in_width;
-          const float ys_lerp = ys[y].lerp;
-
-          for (index_t x = 0; x < out_width; ++x) {
-            const float xs_lerp = xs[x].lerp;
-            const T top_left = y_lower_input_ptr[xs[x].lower];
-            const T top_right = y_lower_input_ptr[xs[x].upper];
-            const T bottom_left = y_upper_input_ptr[xs[x].lower];
-            const T bottom_right = y_upper_input_ptr[xs[x].upper];
-            channel_output_ptr[y * out_width + x] =
-                ComputeLerp(top_left, top_right, bottom_left,
-                            bottom_right, xs_lerp, ys_lerp);
-          }
-        }
-      }
-    }
-  }, 0, batch_size, 1, 0, channels, 1);
+// The 2 taps of linear interpolation along an axis.
+inline void BuildLinearTable(
+    const index_t out_size,
+    const index_t in_size,
+    const float scale,
+    const CoordinateTransformationMode coordinate_transformation_mode,
+    ResizeAxisTable *table) {
+  std::vector<CachedInterpolation> interpolation(out_size + 1);
+  ComputeInterpolationWeights(out_size, in_size, scale,
+                              coordinate_transformation_mode,
+                              interpolation.data());
+  table->Reset(out_size, 2);
+  for (index_t i = 0; i < out_size; ++i) {
+    table->indices[i * 2] = interpolation[i].lower;
+    table->indices[i * 2 + 1] = interpolation[i].upper;
+    table->weights[i * 2] = 1.f - interpolation[i].lerp;
+    table->weights[i * 2 + 1] = interpolation[i].lerp;
+  }
 }
 
 template<typename T>
@@ -235,34 +208,19 @@ class ResizeBilinearOp<RuntimeType::RT_CPU, T> : public Operation {
       return MaceStatus::MACE_SUCCESS;
     }
 
-    // ONNX's scale is the opposite of ours
-    float height_scale = common::utils::CalculateResizeScale(in_height,
-                                                             out_height,
-                                                             align_corners_);
-    float width_scale = common::utils::CalculateResizeScale(in_width,
-                                                            out_width,
-                                                            align_corners_);
-
-    std::vector<CachedInterpolation> ys(out_height + 1);
-    std::vector<CachedInterpolation> xs(out_width + 1);
-
-    // Compute the cached interpolation weights on the x and y dimensions.
-    ComputeInterpolationWeights(out_height, in_height, height_scale,
-                                coordinate_transformation_mode_, ys.data());
-    ComputeInterpolationWeights(out_width, in_width, width_scale,
-                                coordinate_transformation_mode_, xs.data());
+    if (tables_.NeedBuild(in_height, in_width, out_height, out_width)) {
+      const float height_scale = common::utils::CalculateResizeScale(
+          in_height, out_height, align_corners_);
+      const float width_scale = common::utils::CalculateResizeScale(
+          in_width, out_width, align_corners_);
+      BuildLinearTable(out_height, in_height, height_scale,
+                       coordinate_transformation_mode_, &tables_.ys);
+      BuildLinearTable(out_width, in_width, width_scale,
+                       coordinate_transformation_mode_, &tables_.xs);
+    }
 
-    ResizeImageNCHW(context,
-                    input_data,
-                    batch,
-                    in_height,
-                    in_width,
-                    out_height,
-                    out_width,
-                    channels,
-                    xs,
-                    ys,
-                    output_data);
+    ResizeImageSeparable(context, input_data, batch * channels, tables_,
+                         output_data);
 
     return MaceStatus::MACE_SUCCESS;
   }
@@ -273,6 +231,7 @@ class ResizeBilinearOp<RuntimeType::RT_CPU, T> : public Operation {
   float height_scale_;
   float width_scale_;
   CoordinateTransformationMode coordinate_transformation_mode_;
+  ResizeTables tables_;
 };
 
 #ifdef MACE_ENABLE_QUANTIZE
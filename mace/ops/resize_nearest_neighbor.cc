@@ -21,6 +21,7 @@
 #include "mace/core/ops/operator.h"
 #include "mace/core/registry/ops_registry.h"
 #include "mace/ops/common/coordinate_transformation_mode.h"
+#include "mace/ops/common/resize.h"
 #include "mace/ops/common/utils.h"
 #ifdef MACE_ENABLE_OPENCL
 #include "mace/ops/opencl/image/resize_nearest_neighbor.h"
@@ -59,56 +60,25 @@ namespace {
 
 }  // namespace
 
-template <typename T>
-inline void ResizeImageNCHW(
-    const OpContext *context,
-    const T *images,
-    const index_t batch_size,
-    const index_t in_height,
-    const index_t in_width,
-    const index_t out_height,
-    const index_t out_width,
-    const index_t channels,
-    const float height_scale,
-    const float width_scale,
+// The single tap of nearest neighbor along an axis.
+inline void BuildNearestTable(
+    const index_t out_size,
+    const index_t in_size,
+    const float scale,
     const bool align_corners,
     const CoordinateTransformationMode coordinate_transformation_mode,
-    const NearestFunc nearest_func,
-    T *output) {
-  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
-
-  thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
-                            index_t start1, index_t end1, index_t step1) {
-    for (index_t b = start0; b < end0; b += step0) {
-      for (index_t c = start1; c < end1; c += step1) {
-        const T
-            *channel_input_ptr =
-            images + (b * channels + c) * in_height * in_width;
-        T *channel_output_ptr =
-            output + (b * channels + c) * out_height * out_width;
-        for (index_t y = 0; y < out_height; ++y) {
-          const float in_f_y = coordinate_transformation_mode == HALF_PIXEL ?
-                               (static_cast<float>(y) + 0.5f) * height_scale :
-                               y * height_scale;
-          const index_t in_y = std::min(
-              (align_corners) ? static_cast<index_t>(roundf(in_f_y))
-                              : static_cast<index_t>(nearest_func(in_f_y)),
-              in_height - 1);
-          for (int x = 0; x < out_width; ++x) {
-            const float in_f_x = coordinate_transformation_mode == HALF_PIXEL ?
-                                 (static_cast<float>(x) + 0.5f) * width_scale :
-                                 x * width_scale;
-            const index_t in_x = std::min(
-                (align_corners) ? static_cast<index_t>(roundf(in_f_x))
-                                : static_cast<index_t>(nearest_func(in_f_x)),
-                in_width - 1);
-            channel_output_ptr[y * out_width + x] =
-                channel_input_ptr[in_y * in_width + in_x];
-          }
-        }
-      }
-    }
-  }, 0, batch_size, 1, 0, channels, 1);
+    const NearestFunc &nearest_func,
+    ResizeAxisTable *table) {
+  table->Reset(out_size, 1);
+  for (index_t i = 0; i < out_size; ++i) {
+    const float in_f = coordinate_transformation_mode == HALF_PIXEL ?
+                       (static_cast<float>(i) + 0.5f) * scale : i * scale;
+    table->indices[i] = std::min(
+        align_corners ? static_cast<index_t>(roundf(in_f))
+                      : static_cast<index_t>(nearest_func(in_f)),
+        in_size - 1);
+    table->weights[i] = 1.f;
+  }
 }
 
 template<RuntimeType D, typename T>
@@ -177,29 +147,24 @@ class ResizeNearestNeighborOp<RuntimeType::RT_CPU, T> : public Operation {
       return MaceStatus::MACE_SUCCESS;
     }
 
-    // Caffe/ONNX's scale is the opposite of ours
-    float height_scale = height_scale_ > 0 ? 1 / height_scale_ :
-                         common::utils::CalculateResizeScale(in_height,
-                                                             out_height,
-                                                             align_corners_);
-    float width_scale = width_scale_ > 0 ? 1 / width_scale_ :
-                        common::utils::CalculateResizeScale(in_width,
-                                                            out_width,
-                                                            align_corners_);
-    ResizeImageNCHW(context,
-                    input_data,
-                    batch,
-                    in_height,
-                    in_width,
-                    out_height,
-                    out_width,
-                    channels,
-                    height_scale,
-                    width_scale,
-                    align_corners_,
-                    coordinate_transformation_mode_,
-                    nearest_func_,
-                    output_data);
+    if (tables_.NeedBuild(in_height, in_width, out_height, out_width)) {
+      // Caffe/ONNX's scale is the opposite of ours
+      const float height_scale = height_scale_ > 0 ? 1 / height_scale_ :
+          common::utils::CalculateResizeScale(in_height, out_height,
+                                              align_corners_);
+      const float width_scale = width_scale_ > 0 ? 1 / width_scale_ :
+          common::utils::CalculateResizeScale(in_width, out_width,
+                                              align_corners_);
+      BuildNearestTable(out_height, in_height, height_scale, align_corners_,
+                        coordinate_transformation_mode_, nearest_func_,
+                        &tables_.ys);
+      BuildNearestTable(out_width, in_width, width_scale, align_corners_,
+                        coordinate_transformation_mode_, nearest_func_,
+                        &tables_.xs);
+    }
+
+    ResizeImageSeparable(context, input_data, batch * channels, tables_,
+                         output_data);
     return MaceStatus::MACE_SUCCESS;
   }
 
@@ -211,6 +176,7 @@ class ResizeNearestNeighborOp<RuntimeType::RT_CPU, T> : public Operation {
   float height_scale_;
   float width_scale_;
   NearestFunc nearest_func_;
+  ResizeTables tables_;
 };
 
 #ifdef MACE_ENABLE_OPENCL
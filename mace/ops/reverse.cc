@@ -28,7 +28,6 @@ class ReverseOp<RuntimeType::RT_CPU, T> : public Operation {
       : Operation(context) {}
 
   MaceStatus Run(OpContext *context) override {
-    MACE_UNUSED(context);
     const Tensor *input = this->Input(INPUT);
     const Tensor *axis = this->Input(AXIS);
     Tensor *output = this->Output(OUTPUT);
@@ -54,17 +53,22 @@ class ReverseOp<RuntimeType::RT_CPU, T> : public Operation {
     const T *input_data = input->data<T>();
     T *output_data = output->mutable_data<T>();
 
-    index_t reverse_size = input_shape[reverse_dim] * low_dim_elem_size;
-    for (index_t h = 0; h < high_dim_elem_size; ++h) {
-      int input_idx = h * reverse_size;
-      int output_idx = input_idx + reverse_size;
-      for (index_t i = 0; i < input_shape[reverse_dim]; ++i) {
-        output_idx -= low_dim_elem_size;
-        memcpy(output_data + output_idx, input_data + input_idx,
-               sizeof(T) * low_dim_elem_size);
-        input_idx += low_dim_elem_size;
+    const index_t reverse_dim_size = input_shape[reverse_dim];
+    const index_t reverse_size = reverse_dim_size * low_dim_elem_size;
+    utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+    thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                              index_t start1, index_t end1, index_t step1) {
+      for (index_t h = start0; h < end0; h += step0) {
+        for (index_t i = start1; i < end1; i += step1) {
+          const index_t input_idx = h * reverse_size + i * low_dim_elem_size;
+          const index_t output_idx =
+              h * reverse_size + (reverse_dim_size - 1 - i) * low_dim_elem_size;
+          memcpy(output_data + output_idx, input_data + input_idx,
+                 sizeof(T) * low_dim_elem_size);
+        }
       }
-    }
+    }, 0, high_dim_elem_size, 1, 0, reverse_dim_size, 1, 0, 0,
+       low_dim_elem_size);
     return MaceStatus::MACE_SUCCESS;
   }
 
@@ -20,6 +20,7 @@
 
 #include "mace/core/ops/operator.h"
 #include "mace/core/registry/ops_registry.h"
+#include "mace/ops/common/transcendental.h"
 
 #if defined(MACE_ENABLE_NEON)
 #include <arm_neon.h>
@@ -332,8 +333,9 @@ class SoftmaxOp<RuntimeType::RT_CPU, float> : public Operation {
             float *output_ptr = output_c_base + k;
             float *cache_k_ptr = cache_ptr + k;
             for (index_t i = 0; i < step; ++i) {
-              output_ptr[i] = std::exp(input_ptr[i] - cache_k_ptr[i]);
+              output_ptr[i] = input_ptr[i] - cache_k_ptr[i];
             }
+            VectorExp(output_ptr, output_ptr, step);
           }
         }
 
@@ -371,9 +373,7 @@ class SoftmaxOp<RuntimeType::RT_CPU, float> : public Operation {
             float *output_c_base = output_b_base + c_offset;
             for (index_t k = start; k < end; k += step) {
               float *output_ptr = output_c_base + k;
-              for (index_t i = 0; i < step; ++i) {
-                output_ptr[i] = std::log(output_ptr[i]);
-              }
+              VectorLog(output_ptr, output_ptr, step);
             }
           }
         }  // use_log_
@@ -455,9 +455,8 @@ class SoftmaxOp<RuntimeType::RT_CPU, float> : public Operation {
     }
 
     thread_pool.Compute1D([=](index_t start, index_t end, index_t step) {
-        for (index_t k = start; k < end; k += step) {
-          output_data[k] = std::exp(output_data[k]);
-        }
+      MACE_UNUSED(step);
+      VectorExp(output_data + start, output_data + start, end - start);
     }, 0, batch_size, 1);
 
     for (index_t b_offset = 0; b_offset < batch_size;
@@ -481,22 +480,18 @@ class SoftmaxOp<RuntimeType::RT_CPU, float> : public Operation {
           for (; c < class_size; ++c) {
             sum += output_ptr[c];
           }
-          if (use_log_) {
-            for (index_t c = 0; c < class_size; ++c) {
-              float output = (static_cast<float>(output_ptr[c])) / sum;
-              output_ptr[c] = std::log(output);
-            }
-          } else {
-            index_t c = 0;
+          c = 0;
 #if defined(MACE_ENABLE_NEON)
-            float div = 1.f / sum;
-            for (; c + 3 < class_size; c += 4) {
-              vst1q_f32(output_ptr + c, vmulq_n_f32(vld1q_f32(output_ptr + c), div));
-            }
+          float div = 1.f / sum;
+          for (; c + 3 < class_size; c += 4) {
+            vst1q_f32(output_ptr + c, vmulq_n_f32(vld1q_f32(output_ptr + c), div));
+          }
 #endif
-            for (; c < class_size; ++c) {
-              output_ptr[c] /= sum;
-            }
+          for (; c < class_size; ++c) {
+            output_ptr[c] /= sum;
+          }
+          if (use_log_) {
+            VectorLog(output_ptr, output_ptr, class_size);
           }
         }  // k
       }, 0, hw_size, hw_stride);
@@ -97,7 +97,6 @@ class SpaceToBatchNDOp<RuntimeType::RT_CPU, T> : public SpaceToBatchOpBase {
       : SpaceToBatchOpBase(context) {}
 
   MaceStatus Run(OpContext *context) override {
-    MACE_UNUSED(context);
     const Tensor *space_tensor = this->Input(0);
     Tensor *batch_tensor = this->Output(0);
     std::vector<index_t> output_shape(4, 0);
@@ -128,68 +127,68 @@ class SpaceToBatchNDOp<RuntimeType::RT_CPU, T> : public SpaceToBatchOpBase {
         std::max(static_cast<index_t>(1), 8 * 1024 / block_shape_w / in_width);
 
     // make channel outter loop so we can make best use of cache
-    for (index_t c = 0; c < channels; ++c) {
-      for (index_t block_h = 0; block_h < out_height;
-           block_h += block_h_size) {
-        for (index_t b = 0; b < out_batches; ++b) {
-          const index_t in_b = b % in_batches;
-          const index_t tile_index = b / in_batches;
-          const index_t tile_h = tile_index / block_shape_w;
-          const index_t tile_w = tile_index % block_shape_w;
-          const index_t valid_h_start = std::max(block_h,
-                                                 (pad_top - tile_h
-                                                     + block_shape_h - 1)
-                                                     / block_shape_h);
-          const index_t valid_h_end = std::min(out_height,
-                                               std::min(
-                                                   block_h + block_h_size,
-                                                   (in_height + pad_top
-                                                       - tile_h
-                                                       + block_shape_h - 1)
-                                                       / block_shape_h));
-          const index_t valid_w_start = std::max(static_cast<index_t>(0),
-                                                 (pad_left - tile_w
-                                                     + block_shape_w - 1)
-                                                     / block_shape_w);
-          const index_t valid_w_end = std::min(out_width,
-                                               (in_width + pad_left - tile_w
-                                                   + block_shape_w - 1)
-                                                   / block_shape_w);
-          const T *input_base =
-              input_data + (in_b * channels + c) * in_height * in_width;
-          T *output_base =
-              output_data + (b * channels + c) * out_height * out_width;
-
-          memset(static_cast<void *>(output_base + block_h * out_width),
-                 0,
-                 (valid_h_start - block_h) * out_width * sizeof(T));
-
-          index_t in_h = valid_h_start * block_shape_h + tile_h - pad_top;
-          for (index_t h = valid_h_start; h < valid_h_end; ++h) {
-            memset(static_cast<void *>(output_base + h * out_width),
+    utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+    thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                              index_t start1, index_t end1, index_t step1) {
+      for (index_t c = start0; c < end0; c += step0) {
+        for (index_t block_h = 0; block_h < out_height;
+             block_h += block_h_size) {
+          for (index_t b = start1; b < end1; b += step1) {
+            const index_t in_b = b % in_batches;
+            const index_t tile_index = b / in_batches;
+            const index_t tile_h = tile_index / block_shape_w;
+            const index_t tile_w = tile_index % block_shape_w;
+            const index_t valid_h_start = std::max(
+                block_h, (pad_top - tile_h + block_shape_h - 1)
+                    / block_shape_h);
+            const index_t valid_h_end = std::min(
+                out_height, std::min(
+                    block_h + block_h_size,
+                    (in_height + pad_top - tile_h + block_shape_h - 1)
+                        / block_shape_h));
+            const index_t valid_w_start = std::max(
+                static_cast<index_t>(0),
+                (pad_left - tile_w + block_shape_w - 1) / block_shape_w);
+            const index_t valid_w_end = std::min(
+                out_width,
+                (in_width + pad_left - tile_w + block_shape_w - 1)
+                    / block_shape_w);
+            const T *input_base =
+                input_data + (in_b * channels + c) * in_height * in_width;
+            T *output_base =
+                output_data + (b * channels + c) * out_height * out_width;
+
+            memset(static_cast<void *>(output_base + block_h * out_width),
+                   0,
+                   (valid_h_start - block_h) * out_width * sizeof(T));
+
+            index_t in_h = valid_h_start * block_shape_h + tile_h - pad_top;
+            for (index_t h = valid_h_start; h < valid_h_end; ++h) {
+              memset(static_cast<void *>(output_base + h * out_width),
+                     0,
+                     valid_w_start * sizeof(T));
+
+              index_t in_w = valid_w_start * block_shape_w + tile_w - pad_left;
+              for (index_t w = valid_w_start; w < valid_w_end; ++w) {
+                output_base[h * out_width + w] =
+                    input_base[in_h * in_width + in_w];
+                in_w += block_shape_w;
+              }  // w
+              in_h += block_shape_h;
+
+              memset(static_cast<void *>(
+                         output_base + h * out_width + valid_w_end),
+                     0, (out_width - valid_w_end) * sizeof(T));
+            }  // h
+
+            memset(static_cast<void *>(output_base + valid_h_end * out_width),
                    0,
-                   valid_w_start * sizeof(T));
-
-            index_t in_w = valid_w_start * block_shape_w + tile_w - pad_left;
-            for (index_t w = valid_w_start; w < valid_w_end; ++w) {
-              output_base[h * out_width + w] =
-                  input_base[in_h * in_width + in_w];
-              in_w += block_shape_w;
-            }  // w
-            in_h += block_shape_h;
-
-            memset(
-                static_cast<void *>(output_base + h * out_width + valid_w_end),
-                0, (out_width - valid_w_end) * sizeof(T));
-          }  // h
-
-          memset(static_cast<void *>(output_base + valid_h_end * out_width),
-                 0,
-                 (std::min(out_height, block_h + block_h_size) - valid_h_end)
-                     * out_width * sizeof(T));
-        }  // b
-      }  // block_h
-    }  // c
+                   (std::min(out_height, block_h + block_h_size) - valid_h_end)
+                       * out_width * sizeof(T));
+          }  // b
+        }  // block_h
+      }  // c
+    }, 0, channels, 1, 0, out_batches, 1, 0, 0, out_height * out_width);
 
     return MaceStatus::MACE_SUCCESS;
   }
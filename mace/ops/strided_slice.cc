@@ -77,8 +77,6 @@ class StridedSliceOp : public Operation {
   }
 
   MaceStatus Run(OpContext *context) override {
-    MACE_UNUSED(context);
-
     if (!checked_) {
       if (has_data_format_ && this->Input(0)->dim_size() == 4) {
         TransposeMaskValueFromNHWCToNCHW(&begin_mask_);
@@ -263,70 +261,62 @@ class StridedSliceOp : public Operation {
              sizeof(T) * (end_indices_vec[0] - begin_indices_vec[0]) *
                  dim_stride[0]);
     } else {
-      if (input->dim_size() == 1) {
-        for (index_t i = begin_indices_vec[0];
-             strides_indices_vec[0] > 0 ? i < end_indices_vec[0]
-                                 : i > end_indices_vec[0];
-             i += strides_indices_vec[0]) {
-          *output_data++ = input_data[i];
-        }
-      } else if (input->dim_size() == 2) {
-        for (index_t i = begin_indices_vec[0];
-             strides_indices_vec[0] > 0 ? i < end_indices_vec[0]
-                                 : i > end_indices_vec[0];
-             i += strides_indices_vec[0]) {
-          for (index_t j = begin_indices_vec[1];
-               strides_indices_vec[1] > 0 ? j < end_indices_vec[1]
-                                   : j > end_indices_vec[1];
-               j += strides_indices_vec[1]) {
-            *output_data++ = input_data[i * input->dim(1) + j];
-          }
+      // Walk the output row by row: outer dims are decomposed from the row
+      // index, and the innermost dim is copied with memcpy when its stride
+      // is 1.
+      const int dims = input->dim_size();
+      std::vector<index_t> counts(dims, 1);
+      for (int d = 0; d < dims; ++d) {
+        const index_t b = begin_indices_vec[d];
+        const index_t e = end_indices_vec[d];
+        const index_t s = strides_indices_vec[d];
+        if (shrink_axis_mask_ & (1 << d)) {
+          counts[d] = 1;
+        } else if (s > 0) {
+          counts[d] = e > b ? (e - b + s - 1) / s : 0;
+        } else {
+          counts[d] = b > e ? (b - e - s - 1) / (-s) : 0;
         }
-      } else if (input->dim_size() == 3) {
-        for (index_t i = begin_indices_vec[0];
-             strides_indices_vec[0] > 0 ? i < end_indices_vec[0]
-                                 : i > end_indices_vec[0];
-             i += strides_indices_vec[0]) {
-          for (index_t j = begin_indices_vec[1];
-               strides_indices_vec[1] > 0 ? j < end_indices_vec[1]
-                                   : j > end_indices_vec[1];
-               j += strides_indices_vec[1]) {
-            for (index_t k = begin_indices_vec[2];
-                 strides_indices_vec[2] > 0 ? k < end_indices_vec[2]
-                                     : k > end_indices_vec[2];
-                 k += strides_indices_vec[2]) {
-              *output_data++ =
-                  input_data[(i * input->dim(1) + j) * input->dim(2) + k];
-            }
+      }
+      const index_t inner_count = counts[dims - 1];
+      const index_t inner_begin = begin_indices_vec[dims - 1];
+      const index_t inner_stride = strides_indices_vec[dims - 1];
+      index_t outer_count = 1;
+      for (int d = 0; d < dims - 1; ++d) {
+        outer_count *= counts[d];
+      }
+
+      std::vector<index_t> begins(begin_indices_vec.begin(),
+                                  begin_indices_vec.end());
+      std::vector<index_t> steps(strides_indices_vec.begin(),
+                                 strides_indices_vec.end());
+      const index_t *counts_ptr = counts.data();
+      const index_t *begins_ptr = begins.data();
+      const index_t *steps_ptr = steps.data();
+      const index_t *dim_stride_ptr = dim_stride.data();
+
+      utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+      thread_pool.Compute1D([=](index_t start, index_t end, index_t step) {
+        for (index_t row = start; row < end; row += step) {
+          index_t in_offset = 0;
+          index_t rest = row;
+          for (int d = dims - 2; d >= 0; --d) {
+            const index_t idx = rest % counts_ptr[d];
+            rest /= counts_ptr[d];
+            in_offset +=
+                (begins_ptr[d] + idx * steps_ptr[d]) * dim_stride_ptr[d];
           }
-        }
-      } else if (input->dim_size() == 4) {
-        for (index_t i = begin_indices_vec[0];
-             strides_indices_vec[0] > 0 ? i < end_indices_vec[0]
-                                 : i > end_indices_vec[0];
-             i += strides_indices_vec[0]) {
-          for (index_t j = begin_indices_vec[1];
-               strides_indices_vec[1] > 0 ? j < end_indices_vec[1]
-                                   : j > end_indices_vec[1];
-               j += strides_indices_vec[1]) {
-            for (index_t k = begin_indices_vec[2];
-                 strides_indices_vec[2] > 0 ? k < end_indices_vec[2]
-                                     : k > end_indices_vec[2];
-                 k += strides_indices_vec[2]) {
-              for (index_t l = begin_indices_vec[3];
-                   strides_indices_vec[3] > 0 ? l < end_indices_vec[3]
-                                       : l > end_indices_vec[3];
-                   l += strides_indices_vec[3]) {
-                *output_data++ =
-                    input_data[((i * input->dim(1) + j) * input->dim(2) + k)
-                               * input->dim(3) + l];
-              }
+          const T *in = input_data + in_offset + inner_begin;
+          T *out = output_data + row * inner_count;
+          if (inner_stride == 1) {
+            memcpy(out, in, inner_count * sizeof(T));
+          } else {
+            for (index_t i = 0; i < inner_count; ++i) {
+              out[i] = in[i * inner_stride];
             }
           }
         }
-      } else {
-        MACE_NOT_IMPLEMENTED;
-      }
+      }, 0, outer_count, 1, 0, inner_count);
     }
     return MaceStatus::MACE_SUCCESS;
   }
@@ -12,8 +12,10 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cstring>
 #include <functional>
 #include <memory>
+#include <numeric>
 #include <vector>
 
 #include "mace/core/ops/operator.h"
@@ -32,7 +34,6 @@ class TileOp : public Operation {
   }
 
   MaceStatus Run(OpContext *context) override {
-    MACE_UNUSED(context);
     const Tensor *input = this->Input(0);
     const Tensor *multiples = this->Input(1);
     const index_t input_dims = input->dim_size();
@@ -74,6 +75,7 @@ class TileOp : public Operation {
     T *fake_input_data = fake_input.mutable_data<T>();
     std::memcpy(fake_input_data, input_data, input->size() * sizeof(T));
 
+    utils::ThreadPool &thread_pool = runtime->thread_pool();
     index_t inner_dim = 1;
     index_t outer_dim = input->size();
     index_t acc_multiples = 1;
@@ -83,19 +85,29 @@ class TileOp : public Operation {
     for (int64_t i = input_dims - 1;; --i) {
       inner_dim *= input->dim(i);
       outer_dim /= input->dim(i);
-      for (int64_t o = 0; o < outer_dim; ++o) {
-        for (int64_t m = 0; m < multiples_vec[i]; ++m) {
-          std::memcpy(output_data + (o * multiples_vec[i] + m) * inner_dim,
-                      fake_input_data + o * inner_dim, inner_dim * sizeof(T));
+      const index_t multiple = multiples_vec[i];
+      const index_t block_size = inner_dim;
+      const T *src_data = fake_input_data;
+      thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                                index_t start1, index_t end1, index_t step1) {
+        for (index_t o = start0; o < end0; o += step0) {
+          for (index_t m = start1; m < end1; m += step1) {
+            std::memcpy(output_data + (o * multiple + m) * block_size,
+                        src_data + o * block_size, block_size * sizeof(T));
+          }
         }
-      }
-      acc_multiples *= multiples_vec[i];
+      }, 0, outer_dim, 1, 0, multiple, 1, 0, 0, block_size);
+      acc_multiples *= multiple;
       if (acc_multiples == total_multiples) {
         break;
       }
-      std::memcpy(fake_input_data, output_data,
-                  input->size() * acc_multiples * sizeof(T));
-      inner_dim *= multiples_vec[i];
+      const index_t copy_size = input->size() * acc_multiples;
+      thread_pool.Compute1D([=](index_t start, index_t end, index_t step) {
+        MACE_UNUSED(step);
+        std::memcpy(fake_input_data + start, output_data + start,
+                    (end - start) * sizeof(T));
+      }, 0, copy_size, 1, 0, 1);
+      inner_dim *= multiple;
     }
 
     return MaceStatus::MACE_SUCCESS;
@@ -0,0 +1,139 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <functional>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "mace/core/ops/operator.h"
+#include "mace/core/registry/ops_registry.h"
+#include "mace/ops/common/top_k.h"
+
+namespace mace {
+namespace ops {
+
+namespace {
+// Equal values keep the lower index first.
+template<typename T>
+struct LargerFirst {
+  bool operator()(const std::pair<T, int> &a,
+                  const std::pair<T, int> &b) const {
+    return a.first > b.first || (a.first == b.first && a.second < b.second);
+  }
+};
+
+template<typename T>
+struct SmallerFirst {
+  bool operator()(const std::pair<T, int> &a,
+                  const std::pair<T, int> &b) const {
+    return a.first < b.first || (a.first == b.first && a.second < b.second);
+  }
+};
+}  // namespace
+
+template<RuntimeType D, class T>
+class TopKOp : public Operation {
+ public:
+  explicit TopKOp(OpConstructContext *context)
+      : Operation(context),
+        k_(Operation::GetOptionalArg<int>("k", 1)),
+        axis_(Operation::GetOptionalArg<int>("axis", -1)),
+        largest_(Operation::GetOptionalArg<int>("largest", 1) == 1) {}
+
+  MaceStatus Run(OpContext *context) override {
+    const Tensor *input = this->Input(INPUT);
+    Tensor *values = this->Output(VALUES);
+    Tensor *indices = this->Output(INDICES);
+
+    const int input_dim_size = input->dim_size();
+    MACE_CHECK(input_dim_size > 0, "TopK input should not be a scalar");
+    const int axis = axis_ < 0 ? axis_ + input_dim_size : axis_;
+    MACE_CHECK(axis >= 0 && axis < input_dim_size,
+               "axis is out of bound: ", axis_);
+
+    index_t k = k_;
+    if (this->InputSize() > K) {
+      const Tensor *k_tensor = this->Input(K);
+      MACE_CHECK(k_tensor->size() == 1, "k should be a scalar");
+      k = k_tensor->data<int32_t>()[0];
+    }
+    const auto &input_shape = input->shape();
+    const index_t axis_dim = input_shape[axis];
+    MACE_CHECK(k >= 0 && k <= axis_dim,
+               "k should be in range [0, ", axis_dim, "], but got ", k);
+
+    std::vector<index_t> output_shape(input_shape);
+    output_shape[axis] = k;
+    MACE_RETURN_IF_ERROR(values->Resize(output_shape));
+    MACE_RETURN_IF_ERROR(indices->Resize(output_shape));
+    if (k == 0) {
+      return MaceStatus::MACE_SUCCESS;
+    }
+
+    const index_t outer_size = std::accumulate(input_shape.begin(),
+                                               input_shape.begin() + axis,
+                                               1, std::multiplies<index_t>());
+    const index_t inner_size = std::accumulate(input_shape.begin() + axis + 1,
+                                               input_shape.end(),
+                                               1, std::multiplies<index_t>());
+    const T *input_data = input->data<T>();
+    T *values_data = values->mutable_data<T>();
+    int32_t *indices_data = indices->mutable_data<int32_t>();
+    const bool largest = largest_;
+
+    utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+    thread_pool.Compute1D([=](index_t start, index_t end, index_t step) {
+      std::vector<std::pair<T, int>> selected;
+      for (index_t i = start; i < end; i += step) {
+        const index_t outer_idx = i / inner_size;
+        const index_t inner_idx = i % inner_size;
+        const T *in = input_data + outer_idx * axis_dim * inner_size
+            + inner_idx;
+        if (largest) {
+          common::SelectTopK(in, axis_dim, inner_size, k, LargerFirst<T>(),
+                             &selected);
+        } else {
+          common::SelectTopK(in, axis_dim, inner_size, k, SmallerFirst<T>(),
+                             &selected);
+        }
+
+        const index_t out_offset = outer_idx * k * inner_size + inner_idx;
+        for (index_t j = 0; j < k; ++j) {
+          values_data[out_offset + j * inner_size] = selected[j].first;
+          indices_data[out_offset + j * inner_size] = selected[j].second;
+        }
+      }
+    }, 0, outer_size * inner_size, 1, 0, static_cast<int>(axis_dim));
+
+    return MaceStatus::MACE_SUCCESS;
+  }
+
+ private:
+  int k_;
+  int axis_;
+  bool largest_;
+
+  MACE_OP_INPUT_TAGS(INPUT, K);
+  MACE_OP_OUTPUT_TAGS(VALUES, INDICES);
+};
+
+void RegisterTopK(OpRegistry *op_registry) {
+  MACE_REGISTER_OP(op_registry, "TopK", TopKOp, RuntimeType::RT_CPU, float);
+  MACE_REGISTER_BF16_OP(op_registry, "TopK", TopKOp, RuntimeType::RT_CPU);
+  MACE_REGISTER_OP(op_registry, "TopK", TopKOp, RuntimeType::RT_CPU, int32_t);
+}
+
+}  // namespace ops
+}  // namespace mace
@@ -38,18 +38,19 @@ class UnsqueezeOp : public Operation {
       MACE_CHECK(axis_[i] >= 0, "axis's value should be non-negative.");
       output_shape.insert(output_shape.begin() + axis_[i], 1);
     }
-    MACE_RETURN_IF_ERROR(output->Resize(output_shape));
-
-    const T *input_data = input->data<T>();
-    T *output_data = output->mutable_data<T>();
-
-    const index_t data_size =
-        std::accumulate(input->shape().begin(), input->shape().end(), 1,
-                        std::multiplies<index_t>());
-    memcpy(output_data, input_data, data_size * sizeof(T));
+    output->ReuseTensorBuffer(*input);
+    output->Reshape(output_shape);
     return MaceStatus::MACE_SUCCESS;
   }
 
+  int ReuseTensorMapId(size_t output_idx) const override {
+    if (output_idx == 0) {
+      return 0;
+    } else {
+      return -1;
+    }
+  }
+
  private:
   std::vector<int> axis_;
 
@@ -0,0 +1,227 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MACE_OPS_X86_COMMON_X86_H_
+#define MACE_OPS_X86_COMMON_X86_H_
+
+#include <immintrin.h>
+
+#include "mace/core/types.h"
+
+namespace mace {
+namespace ops {
+namespace x86 {
+
+// The float vector of the widest SIMD targeted by the compiler: AVX-512,
+// AVX2 with FMA, or SSE2.
+#if defined(__AVX512F__)
+typedef __m512 VecF;
+const int kVecFLanes = 16;
+
+inline VecF VecLoad(const float *ptr) { return _mm512_loadu_ps(ptr); }
+inline void VecStore(float *ptr, VecF v) { _mm512_storeu_ps(ptr, v); }
+inline VecF VecZero() { return _mm512_setzero_ps(); }
+inline VecF VecSet1(float v) { return _mm512_set1_ps(v); }
+inline VecF VecAdd(VecF a, VecF b) { return _mm512_add_ps(a, b); }
+inline VecF VecSub(VecF a, VecF b) { return _mm512_sub_ps(a, b); }
+inline VecF VecMul(VecF a, VecF b) { return _mm512_mul_ps(a, b); }
+inline VecF VecDiv(VecF a, VecF b) { return _mm512_div_ps(a, b); }
+// The max and min return b if a lane of a or b is NaN.
+inline VecF VecMax(VecF a, VecF b) { return _mm512_max_ps(a, b); }
+inline VecF VecMin(VecF a, VecF b) { return _mm512_min_ps(a, b); }
+// Clear the sign bits.
+inline VecF VecAbs(VecF v) {
+  return _mm512_castsi512_ps(_mm512_and_si512(
+      _mm512_castps_si512(v), _mm512_set1_epi32(0x7fffffff)));
+}
+// acc + a * b
+inline VecF VecFma(VecF acc, VecF a, VecF b) {
+  return _mm512_fmadd_ps(a, b, acc);
+}
+inline float VecSum(VecF v) { return _mm512_reduce_add_ps(v); }
+// Round to the nearest integer.
+inline VecF VecRound(VecF v) {
+  return _mm512_roundscale_ps(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+// 2^n of the integers n in [-126, 127].
+inline VecF VecPow2(VecF n) {
+  const __m512i e = _mm512_add_epi32(_mm512_cvtps_epi32(n),
+                                     _mm512_set1_epi32(127));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(e, 23));
+}
+// Split the positive normal v into m * 2^e with m in [0.5, 1), return m.
+inline VecF VecFrexp(VecF v, VecF *e) {
+  const __m512i bits = _mm512_castps_si512(v);
+  *e = _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_srli_epi32(bits, 23),
+                                           _mm512_set1_epi32(126)));
+  return _mm512_castsi512_ps(_mm512_or_si512(
+      _mm512_and_si512(bits, _mm512_set1_epi32(0x007fffff)),
+      _mm512_set1_epi32(0x3f000000)));
+}
+// a < b ? x : y
+inline VecF VecSelectLess(VecF a, VecF b, VecF x, VecF y) {
+  return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(a, b, _CMP_LT_OQ), y, x);
+}
+// Load lanes of fp16 and convert them to float.
+inline VecF VecLoadHalf(const void *ptr) {
+  return _mm512_cvtph_ps(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr)));
+}
+#ifdef MACE_ENABLE_BFLOAT16
+// BFloat16 is the high half of float, it is widened by a shift and
+// truncated when stored, as BFloat16(float) does.
+inline VecF VecLoad(const BFloat16 *ptr) {
+  const __m512i v = _mm512_cvtepu16_epi32(
+      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(ptr)));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(v, 16));
+}
+inline void VecStore(BFloat16 *ptr, VecF v) {
+  const __m512i high = _mm512_srli_epi32(_mm512_castps_si512(v), 16);
+  _mm256_storeu_si256(reinterpret_cast<__m256i *>(ptr),
+                      _mm512_cvtepi32_epi16(high));
+}
+#endif  // MACE_ENABLE_BFLOAT16
+#elif defined(__AVX2__) && defined(__FMA__)
+typedef __m256 VecF;
+const int kVecFLanes = 8;
+
+inline VecF VecLoad(const float *ptr) { return _mm256_loadu_ps(ptr); }
+inline void VecStore(float *ptr, VecF v) { _mm256_storeu_ps(ptr, v); }
+inline VecF VecZero() { return _mm256_setzero_ps(); }
+inline VecF VecSet1(float v) { return _mm256_set1_ps(v); }
+inline VecF VecAdd(VecF a, VecF b) { return _mm256_add_ps(a, b); }
+inline VecF VecSub(VecF a, VecF b) { return _mm256_sub_ps(a, b); }
+inline VecF VecMul(VecF a, VecF b) { return _mm256_mul_ps(a, b); }
+inline VecF VecDiv(VecF a, VecF b) { return _mm256_div_ps(a, b); }
+inline VecF VecMax(VecF a, VecF b) { return _mm256_max_ps(a, b); }
+inline VecF VecMin(VecF a, VecF b) { return _mm256_min_ps(a, b); }
+inline VecF VecAbs(VecF v) {
+  return _mm256_andnot_ps(_mm256_set1_ps(-0.f), v);
+}
+inline VecF VecFma(VecF acc, VecF a, VecF b) {
+  return _mm256_fmadd_ps(a, b, acc);
+}
+inline float VecSum(VecF v) {
+  __m128 sum = _mm_add_ps(_mm256_castps256_ps128(v),
+                          _mm256_extractf128_ps(v, 1));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum);
+}
+inline VecF VecRound(VecF v) {
+  return _mm256_round_ps(v, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+}
+inline VecF VecPow2(VecF n) {
+  const __m256i e = _mm256_add_epi32(_mm256_cvtps_epi32(n),
+                                     _mm256_set1_epi32(127));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(e, 23));
+}
+inline VecF VecFrexp(VecF v, VecF *e) {
+  const __m256i bits = _mm256_castps_si256(v);
+  *e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23),
+                                           _mm256_set1_epi32(126)));
+  return _mm256_castsi256_ps(_mm256_or_si256(
+      _mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+      _mm256_set1_epi32(0x3f000000)));
+}
+inline VecF VecSelectLess(VecF a, VecF b, VecF x, VecF y) {
+  return _mm256_blendv_ps(y, x, _mm256_cmp_ps(a, b, _CMP_LT_OQ));
+}
+#if defined(__F16C__)
+inline VecF VecLoadHalf(const void *ptr) {
+  return _mm256_cvtph_ps(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr)));
+}
+#endif
+#ifdef MACE_ENABLE_BFLOAT16
+inline VecF VecLoad(const BFloat16 *ptr) {
+  const __m256i v = _mm256_cvtepu16_epi32(
+      _mm_loadu_si128(reinterpret_cast<const __m128i *>(ptr)));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(v, 16));
+}
+// The arithmetic shift keeps the high halves in the int16 range, so that the
+// saturating pack does not change them.
+inline void VecStore(BFloat16 *ptr, VecF v) {
+  const __m256i high = _mm256_srai_epi32(_mm256_castps_si256(v), 16);
+  const __m256i packed = _mm256_permute4x64_epi64(
+      _mm256_packs_epi32(high, high), 0x08);
+  _mm_storeu_si128(reinterpret_cast<__m128i *>(ptr),
+                   _mm256_castsi256_si128(packed));
+}
+#endif  // MACE_ENABLE_BFLOAT16
+#else
+typedef __m128 VecF;
+const int kVecFLanes = 4;
+
+inline VecF VecLoad(const float *ptr) { return _mm_loadu_ps(ptr); }
+inline void VecStore(float *ptr, VecF v) { _mm_storeu_ps(ptr, v); }
+inline VecF VecZero() { return _mm_setzero_ps(); }
+inline VecF VecSet1(float v) { return _mm_set1_ps(v); }
+inline VecF VecAdd(VecF a, VecF b) { return _mm_add_ps(a, b); }
+inline VecF VecSub(VecF a, VecF b) { return _mm_sub_ps(a, b); }
+inline VecF VecMul(VecF a, VecF b) { return _mm_mul_ps(a, b); }
+inline VecF VecDiv(VecF a, VecF b) { return _mm_div_ps(a, b); }
+inline VecF VecMax(VecF a, VecF b) { return _mm_max_ps(a, b); }
+inline VecF VecMin(VecF a, VecF b) { return _mm_min_ps(a, b); }
+inline VecF VecAbs(VecF v) { return _mm_andnot_ps(_mm_set1_ps(-0.f), v); }
+inline VecF VecFma(VecF acc, VecF a, VecF b) {
+  return _mm_add_ps(acc, _mm_mul_ps(a, b));
+}
+inline float VecSum(VecF v) {
+  __m128 sum = _mm_add_ps(v, _mm_movehl_ps(v, v));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+  return _mm_cvtss_f32(sum);
+}
+// SSE2 has no rounding instruction, the lanes must be in the int32 range.
+inline VecF VecRound(VecF v) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(v)); }
+inline VecF VecPow2(VecF n) {
+  const __m128i e = _mm_add_epi32(_mm_cvtps_epi32(n), _mm_set1_epi32(127));
+  return _mm_castsi128_ps(_mm_slli_epi32(e, 23));
+}
+inline VecF VecFrexp(VecF v, VecF *e) {
+  const __m128i bits = _mm_castps_si128(v);
+  *e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23),
+                                     _mm_set1_epi32(126)));
+  return _mm_castsi128_ps(_mm_or_si128(
+      _mm_and_si128(bits, _mm_set1_epi32(0x007fffff)),
+      _mm_set1_epi32(0x3f000000)));
+}
+inline VecF VecSelectLess(VecF a, VecF b, VecF x, VecF y) {
+  const __m128 mask = _mm_cmplt_ps(a, b);
+  return _mm_or_ps(_mm_and_ps(mask, x), _mm_andnot_ps(mask, y));
+}
+#if defined(__F16C__)
+inline VecF VecLoadHalf(const void *ptr) {
+  return _mm_cvtph_ps(
+      _mm_loadl_epi64(reinterpret_cast<const __m128i *>(ptr)));
+}
+#endif
+#ifdef MACE_ENABLE_BFLOAT16
+inline VecF VecLoad(const BFloat16 *ptr) {
+  const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(ptr));
+  return _mm_castsi128_ps(_mm_unpacklo_epi16(_mm_setzero_si128(), v));
+}
+inline void VecStore(BFloat16 *ptr, VecF v) {
+  const __m128i high = _mm_srai_epi32(_mm_castps_si128(v), 16);
+  _mm_storel_epi64(reinterpret_cast<__m128i *>(ptr),
+                   _mm_packs_epi32(high, high));
+}
+#endif  // MACE_ENABLE_BFLOAT16
+#endif
+
+}  // namespace x86
+}  // namespace ops
+}  // namespace mace
+
+#endif  // MACE_OPS_X86_COMMON_X86_H_
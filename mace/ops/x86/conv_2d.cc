@@ -0,0 +1,181 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mace/ops/x86/conv_2d.h"
+
+#include <algorithm>
+
+#include "mace/ops/common/conv_pool_2d_util.h"
+#include "mace/ops/x86/gemm.h"
+
+namespace mace {
+namespace ops {
+namespace x86 {
+
+namespace {
+// Packs a column block of the implicit im2col matrix
+// [in_channels * kernel_h * kernel_w, out_height * out_width] of one image.
+template<typename T>
+struct Im2colPacker {
+  const T *input;
+  index_t in_height;
+  index_t in_width;
+  index_t in_channels;
+  index_t out_width;
+  index_t out_pixels;
+  int kernel_h;
+  int kernel_w;
+  int stride_h;
+  int stride_w;
+  int dilation_h;
+  int dilation_w;
+  int pad_top;
+  int pad_left;
+
+  void operator()(const index_t col_start, float *packed) const {
+    const index_t in_image_size = in_height * in_width;
+    const index_t col_len = std::min(kGemmCols, out_pixels - col_start);
+    index_t ih0[kGemmCols];
+    index_t iw0[kGemmCols];
+    for (index_t j = 0; j < kGemmCols; ++j) {
+      const index_t p = col_start + std::min(j, col_len - 1);
+      ih0[j] = (p / out_width) * stride_h - pad_top;
+      iw0[j] = (p % out_width) * stride_w - pad_left;
+    }
+    // The block is within one output row, so its input is contiguous with
+    // stride 1.
+    const bool one_row = col_len == kGemmCols && stride_w == 1 &&
+        ih0[0] == ih0[kGemmCols - 1];
+
+    float *dst = packed;
+    for (index_t c = 0; c < in_channels; ++c) {
+      const T *in_channel = input + c * in_image_size;
+      for (int kh = 0; kh < kernel_h; ++kh) {
+        for (int kw = 0; kw < kernel_w; ++kw, dst += kGemmCols) {
+          const index_t dh = kh * dilation_h;
+          const index_t dw = kw * dilation_w;
+          if (one_row) {
+            const index_t ih = ih0[0] + dh;
+            const index_t iw = iw0[0] + dw;
+            if (ih >= 0 && ih < in_height && iw >= 0 &&
+                iw + kGemmCols <= in_width) {
+              const T *src = in_channel + ih * in_width + iw;
+              VecStore(dst, VecLoad(src));
+              VecStore(dst + kVecFLanes, VecLoad(src + kVecFLanes));
+              continue;
+            }
+          }
+          for (index_t j = 0; j < kGemmCols; ++j) {
+            const index_t ih = ih0[j] + dh;
+            const index_t iw = iw0[j] + dw;
+            dst[j] = (j < col_len && ih >= 0 && ih < in_height &&
+                iw >= 0 && iw < in_width) ?
+                static_cast<float>(in_channel[ih * in_width + iw]) : 0.f;
+          }
+        }
+      }
+    }
+  }
+};
+}  // namespace
+
+template<typename T>
+MaceStatus Conv2d<T>::Compute(const OpContext *context,
+                              const Tensor *input,
+                              const Tensor *filter,
+                              Tensor *output) {
+  const std::vector<index_t> in_shape = input->shape();
+  const std::vector<index_t> filter_shape = filter->shape();
+  MACE_CHECK(in_shape[1] == filter_shape[1]);
+  std::vector<index_t> out_shape(4);
+
+  std::vector<int> paddings(2);
+  if (paddings_.empty()) {
+    CalcNCHWPaddingAndOutputSize(input->shape().data(),
+                                 filter->shape().data(),
+                                 dilations_.data(),
+                                 strides_.data(),
+                                 padding_type_,
+                                 out_shape.data(),
+                                 paddings.data());
+  } else {
+    paddings = paddings_;
+    CalcNCHWOutputSize(input->shape().data(),
+                       filter->shape().data(),
+                       paddings_.data(),
+                       dilations_.data(),
+                       strides_.data(),
+                       RoundType::FLOOR,
+                       out_shape.data());
+  }
+  MACE_RETURN_IF_ERROR(output->Resize(out_shape));
+
+  const index_t batch = in_shape[0];
+  const index_t in_channels = in_shape[1];
+  const index_t in_height = in_shape[2];
+  const index_t in_width = in_shape[3];
+  const index_t out_channels = out_shape[1];
+  const index_t out_pixels = out_shape[2] * out_shape[3];
+  const int kernel_h = static_cast<int>(filter_shape[2]);
+  const int kernel_w = static_cast<int>(filter_shape[3]);
+  const index_t depth = in_channels * kernel_h * kernel_w;
+
+  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+  if (packed_filter_src_ != filter->raw_data() || !filter->is_weight()) {
+    PackGemmLhsBlocks(&thread_pool, filter->data<T>(), depth, 1,
+                      out_channels, depth, &packed_filter_);
+    packed_filter_src_ = filter->raw_data();
+  }
+
+  const bool is_pointwise = kernel_h == 1 && kernel_w == 1 &&
+      strides_[0] == 1 && strides_[1] == 1 && paddings[0] == 0 &&
+      paddings[1] == 0;
+  const T *input_data = input->data<T>();
+  T *output_data = output->mutable_data<T>();
+  for (index_t b = 0; b < batch; ++b) {
+    const T *in_ptr = input_data + b * in_channels * in_height * in_width;
+    T *out_ptr = output_data + b * out_channels * out_pixels;
+    if (is_pointwise) {
+      auto pack_rhs = [=](index_t col_start, float *packed) {
+        PackGemmRhs(in_ptr, out_pixels, 1, depth, out_pixels, col_start,
+                    packed);
+      };
+      PackedGemm(&thread_pool, packed_filter_.data(), pack_rhs, out_channels,
+                 out_pixels, depth, out_ptr, out_pixels, 1);
+    } else {
+      const Im2colPacker<T> pack_rhs = {
+          in_ptr, in_height, in_width, in_channels, out_shape[3], out_pixels,
+          kernel_h, kernel_w, strides_[0], strides_[1], dilations_[0],
+          dilations_[1], paddings[0] >> 1, paddings[1] >> 1};
+      PackedGemm(&thread_pool, packed_filter_.data(), pack_rhs, out_channels,
+                 out_pixels, depth, out_ptr, out_pixels, 1);
+    }
+  }
+
+  return MaceStatus::MACE_SUCCESS;
+}
+
+void RegisterConv2dDelegator(OpDelegatorRegistry *registry) {
+  MACE_REGISTER_DELEGATOR(
+      registry, Conv2d<float>, delegator::Conv2dParam,
+      MACE_DELEGATOR_KEY(Conv2d, RuntimeType::RT_CPU, float, ImplType::X86));
+  MACE_REGISTER_BF16_DELEGATOR(
+      registry, Conv2d<BFloat16>, delegator::Conv2dParam,
+      MACE_DELEGATOR_KEY(Conv2d, RuntimeType::RT_CPU, BFloat16,
+                         ImplType::X86));
+}
+
+}  // namespace x86
+}  // namespace ops
+}  // namespace mace
@@ -0,0 +1,57 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MACE_OPS_X86_CONV_2D_H_
+#define MACE_OPS_X86_CONV_2D_H_
+
+#include <vector>
+
+#include "mace/core/ops/op_context.h"
+#include "mace/core/tensor.h"
+#include "mace/ops/delegator/conv_2d.h"
+#include "mace/public/mace.h"
+
+namespace mace {
+namespace ops {
+namespace x86 {
+
+// NCHW convolution of float or BFloat16 as the packed GEMM
+//   output[out_channels, out_pixels] =
+//       filter[out_channels, in_channels * kernel] * im2col(input).
+// The im2col is not materialized, the columns are gathered from the input
+// while the rhs blocks are packed as float. All the filter sizes, strides
+// and dilations are supported.
+template<typename T>
+class Conv2d : public delegator::Conv2d {
+ public:
+  explicit Conv2d(const delegator::Conv2dParam &param)
+      : delegator::Conv2d(param), packed_filter_src_(nullptr) {}
+  ~Conv2d() {}
+
+  MaceStatus Compute(const OpContext *context,
+                     const Tensor *input,
+                     const Tensor *filter,
+                     Tensor *output) override;
+
+ private:
+  // The filter packed by PackGemmLhsBlocks.
+  std::vector<float> packed_filter_;
+  const void *packed_filter_src_;
+};
+
+}  // namespace x86
+}  // namespace ops
+}  // namespace mace
+
+#endif  // MACE_OPS_X86_CONV_2D_H_
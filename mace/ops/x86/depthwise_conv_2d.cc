@@ -0,0 +1,340 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mace/ops/x86/depthwise_conv_2d.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+#include "mace/ops/common/conv_pool_2d_util.h"
+#include "mace/ops/x86/common_x86.h"
+#include "mace/utils/math.h"
+#include "mace/utils/memory.h"
+
+namespace mace {
+namespace ops {
+namespace x86 {
+
+namespace {
+const index_t kBlock = kVecFLanes;
+static_assert(kBlock == kNCHWcBlock, "NCHWc block must match the SIMD width");
+
+struct DepthwiseRowParam {
+  index_t in_row_stride;
+  index_t out_width;
+  int kernel_h;
+  int kernel_w;
+  int stride_w;
+  int dilation_h;
+  int dilation_w;
+};
+
+// Compute one output row of a channel block, in points to the first input
+// row of the output row.
+typedef void (*DepthwiseRowFunc)(const float *in, const float *filter,
+                                 const DepthwiseRowParam &p, float *out);
+
+template<int KH, int KW, int SW>
+void DepthwiseRowKxK(const float *in, const float *filter,
+                     const DepthwiseRowParam &p, float *out) {
+  const index_t in_row_stride = p.in_row_stride;
+  index_t ow = 0;
+  for (; ow + 4 <= p.out_width; ow += 4) {
+    VecF acc0 = VecZero();
+    VecF acc1 = VecZero();
+    VecF acc2 = VecZero();
+    VecF acc3 = VecZero();
+    const float *in_base = in + ow * SW * kBlock;
+    for (int kh = 0; kh < KH; ++kh) {
+      const float *in_row = in_base + kh * in_row_stride;
+      const float *filter_row = filter + kh * KW * kBlock;
+      for (int kw = 0; kw < KW; ++kw) {
+        const VecF w = VecLoad(filter_row + kw * kBlock);
+        acc0 = VecFma(acc0, VecLoad(in_row + kw * kBlock), w);
+        acc1 = VecFma(acc1, VecLoad(in_row + (SW + kw) * kBlock), w);
+        acc2 = VecFma(acc2, VecLoad(in_row + (2 * SW + kw) * kBlock), w);
+        acc3 = VecFma(acc3, VecLoad(in_row + (3 * SW + kw) * kBlock), w);
+      }
+    }
+    VecStore(out + ow * kBlock, acc0);
+    VecStore(out + (ow + 1) * kBlock, acc1);
+    VecStore(out + (ow + 2) * kBlock, acc2);
+    VecStore(out + (ow + 3) * kBlock, acc3);
+  }
+  for (; ow < p.out_width; ++ow) {
+    VecF acc = VecZero();
+    const float *in_base = in + ow * SW * kBlock;
+    for (int kh = 0; kh < KH; ++kh) {
+      const float *in_row = in_base + kh * in_row_stride;
+      const float *filter_row = filter + kh * KW * kBlock;
+      for (int kw = 0; kw < KW; ++kw) {
+        acc = VecFma(acc, VecLoad(in_row + kw * kBlock),
+                     VecLoad(filter_row + kw * kBlock));
+      }
+    }
+    VecStore(out + ow * kBlock, acc);
+  }
+}
+
+void DepthwiseRowGeneral(const float *in, const float *filter,
+                         const DepthwiseRowParam &p, float *out) {
+  const index_t in_kh_stride = p.dilation_h * p.in_row_stride;
+  for (index_t ow = 0; ow < p.out_width; ++ow) {
+    VecF acc = VecZero();
+    const float *in_base = in + ow * p.stride_w * kBlock;
+    const float *filter_ptr = filter;
+    for (int kh = 0; kh < p.kernel_h; ++kh) {
+      const float *in_row = in_base + kh * in_kh_stride;
+      for (int kw = 0; kw < p.kernel_w; ++kw) {
+        acc = VecFma(acc, VecLoad(in_row + kw * p.dilation_w * kBlock),
+                     VecLoad(filter_ptr));
+        filter_ptr += kBlock;
+      }
+    }
+    VecStore(out + ow * kBlock, acc);
+  }
+}
+
+DepthwiseRowFunc SelectRowFunc(int kernel_h, int kernel_w, int stride_h,
+                               int stride_w, int dilation_h, int dilation_w) {
+  if (dilation_h != 1 || dilation_w != 1 || stride_h != stride_w ||
+      kernel_h != kernel_w) {
+    return DepthwiseRowGeneral;
+  }
+  if (kernel_h == 3 && stride_w == 1) {
+    return DepthwiseRowKxK<3, 3, 1>;
+  } else if (kernel_h == 3 && stride_w == 2) {
+    return DepthwiseRowKxK<3, 3, 2>;
+  } else if (kernel_h == 5 && stride_w == 1) {
+    return DepthwiseRowKxK<5, 5, 1>;
+  } else if (kernel_h == 5 && stride_w == 2) {
+    return DepthwiseRowKxK<5, 5, 2>;
+  }
+  return DepthwiseRowGeneral;
+}
+}  // namespace
+
+void DepthwiseConv2dNCHWc::PackFilter(const Tensor *filter) {
+  const index_t channels = filter->dim(1);
+  const index_t kernel_size = filter->dim(2) * filter->dim(3);
+  const index_t blocks = RoundUpDiv(channels, kBlock);
+  packed_filter_.assign(blocks * kernel_size * kBlock, 0.f);
+  const float *filter_data = filter->data<float>();
+  for (index_t c = 0; c < channels; ++c) {
+    float *dst = packed_filter_.data() +
+        (c / kBlock) * kernel_size * kBlock + c % kBlock;
+    const float *src = filter_data + c * kernel_size;
+    for (index_t k = 0; k < kernel_size; ++k) {
+      dst[k * kBlock] = src[k];
+    }
+  }
+  packed_filter_src_ = filter->raw_data();
+}
+
+MaceStatus DepthwiseConv2dNCHWc::Compute(const OpContext *context,
+                                         const Tensor *input,
+                                         const Tensor *filter,
+                                         Tensor *output) {
+  MACE_CHECK(filter->dim(0) == 1,
+             "NCHWc depthwise conv only supports multiplier 1");
+  const index_t channels = filter->dim(1);
+  const index_t blocks = RoundUpDiv(channels, kBlock);
+  // The input and output are either NCHW or already blocked.
+  const bool blocked_input = input->data_format() == DataFormat::NCHWc;
+  const bool blocked_output = output->data_format() == DataFormat::NCHWc;
+  if (blocked_input) {
+    MACE_CHECK(input->dim_size() == 5 && input->dim(1) == blocks &&
+               input->dim(4) == kBlock, "Invalid NCHWc input shape ",
+               MakeString(input->shape()));
+  } else {
+    MACE_CHECK(input->dim_size() == 4 && input->dim(1) == channels);
+  }
+  const std::vector<index_t> in_shape = {input->dim(0), channels,
+                                         input->dim(2), input->dim(3)};
+  std::vector<index_t> out_shape(4);
+  std::vector<int> paddings(2);
+  if (paddings_.empty()) {
+    CalcNCHWPaddingAndOutputSize(in_shape.data(),
+                                 filter->shape().data(),
+                                 dilations_.data(),
+                                 strides_.data(),
+                                 padding_type_,
+                                 out_shape.data(),
+                                 paddings.data());
+  } else {
+    paddings = paddings_;
+    CalcNCHWOutputSize(in_shape.data(),
+                       filter->shape().data(),
+                       paddings_.data(),
+                       dilations_.data(),
+                       strides_.data(),
+                       RoundType::FLOOR,
+                       out_shape.data());
+  }
+  out_shape[1] = channels;
+  if (blocked_output) {
+    MACE_RETURN_IF_ERROR(output->Resize(
+        {out_shape[0], blocks, out_shape[2], out_shape[3], kBlock}));
+  } else {
+    MACE_RETURN_IF_ERROR(output->Resize(out_shape));
+  }
+
+  const index_t batch = input->dim(0);
+  const index_t in_height = input->dim(2);
+  const index_t in_width = input->dim(3);
+  const index_t out_height = out_shape[2];
+  const index_t out_width = out_shape[3];
+  const int kernel_h = static_cast<int>(filter->dim(2));
+  const int kernel_w = static_cast<int>(filter->dim(3));
+  const int stride_h = strides_[0];
+  const int stride_w = strides_[1];
+  const int dilation_h = dilations_[0];
+  const int dilation_w = dilations_[1];
+  const index_t pad_top = paddings[0] >> 1;
+  const index_t pad_left = paddings[1] >> 1;
+  // The padded input covers all the taps of the outputs, so the kernels need
+  // no bound checks.
+  const index_t padded_height = std::max(
+      in_height + pad_top,
+      (out_height - 1) * stride_h + (kernel_h - 1) * dilation_h + 1);
+  const index_t padded_width = std::max(
+      in_width + pad_left,
+      (out_width - 1) * stride_w + (kernel_w - 1) * dilation_w + 1);
+  const index_t in_image_size = in_height * in_width;
+  const index_t out_image_size = out_height * out_width;
+  const index_t padded_block_size = padded_height * padded_width * kBlock;
+
+  if (packed_filter_src_ != filter->raw_data() || !filter->is_weight()) {
+    PackFilter(filter);
+  }
+
+  Runtime *runtime = context->runtime();
+  const float *input_data = input->data<float>();
+  const float *filter_data = packed_filter_.data();
+  float *output_data = output->mutable_data<float>();
+  utils::ThreadPool &thread_pool = runtime->thread_pool();
+
+  // A blocked input which needs no padding is used in place.
+  const bool pack_input = !blocked_input || pad_top > 0 || pad_left > 0 ||
+      padded_height > in_height || padded_width > in_width;
+  std::unique_ptr<Tensor> packed_input;
+  const float *blocked_data = input_data;
+  if (pack_input) {
+    packed_input = make_unique<Tensor>(
+        runtime, DataType::DT_FLOAT, MemoryType::CPU_BUFFER,
+        std::vector<index_t>{batch, blocks, padded_height, padded_width,
+                             kBlock});
+    MACE_RETURN_IF_ERROR(runtime->AllocateBufferForTensor(packed_input.get(),
+                                                          RENT_SCRATCH));
+    float *packed_data = packed_input->mutable_data<float>();
+    blocked_data = packed_data;
+
+    // Pack the input into padded channel blocks.
+    thread_pool.Compute1D([=](index_t start, index_t end, index_t step) {
+      for (index_t i = start; i < end; i += step) {
+        const index_t b = i / blocks;
+        const index_t c_begin = (i % blocks) * kBlock;
+        const index_t valid = std::min(kBlock, channels - c_begin);
+        float *dst = packed_data + i * padded_block_size;
+        if (valid < kBlock && !blocked_input) {
+          memset(dst, 0, padded_block_size * sizeof(float));
+        } else {
+          auto zero = [=](index_t h, index_t w_begin, index_t w_end) {
+            memset(dst + (h * padded_width + w_begin) * kBlock, 0,
+                   (w_end - w_begin) * kBlock * sizeof(float));
+          };
+          for (index_t h = 0; h < padded_height; ++h) {
+            if (h < pad_top || h >= pad_top + in_height) {
+              zero(h, 0, padded_width);
+            } else {
+              zero(h, 0, pad_left);
+              zero(h, pad_left + in_width, padded_width);
+            }
+          }
+        }
+        if (blocked_input) {
+          const float *src = input_data + i * in_image_size * kBlock;
+          for (index_t h = 0; h < in_height; ++h) {
+            memcpy(dst + ((h + pad_top) * padded_width + pad_left) * kBlock,
+                   src + h * in_width * kBlock,
+                   in_width * kBlock * sizeof(float));
+          }
+          continue;
+        }
+        for (index_t l = 0; l < valid; ++l) {
+          const float *src = input_data + (b * channels + c_begin + l) *
+              in_image_size;
+          for (index_t h = 0; h < in_height; ++h) {
+            float *dst_row =
+                dst + ((h + pad_top) * padded_width + pad_left) * kBlock + l;
+            const float *src_row = src + h * in_width;
+            for (index_t w = 0; w < in_width; ++w) {
+              dst_row[w * kBlock] = src_row[w];
+            }
+          }
+        }
+      }
+    }, 0, batch * blocks, 1);
+  }
+
+  const DepthwiseRowParam p = {padded_width * kBlock, out_width, kernel_h,
+                               kernel_w, stride_w, dilation_h, dilation_w};
+  const DepthwiseRowFunc row_func = SelectRowFunc(
+      kernel_h, kernel_w, stride_h, stride_w, dilation_h, dilation_w);
+  const index_t filter_block_size = kernel_h * kernel_w * kBlock;
+
+  thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                            index_t start1, index_t end1, index_t step1) {
+    std::vector<float> row(blocked_output ? 0 : out_width * kBlock);
+    for (index_t i = start0; i < end0; i += step0) {
+      const index_t b = i / blocks;
+      const index_t cb = i % blocks;
+      const index_t valid = std::min(kBlock, channels - cb * kBlock);
+      const float *in_block = blocked_data + i * padded_block_size;
+      const float *filter_block = filter_data + cb * filter_block_size;
+      for (index_t h = start1; h < end1; h += step1) {
+        const float *in_row = in_block + h * stride_h * p.in_row_stride;
+        if (blocked_output) {
+          row_func(in_row, filter_block, p,
+                   output_data + (i * out_height + h) * out_width * kBlock);
+          continue;
+        }
+        row_func(in_row, filter_block, p, row.data());
+        // Scatter the row back to NCHW.
+        float *out_block = output_data +
+            (b * channels + cb * kBlock) * out_image_size;
+        for (index_t l = 0; l < valid; ++l) {
+          float *out_row = out_block + l * out_image_size + h * out_width;
+          for (index_t w = 0; w < out_width; ++w) {
+            out_row[w] = row[w * kBlock + l];
+          }
+        }
+      }
+    }
+  }, 0, batch * blocks, 1, 0, out_height, 1);
+
+  return MaceStatus::MACE_SUCCESS;
+}
+
+void RegisterDepthwiseConv2dDelegator(OpDelegatorRegistry *registry) {
+  MACE_REGISTER_DELEGATOR(
+      registry, DepthwiseConv2dNCHWc, delegator::DepthwiseConv2dParam,
+      MACE_DELEGATOR_KEY(DepthwiseConv2d, RuntimeType::RT_CPU,
+                         float, ImplType::X86));
+}
+
+}  // namespace x86
+}  // namespace ops
+}  // namespace mace
@@ -0,0 +1,58 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MACE_OPS_X86_DEPTHWISE_CONV_2D_H_
+#define MACE_OPS_X86_DEPTHWISE_CONV_2D_H_
+
+#include <vector>
+
+#include "mace/core/ops/op_context.h"
+#include "mace/core/tensor.h"
+#include "mace/ops/delegator/depthwise_conv_2d.h"
+#include "mace/public/mace.h"
+
+namespace mace {
+namespace ops {
+namespace x86 {
+
+// Depthwise convolution on the channel-blocked NCHW[x]c layout, x is the
+// number of float lanes of the SIMD. A vector holds one pixel of x channels,
+// so all the filter sizes and strides are vectorized the same way; 3x3 and
+// 5x5 with stride 1 or 2 have unrolled kernels. Only multiplier 1 is
+// supported. The input and output are NCHW, which is packed internally, or
+// DataFormat::NCHWc tensors.
+class DepthwiseConv2dNCHWc : public delegator::DepthwiseConv2d {
+ public:
+  explicit DepthwiseConv2dNCHWc(const delegator::DepthwiseConv2dParam &param)
+      : delegator::DepthwiseConv2d(param), packed_filter_src_(nullptr) {}
+  virtual ~DepthwiseConv2dNCHWc() {}
+
+  MaceStatus Compute(const OpContext *context,
+                     const Tensor *input,
+                     const Tensor *filter,
+                     Tensor *output) override;
+
+ private:
+  void PackFilter(const Tensor *filter);
+
+  // The filter as [channel block, kernel h, kernel w, lanes].
+  std::vector<float> packed_filter_;
+  const void *packed_filter_src_;
+};
+
+}  // namespace x86
+}  // namespace ops
+}  // namespace mace
+
+#endif  // MACE_OPS_X86_DEPTHWISE_CONV_2D_H_
@@ -0,0 +1,118 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mace/ops/x86/gemm.h"
+
+namespace mace {
+namespace ops {
+namespace x86 {
+
+template<typename T>
+MaceStatus Gemm<T>::Compute(const OpContext *context,
+                            const Tensor *lhs,
+                            const Tensor *rhs,
+                            const index_t batch,
+                            const index_t rows,
+                            const index_t cols,
+                            const index_t depth,
+                            const MatrixMajor lhs_major,
+                            const MatrixMajor rhs_major,
+                            const MatrixMajor output_major,
+                            const bool lhs_batched,
+                            const bool rhs_batched,
+                            Tensor *output) {
+  const T *lhs_data = lhs->data<T>();
+  const T *rhs_data = rhs->data<T>();
+  T *output_data = output->mutable_data<T>();
+
+  const index_t lhs_row_stride = lhs_major == RowMajor ? depth : 1;
+  const index_t lhs_depth_stride = lhs_major == RowMajor ? 1 : rows;
+  const index_t rhs_depth_stride = rhs_major == RowMajor ? cols : 1;
+  const index_t rhs_col_stride = rhs_major == RowMajor ? 1 : depth;
+  const index_t out_row_stride = output_major == RowMajor ? cols : 1;
+  const index_t out_col_stride = output_major == RowMajor ? 1 : rows;
+
+  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+
+  for (index_t b = 0; b < batch; ++b) {
+    if (b == 0 || lhs_batched) {
+      PackGemmLhsBlocks(&thread_pool, lhs_data + b * rows * depth,
+                        lhs_row_stride, lhs_depth_stride, rows, depth,
+                        &packed_lhs_);
+    }
+    const T *rhs_ptr =
+        rhs_data + static_cast<index_t>(rhs_batched) * b * depth * cols;
+    auto pack_rhs = [=](index_t col_start, float *packed) {
+      PackGemmRhs(rhs_ptr, rhs_depth_stride, rhs_col_stride, depth, cols,
+                  col_start, packed);
+    };
+    PackedGemm(&thread_pool, packed_lhs_.data(), pack_rhs, rows, cols, depth,
+               output_data + b * rows * cols, out_row_stride, out_col_stride);
+  }
+
+  return MaceStatus::MACE_SUCCESS;
+}
+
+template<typename T>
+MaceStatus Gemm<T>::Compute(const OpContext *context,
+                            const Tensor *lhs,
+                            const Tensor *rhs,
+                            const index_t batch,
+                            const index_t lhs_rows,
+                            const index_t lhs_cols,
+                            const index_t rhs_rows,
+                            const index_t rhs_cols,
+                            const bool transpose_lhs,
+                            const bool transpose_rhs,
+                            const bool transpose_out,
+                            const bool lhs_batched,
+                            const bool rhs_batched,
+                            Tensor *output) {
+  index_t rows = transpose_lhs ? lhs_cols : lhs_rows;
+  index_t depth = transpose_lhs ? lhs_rows : lhs_cols;
+  index_t cols = transpose_rhs ? rhs_rows : rhs_cols;
+  index_t depth2 = transpose_rhs ? rhs_cols : rhs_rows;
+  MACE_CHECK(depth == depth2,
+             "Matrices that multiply have inconsistent depth dim: ",
+             depth,
+             " vs. ",
+             depth2);
+
+  return Gemm<T>::Compute(context,
+                          lhs,
+                          rhs,
+                          batch,
+                          rows,
+                          cols,
+                          depth,
+                          transpose_lhs ? ColMajor : RowMajor,
+                          transpose_rhs ? ColMajor : RowMajor,
+                          transpose_out ? ColMajor : RowMajor,
+                          lhs_batched,
+                          rhs_batched,
+                          output);
+}
+
+void RegisterGemmDelegator(OpDelegatorRegistry *registry) {
+  MACE_REGISTER_DELEGATOR(
+      registry, Gemm<float>, delegator::GemmParam,
+      MACE_DELEGATOR_KEY(Gemm, RuntimeType::RT_CPU, float, ImplType::X86));
+  MACE_REGISTER_BF16_DELEGATOR(
+      registry, Gemm<BFloat16>, delegator::GemmParam,
+      MACE_DELEGATOR_KEY(Gemm, RuntimeType::RT_CPU, BFloat16, ImplType::X86));
+}
+
+}  // namespace x86
+}  // namespace ops
+}  // namespace mace
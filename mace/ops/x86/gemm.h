@@ -0,0 +1,222 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MACE_OPS_X86_GEMM_H_
+#define MACE_OPS_X86_GEMM_H_
+
+#include <algorithm>
+#include <vector>
+
+#include "mace/core/ops/op_context.h"
+#include "mace/core/tensor.h"
+#include "mace/ops/common/matrix.h"
+#include "mace/ops/delegator/gemm.h"
+#include "mace/ops/x86/common_x86.h"
+#include "mace/public/mace.h"
+#include "mace/utils/math.h"
+
+namespace mace {
+namespace ops {
+namespace x86 {
+
+// The register block of the packed GEMM, kGemmRows rows times 2 vectors of
+// columns. The operands are packed as float, so BFloat16 is converted once
+// while it is packed and the kernel is the same for all the types.
+const index_t kGemmRows = 4;
+const index_t kGemmCols = 2 * kVecFLanes;
+
+// Pack the rows [row_start, row_start + kGemmRows) of lhs[rows, depth] given
+// by its element strides as [depth, kGemmRows], the rows past the end are 0.
+template<typename T>
+void PackGemmLhs(const T *lhs, const index_t row_stride,
+                 const index_t depth_stride, const index_t rows,
+                 const index_t depth, const index_t row_start,
+                 float *packed) {
+  const index_t row_len = std::min(kGemmRows, rows - row_start);
+  for (index_t i = 0; i < kGemmRows; ++i) {
+    if (i >= row_len) {
+      for (index_t d = 0; d < depth; ++d) {
+        packed[d * kGemmRows + i] = 0.f;
+      }
+      continue;
+    }
+    const T *src = lhs + (row_start + i) * row_stride;
+    for (index_t d = 0; d < depth; ++d) {
+      packed[d * kGemmRows + i] = static_cast<float>(src[d * depth_stride]);
+    }
+  }
+}
+
+// Pack the columns [col_start, col_start + kGemmCols) of rhs[depth, cols]
+// given by its element strides as [depth, kGemmCols], the columns past the
+// end are 0.
+template<typename T>
+void PackGemmRhs(const T *rhs, const index_t depth_stride,
+                 const index_t col_stride, const index_t depth,
+                 const index_t cols, const index_t col_start,
+                 float *packed) {
+  const index_t col_len = std::min(kGemmCols, cols - col_start);
+  if (col_stride == 1 && col_len == kGemmCols) {
+    for (index_t d = 0; d < depth; ++d) {
+      const T *src = rhs + d * depth_stride + col_start;
+      float *dst = packed + d * kGemmCols;
+      VecStore(dst, VecLoad(src));
+      VecStore(dst + kVecFLanes, VecLoad(src + kVecFLanes));
+    }
+    return;
+  }
+  for (index_t d = 0; d < depth; ++d) {
+    const T *src = rhs + d * depth_stride + col_start * col_stride;
+    float *dst = packed + d * kGemmCols;
+    for (index_t j = 0; j < col_len; ++j) {
+      dst[j] = static_cast<float>(src[j * col_stride]);
+    }
+    std::fill(dst + col_len, dst + kGemmCols, 0.f);
+  }
+}
+
+// tile[kGemmRows, kGemmCols] = packed lhs * packed rhs
+inline void GemmKernel(const float *packed_lhs, const float *packed_rhs,
+                       const index_t depth, float *tile) {
+  VecF acc[kGemmRows][2];
+  for (index_t i = 0; i < kGemmRows; ++i) {
+    acc[i][0] = VecZero();
+    acc[i][1] = VecZero();
+  }
+  for (index_t d = 0; d < depth; ++d) {
+    const VecF r0 = VecLoad(packed_rhs);
+    const VecF r1 = VecLoad(packed_rhs + kVecFLanes);
+    for (index_t i = 0; i < kGemmRows; ++i) {
+      const VecF l = VecSet1(packed_lhs[i]);
+      acc[i][0] = VecFma(acc[i][0], l, r0);
+      acc[i][1] = VecFma(acc[i][1], l, r1);
+    }
+    packed_lhs += kGemmRows;
+    packed_rhs += kGemmCols;
+  }
+  for (index_t i = 0; i < kGemmRows; ++i) {
+    VecStore(tile + i * kGemmCols, acc[i][0]);
+    VecStore(tile + i * kGemmCols + kVecFLanes, acc[i][1]);
+  }
+}
+
+// out[rows, cols] = lhs * rhs, the lhs is packed by PackGemmLhs for all the
+// row blocks one after another, pack_rhs(col_start, packed) packs a column
+// block of the rhs as PackGemmRhs does. The column blocks are split over the
+// threads, and each block is packed once for all the rows of a thread.
+template<typename T, typename PackRhs>
+void PackedGemm(utils::ThreadPool *thread_pool,
+                const float *packed_lhs,
+                const PackRhs &pack_rhs,
+                const index_t rows,
+                const index_t cols,
+                const index_t depth,
+                T *out,
+                const index_t out_row_stride,
+                const index_t out_col_stride) {
+  const index_t row_blocks = RoundUpDiv(rows, kGemmRows);
+  const index_t col_blocks = RoundUpDiv(cols, kGemmCols);
+  thread_pool->Compute2D([=](index_t start0, index_t end0, index_t step0,
+                             index_t start1, index_t end1, index_t step1) {
+    std::vector<float> packed_rhs(depth * kGemmCols);
+    float tile[kGemmRows * kGemmCols];
+    for (index_t cb = start0; cb < end0; cb += step0) {
+      const index_t col_start = cb * kGemmCols;
+      const index_t col_len = std::min(kGemmCols, cols - col_start);
+      pack_rhs(col_start, packed_rhs.data());
+      for (index_t rb = start1; rb < end1; rb += step1) {
+        const index_t row_start = rb * kGemmRows;
+        const index_t row_len = std::min(kGemmRows, rows - row_start);
+        GemmKernel(packed_lhs + rb * depth * kGemmRows, packed_rhs.data(),
+                   depth, tile);
+        for (index_t i = 0; i < row_len; ++i) {
+          T *out_ptr = out + (row_start + i) * out_row_stride +
+              col_start * out_col_stride;
+          const float *tile_row = tile + i * kGemmCols;
+          if (out_col_stride == 1 && col_len == kGemmCols) {
+            VecStore(out_ptr, VecLoad(tile_row));
+            VecStore(out_ptr + kVecFLanes, VecLoad(tile_row + kVecFLanes));
+          } else {
+            for (index_t j = 0; j < col_len; ++j) {
+              out_ptr[j * out_col_stride] = tile_row[j];
+            }
+          }
+        }
+      }
+    }
+  }, 0, col_blocks, 1, 0, row_blocks, 1);
+}
+
+// Pack all the row blocks of lhs for PackedGemm.
+template<typename T>
+void PackGemmLhsBlocks(utils::ThreadPool *thread_pool, const T *lhs,
+                       const index_t row_stride, const index_t depth_stride,
+                       const index_t rows, const index_t depth,
+                       std::vector<float> *packed) {
+  const index_t row_blocks = RoundUpDiv(rows, kGemmRows);
+  packed->resize(row_blocks * kGemmRows * depth);
+  float *packed_data = packed->data();
+  thread_pool->Compute1D([=](index_t start, index_t end, index_t step) {
+    for (index_t rb = start; rb < end; rb += step) {
+      PackGemmLhs(lhs, row_stride, depth_stride, rows, depth,
+                  rb * kGemmRows, packed_data + rb * kGemmRows * depth);
+    }
+  }, 0, row_blocks, 1);
+}
+
+// GEMM of float or BFloat16 with the packed register-blocked kernel.
+template<typename T>
+class Gemm : public delegator::Gemm {
+ public:
+  explicit Gemm(const delegator::GemmParam &param) : delegator::Gemm(param) {}
+  ~Gemm() {}
+
+  MaceStatus Compute(const OpContext *context,
+                     const Tensor *lhs,
+                     const Tensor *rhs,
+                     const index_t batch,
+                     const index_t rows,
+                     const index_t cols,
+                     const index_t depth,
+                     const MatrixMajor lhs_major,
+                     const MatrixMajor rhs_major,
+                     const MatrixMajor output_major,
+                     const bool lhs_batched,
+                     const bool rhs_batched,
+                     Tensor *output) override;
+
+  MaceStatus Compute(const OpContext *context,
+                     const Tensor *lhs,
+                     const Tensor *rhs,
+                     const index_t batch,
+                     const index_t lhs_rows,
+                     const index_t lhs_cols,
+                     const index_t rhs_rows,
+                     const index_t rhs_cols,
+                     const bool transpose_lhs,
+                     const bool transpose_rhs,
+                     const bool transpose_out,
+                     const bool lhs_batched,
+                     const bool rhs_batched,
+                     Tensor *output) override;
+
+ private:
+  std::vector<float> packed_lhs_;
+};
+
+}  // namespace x86
+}  // namespace ops
+}  // namespace mace
+
+#endif  // MACE_OPS_X86_GEMM_H_
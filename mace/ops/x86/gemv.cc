@@ -0,0 +1,253 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mace/ops/x86/gemv.h"
+
+#include <algorithm>
+
+#include "mace/ops/x86/common_x86.h"
+#include "mace/utils/math.h"
+
+namespace mace {
+namespace ops {
+namespace x86 {
+
+namespace {
+// The rows of a pass, and the rhs vectors sharing the lhs when it is not
+// batched (2 rows for 4 vectors keep the accumulators in registers).
+const index_t kRowBlock = 4;
+const index_t kBatchBlock = 4;
+const index_t kBatchRowBlock = 2;
+
+template<typename L>
+inline VecF LoadLhs(const L *ptr) { return VecLoad(ptr); }
+
+#ifdef MACE_ENABLE_X86_HALF_WEIGHTS
+template<>
+inline VecF LoadLhs<half>(const half *ptr) { return VecLoadHalf(ptr); }
+#endif  // MACE_ENABLE_X86_HALF_WEIGHTS
+
+// sums[b * R + r] = dot(lhs row r, rhs vector b) for R rows and B vectors.
+template<typename L, typename T, int R, int B>
+struct GemvBlock {
+  static void Compute(const L *lhs, const T *rhs, const index_t rhs_stride,
+                      const index_t width, float *sums) {
+    VecF acc[B][R];
+    for (int b = 0; b < B; ++b) {
+      for (int r = 0; r < R; ++r) {
+        acc[b][r] = VecZero();
+      }
+    }
+
+    index_t w = 0;
+    for (; w + kVecFLanes <= width; w += kVecFLanes) {
+      VecF l[R];
+      for (int r = 0; r < R; ++r) {
+        l[r] = LoadLhs(lhs + r * width + w);
+      }
+      for (int b = 0; b < B; ++b) {
+        const VecF x = VecLoad(rhs + b * rhs_stride + w);
+        for (int r = 0; r < R; ++r) {
+          acc[b][r] = VecFma(acc[b][r], l[r], x);
+        }
+      }
+    }
+
+    for (int b = 0; b < B; ++b) {
+      for (int r = 0; r < R; ++r) {
+        sums[b * R + r] = VecSum(acc[b][r]);
+      }
+    }
+    for (; w < width; ++w) {
+      for (int r = 0; r < R; ++r) {
+        const float lv = static_cast<float>(lhs[r * width + w]);
+        for (int b = 0; b < B; ++b) {
+          sums[b * R + r] += lv * static_cast<float>(rhs[b * rhs_stride + w]);
+        }
+      }
+    }
+  }
+};
+
+#if defined(MACE_ENABLE_BFLOAT16) && defined(__AVX512BF16__)
+// vdpbf16ps accumulates the products of the pairs of BFloat16 lanes.
+template<int R, int B>
+struct GemvBlock<BFloat16, BFloat16, R, B> {
+  static void Compute(const BFloat16 *lhs, const BFloat16 *rhs,
+                      const index_t rhs_stride, const index_t width,
+                      float *sums) {
+    const index_t kPairLanes = 32;
+    __m512 acc[B][R];
+    for (int b = 0; b < B; ++b) {
+      for (int r = 0; r < R; ++r) {
+        acc[b][r] = _mm512_setzero_ps();
+      }
+    }
+
+    index_t w = 0;
+    for (; w + kPairLanes <= width; w += kPairLanes) {
+      __m512bh l[R];
+      for (int r = 0; r < R; ++r) {
+        l[r] = (__m512bh)_mm512_loadu_si512(lhs + r * width + w);
+      }
+      for (int b = 0; b < B; ++b) {
+        const __m512bh x =
+            (__m512bh)_mm512_loadu_si512(rhs + b * rhs_stride + w);
+        for (int r = 0; r < R; ++r) {
+          acc[b][r] = _mm512_dpbf16_ps(acc[b][r], l[r], x);
+        }
+      }
+    }
+
+    for (int b = 0; b < B; ++b) {
+      for (int r = 0; r < R; ++r) {
+        sums[b * R + r] = _mm512_reduce_add_ps(acc[b][r]);
+      }
+    }
+    for (; w < width; ++w) {
+      for (int r = 0; r < R; ++r) {
+        const float lv = static_cast<float>(lhs[r * width + w]);
+        for (int b = 0; b < B; ++b) {
+          sums[b * R + r] += lv * static_cast<float>(rhs[b * rhs_stride + w]);
+        }
+      }
+    }
+  }
+};
+#endif  // MACE_ENABLE_BFLOAT16 && __AVX512BF16__
+}  // namespace
+
+template<>
+MaceStatus Gemv<float>::Compute(const OpContext *context,
+                                const Tensor *lhs,
+                                const Tensor *rhs,
+                                const Tensor *bias,
+                                const index_t batch,
+                                const index_t lhs_height,
+                                const index_t lhs_width,
+                                const bool lhs_batched,
+                                const bool rhs_batched,
+                                Tensor *output) {
+#ifdef MACE_ENABLE_X86_HALF_WEIGHTS
+  if (lhs->dtype() == DT_HALF) {
+    return DoCompute(context, lhs->data<half>(), rhs, bias, batch,
+                     lhs_height, lhs_width, lhs_batched, rhs_batched, output);
+  }
+#endif  // MACE_ENABLE_X86_HALF_WEIGHTS
+  MACE_CHECK(lhs->dtype() == DT_FLOAT, "unsupported lhs data type: ",
+             DataTypeToString(lhs->dtype()));
+  return DoCompute(context, lhs->data<float>(), rhs, bias, batch,
+                   lhs_height, lhs_width, lhs_batched, rhs_batched, output);
+}
+
+#ifdef MACE_ENABLE_BFLOAT16
+template<>
+MaceStatus Gemv<BFloat16>::Compute(const OpContext *context,
+                                   const Tensor *lhs,
+                                   const Tensor *rhs,
+                                   const Tensor *bias,
+                                   const index_t batch,
+                                   const index_t lhs_height,
+                                   const index_t lhs_width,
+                                   const bool lhs_batched,
+                                   const bool rhs_batched,
+                                   Tensor *output) {
+  return DoCompute(context, lhs->data<BFloat16>(), rhs, bias, batch,
+                   lhs_height, lhs_width, lhs_batched, rhs_batched, output);
+}
+#endif  // MACE_ENABLE_BFLOAT16
+
+template<typename T>
+template<typename L>
+MaceStatus Gemv<T>::DoCompute(const OpContext *context,
+                              const L *lhs_data,
+                              const Tensor *rhs,
+                              const Tensor *bias,
+                              const index_t batch,
+                              const index_t lhs_height,
+                              const index_t lhs_width,
+                              const bool lhs_batched,
+                              const bool rhs_batched,
+                              Tensor *output) {
+  const T *rhs_data = rhs->data<T>();
+  const T *bias_data = bias == nullptr ? nullptr : bias->data<T>();
+  T *output_data = output->mutable_data<T>();
+
+  const index_t lhs_size = lhs_height * lhs_width;
+  const index_t rhs_stride = rhs_batched ? lhs_width : 0;
+  const bool share_lhs = !lhs_batched && rhs_batched && batch >= kBatchBlock;
+  const index_t batch_block = share_lhs ? kBatchBlock : 1;
+  const index_t row_block = share_lhs ? kBatchRowBlock : kRowBlock;
+
+  utils::ThreadPool &thread_pool = context->runtime()->thread_pool();
+
+  thread_pool.Compute2D([=](index_t start0, index_t end0, index_t step0,
+                            index_t start1, index_t end1, index_t step1) {
+    float sums[kBatchBlock * kRowBlock];
+    for (index_t bb = start0; bb < end0; bb += step0) {
+      const index_t b_start = bb * batch_block;
+      const index_t b_len = std::min(batch_block, batch - b_start);
+      const L *lhs_base =
+          lhs_data + static_cast<index_t>(lhs_batched) * b_start * lhs_size;
+      const T *rhs_base = rhs_data + b_start * rhs_stride;
+      T *out_base = output_data + b_start * lhs_height;
+
+      for (index_t hb = start1; hb < end1; hb += step1) {
+        const index_t h_start = hb * row_block;
+        const index_t h_len = std::min(row_block, lhs_height - h_start);
+        const L *lhs_ptr = lhs_base + h_start * lhs_width;
+
+        if (b_len == kBatchBlock && h_len == kBatchRowBlock) {
+          GemvBlock<L, T, kBatchRowBlock, kBatchBlock>::Compute(
+              lhs_ptr, rhs_base, rhs_stride, lhs_width, sums);
+        } else if (b_len == 1 && h_len == kRowBlock) {
+          GemvBlock<L, T, kRowBlock, 1>::Compute(
+              lhs_ptr, rhs_base, rhs_stride, lhs_width, sums);
+        } else {
+          for (index_t b = 0; b < b_len; ++b) {
+            for (index_t h = 0; h < h_len; ++h) {
+              GemvBlock<L, T, 1, 1>::Compute(
+                  lhs_ptr + h * lhs_width, rhs_base + b * rhs_stride,
+                  rhs_stride, lhs_width, sums + b * h_len + h);
+            }
+          }
+        }
+
+        for (index_t b = 0; b < b_len; ++b) {
+          T *out_ptr = out_base + b * lhs_height + h_start;
+          for (index_t h = 0; h < h_len; ++h) {
+            out_ptr[h] = sums[b * h_len + h] + (bias_data == nullptr ?
+                0.f : static_cast<float>(bias_data[h_start + h]));
+          }
+        }
+      }
+    }
+  }, 0, RoundUpDiv(batch, batch_block), 1,
+     0, RoundUpDiv(lhs_height, row_block), 1);
+
+  return MaceStatus::MACE_SUCCESS;
+}
+
+void RegisterGemvDelegator(OpDelegatorRegistry *registry) {
+  MACE_REGISTER_DELEGATOR(
+      registry, Gemv<float>, DelegatorParam,
+      MACE_DELEGATOR_KEY(Gemv, RuntimeType::RT_CPU, float, ImplType::X86));
+  MACE_REGISTER_BF16_DELEGATOR(
+      registry, Gemv<BFloat16>, DelegatorParam,
+      MACE_DELEGATOR_KEY(Gemv, RuntimeType::RT_CPU, BFloat16, ImplType::X86));
+}
+
+}  // namespace x86
+}  // namespace ops
+}  // namespace mace
@@ -0,0 +1,68 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MACE_OPS_X86_GEMV_H_
+#define MACE_OPS_X86_GEMV_H_
+
+#include "mace/core/ops/op_context.h"
+#include "mace/core/tensor.h"
+#include "mace/ops/delegator/gemv.h"
+#include "mace/public/mace.h"
+
+namespace mace {
+namespace ops {
+namespace x86 {
+
+// GEMV computed in float. For T = float the lhs is float, or fp16 with
+// MACE_ENABLE_X86_HALF_WEIGHTS, which is converted to float as it is loaded,
+// so that the weights of FullyConnected and DynamicLSTM stay in fp16. For
+// T = BFloat16 all the operands are BFloat16, the dot products use
+// vdpbf16ps with AVX512-BF16 and are widened by shifts otherwise. When the
+// lhs is shared by the batch, it is loaded once for every 4 rhs vectors.
+template<typename T>
+class Gemv : public delegator::Gemv {
+ public:
+  explicit Gemv(const DelegatorParam &param) : delegator::Gemv(param) {}
+  ~Gemv() {}
+
+  MaceStatus Compute(const OpContext *context,
+                     const Tensor *lhs,
+                     const Tensor *rhs,
+                     const Tensor *bias,
+                     const index_t batch,
+                     const index_t lhs_height,
+                     const index_t lhs_width,
+                     const bool lhs_batched,
+                     const bool rhs_batched,
+                     Tensor *output) override;
+
+ private:
+  template<typename L>
+  MaceStatus DoCompute(const OpContext *context,
+                       const L *lhs_data,
+                       const Tensor *rhs,
+                       const Tensor *bias,
+                       const index_t batch,
+                       const index_t lhs_height,
+                       const index_t lhs_width,
+                       const bool lhs_batched,
+                       const bool rhs_batched,
+                       Tensor *output);
+};
+
+}  // namespace x86
+}  // namespace ops
+}  // namespace mace
+
+#endif  // MACE_OPS_X86_GEMV_H_
@@ -34,6 +34,23 @@ MaceStatus Env::SchedSetAffinity(const std::vector<size_t> &cpu_ids) {
   return MaceStatus::MACE_UNSUPPORTED;
 }
 
+MaceStatus Env::GetNumaNodeCPUs(std::vector<std::vector<size_t>> *node_cpus) {
+  return MaceStatus::MACE_UNSUPPORTED;
+}
+
+MaceStatus Env::BindMemoryToNumaNode(void *addr, size_t length, int node) {
+  return MaceStatus::MACE_UNSUPPORTED;
+}
+
+MaceStatus Env::HugePageAlloc(void **memptr, size_t *length,
+                              bool explicit_huge_pages) {
+  return MaceStatus::MACE_UNSUPPORTED;
+}
+
+MaceStatus Env::HugePageFree(void *addr, size_t length) {
+  return MaceStatus::MACE_UNSUPPORTED;
+}
+
 std::unique_ptr<MallocLogger> Env::NewMallocLogger(
       std::ostringstream *oss,
       const std::string &name) {
@@ -22,6 +22,7 @@
 
 #include <cstddef>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -61,6 +62,38 @@ int GetCPUCount() {
   return cpu_count;
 }
 
+// Parse a sysfs list such as "0-3,8-11".
+bool ReadSysfsList(const std::string &path, std::vector<size_t> *ids) {
+  std::ifstream f(path);
+  if (!f.is_open()) {
+    return false;
+  }
+  std::string line;
+  std::getline(f, line);
+  f.close();
+  std::stringstream ss(line);
+  std::string range;
+  while (std::getline(ss, range, ',')) {
+    if (range.empty() || range[0] == '\n') {
+      continue;
+    }
+    char *end = nullptr;
+    const size_t first = strtoul(range.c_str(), &end, 10);
+    size_t last = first;
+    if (*end == '-') {
+      last = strtoul(end + 1, nullptr, 10);
+    }
+    for (size_t id = first; id <= last; ++id) {
+      ids->push_back(id);
+    }
+  }
+  return true;
+}
+
+constexpr size_t kHugePageSize = 2 * 1024 * 1024;
+constexpr int kMpolBind = 2;  // MPOL_BIND of linux/mempolicy.h
+constexpr unsigned int kMpolMfMove = 1 << 1;  // MPOL_MF_MOVE
+
 }  // namespace
 
 int64_t LinuxBaseEnv::NowMicros() {
@@ -122,6 +155,121 @@ MaceStatus LinuxBaseEnv::SchedSetAffinity(const std::vector<size_t> &cpu_ids) {
   return MaceStatus::MACE_SUCCESS;
 }
 
+MaceStatus LinuxBaseEnv::GetNumaNodeCPUs(
+    std::vector<std::vector<size_t>> *node_cpus) {
+  MACE_CHECK_NOTNULL(node_cpus);
+  // Read sysfs instead of using libnuma, which is not always available.
+  const std::string node_dir = "/sys/devices/system/node/";
+  std::vector<size_t> nodes;
+  if (!ReadSysfsList(node_dir + "online", &nodes) || nodes.empty()) {
+    LOG(WARNING) << "failed to read " << node_dir << "online";
+    return MaceStatus::MACE_UNSUPPORTED;
+  }
+  node_cpus->clear();
+  node_cpus->resize(nodes.back() + 1);
+  for (auto node : nodes) {
+    const std::string cpu_list = MakeString(node_dir, "node", node,
+                                            "/cpulist");
+    if (!ReadSysfsList(cpu_list, &(*node_cpus)[node])) {
+      LOG(ERROR) << "failed to read " << cpu_list;
+      return MaceStatus::MACE_RUNTIME_ERROR;
+    }
+    VLOG(1) << "NUMA node " << node << " CPUs: "
+            << MakeString((*node_cpus)[node]);
+  }
+
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus LinuxBaseEnv::BindMemoryToNumaNode(void *addr, size_t length,
+                                              int node) {
+#ifdef SYS_mbind
+  const size_t page_size = sysconf(_SC_PAGESIZE);
+  if (node < 0 || reinterpret_cast<uintptr_t>(addr) % page_size != 0) {
+    return MaceStatus::MACE_INVALID_ARGS;
+  }
+  const size_t kBitsPerMask = sizeof(unsigned long) * 8;  // NOLINT
+  std::vector<unsigned long> mask(node / kBitsPerMask + 1, 0);  // NOLINT
+  mask[node / kBitsPerMask] = 1UL << (node % kBitsPerMask);
+  // The kernel takes maxnode as the number of bits plus one.
+  int error = syscall(SYS_mbind, addr, length, kMpolBind, mask.data(),
+                      mask.size() * kBitsPerMask + 1, kMpolMfMove);
+  if (error != 0) {
+    LOG(WARNING) << "Bind memory to NUMA node " << node << " failed: "
+                 << strerror(errno);
+    return MaceStatus::MACE_RUNTIME_ERROR;
+  }
+  return MaceStatus::MACE_SUCCESS;
+#else
+  MACE_UNUSED(addr);
+  MACE_UNUSED(length);
+  MACE_UNUSED(node);
+  return MaceStatus::MACE_UNSUPPORTED;
+#endif
+}
+
+MaceStatus LinuxBaseEnv::HugePageAlloc(void **memptr, size_t *length,
+                                       bool explicit_huge_pages) {
+  const size_t size =
+      (*length + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+#ifdef MAP_HUGETLB
+  if (explicit_huge_pages) {
+    void *addr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (addr == MAP_FAILED) {
+      VLOG(1) << "Map explicit huge pages failed: " << strerror(errno);
+      return MaceStatus::MACE_OUT_OF_RESOURCES;
+    }
+    *memptr = addr;
+    *length = size;
+    return MaceStatus::MACE_SUCCESS;
+  }
+#endif  // MAP_HUGETLB
+#ifdef MADV_HUGEPAGE
+  if (!explicit_huge_pages) {
+    // Map one more huge page and unmap the unaligned head and tail, so that
+    // all of the memory could be backed by huge pages.
+    const size_t map_size = size + kHugePageSize;
+    void *addr = mmap(nullptr, map_size, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (addr == MAP_FAILED) {
+      return MaceStatus::MACE_OUT_OF_RESOURCES;
+    }
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(addr);
+    const uintptr_t aligned_begin =
+        (begin + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    const size_t head = aligned_begin - begin;
+    const size_t tail = map_size - head - size;
+    if (head > 0) {
+      munmap(addr, head);
+    }
+    if (tail > 0) {
+      munmap(reinterpret_cast<void *>(aligned_begin + size), tail);
+    }
+    void *aligned_addr = reinterpret_cast<void *>(aligned_begin);
+    if (madvise(aligned_addr, size, MADV_HUGEPAGE) != 0) {
+      VLOG(1) << "Advise transparent huge pages failed: " << strerror(errno);
+      munmap(aligned_addr, size);
+      return MaceStatus::MACE_UNSUPPORTED;
+    }
+    *memptr = aligned_addr;
+    *length = size;
+    return MaceStatus::MACE_SUCCESS;
+  }
+#endif  // MADV_HUGEPAGE
+  MACE_UNUSED(memptr);
+  MACE_UNUSED(size);
+  return MaceStatus::MACE_UNSUPPORTED;
+}
+
+MaceStatus LinuxBaseEnv::HugePageFree(void *addr, size_t length) {
+  if (munmap(addr, length) != 0) {
+    LOG(ERROR) << "Unmap huge pages failed: " << strerror(errno);
+    return MaceStatus::MACE_RUNTIME_ERROR;
+  }
+  return MaceStatus::MACE_SUCCESS;
+}
+
 MaceStatus LinuxBaseEnv::AdviseFree(void *addr, size_t length) {
   int page_size = sysconf(_SC_PAGESIZE);
   void *addr_aligned =
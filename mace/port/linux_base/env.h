@@ -30,6 +30,13 @@ class LinuxBaseEnv : public Env {
   MaceStatus GetCPUMaxFreq(std::vector<float> *max_freqs) override;
   FileSystem *GetFileSystem() override;
   MaceStatus SchedSetAffinity(const std::vector<size_t> &cpu_ids) override;
+  MaceStatus GetNumaNodeCPUs(
+      std::vector<std::vector<size_t>> *node_cpus) override;
+  MaceStatus BindMemoryToNumaNode(void *addr, size_t length,
+                                  int node) override;
+  MaceStatus HugePageAlloc(void **memptr, size_t *length,
+                           bool explicit_huge_pages) override;
+  MaceStatus HugePageFree(void *addr, size_t length) override;
 
  protected:
   PosixFileSystem posix_file_system_;
@@ -14,11 +14,28 @@
 
 #include "mace/runtimes/cpu/cpu_ref_allocator.h"
 
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
 #include "mace/core/runtime_failure_mock.h"
 #include "mace/utils/logging.h"
+#include "mace/utils/math.h"
 
 namespace mace {
 
+namespace {
+constexpr index_t kHugePageSize = 2 * 1024 * 1024;
+
+index_t GetPageSize() {
+#ifdef _WIN32
+  return 4096;
+#else
+  return sysconf(_SC_PAGESIZE);
+#endif
+}
+}  // namespace
+
 MemoryType CpuRefAllocator::GetMemType() {
   return MemoryType::CPU_BUFFER;
 }
@@ -34,15 +51,83 @@ MaceStatus CpuRefAllocator::New(const MemInfo &info, void **result) {
     return MaceStatus::MACE_OUT_OF_RESOURCES;
   }
 
-  MACE_RETURN_IF_ERROR(Memalign(result, kMaceAlignment, nbytes));
+  if (huge_page_policy_ != HUGE_PAGE_NONE && nbytes >= kHugePageSize &&
+      NewHugePageBuffer(nbytes, result) == MaceStatus::MACE_SUCCESS) {
+    return MaceStatus::MACE_SUCCESS;
+  }
+
+  if (numa_node_ < 0) {
+    MACE_RETURN_IF_ERROR(Memalign(result, kMaceAlignment, nbytes));
+  } else {
+    // The memory policy is set by pages, don't share them with other
+    // buffers.
+    const index_t page_size = GetPageSize();
+    nbytes = RoundUp<index_t>(nbytes, page_size);
+    MACE_RETURN_IF_ERROR(Memalign(result, page_size, nbytes));
+    if (BindMemoryToNumaNode(*result, nbytes, numa_node_)
+        != MaceStatus::MACE_SUCCESS) {
+      VLOG(1) << "Allocate CPU buffer without NUMA binding";
+    }
+  }
+
+  if (huge_page_policy_ != HUGE_PAGE_NONE) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_[*result] = {nbytes, false};
+    allocated_bytes_ += nbytes;
+  }
 
   return MaceStatus::MACE_SUCCESS;
 }
 
+MaceStatus CpuRefAllocator::NewHugePageBuffer(index_t nbytes, void **result) {
+  size_t length = static_cast<size_t>(nbytes);
+  MaceStatus status = MaceStatus::MACE_UNSUPPORTED;
+  if (huge_page_policy_ == HUGE_PAGE_EXPLICIT) {
+    status = HugePageAlloc(result, &length, true);
+  }
+  if (status != MaceStatus::MACE_SUCCESS) {
+    status = HugePageAlloc(result, &length, false);
+  }
+  if (status != MaceStatus::MACE_SUCCESS) {
+    VLOG(1) << "Allocate CPU buffer without huge pages";
+    return status;
+  }
+  if (numa_node_ >= 0) {
+    BindMemoryToNumaNode(*result, length, numa_node_);
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  buffers_[*result] = {static_cast<index_t>(length), true};
+  allocated_bytes_ += length;
+  huge_page_bytes_ += length;
+  return MaceStatus::MACE_SUCCESS;
+}
+
 void CpuRefAllocator::Delete(void *data) {
   MACE_CHECK_NOTNULL(data);
   VLOG(3) << "Free CPU buffer";
+  if (huge_page_policy_ != HUGE_PAGE_NONE) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto iter = buffers_.find(data);
+    if (iter != buffers_.end()) {
+      const BufferInfo info = iter->second;
+      buffers_.erase(iter);
+      allocated_bytes_ -= info.bytes;
+      if (info.huge_page) {
+        huge_page_bytes_ -= info.bytes;
+        HugePageFree(data, info.bytes);
+        return;
+      }
+    }
+  }
   free(data);
 }
 
+void CpuRefAllocator::GetHugePageCoverage(index_t *allocated_bytes,
+                                          index_t *huge_page_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  *allocated_bytes = allocated_bytes_;
+  *huge_page_bytes = huge_page_bytes_;
+}
+
 }  // namespace mace
@@ -15,17 +15,52 @@
 #ifndef MACE_RUNTIMES_CPU_CPU_REF_ALLOCATOR_H_
 #define MACE_RUNTIMES_CPU_CPU_REF_ALLOCATOR_H_
 
+#include <mutex>  // NOLINT(build/c++11)
+#include <unordered_map>
+
 #include "mace/core/memory/allocator.h"
 
 namespace mace {
 class CpuRefAllocator : public Allocator {
  public:
-  CpuRefAllocator() {}
+  CpuRefAllocator()
+      : numa_node_(-1), huge_page_policy_(HUGE_PAGE_NONE),
+        allocated_bytes_(0), huge_page_bytes_(0) {}
   ~CpuRefAllocator() {}
 
+  // Allocate the buffers on the NUMA node, -1 for no binding.
+  void SetNumaNode(int numa_node) {
+    numa_node_ = numa_node;
+  }
+
+  // Back the buffers of at least one huge page with huge pages.
+  void SetHugePagePolicy(CPUHugePagePolicy policy) {
+    huge_page_policy_ = policy;
+  }
+
+  // The bytes of the buffers in use, and of those backed by huge pages. Only
+  // counted if huge pages are enabled.
+  void GetHugePageCoverage(index_t *allocated_bytes,
+                           index_t *huge_page_bytes);
+
   MemoryType GetMemType() override;
   MaceStatus New(const MemInfo &info, void **result) override;
   void Delete(void *data) override;
+
+ private:
+  MaceStatus NewHugePageBuffer(index_t nbytes, void **result);
+
+  struct BufferInfo {
+    index_t bytes;
+    bool huge_page;
+  };
+
+  int numa_node_;
+  CPUHugePagePolicy huge_page_policy_;
+  std::mutex mutex_;
+  std::unordered_map<void *, BufferInfo> buffers_;
+  index_t allocated_bytes_;
+  index_t huge_page_bytes_;
 };
 
 }  // namespace mace
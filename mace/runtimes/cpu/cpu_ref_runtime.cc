@@ -26,12 +26,37 @@ CpuRefRuntime::CpuRefRuntime(RuntimeContext *runtime_context)
     : CpuRuntime(runtime_context),
       buffer_allocator_(make_unique<CpuRefAllocator>()),
       buffer_manager_(
-          make_unique<GeneralMemoryManager>(buffer_allocator_.get())) {}
+          make_unique<GeneralMemoryManager>(buffer_allocator_.get())),
+      huge_page_coverage_logged_(false) {}
 
 CpuRefRuntime::~CpuRefRuntime() {
   VLOG(1) << "Destroy CpuRefRuntime";
 }
 
+MaceStatus CpuRefRuntime::Init(const MaceEngineCfgImpl *engine_config,
+                               const MemoryType mem_type) {
+  MACE_RETURN_IF_ERROR(CpuRuntime::Init(engine_config, mem_type));
+  buffer_allocator_->SetNumaNode(numa_node());
+  buffer_allocator_->SetHugePagePolicy(huge_page_policy());
+  return MaceStatus::MACE_SUCCESS;
+}
+
+MaceStatus CpuRefRuntime::AfterRun() {
+  // All the buffers are allocated after the first run.
+  if (huge_page_policy() != HUGE_PAGE_NONE && !huge_page_coverage_logged_) {
+    index_t allocated_bytes = 0;
+    index_t huge_page_bytes = 0;
+    buffer_allocator_->GetHugePageCoverage(&allocated_bytes,
+                                           &huge_page_bytes);
+    LOG(INFO) << "Huge pages back " << huge_page_bytes << " of "
+              << allocated_bytes << " bytes of CPU buffers ("
+              << (allocated_bytes > 0 ?
+                  huge_page_bytes * 100 / allocated_bytes : 0) << "%)";
+    huge_page_coverage_logged_ = true;
+  }
+  return CpuRuntime::AfterRun();
+}
+
 MemoryManager *CpuRefRuntime::GetMemoryManager(MemoryType mem_type) {
   MemoryManager *buffer_manager = nullptr;
   if (mem_type == MemoryType::CPU_BUFFER) {
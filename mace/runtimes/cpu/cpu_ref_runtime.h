@@ -28,12 +28,17 @@ class CpuRefRuntime : public CpuRuntime {
   explicit CpuRefRuntime(RuntimeContext *runtime_context);
   ~CpuRefRuntime();
 
+  MaceStatus Init(const MaceEngineCfgImpl *engine_config,
+                  const MemoryType mem_type) override;
+  MaceStatus AfterRun() override;
+
  protected:
   MemoryManager *GetMemoryManager(MemoryType mem_type) override;
 
  private:
   std::unique_ptr<CpuRefAllocator> buffer_allocator_;
   std::unique_ptr<GeneralMemoryManager> buffer_manager_;
+  bool huge_page_coverage_logged_;
 };
 
 }  // namespace mace
@@ -14,16 +14,89 @@
 
 #include "mace/runtimes/cpu/cpu_runtime.h"
 
+#include <map>
+#include <mutex>  // NOLINT(build/c++11)
+#include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "mace/core/memory/buffer.h"
 #include "mace/core/proto/net_def_helper.h"
 #include "mace/utils/memory.h"
+#include "mace/utils/timer.h"
+#include "mace/utils/tuner.h"
 
 namespace mace {
 
+class CpuRuntime::SharedTuner {
+ public:
+  explicit SharedTuner(const std::string &path) : tuner_(path) {
+    // The Tuner writes to MACE_RUN_PARAMETER_PATH by default, which is the
+    // file of the OpenCL parameters, so only write the CPU parameters to
+    // their own file and only when they are tuned.
+    tuner_.SetOutputPath(tuner_.IsTuning() ? path : "");
+  }
+
+  static std::shared_ptr<SharedTuner> Get(const std::string &path) {
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<SharedTuner>> tuners;
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<SharedTuner> tuner = tuners[path].lock();
+    if (tuner == nullptr) {
+      tuner = std::make_shared<SharedTuner>(path);
+      tuners[path] = tuner;
+    }
+    return tuner;
+  }
+
+  std::vector<uint32_t> TuneOrRun(
+      const std::string &key,
+      const std::vector<uint32_t> &default_params,
+      const std::function<std::vector<std::vector<uint32_t>>()> &generator,
+      const std::function<MaceStatus(const std::vector<uint32_t> &)> &func,
+      MaceStatus *status) {
+    // Tuner returns the result of the fastest params, so return the index of
+    // the params run to find them.
+    std::vector<std::vector<uint32_t>> params_run;
+    *status = MaceStatus::MACE_SUCCESS;
+    std::function<int(const std::vector<uint32_t> &, Timer *,
+                      std::vector<uint32_t> *)> timed_func =
+        [&](const std::vector<uint32_t> &params, Timer *timer,
+            std::vector<uint32_t> *tuning_result) -> int {
+          if (timer != nullptr) {
+            timer->ClearTiming();
+            timer->StartTiming();
+          }
+          MaceStatus func_status = func(params);
+          if (timer != nullptr) {
+            timer->AccumulateTiming();
+            *tuning_result = params;
+          }
+          if (func_status != MaceStatus::MACE_SUCCESS) {
+            *status = func_status;
+          }
+          params_run.push_back(params);
+          return static_cast<int>(params_run.size() - 1);
+        };
+    WallClockTimer timer;
+    std::lock_guard<std::mutex> lock(mutex_);
+    int index = tuner_.TuneOrRun<int>(key, default_params, generator,
+                                      timed_func, &timer);
+    return params_run.empty() ? default_params : params_run[index];
+  }
+
+ private:
+  Tuner<uint32_t> tuner_;
+  std::mutex mutex_;
+};
+
 CpuRuntime::CpuRuntime(RuntimeContext *runtime_context)
-    : Runtime(runtime_context) {}
+    : Runtime(runtime_context), numa_node_(-1),
+      huge_page_policy_(HUGE_PAGE_NONE) {
+#ifdef MACE_ENABLE_X86_HALF_WEIGHTS
+  half_gemv_net_def_ = nullptr;
+#endif  // MACE_ENABLE_X86_HALF_WEIGHTS
+}
 
 MaceStatus CpuRuntime::Init(const MaceEngineCfgImpl *engine_config,
                             const MemoryType mem_type) {
@@ -31,8 +104,18 @@ MaceStatus CpuRuntime::Init(const MaceEngineCfgImpl *engine_config,
 #ifdef MACE_ENABLE_QUANTIZE
   MACE_CHECK_NOTNULL(GetGemmlowpContext());
 #endif  // MACE_ENABLE_QUANTIZE
-  SetThreadsHintAndAffinityPolicy(engine_config->num_threads(),
-                                  engine_config->cpu_affinity_policy());
+  if (engine_config->cpu_numa_node() < 0 ||
+      SetThreadsHintAndNumaNode(engine_config->num_threads(),
+                                engine_config->cpu_numa_node())
+          != MaceStatus::MACE_SUCCESS) {
+    SetThreadsHintAndAffinityPolicy(engine_config->num_threads(),
+                                    engine_config->cpu_affinity_policy());
+  }
+  huge_page_policy_ = engine_config->cpu_huge_page_policy();
+  const std::string tuning_path = engine_config->cpu_tuning_parameter_path();
+  if (!tuning_path.empty()) {
+    tuner_ = SharedTuner::Get(tuning_path);
+  }
 
   return MaceStatus::MACE_SUCCESS;
 }
@@ -45,10 +128,20 @@ std::unique_ptr<Buffer> CpuRuntime::MakeSliceBuffer(
     const NetDef &net_def,
     const unsigned char *model_data, const index_t model_data_size) {
   MACE_ASSERT(model_data != nullptr && model_data_size > 0);
+#ifdef MACE_ENABLE_X86_HALF_WEIGHTS
+  // The tensors of a net are loaded next, which may be at the address of a
+  // net loaded before.
+  half_gemv_net_def_ = nullptr;
+#endif  // MACE_ENABLE_X86_HALF_WEIGHTS
   if (NetDefHelper::HasHalfTensor(net_def)) {
     return nullptr;
   }
 
+  // Copy the weights to the memory of the NUMA node or to huge pages.
+  if (numa_node_ >= 0 || huge_page_policy_ != HUGE_PAGE_NONE) {
+    return nullptr;
+  }
+
   if (!NetDefHelper::IsQuantizedModel(net_def) &&
       NetDefHelper::HasQuantizedTensor(net_def)) {
     return nullptr;
@@ -61,14 +154,67 @@ std::unique_ptr<Buffer> CpuRuntime::MakeSliceBuffer(
   return buffer;
 }
 
+#ifdef MACE_ENABLE_X86_HALF_WEIGHTS
+namespace {
+// The tensors only read as the weights of the gemv of FullyConnected or
+// DynamicLSTM, which converts fp16 to float on the fly.
+std::unordered_set<std::string> HalfGemvWeights(const NetDef &net_def) {
+  std::unordered_set<std::string> weights;
+  std::unordered_set<std::string> others;
+  for (auto &op : net_def.op()) {
+    for (int i = 0; i < op.input_size(); ++i) {
+      const bool is_weight =
+          (op.type() == "FullyConnected" && i == 1) ||
+          (op.type() == "DynamicLSTM" && (i == 3 || i == 5));
+      if (is_weight) {
+        weights.insert(op.input(i));
+      } else {
+        others.insert(op.input(i));
+      }
+    }
+  }
+  for (auto &name : others) {
+    weights.erase(name);
+  }
+  return weights;
+}
+}  // namespace
+#endif  // MACE_ENABLE_X86_HALF_WEIGHTS
+
 DataType CpuRuntime::GetComputeDataType(const NetDef &net_def,
                                         const ConstTensor &const_tensor) {
   if (const_tensor.data_type() == DataType::DT_HALF) {
+#ifdef MACE_ENABLE_X86_HALF_WEIGHTS
+    if (half_gemv_net_def_ != &net_def) {
+      half_gemv_weights_ = HalfGemvWeights(net_def);
+      half_gemv_net_def_ = &net_def;
+    }
+    if (half_gemv_weights_.count(const_tensor.name()) > 0) {
+      return DataType::DT_HALF;
+    }
+#endif  // MACE_ENABLE_X86_HALF_WEIGHTS
     return DataType::DT_FLOAT;
   }
   return Runtime::GetComputeDataType(net_def, const_tensor);
 }
 
+bool CpuRuntime::IsTunerEnabled() const {
+  return tuner_ != nullptr;
+}
+
+std::vector<uint32_t> CpuRuntime::TuneOrRun(
+    const std::string &key,
+    const std::vector<uint32_t> &default_params,
+    const std::function<std::vector<std::vector<uint32_t>>()> &generator,
+    const std::function<MaceStatus(const std::vector<uint32_t> &)> &func,
+    MaceStatus *status) {
+  if (tuner_ == nullptr) {
+    *status = func(default_params);
+    return default_params;
+  }
+  return tuner_->TuneOrRun(key, default_params, generator, func, status);
+}
+
 MaceStatus CpuRuntime::SetThreadsHintAndAffinityPolicy(
     int num_threads_hint, CPUAffinityPolicy policy) {
   // get cpu frequency info
@@ -99,6 +245,26 @@ MaceStatus CpuRuntime::SetThreadsHintAndAffinityPolicy(
   return status;
 }
 
+MaceStatus CpuRuntime::SetThreadsHintAndNumaNode(int num_threads_hint,
+                                                 int numa_node) {
+  std::vector<size_t> cores_to_use;
+  MACE_RETURN_IF_ERROR(utils::GetNumaNodeCoresToUse(
+      numa_node, &num_threads_hint, &cores_to_use));
+
+#ifdef MACE_ENABLE_QUANTIZE
+  if (gemm_context_ != nullptr) {
+    gemm_context_->set_max_num_threads(num_threads_hint);
+  }
+#endif  // MACE_ENABLE_QUANTIZE
+
+  MACE_RETURN_IF_ERROR(SchedSetAffinity(cores_to_use));
+  VLOG(1) << "Set affinity to NUMA node " << numa_node << ": "
+          << MakeString(cores_to_use);
+  numa_node_ = numa_node;
+
+  return MaceStatus::MACE_SUCCESS;
+}
+
 #ifdef MACE_ENABLE_QUANTIZE
 gemmlowp::GemmContext *CpuRuntime::GetGemmlowpContext() {
   if (gemm_context_ == nullptr) {
@@ -16,7 +16,11 @@
 #ifndef MACE_RUNTIMES_CPU_CPU_RUNTIME_H_
 #define MACE_RUNTIMES_CPU_CPU_RUNTIME_H_
 
+#include <functional>
 #include <memory>
+#include <string>
+#include <unordered_set>
+#include <vector>
 
 #include "mace/core/runtime/runtime.h"
 
@@ -49,14 +53,50 @@ class CpuRuntime : public Runtime {
   gemmlowp::GemmContext *GetGemmlowpContext();
 #endif  // MACE_ENABLE_QUANTIZE
 
+  // Whether the CPU tuning parameter path is set, if not, ops should use
+  // their built-in heuristics.
+  bool IsTunerEnabled() const;
+
+  // Run func with the tuned params of key, or the default params if key is
+  // not tuned. If MACE_TUNING=1, time func with all the params generated
+  // instead and keep the fastest ones. Return the params finally chosen.
+  std::vector<uint32_t> TuneOrRun(
+      const std::string &key,
+      const std::vector<uint32_t> &default_params,
+      const std::function<std::vector<std::vector<uint32_t>>()> &generator,
+      const std::function<MaceStatus(const std::vector<uint32_t> &)> &func,
+      MaceStatus *status);
+
+ protected:
+  // The NUMA node the threads are bound to, or -1.
+  int numa_node() const {
+    return numa_node_;
+  }
+
+  CPUHugePagePolicy huge_page_policy() const {
+    return huge_page_policy_;
+  }
+
  private:
   MaceStatus SetThreadsHintAndAffinityPolicy(int num_threads_hint,
                                              CPUAffinityPolicy policy);
+  MaceStatus SetThreadsHintAndNumaNode(int num_threads_hint, int numa_node);
 
  private:
 #ifdef MACE_ENABLE_QUANTIZE
   std::unique_ptr<gemmlowp::GemmContext> gemm_context_;
 #endif  // MACE_ENABLE_QUANTIZE
+  int numa_node_;
+  CPUHugePagePolicy huge_page_policy_;
+#ifdef MACE_ENABLE_X86_HALF_WEIGHTS
+  // The fp16 tensors of half_gemv_net_def_ which are kept as fp16, built
+  // once for the net whose tensors are being loaded.
+  const NetDef *half_gemv_net_def_;
+  std::unordered_set<std::string> half_gemv_weights_;
+#endif  // MACE_ENABLE_X86_HALF_WEIGHTS
+  class SharedTuner;
+  // Shared by the runtimes with the same parameter path.
+  std::shared_ptr<SharedTuner> tuner_;
 };
 
 }  // namespace mace
@@ -165,6 +165,12 @@ DEFINE_string(
     accelerator_storage_file,
     "",
     "accelerator init cache path, used when store accelerator init cache");
+DEFINE_string(init_cache_path,
+              "",
+              "directory of the cpu init cache, empty to disable it");
+DEFINE_string(cpu_tuning_parameter_path,
+              "",
+              "parameter file of the cpu autotuner, empty to disable it");
 DEFINE_int32(round, 1, "round");
 DEFINE_int32(restart_round, 1, "restart round");
 DEFINE_int32(malloc_check_cycle, -1, "malloc debug check cycle, -1 to disable");
@@ -173,6 +179,10 @@ DEFINE_int32(gpu_priority_hint, 3, "0:DEFAULT/1:LOW/2:NORMAL/3:HIGH");
 DEFINE_int32(num_threads, -1, "num of threads");
 DEFINE_int32(cpu_affinity_policy, 1,
              "0:AFFINITY_NONE/1:AFFINITY_BIG_ONLY/2:AFFINITY_LITTLE_ONLY");
+DEFINE_int32(cpu_numa_node, -1,
+             "NUMA node to run cpu threads and allocate memory, -1 for none");
+DEFINE_int32(cpu_huge_page_policy, 0,
+             "0:HUGE_PAGE_NONE/1:HUGE_PAGE_TRANSPARENT/2:HUGE_PAGE_EXPLICIT");
 DEFINE_int32(apu_boost_hint, 100,
              "APU boost value ranged between 0 (lowest) to 100 (highest)");
 DEFINE_int32(apu_preference_hint, 1,
@@ -341,6 +351,9 @@ bool RunModel(const std::string &model_name,
   if (status != MaceStatus::MACE_SUCCESS) {
     LOG(WARNING) << "Set cpu affinity failed.";
   }
+  config.SetCPUNumaNode(FLAGS_cpu_numa_node);
+  config.SetCPUHugePagePolicy(
+      static_cast<CPUHugePagePolicy>(FLAGS_cpu_huge_page_policy));
 #if defined(MACE_ENABLE_OPENCL) || defined(MACE_ENABLE_HTA)
   std::shared_ptr<OpenclContext> opencl_context;
   const char *storage_path_ptr = getenv("MACE_INTERNAL_STORAGE_PATH");
@@ -381,6 +394,8 @@ bool RunModel(const std::string &model_name,
 #ifdef MACE_ENABLE_QNN
   config.SetQnnPerformance(HEXAGON_SYSTEM_SETTINGS);
 #endif
+  config.SetInitCachePath(FLAGS_init_cache_path);
+  config.SetCPUTuningParameterPath(FLAGS_cpu_tuning_parameter_path);
   std::unique_ptr<mace::port::ReadOnlyMemoryRegion> model_graph_data =
       make_unique<mace::port::ReadOnlyBufferMemoryRegion>();
   if (FLAGS_model_file != "") {
@@ -734,6 +749,9 @@ int Main(int argc, char **argv) {
   LOG(INFO) << "accelerator_cache_policy: " << FLAGS_accelerator_cache_policy;
   LOG(INFO) << "accelerator_binary_file: " << FLAGS_accelerator_binary_file;
   LOG(INFO) << "accelerator_storage_file: " << FLAGS_accelerator_storage_file;
+  LOG(INFO) << "init_cache_path: " << FLAGS_init_cache_path;
+  LOG(INFO) << "cpu_tuning_parameter_path: "
+            << FLAGS_cpu_tuning_parameter_path;
   LOG(INFO) << "apu_boost_hint: " << FLAGS_apu_boost_hint;
   LOG(INFO) << "apu_preference_hint: " << FLAGS_apu_preference_hint;
   LOG(INFO) << "round: " << FLAGS_round;
@@ -742,6 +760,8 @@ int Main(int argc, char **argv) {
   LOG(INFO) << "gpu_priority_hint: " << FLAGS_gpu_priority_hint;
   LOG(INFO) << "num_threads: " << FLAGS_num_threads;
   LOG(INFO) << "cpu_affinity_policy: " << FLAGS_cpu_affinity_policy;
+  LOG(INFO) << "cpu_numa_node: " << FLAGS_cpu_numa_node;
+  LOG(INFO) << "cpu_huge_page_policy: " << FLAGS_cpu_huge_page_policy;
   auto limit_opencl_kernel_time = getenv("MACE_LIMIT_OPENCL_KERNEL_TIME");
   if (limit_opencl_kernel_time) {
     LOG(INFO) << "limit_opencl_kernel_time: "
@@ -143,6 +143,26 @@ MaceStatus GetCPUCoresToUse(const std::vector<float> &cpu_max_freqs,
   return MaceStatus::MACE_SUCCESS;
 }
 
+MaceStatus GetNumaNodeCoresToUse(int numa_node,
+                                 int *thread_count,
+                                 std::vector<size_t> *cores) {
+  std::vector<std::vector<size_t>> node_cpus;
+  MACE_RETURN_IF_ERROR(port::Env::Default()->GetNumaNodeCPUs(&node_cpus));
+  if (numa_node < 0 || numa_node >= static_cast<int>(node_cpus.size())
+      || node_cpus[numa_node].empty()) {
+    LOG(ERROR) << "NUMA node " << numa_node << " has no CPU";
+    return MaceStatus::MACE_INVALID_ARGS;
+  }
+  *cores = node_cpus[numa_node];
+  if (*thread_count > 0 && *thread_count < static_cast<int>(cores->size())) {
+    cores->resize(*thread_count);
+  }
+  *thread_count = static_cast<int>(cores->size());
+  VLOG(2) << "Bind threads to NUMA node " << numa_node << ", cores: "
+          << MakeString(*cores);
+  return MaceStatus::MACE_SUCCESS;
+}
+
 ThreadPool::ThreadPool(const int thread_count_hint,
                        const CPUAffinityPolicy policy)
     : event_(kThreadPoolNone),
@@ -166,16 +186,27 @@ ThreadPool::ThreadPool(const int thread_count_hint,
     }
   }
 
-  default_tile_count_ = thread_count;
-  if (thread_count > 1) {
-    default_tile_count_ = thread_count * kTileCountPerThread;
+  threads_ = std::vector<std::thread>(static_cast<size_t>(thread_count));
+  thread_infos_ = std::vector<ThreadInfo>(static_cast<size_t>(thread_count));
+  SetTileCountPerThread(kTileCountPerThread);
+  for (auto &thread_info : thread_infos_) {
+    thread_info.cpu_cores = cores_to_use;
   }
-  MACE_CHECK(default_tile_count_ > 0, "default tile count should > 0");
+}
+
+ThreadPool::ThreadPool(const std::vector<size_t> &cpu_cores)
+    : event_(kThreadPoolNone),
+      count_down_latch_(kThreadPoolSpinWaitTime) {
+  const int thread_count = static_cast<int>(cpu_cores.size());
+  MACE_CHECK(thread_count > 0);
+  VLOG(2) << "Use " << thread_count << " threads on cores "
+          << MakeString(cpu_cores);
 
   threads_ = std::vector<std::thread>(static_cast<size_t>(thread_count));
   thread_infos_ = std::vector<ThreadInfo>(static_cast<size_t>(thread_count));
+  SetTileCountPerThread(kTileCountPerThread);
   for (auto &thread_info : thread_infos_) {
-    thread_info.cpu_cores = cores_to_use;
+    thread_info.cpu_cores = cpu_cores;
   }
 }
 
@@ -192,6 +223,19 @@ ThreadPool::~ThreadPool() {
   Destroy();
 }
 
+void ThreadPool::SetTileCountPerThread(int tile_count_per_thread) {
+  if (tile_count_per_thread <= 0) {
+    tile_count_per_thread = kTileCountPerThread;
+  }
+  tile_count_per_thread_ = tile_count_per_thread;
+  const int64_t thread_count = static_cast<int64_t>(threads_.size());
+  default_tile_count_ = thread_count;
+  if (thread_count > 1) {
+    default_tile_count_ = thread_count * tile_count_per_thread;
+  }
+  MACE_CHECK(default_tile_count_ > 0, "default tile count should > 0");
+}
+
 void ThreadPool::Init() {
   VLOG(2) << "Init thread pool";
   if (threads_.size() <= 1) {
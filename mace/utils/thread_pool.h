@@ -34,14 +34,36 @@ MaceStatus GetCPUCoresToUse(const std::vector<float> &cpu_max_freqs,
                             int *thread_count_hint,
                             std::vector<size_t> *cores);
 
+// Get the cores of the NUMA node, at most thread_count_hint of them if it is
+// positive. thread_count is set to the number of the cores.
+MaceStatus GetNumaNodeCoresToUse(int numa_node,
+                                 int *thread_count,
+                                 std::vector<size_t> *cores);
+
 class ThreadPool {
  public:
   ThreadPool(const int thread_count,
              const CPUAffinityPolicy affinity_policy);
+  // One thread per core, all bound to the given cores. Unlike the above
+  // constructor, the affinity of the calling thread is not changed, the
+  // thread which runs Compute* should bind itself if needed.
+  explicit ThreadPool(const std::vector<size_t> &cpu_cores);
   ~ThreadPool();
 
   void Init();
 
+  size_t thread_count() const {
+    return threads_.size();
+  }
+
+  // The tile count per thread used by Compute* when the tile sizes are not
+  // given. Ops run one by one on a pool, so an op could tune it around its
+  // Compute* calls and restore it afterwards. <= 0 means the default.
+  int tile_count_per_thread() const {
+    return tile_count_per_thread_;
+  }
+  void SetTileCountPerThread(int tile_count_per_thread);
+
   void Run(const std::function<void(const int64_t)> &func,
            const int64_t iterations);
 
@@ -116,6 +138,7 @@ class ThreadPool {
   std::vector<std::thread> threads_;
   std::vector<float> cpu_max_freqs_;
 
+  int tile_count_per_thread_;
   int64_t default_tile_count_;
 };
 
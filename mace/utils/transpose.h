@@ -17,8 +17,16 @@
 
 #if defined(MACE_ENABLE_NEON)
 #include <arm_neon.h>
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
 #endif  // MACE_ENABLE_NEON
 #include <algorithm>
+#include <functional>
+#include <numeric>
 #include <vector>
 
 #include "mace/core/types.h"
@@ -161,46 +169,260 @@ inline void TransposeNCHWToNHWCC2<float, float>(utils::ThreadPool *thread_pool,
   }, 0, height, 1);
 }
 
+// Edge of the square tiles used by the blocked 2D transpose, a tile of
+// input and a tile of output fit in L1 together.
+constexpr index_t kTransposeTileSize = 32;
+
+// Convert size elements from SrcT to DstT.
+template<typename SrcT, typename DstT>
+inline void ConvertData(const SrcT *src, DstT *dst, const index_t size) {
+  for (index_t i = 0; i < size; ++i) {
+    dst[i] = src[i];
+  }
+}
+
+#ifdef MACE_ENABLE_BFLOAT16
+// BFloat16 is the high half of float, the bulk conversions widen it by a
+// shift and truncate float as BFloat16(float) does.
+inline void ConvertData(const BFloat16 *src, float *dst, const index_t size) {
+  const uint16_t *in = reinterpret_cast<const uint16_t *>(src);
+  index_t i = 0;
+#if defined(MACE_ENABLE_NEON)
+  for (; i + 4 <= size; i += 4) {
+    vst1q_f32(dst + i, vreinterpretq_f32_u32(vshll_n_u16(vld1_u16(in + i),
+                                                         16)));
+  }
+#elif defined(__AVX2__)
+  for (; i + 8 <= size; i += 8) {
+    const __m256i v = _mm256_cvtepu16_epi32(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)));
+    _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(_mm256_slli_epi32(v, 16)));
+  }
+#elif defined(__SSE2__)
+  for (; i + 4 <= size; i += 4) {
+    const __m128i v =
+        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in + i));
+    _mm_storeu_ps(dst + i, _mm_castsi128_ps(
+        _mm_unpacklo_epi16(_mm_setzero_si128(), v)));
+  }
+#endif
+  for (; i < size; ++i) {
+    dst[i] = src[i];
+  }
+}
+
+inline void ConvertData(const float *src, BFloat16 *dst, const index_t size) {
+  uint16_t *out = reinterpret_cast<uint16_t *>(dst);
+  index_t i = 0;
+#if defined(MACE_ENABLE_NEON)
+  for (; i + 4 <= size; i += 4) {
+    vst1_u16(out + i, vshrn_n_u32(vreinterpretq_u32_f32(vld1q_f32(src + i)),
+                                  16));
+  }
+#elif defined(__AVX2__)
+  // The arithmetic shift keeps the high halves in the int16 range, so that
+  // the saturating pack does not change them.
+  for (; i + 8 <= size; i += 8) {
+    const __m256i high =
+        _mm256_srai_epi32(_mm256_castps_si256(_mm256_loadu_ps(src + i)), 16);
+    const __m256i packed = _mm256_permute4x64_epi64(
+        _mm256_packs_epi32(high, high), 0x08);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i),
+                     _mm256_castsi256_si128(packed));
+  }
+#elif defined(__SSE2__)
+  for (; i + 4 <= size; i += 4) {
+    const __m128i high =
+        _mm_srai_epi32(_mm_castps_si128(_mm_loadu_ps(src + i)), 16);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(out + i),
+                     _mm_packs_epi32(high, high));
+  }
+#endif
+  for (; i < size; ++i) {
+    dst[i] = src[i];
+  }
+}
+#endif  // MACE_ENABLE_BFLOAT16
+
+// Transpose a rows x cols block, input and output are row-major with the
+// given row strides.
+template<typename SrcT, typename DstT>
+void TransposeBlock(const SrcT *input, const index_t in_stride,
+                    DstT *output, const index_t out_stride,
+                    const index_t rows, const index_t cols) {
+  for (index_t j = 0; j < cols; ++j) {
+    for (index_t i = 0; i < rows; ++i) {
+      output[j * out_stride + i] = input[i * in_stride + j];
+    }
+  }
+}
+
+inline void Transpose4x4(const float *input, const index_t in_stride,
+                         float *output, const index_t out_stride) {
+#if defined(MACE_ENABLE_NEON)
+  float32x4x2_t t01 = vtrnq_f32(vld1q_f32(input),
+                                vld1q_f32(input + in_stride));
+  float32x4x2_t t23 = vtrnq_f32(vld1q_f32(input + 2 * in_stride),
+                                vld1q_f32(input + 3 * in_stride));
+  vst1q_f32(output, vcombine_f32(vget_low_f32(t01.val[0]),
+                                 vget_low_f32(t23.val[0])));
+  vst1q_f32(output + out_stride, vcombine_f32(vget_low_f32(t01.val[1]),
+                                              vget_low_f32(t23.val[1])));
+  vst1q_f32(output + 2 * out_stride,
+            vcombine_f32(vget_high_f32(t01.val[0]),
+                         vget_high_f32(t23.val[0])));
+  vst1q_f32(output + 3 * out_stride,
+            vcombine_f32(vget_high_f32(t01.val[1]),
+                         vget_high_f32(t23.val[1])));
+#elif defined(__SSE__)
+  __m128 r0 = _mm_loadu_ps(input);
+  __m128 r1 = _mm_loadu_ps(input + in_stride);
+  __m128 r2 = _mm_loadu_ps(input + 2 * in_stride);
+  __m128 r3 = _mm_loadu_ps(input + 3 * in_stride);
+  _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+  _mm_storeu_ps(output, r0);
+  _mm_storeu_ps(output + out_stride, r1);
+  _mm_storeu_ps(output + 2 * out_stride, r2);
+  _mm_storeu_ps(output + 3 * out_stride, r3);
+#else
+  for (index_t j = 0; j < 4; ++j) {
+    for (index_t i = 0; i < 4; ++i) {
+      output[j * out_stride + i] = input[i * in_stride + j];
+    }
+  }
+#endif
+}
+
+template<>
+inline void TransposeBlock<float, float>(const float *input,
+                                         const index_t in_stride,
+                                         float *output,
+                                         const index_t out_stride,
+                                         const index_t rows,
+                                         const index_t cols) {
+  const index_t rows4 = rows & ~3;
+  const index_t cols4 = cols & ~3;
+  for (index_t i = 0; i < rows4; i += 4) {
+    for (index_t j = 0; j < cols4; j += 4) {
+      Transpose4x4(input + i * in_stride + j, in_stride,
+                   output + j * out_stride + i, out_stride);
+    }
+  }
+  for (index_t j = cols4; j < cols; ++j) {
+    for (index_t i = 0; i < rows4; ++i) {
+      output[j * out_stride + i] = input[i * in_stride + j];
+    }
+  }
+  for (index_t j = 0; j < cols; ++j) {
+    for (index_t i = rows4; i < rows; ++i) {
+      output[j * out_stride + i] = input[i * in_stride + j];
+    }
+  }
+}
+
+#ifdef MACE_ENABLE_BFLOAT16
+// The tile is converted row by row through a float tile, which is
+// transposed as float.
+template<>
+inline void TransposeBlock<BFloat16, float>(const BFloat16 *input,
+                                            const index_t in_stride,
+                                            float *output,
+                                            const index_t out_stride,
+                                            const index_t rows,
+                                            const index_t cols) {
+  float tile[kTransposeTileSize * kTransposeTileSize];
+  for (index_t i = 0; i < rows; ++i) {
+    ConvertData(input + i * in_stride, tile + i * kTransposeTileSize, cols);
+  }
+  TransposeBlock(static_cast<const float *>(tile), kTransposeTileSize,
+                 output, out_stride, rows, cols);
+}
+
+template<>
+inline void TransposeBlock<float, BFloat16>(const float *input,
+                                            const index_t in_stride,
+                                            BFloat16 *output,
+                                            const index_t out_stride,
+                                            const index_t rows,
+                                            const index_t cols) {
+  float tile[kTransposeTileSize * kTransposeTileSize];
+  TransposeBlock(input, in_stride, tile, kTransposeTileSize, rows, cols);
+  for (index_t j = 0; j < cols; ++j) {
+    ConvertData(static_cast<const float *>(tile + j * kTransposeTileSize),
+                output + j * out_stride, rows);
+  }
+}
+#endif  // MACE_ENABLE_BFLOAT16
+
+// Drop the dims of size 1 and merge the input dims which stay adjacent
+// after the permutation, e.g. [2, 3, 4, 5] with {0, 2, 3, 1} becomes
+// [2, 3, 20] with {0, 2, 1}.
+inline void CoalesceTransposeDims(const std::vector<int64_t> &input_shape,
+                                  const std::vector<int> &dst_dims,
+                                  std::vector<index_t> *shape,
+                                  std::vector<int> *dims) {
+  const int rank = static_cast<int>(input_shape.size());
+  std::vector<int> kept_dims;
+  for (int i = 0; i < rank; ++i) {
+    if (input_shape[dst_dims[i]] != 1) {
+      kept_dims.push_back(dst_dims[i]);
+    }
+  }
+
+  std::vector<bool> merge_with_prev(rank, false);
+  for (size_t i = 1; i < kept_dims.size(); ++i) {
+    bool skipped_only_ones = true;
+    for (int d = kept_dims[i - 1] + 1; d < kept_dims[i]; ++d) {
+      skipped_only_ones = skipped_only_ones && input_shape[d] == 1;
+    }
+    if (kept_dims[i] > kept_dims[i - 1] && skipped_only_ones) {
+      merge_with_prev[kept_dims[i]] = true;
+    }
+  }
+
+  shape->clear();
+  dims->clear();
+  std::vector<int> new_dim(rank, -1);
+  for (int d = 0; d < rank; ++d) {
+    if (input_shape[d] == 1) {
+      continue;
+    }
+    if (merge_with_prev[d]) {
+      shape->back() *= input_shape[d];
+    } else {
+      shape->push_back(input_shape[d]);
+    }
+    new_dim[d] = static_cast<int>(shape->size()) - 1;
+  }
+  for (int d : kept_dims) {
+    if (!merge_with_prev[d]) {
+      dims->push_back(new_dim[d]);
+    }
+  }
+  if (shape->empty()) {
+    shape->push_back(1);
+    dims->push_back(0);
+  }
+}
+
 template<typename SrcT, typename DstT>
 MaceStatus Transpose(utils::ThreadPool *thread_pool,
                      const SrcT *input,
                      const std::vector<int64_t> &input_shape,
                      const std::vector<int> &dst_dims,
                      DstT *output) {
-  MACE_CHECK((input_shape.size() == 2 && dst_dims.size() == 2) ||
-      (input_shape.size() == 3 && dst_dims.size() == 3) ||
-      (input_shape.size() == 4 && dst_dims.size() == 4),
-             "Only support 2D, 3D or 4D transpose");
-
-  std::vector<index_t> output_shape;
-  for (size_t i = 0; i < dst_dims.size(); ++i) {
-    output_shape.push_back(input_shape[dst_dims[i]]);
+  const size_t input_rank = input_shape.size();
+  MACE_CHECK(input_rank == dst_dims.size() && input_rank > 0,
+             "Transpose dims should match the input rank");
+  std::vector<bool> dim_used(input_rank, false);
+  for (size_t i = 0; i < input_rank; ++i) {
+    MACE_CHECK(dst_dims[i] >= 0 && dst_dims[i] < static_cast<int>(input_rank)
+                   && !dim_used[dst_dims[i]],
+               "Transpose dims should be a permutation");
+    dim_used[dst_dims[i]] = true;
   }
 
-  if (input_shape.size() == 2) {
-    MACE_CHECK(dst_dims[0] == 1 && dst_dims[1] == 0, "no need transform");
-    index_t height = input_shape[0];
-    index_t width = input_shape[1];
-    index_t stride_i = height;
-    index_t stride_j = width;
-    index_t tile_size = height > 512 || width > 512 ? 64 : 32;
-
-    thread_pool->Compute2D([=](index_t start0, index_t end0, index_t step0,
-                               index_t start1, index_t end1, index_t step1) {
-      for (index_t i = start0; i < end0; i += step0) {
-        for (index_t j = start1; j < end1; j += step1) {
-          index_t end_i = std::min(i + tile_size, height);
-          index_t end_j = std::min(j + tile_size, width);
-          for (index_t tile_i = i; tile_i < end_i; ++tile_i) {
-            for (index_t tile_j = j; tile_j < end_j; ++tile_j) {
-              output[tile_j * stride_i + tile_i] =
-                  input[tile_i * stride_j + tile_j];
-            }
-          }
-        }
-      }
-    }, 0, height, tile_size, 0, width, tile_size);
-  } else if (input_shape.size() == 4) {
+  if (input_rank == 4) {
     std::vector<int> transpose_order_from_NHWC_to_NCHW{0, 3, 1, 2};
     std::vector<int> transpose_order_from_NCHW_to_NHWC{0, 2, 3, 1};
     index_t batch_size = input_shape[1] * input_shape[2] * input_shape[3];
@@ -213,6 +435,7 @@ MaceStatus Transpose(utils::ThreadPool *thread_pool,
                               input_shape[1],
                               input_shape[2]);
       }
+      return MaceStatus::MACE_SUCCESS;
     } else if (dst_dims == transpose_order_from_NCHW_to_NHWC
         && input_shape[1] == 2) {
       for (index_t b = 0; b < input_shape[0]; ++b) {
@@ -222,156 +445,122 @@ MaceStatus Transpose(utils::ThreadPool *thread_pool,
                               input_shape[2],
                               input_shape[3]);
       }
-    } else if (dst_dims == std::vector<int>{0, 2, 1, 3}) {
-      index_t height = input_shape[1];
-      index_t width = input_shape[2];
-      index_t channel = input_shape[3];
-      index_t stride_i = height;
-      index_t stride_j = width;
-      index_t tile_size = std::max(static_cast<index_t>(1),
-                                   static_cast<index_t>(std::sqrt(
-                                       8 * 1024 / channel)));
-      for (index_t b = 0; b < input_shape[0]; ++b) {
-        auto input_offset = input + b * batch_size;
-        auto output_offset = output + b * batch_size;
-        for (index_t i = 0; i < height; i += tile_size) {
-          for (index_t j = 0; j < width; j += tile_size) {
-            index_t end_i = std::min(i + tile_size, height);
-            index_t end_j = std::min(j + tile_size, width);
-            for (index_t tile_i = i; tile_i < end_i; ++tile_i) {
-              for (index_t tile_j = j; tile_j < end_j; ++tile_j) {
-                auto output_ptr =
-                    output_offset + (tile_j * stride_i + tile_i) * channel;
-                auto input_ptr =
-                    input_offset + (tile_i * stride_j + tile_j) * channel;
-                for (index_t k = 0; k < channel; ++k) {
-                  output_ptr[k] = input_ptr[k];
-                }
-              }
-            }
-          }
-        }
-      }
-    } else {
-      std::vector<index_t>
-          in_stride{input_shape[1] * input_shape[2] * input_shape[3],
-                    input_shape[2] * input_shape[3], input_shape[3], 1};
-      std::vector<index_t>
-          out_stride{output_shape[1] * output_shape[2] * output_shape[3],
-                     output_shape[2] * output_shape[3], output_shape[3], 1};
-
-      std::vector<index_t> idim(4, 0);
-      std::vector<index_t> odim(4, 0);
-      for (odim[0] = 0; odim[0] < output_shape[0]; ++odim[0]) {
-        for (odim[1] = 0; odim[1] < output_shape[1]; ++odim[1]) {
-          for (odim[2] = 0; odim[2] < output_shape[2]; ++odim[2]) {
-            for (odim[3] = 0; odim[3] < output_shape[3]; ++odim[3]) {
-              idim[dst_dims[0]] = odim[0];
-              idim[dst_dims[1]] = odim[1];
-              idim[dst_dims[2]] = odim[2];
-              idim[dst_dims[3]] = odim[3];
-
-              output[odim[0] * out_stride[0] + odim[1] * out_stride[1]
-                  + odim[2] * out_stride[2] + odim[3]] =
-                  input[idim[0] * in_stride[0] + idim[1] * in_stride[1]
-                      + idim[2] * in_stride[2] + idim[3]];
-            }
-          }
+      return MaceStatus::MACE_SUCCESS;
+    }
+  }
+
+  std::vector<index_t> shape;
+  std::vector<int> dims;
+  CoalesceTransposeDims(input_shape, dst_dims, &shape, &dims);
+  const int rank = static_cast<int>(shape.size());
+
+  std::vector<index_t> in_stride(rank, 1);
+  std::vector<index_t> out_stride(rank, 1);
+  for (int i = rank - 2; i >= 0; --i) {
+    in_stride[i] = in_stride[i + 1] * shape[i + 1];
+    out_stride[i] = out_stride[i + 1] * shape[dims[i + 1]];
+  }
+
+  if (rank == 1) {
+    // Nothing is permuted.
+    const index_t size = shape[0];
+    thread_pool->Compute1D([=](index_t start, index_t end, index_t step) {
+      MACE_UNUSED(step);
+      ConvertData(input + start, output + start, end - start);
+    }, 0, size, 1, 0, 1);
+    return MaceStatus::MACE_SUCCESS;
+  }
+
+  if (dims[rank - 1] == rank - 1) {
+    // The innermost dim is not permuted, copy it row by row.
+    const index_t inner_size = shape[rank - 1];
+    const index_t rows = std::accumulate(shape.begin(), shape.end() - 1, 1,
+                                         std::multiplies<index_t>());
+    const int outer_rank = rank - 1;
+    std::vector<index_t> row_shape(outer_rank);
+    std::vector<index_t> row_in_stride(outer_rank);
+    for (int i = 0; i < outer_rank; ++i) {
+      row_shape[i] = shape[dims[i]];
+      row_in_stride[i] = in_stride[dims[i]];
+    }
+    const index_t *row_shape_ptr = row_shape.data();
+    const index_t *row_in_stride_ptr = row_in_stride.data();
+    thread_pool->Compute1D([=](index_t start, index_t end, index_t step) {
+      for (index_t r = start; r < end; r += step) {
+        index_t in_offset = 0;
+        index_t remain = r;
+        for (int i = outer_rank - 1; i >= 0; --i) {
+          in_offset += (remain % row_shape_ptr[i]) * row_in_stride_ptr[i];
+          remain /= row_shape_ptr[i];
         }
+        ConvertData(input + in_offset, output + r * inner_size, inner_size);
       }
+    }, 0, rows, 1, 0, static_cast<int>(inner_size));
+    return MaceStatus::MACE_SUCCESS;
+  }
+
+  // Blocked 2D transpose between the input innermost dim (cols) and the
+  // output innermost dim (rows), the other dims are batched.
+  const int row_dim = dims[rank - 1];
+  const int col_dim = rank - 1;
+  int col_out_pos = 0;
+  while (dims[col_out_pos] != col_dim) {
+    ++col_out_pos;
+  }
+  const index_t rows = shape[row_dim];
+  const index_t cols = shape[col_dim];
+  const index_t row_in_stride = in_stride[row_dim];
+  const index_t col_out_stride = out_stride[col_out_pos];
+
+  std::vector<index_t> batch_shape;
+  std::vector<index_t> batch_in_stride;
+  std::vector<index_t> batch_out_stride;
+  for (int i = 0; i < rank; ++i) {
+    if (dims[i] != row_dim && dims[i] != col_dim) {
+      batch_shape.push_back(shape[dims[i]]);
+      batch_in_stride.push_back(in_stride[dims[i]]);
+      batch_out_stride.push_back(out_stride[i]);
     }
-  } else if (input_shape.size() == 3) {
-    const index_t batch = input_shape[0];
-    const index_t height = input_shape[1];
-    const index_t width = input_shape[2];
-    if (dst_dims == std::vector<int>{0, 2, 1}) {
-      index_t stride_h = height;
-      index_t stride_w = width;
-      index_t stride_hw = height * width;
-      index_t tile_size = height > 512 || width > 512 ? 64 : 32;
-
-      thread_pool->Compute3D([=](index_t start, index_t end, index_t step,
-                                 index_t start0, index_t end0, index_t step0,
-                                 index_t start1, index_t end1, index_t step1) {
-        for (index_t b = start; b < end; b += step) {
-          for (index_t i = start0; i < end0; i += step0) {
-            for (index_t j = start1; j < end1; j += step1) {
-              index_t end_i = std::min(i + tile_size, height);
-              index_t end_j = std::min(j + tile_size, width);
-              for (index_t tile_i = i; tile_i < end_i; ++tile_i) {
-                for (index_t tile_j = j; tile_j < end_j; ++tile_j) {
-                  output[b * stride_hw + tile_j * stride_h + tile_i] =
-                      input[b * stride_hw + tile_i * stride_w + tile_j];
-                }
-              }
-            }
-          }
-        }
-      }, 0, batch, 1, 0, height, tile_size, 0, width, tile_size);
-    } else if (dst_dims == std::vector<int>{1, 0, 2}) {
-      thread_pool->Compute2D([=](index_t start0, index_t end0, index_t step0,
-                                 index_t start1, index_t end1, index_t step1) {
-        for (int i = start0; i < end0; i += step0) {
-          for (int j = start1; j < end1; j += step1) {
-            auto output_ptr = output + (j * batch + i) * width;
-            auto input_ptr = input + (i * height + j) * width;
-            for (index_t k = 0; k < width; ++k) {
-              output_ptr[k] = input_ptr[k];
-            }
-          }
-        }
-      }, 0, batch, 1, 0, height, 1);
-    } else if (dst_dims == std::vector<int>{1, 2, 0}) {
-      thread_pool->Compute3D([=](index_t start, index_t end, index_t step,
-                                 index_t start0, index_t end0, index_t step0,
-                                 index_t start1, index_t end1, index_t step1) {
-        for (int i = start; i < end; i += step) {
-          for (int j = start0; j < end0; j += step0) {
-            for (int k = start1; k < end1; k += step1) {
-              output[(j * width + k) * batch + i] =
-                  input[(i * height + j) * width + k];
-            }
-          }
-        }
-      }, 0, batch, 1, 0, height, 1, 0, width, 1);
-    } else if (dst_dims == std::vector<int>{2, 0, 1}) {
-      thread_pool->Compute3D([=](index_t start, index_t end, index_t step,
-                                 index_t start0, index_t end0, index_t step0,
-                                 index_t start1, index_t end1, index_t step1) {
-        for (int i = start; i < end; i += step) {
-          for (int j = start0; j < end0; j += step0) {
-            for (int k = start1; k < end1; k += step1) {
-              output[(k * batch + i) * height + j] =
-                  input[(i * height + j) * width + k];
-            }
-          }
-        }
-      }, 0, batch, 1, 0, height, 1, 0, width, 1);
-    } else if (dst_dims == std::vector<int>{2, 1, 0}) {
-      thread_pool->Compute3D([=](index_t start, index_t end, index_t step,
-                                 index_t start0, index_t end0, index_t step0,
-                                 index_t start1, index_t end1, index_t step1) {
-        for (int i = start; i < end; i += step) {
-          for (int j = start0; j < end0; j += step0) {
-            for (int k = start1; k < end1; k += step1) {
-              output[(k * height + j) * batch + i] =
-                  input[(i * height + j) * width + k];
-            }
-          }
+  }
+  const int batch_rank = static_cast<int>(batch_shape.size());
+  const index_t batch = std::accumulate(batch_shape.begin(),
+                                        batch_shape.end(), 1,
+                                        std::multiplies<index_t>());
+  const index_t *batch_shape_ptr = batch_shape.data();
+  const index_t *batch_in_stride_ptr = batch_in_stride.data();
+  const index_t *batch_out_stride_ptr = batch_out_stride.data();
+  const index_t tile_size = kTransposeTileSize;
+
+  thread_pool->Compute3D([=](index_t start0, index_t end0, index_t step0,
+                             index_t start1, index_t end1, index_t step1,
+                             index_t start2, index_t end2, index_t step2) {
+    for (index_t b = start0; b < end0; b += step0) {
+      index_t in_offset = 0;
+      index_t out_offset = 0;
+      index_t remain = b;
+      for (int i = batch_rank - 1; i >= 0; --i) {
+        const index_t idx = remain % batch_shape_ptr[i];
+        in_offset += idx * batch_in_stride_ptr[i];
+        out_offset += idx * batch_out_stride_ptr[i];
+        remain /= batch_shape_ptr[i];
+      }
+      for (index_t i = start1; i < end1; i += step1) {
+        for (index_t j = start2; j < end2; j += step2) {
+          TransposeBlock(input + in_offset + i * row_in_stride + j,
+                         row_in_stride,
+                         output + out_offset + j * col_out_stride + i,
+                         col_out_stride,
+                         std::min(tile_size, rows - i),
+                         std::min(tile_size, cols - j));
         }
-      }, 0, batch, 1, 0, height, 1, 0, width, 1);
-    } else {
-      MACE_CHECK(false, "no need to transform.");
+      }
     }
-
-  } else {
-    MACE_NOT_IMPLEMENTED;
-  }
+  }, 0, batch, 1, 0, rows, tile_size, 0, cols, tile_size,
+     0, 0, 0, static_cast<int>(tile_size * tile_size));
 
   return MaceStatus::MACE_SUCCESS;
 }
 
-
 inline void CopyDataBetweenSameType(mace::utils::ThreadPool *thread_pool,
                                     const void *src, void *dst, int64_t size) {
   if (size < kCopyBlockSize || thread_pool == nullptr) {
@@ -391,15 +580,12 @@ template<typename SrcT, typename DstT>
 void CopyDataBetweenDiffType(mace::utils::ThreadPool *thread_pool,
                              const SrcT *src, DstT *dst, index_t tensor_size) {
   if (tensor_size < kCopyBlockSize || thread_pool == nullptr) {
-    for (index_t i = 0; i < tensor_size; ++i) {
-      dst[i] = src[i];
-    }
+    ConvertData(src, dst, tensor_size);
   } else {
     thread_pool->Compute1D(
         [=](index_t start, index_t end, index_t step) {
-          for (index_t i = start; i < end; i += step) {
-            dst[i] = src[i];
-          }
+          MACE_UNUSED(step);
+          ConvertData(src + start, dst + start, end - start);
         },
         0, tensor_size, 1);
   }
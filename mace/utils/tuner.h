@@ -132,6 +132,12 @@ class Tuner {
     return is_tuning_;
   }
 
+  // Write the parameters to path at destruction instead of the path given by
+  // MACE_RUN_PARAMETER_PATH.
+  void SetOutputPath(const std::string &path) {
+    path_ = path;
+  }
+
  private:
   void WriteRunParameters() {
     if (!path_.empty()) {
@@ -0,0 +1,175 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mace/benchmark_utils/roofline.h"
+
+#if defined(MACE_ENABLE_NEON)
+#include <arm_neon.h>
+#elif defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+#include "mace/port/env.h"
+
+namespace mace {
+namespace testing {
+
+namespace {
+
+constexpr int kProbeRepeats = 5;
+constexpr int64_t kFmaTasks = 64;
+constexpr int64_t kFmaRoundsPerTask = 1 << 18;
+// 8 independent chains of 4 lanes, a multiply and an add each
+constexpr int64_t kFlopsPerRound = 8 * 4 * 2;
+// Two arrays of 32MB, far larger than the last level cache
+constexpr int64_t kStreamSize = 8 << 20;
+
+float FmaKernel(int64_t rounds) {
+#if defined(MACE_ENABLE_NEON)
+  const float32x4_t a = vdupq_n_f32(0.9999f);
+  const float32x4_t b = vdupq_n_f32(1e-4f);
+  float32x4_t acc[8];
+  for (int i = 0; i < 8; ++i) {
+    acc[i] = vdupq_n_f32(static_cast<float>(i));
+  }
+  for (int64_t r = 0; r < rounds; ++r) {
+    for (int i = 0; i < 8; ++i) {
+#if defined(__aarch64__)
+      acc[i] = vfmaq_f32(b, acc[i], a);
+#else
+      acc[i] = vmlaq_f32(b, acc[i], a);
+#endif
+    }
+  }
+  float32x4_t sum = acc[0];
+  for (int i = 1; i < 8; ++i) {
+    sum = vaddq_f32(sum, acc[i]);
+  }
+  return vgetq_lane_f32(sum, 0);
+#elif defined(__SSE__)
+  const __m128 a = _mm_set1_ps(0.9999f);
+  const __m128 b = _mm_set1_ps(1e-4f);
+  __m128 acc[8];
+  for (int i = 0; i < 8; ++i) {
+    acc[i] = _mm_set1_ps(static_cast<float>(i));
+  }
+  for (int64_t r = 0; r < rounds; ++r) {
+    for (int i = 0; i < 8; ++i) {
+      acc[i] = _mm_add_ps(_mm_mul_ps(acc[i], a), b);
+    }
+  }
+  __m128 sum = acc[0];
+  for (int i = 1; i < 8; ++i) {
+    sum = _mm_add_ps(sum, acc[i]);
+  }
+  return _mm_cvtss_f32(sum);
+#else
+  float acc[32];
+  for (int i = 0; i < 32; ++i) {
+    acc[i] = static_cast<float>(i);
+  }
+  for (int64_t r = 0; r < rounds; ++r) {
+    for (int i = 0; i < 32; ++i) {
+      acc[i] = acc[i] * 0.9999f + 1e-4f;
+    }
+  }
+  float sum = 0.f;
+  for (int i = 0; i < 32; ++i) {
+    sum += acc[i];
+  }
+  return sum;
+#endif
+}
+
+void ScaleKernel(const float *src, float *dst, int64_t size) {
+  int64_t i = 0;
+#if defined(MACE_ENABLE_NEON)
+  const float32x4_t scale = vdupq_n_f32(1.0001f);
+  for (; i + 3 < size; i += 4) {
+    vst1q_f32(dst + i, vmulq_f32(vld1q_f32(src + i), scale));
+  }
+#elif defined(__SSE__)
+  const __m128 scale = _mm_set1_ps(1.0001f);
+  for (; i + 3 < size; i += 4) {
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_loadu_ps(src + i), scale));
+  }
+#endif
+  for (; i < size; ++i) {
+    dst[i] = src[i] * 1.0001f;
+  }
+}
+
+double MeasureGflops(utils::ThreadPool *thread_pool) {
+  std::vector<float> sinks(kFmaTasks);
+  float *sinks_data = sinks.data();
+  double best = 0;
+  for (int n = 0; n < kProbeRepeats; ++n) {
+    const int64_t start_micros = NowMicros();
+    thread_pool->Compute1D([=](int64_t start, int64_t end, int64_t step) {
+      for (int64_t t = start; t < end; t += step) {
+        sinks_data[t] = FmaKernel(kFmaRoundsPerTask);
+      }
+    }, 0, kFmaTasks, 1, 1);
+    const double seconds =
+        std::max<int64_t>(NowMicros() - start_micros, 1) * 1e-6;
+    best = std::max(best, kFmaTasks * kFmaRoundsPerTask * kFlopsPerRound
+        * 1e-9 / seconds);
+  }
+  // keep the results alive
+  volatile float sink = 0.f;
+  for (float value : sinks) {
+    sink = sink + value;
+  }
+  return best;
+}
+
+double MeasureGbps(utils::ThreadPool *thread_pool) {
+  // the pages are touched by the initialization
+  std::vector<float> src(kStreamSize, 1.f);
+  std::vector<float> dst(kStreamSize, 0.f);
+  const float *src_data = src.data();
+  float *dst_data = dst.data();
+  double best = 0;
+  for (int n = 0; n < kProbeRepeats; ++n) {
+    const int64_t start_micros = NowMicros();
+    thread_pool->Compute1D([=](int64_t start, int64_t end, int64_t step) {
+      MACE_UNUSED(step);
+      ScaleKernel(src_data + start, dst_data + start, end - start);
+    }, 0, kStreamSize, 1);
+    const double seconds =
+        std::max<int64_t>(NowMicros() - start_micros, 1) * 1e-6;
+    // one read and one write of every element
+    best = std::max(best, 2 * kStreamSize * sizeof(float) * 1e-9 / seconds);
+  }
+  return best;
+}
+
+}  // namespace
+
+MachinePeak MeasureMachinePeak(utils::ThreadPool *thread_pool) {
+  MachinePeak peak;
+  peak.gflops = MeasureGflops(thread_pool);
+  peak.gbps = MeasureGbps(thread_pool);
+  return peak;
+}
+
+double AttainableGflops(const MachinePeak &peak, double flops_per_byte) {
+  return std::min(peak.gflops, flops_per_byte * peak.gbps);
+}
+
+}  // namespace testing
+}  // namespace mace
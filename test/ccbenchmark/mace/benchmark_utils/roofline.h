@@ -0,0 +1,42 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MACE_BENCHMARK_UTILS_ROOFLINE_H_
+#define MACE_BENCHMARK_UTILS_ROOFLINE_H_
+
+#include <cstdint>
+
+#include "mace/utils/thread_pool.h"
+
+namespace mace {
+namespace testing {
+
+struct MachinePeak {
+  double gflops;
+  double gbps;
+};
+
+// Measure the float multiply-add throughput and the memory bandwidth reached
+// by the threads of the thread pool, with the SIMD instructions this build
+// uses. They are the roofs every op benchmark is compared with.
+MachinePeak MeasureMachinePeak(utils::ThreadPool *thread_pool);
+
+// The GFLOP/s reachable with the arithmetic intensity, i.e. min(peak FLOP/s,
+// intensity * peak bandwidth).
+double AttainableGflops(const MachinePeak &peak, double flops_per_byte);
+
+}  // namespace testing
+}  // namespace mace
+
+#endif  // MACE_BENCHMARK_UTILS_ROOFLINE_H_
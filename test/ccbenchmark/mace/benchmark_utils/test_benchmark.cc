@@ -16,9 +16,12 @@
 #include <cstdlib>
 
 #include <algorithm>
+#include <cmath>
+#include <fstream>
 #include <regex>  // NOLINT(build/c++11)
 #include <vector>
 
+#include "mace/benchmark_utils/roofline.h"
 #include "mace/benchmark_utils/test_benchmark.h"
 #include "mace/port/env.h"
 #include "mace/utils/logging.h"
@@ -27,7 +30,7 @@ namespace mace {
 namespace testing {
 
 static std::vector<Benchmark *> *all_benchmarks = nullptr;
-static int64_t bytes_processed;
+static int64_t bytes_processed = 0;
 static int64_t macs_processed = 0;
 static int64_t accum_time = 0;
 static int64_t start_time = 0;
@@ -37,8 +40,12 @@ Benchmark::Benchmark(const char *name, void (*benchmark_func)(int))
   Register();
 }
 
-// Run all benchmarks that matches the pattern
 void Benchmark::Run(const char *pattern) {
+  Run(pattern, BenchmarkOptions());
+}
+
+// Run all benchmarks that matches the pattern
+void Benchmark::Run(const char *pattern, const BenchmarkOptions &options) {
   if (!all_benchmarks) return;
 
   std::sort(all_benchmarks->begin(), all_benchmarks->end(),
@@ -59,21 +66,104 @@ void Benchmark::Run(const char *pattern) {
     width = std::max<int>(width, b->name_.length());
   }
 
+  const int repetitions = std::max(options.repetitions, 1);
+  const bool has_roofline = options.roofline_thread_pool != nullptr;
+  MachinePeak peak = {0, 0};
+  if (has_roofline) {
+    peak = MeasureMachinePeak(options.roofline_thread_pool);
+    printf("Peak: %.2f GFLOP/s, %.2f GB/s\n", peak.gflops, peak.gbps);
+  }
+
+  std::ofstream json;
+  if (!options.output_json.empty()) {
+    json.open(options.output_json);
+    if (!json.is_open()) {
+      LOG(ERROR) << "Failed to open " << options.output_json;
+    } else if (has_roofline) {
+      json << "{\"peak_gflops\": " << peak.gflops
+           << ", \"peak_gb_per_sec\": " << peak.gbps << "}\n";
+    }
+  }
+
   // Internal perf regression tools depends on the output formatting,
-  // please keep in consistent when modifying
-  printf("%-*s %10s %10s %10s %10s\n", width, "Benchmark", "Time(ns)",
+  // please keep in consistent when modifying, the optional columns are
+  // appended to the end.
+  int line_width = width + 45;
+  printf("%-*s %10s %10s %10s %10s", width, "Benchmark", "Time(ns)",
          "Iterations", "Input(MB/s)", "GMACPS");
-  printf("%s\n", std::string(width + 45, '-').c_str());
+  if (repetitions > 1) {
+    printf(" %10s", "StdDev(%)");
+    line_width += 11;
+  }
+  if (has_roofline) {
+    printf(" %10s %10s %10s", "GFLOP/s", "GB/s", "Roofline(%)");
+    line_width += 33;
+  }
+  printf("\n%s\n", std::string(line_width, '-').c_str());
   for (auto b : *all_benchmarks) {
     if (!std::regex_match(b->name_, match, regex)) continue;
     int iters;
     double seconds;
     b->Run(&iters, &seconds);
-    float mbps = (bytes_processed * 1e-6) / seconds;
+    std::vector<double> run_seconds(1, seconds);
+    for (int i = 1; i < repetitions; ++i) {
+      run_seconds.push_back(b->RunIters(iters));
+    }
+    double mean = 0;
+    for (double s : run_seconds) {
+      mean += s;
+    }
+    mean /= repetitions;
+    double variance = 0;
+    for (double s : run_seconds) {
+      variance += (s - mean) * (s - mean);
+    }
+    const double stddev =
+        repetitions > 1 ? std::sqrt(variance / (repetitions - 1)) : 0;
+
+    const double time_ns = mean * 1e9 / iters;
+    float mbps = (bytes_processed * 1e-6) / mean;
     // MACCs or other computations
-    float gmacs = (macs_processed * 1e-9) / seconds;
-    printf("%-*s %10.0f %10d %10.2f %10.2f\n", width, b->name_.c_str(),
-           seconds * 1e9 / iters, iters, mbps, gmacs);
+    float gmacs = (macs_processed * 1e-9) / mean;
+    printf("%-*s %10.0f %10d %10.2f %10.2f", width, b->name_.c_str(),
+           time_ns, iters, mbps, gmacs);
+    if (repetitions > 1) {
+      printf(" %10.2f", stddev / mean * 100);
+    }
+
+    // A MAC is two floating point operations, the bytes are those the
+    // benchmark reports, usually its input.
+    const double gflops = 2 * gmacs;
+    const double gbps = mbps * 1e-3;
+    double roofline_percent = 0;
+    if (macs_processed > 0) {
+      const double attainable = bytes_processed > 0 ?
+          AttainableGflops(peak, 2.0 * macs_processed / bytes_processed) :
+          peak.gflops;
+      roofline_percent = gflops / attainable * 100;
+    } else if (bytes_processed > 0) {
+      roofline_percent = gbps / peak.gbps * 100;
+    }
+    if (has_roofline) {
+      printf(" %10.2f %10.2f %10.2f", gflops, gbps, roofline_percent);
+    }
+    printf("\n");
+
+    if (json.is_open()) {
+      json << "{\"name\": \"" << b->name_ << "\""
+           << ", \"iterations\": " << iters
+           << ", \"repetitions\": " << repetitions
+           << ", \"time_ns\": " << time_ns
+           << ", \"time_ns_stddev\": " << stddev * 1e9 / iters
+           << ", \"mb_per_sec\": " << mbps
+           << ", \"gmacs_per_sec\": " << gmacs;
+      if (has_roofline) {
+        json << ", \"gflops\": " << gflops
+             << ", \"gb_per_sec\": " << gbps
+             << ", \"roofline_percent\": " << roofline_percent;
+      }
+      json << "}\n";
+    }
   }
 }
 
@@ -88,12 +178,7 @@ void Benchmark::Run(int *run_count, double *run_seconds) {
   static const double kMinTime = 0.5;
   int64_t iters = kMinIters;
   while (true) {
-    bytes_processed = -1;
-    macs_processed = 0;
-    RestartTiming();
-    (*benchmark_func_)(iters);
-    StopTiming();
-    const double seconds = accum_time * 1e-6;
+    const double seconds = RunIters(static_cast<int>(iters));
     if (seconds >= kMinTime || iters >= kMaxIters) {
       *run_count = iters;
       *run_seconds = seconds;
@@ -107,6 +192,15 @@ void Benchmark::Run(int *run_count, double *run_seconds) {
   }
 }
 
+double Benchmark::RunIters(int iters) {
+  bytes_processed = 0;
+  macs_processed = 0;
+  RestartTiming();
+  (*benchmark_func_)(iters);
+  StopTiming();
+  return accum_time * 1e-6;
+}
+
 void BytesProcessed(int64_t n) { bytes_processed = n; }
 void MacsProcessed(int64_t n) { macs_processed = n; }
 void RestartTiming() {
@@ -20,6 +20,8 @@
 #include <utility>
 #include <vector>
 
+#include "mace/utils/thread_pool.h"
+
 #define MACE_BENCHMARK(n) \
   static ::mace::testing::Benchmark *__benchmark_##n = \
       (new ::mace::testing::Benchmark(#n, (n)))
@@ -27,11 +29,25 @@
 namespace mace {
 namespace testing {
 
+struct BenchmarkOptions {
+  // Every benchmark is run this many times with the same iterations, the
+  // mean and the standard deviation of the runs are reported.
+  int repetitions = 1;
+  // If not empty, the results are also written to this file, one JSON
+  // object per line.
+  std::string output_json;
+  // If not null, the peak FLOP/s and memory bandwidth of this thread pool
+  // are measured and every benchmark reports its GFLOP/s, GB/s and the
+  // percentage of the roofline it reaches.
+  utils::ThreadPool *roofline_thread_pool = nullptr;
+};
+
 class Benchmark {
  public:
   Benchmark(const char *name, void (*benchmark_func)(int32_t));
 
   static void Run(const char *pattern);
+  static void Run(const char *pattern, const BenchmarkOptions &options);
 
  private:
   std::string name_;
@@ -39,6 +55,7 @@ class Benchmark {
 
   void Register();
   void Run(int *run_count, double *run_seconds);
+  double RunIters(int iters);
 };
 
 void BytesProcessed(int64_t);
@@ -13,15 +13,27 @@
 // limitations under the License.
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "gflags/gflags.h"
 #include "mace/benchmark_utils/test_benchmark.h"
 #include "mace/ops/ops_test_util.h"
+#include "mace/port/env.h"
+#include "mace/utils/string_util.h"
 
 DEFINE_string(filter, "all", "op benchmark regex filter, eg:.*CONV.*");
 DEFINE_int32(num_threads, -1, "num of threads");
 DEFINE_int32(cpu_affinity_policy, 1,
              "0:AFFINITY_NONE/1:AFFINITY_BIG_ONLY/2:AFFINITY_LITTLE_ONLY");
+DEFINE_string(cpu_ids, "",
+              "comma separated cores to pin the benchmark to, "
+              "cpu_affinity_policy is ignored if set, eg:4,5,6,7");
+DEFINE_int32(repetitions, 1, "runs of every benchmark to compute variance");
+DEFINE_string(output_json, "", "write the results as JSON lines to the file");
+DEFINE_bool(roofline, false,
+            "measure the peak FLOP/s and memory bandwidth, and report how "
+            "far every benchmark is from the roofline");
 
 int main(int argc, char **argv) {
   std::string usage = "run ops benchmark\nusage: " + std::string(argv[0])
@@ -29,11 +41,37 @@ int main(int argc, char **argv) {
   gflags::SetUsageMessage(usage);
   gflags::ParseCommandLineFlags(&argc, &argv, true);
 
+  int num_threads = FLAGS_num_threads;
+  auto cpu_affinity_policy =
+      static_cast<mace::CPUAffinityPolicy>(FLAGS_cpu_affinity_policy);
+  if (!FLAGS_cpu_ids.empty()) {
+    std::vector<size_t> cpu_ids;
+    for (auto &id : mace::Split(FLAGS_cpu_ids, ',')) {
+      cpu_ids.push_back(std::stoul(id));
+    }
+    // The threads of the thread pool inherit the affinity of the main thread
+    // when the policy is AFFINITY_NONE.
+    if (mace::port::Env::Default()->SchedSetAffinity(cpu_ids)
+        != mace::MaceStatus::MACE_SUCCESS) {
+      std::cerr << "Failed to pin to cores " << FLAGS_cpu_ids << std::endl;
+      return 1;
+    }
+    cpu_affinity_policy = mace::CPUAffinityPolicy::AFFINITY_NONE;
+    if (num_threads <= 0) {
+      num_threads = static_cast<int>(cpu_ids.size());
+    }
+  }
+
   // config runtime
-  mace::ops::test::OpTestContext::Get(
-      FLAGS_num_threads,
-      static_cast<mace::CPUAffinityPolicy>(FLAGS_cpu_affinity_policy));
+  auto context = mace::ops::test::OpTestContext::Get(num_threads,
+                                                     cpu_affinity_policy);
 
-  mace::testing::Benchmark::Run(FLAGS_filter.c_str());
+  mace::testing::BenchmarkOptions options;
+  options.repetitions = FLAGS_repetitions;
+  options.output_json = FLAGS_output_json;
+  if (FLAGS_roofline) {
+    options.roofline_thread_pool = context->thread_pool();
+  }
+  mace::testing::Benchmark::Run(FLAGS_filter.c_str(), options);
   return 0;
 }
@@ -0,0 +1,373 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+/**
+ * End to end benchmark of synthetic models, sweeping the thread count, the
+ * CPU affinity policy and the batch size.
+ * Usage:
+ * mace_model_benchmark --models=all \
+ *                      --num_threads=1,2,4 \
+ *                      --cpu_affinity_policy=0,1 \
+ *                      --batch=1,4 \
+ *                      --round=50 \
+ *                      --output_json=result.json \
+ *                      --baseline_json=baseline.json \
+ *                      --threshold=0.1
+ * It exits with 1 if any p50 or p90 latency is worse than the baseline by
+ * more than the threshold.
+ */
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if !defined(__linux__) && !defined(_WIN32)
+#include <sys/resource.h>
+#endif
+
+#include "gflags/gflags.h"
+#include "mace/core/proto/arg_helper.h"
+#include "mace/models/synthetic_models.h"
+#include "mace/port/env.h"
+#include "mace/public/mace.h"
+#include "mace/utils/logging.h"
+#include "mace/utils/statistics.h"
+#include "mace/utils/string_util.h"
+
+DEFINE_string(models, "all", "comma separated synthetic models to run");
+DEFINE_string(num_threads, "1,2,4", "comma separated thread counts");
+DEFINE_string(cpu_affinity_policy, "0,1",
+              "comma separated policies, 0:AFFINITY_NONE/1:AFFINITY_BIG_ONLY"
+              "/2:AFFINITY_LITTLE_ONLY");
+DEFINE_string(batch, "1", "comma separated batch sizes");
+DEFINE_int32(warmup, 3, "rounds to run before timing");
+DEFINE_int32(round, 50, "rounds to time");
+DEFINE_string(output_json, "", "file to write the results to");
+DEFINE_string(baseline_json, "", "results to compare with");
+DEFINE_double(threshold, 0.1,
+              "max allowed relative slowdown of p50 and p90 latency");
+
+namespace mace {
+namespace benchmark {
+namespace {
+
+struct Result {
+  std::string name;
+  std::string model;
+  int num_threads;
+  int cpu_affinity_policy;
+  int batch;
+  int round;
+  double cold_start_ms;
+  double avg_ms;
+  double p50_ms;
+  double p90_ms;
+  double p99_ms;
+  int64_t peak_rss_kb;
+};
+
+std::vector<int> ParseInts(const std::string &str) {
+  std::vector<int> values;
+  for (auto &item : Split(str, ',')) {
+    values.push_back(atoi(item.c_str()));
+  }
+  return values;
+}
+
+// Nearest-rank percentile of sorted latencies.
+double Percentile(const std::vector<int64_t> &sorted_us, double percent) {
+  if (sorted_us.empty()) {
+    return 0;
+  }
+  size_t rank = static_cast<size_t>(
+      std::ceil(percent / 100 * sorted_us.size()));
+  rank = std::min(std::max<size_t>(rank, 1), sorted_us.size());
+  return sorted_us[rank - 1] / 1000.0;
+}
+
+// Reset the peak RSS so each configuration is measured on its own, only
+// supported by Linux.
+void ResetPeakRss() {
+#if defined(__linux__)
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  if (clear_refs.is_open()) {
+    clear_refs << "5";
+  }
+#endif
+}
+
+int64_t PeakRssKb() {
+#if defined(__linux__)
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.compare(0, 6, "VmHWM:") == 0) {
+      return atoll(line.c_str() + 6);
+    }
+  }
+  return 0;
+#elif !defined(_WIN32)
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+  return usage.ru_maxrss / 1024;
+#else
+  return usage.ru_maxrss;
+#endif
+#else
+  return 0;
+#endif
+}
+
+void CreateTensors(const std::vector<std::string> &names,
+                   const std::vector<std::vector<int64_t>> &shapes,
+                   std::map<std::string, MaceTensor> *tensors) {
+  for (size_t i = 0; i < names.size(); ++i) {
+    const int64_t size = std::accumulate(shapes[i].begin(), shapes[i].end(),
+                                         1, std::multiplies<int64_t>());
+    auto buffer = std::shared_ptr<float>(new float[size],
+                                         std::default_delete<float[]>());
+    std::fill_n(buffer.get(), size, 0.5f);
+    (*tensors)[names[i]] = MaceTensor(shapes[i], buffer);
+  }
+}
+
+MaceStatus RunModel(const std::string &model_name, int num_threads,
+                    int policy, int batch, Result *result) {
+  auto model = CreateSyntheticModel(model_name, batch);
+  MACE_CHECK(model != nullptr, "unknown model: ", model_name);
+  SetProtoArg(&model->net_def, "runtime_type",
+              static_cast<int>(RuntimeType::RT_CPU));
+  SetProtoArg(&model->net_def, "opencl_mem_type",
+              static_cast<int>(MemoryType::CPU_BUFFER));
+
+  std::map<std::string, MaceTensor> inputs;
+  std::map<std::string, MaceTensor> outputs;
+  CreateTensors(model->input_names, model->input_shapes, &inputs);
+  CreateTensors(model->output_names, model->output_shapes, &outputs);
+
+  ResetPeakRss();
+  // The cold start covers the engine creation, the initialization and the
+  // first run, which allocates the buffers and packs the weights.
+  int64_t start = NowMicros();
+  MaceEngineConfig config;
+  MACE_RETURN_IF_ERROR(config.SetCPUThreadPolicy(
+      num_threads, static_cast<CPUAffinityPolicy>(policy)));
+  MaceEngine engine(config);
+  MACE_RETURN_IF_ERROR(engine.Init(&model->net_def, model->input_names,
+                                   model->output_names,
+                                   model->weights.data(),
+                                   model->weights.size()));
+  MACE_RETURN_IF_ERROR(engine.Run(inputs, &outputs));
+  const int64_t cold_start_us = NowMicros() - start;
+
+  for (int i = 0; i < FLAGS_warmup; ++i) {
+    MACE_RETURN_IF_ERROR(engine.Run(inputs, &outputs));
+  }
+  std::vector<int64_t> latencies;
+  TimeInfo<int64_t> time_info;
+  for (int i = 0; i < FLAGS_round; ++i) {
+    start = NowMicros();
+    MACE_RETURN_IF_ERROR(engine.Run(inputs, &outputs));
+    const int64_t duration = NowMicros() - start;
+    latencies.push_back(duration);
+    time_info.UpdateTime(duration);
+  }
+  std::sort(latencies.begin(), latencies.end());
+
+  result->name = MakeString(model_name, "/threads_", num_threads,
+                            "/policy_", policy, "/batch_", batch);
+  result->model = model_name;
+  result->num_threads = num_threads;
+  result->cpu_affinity_policy = policy;
+  result->batch = batch;
+  result->round = FLAGS_round;
+  result->cold_start_ms = cold_start_us / 1000.0;
+  result->avg_ms = time_info.avg() / 1000.0;
+  result->p50_ms = Percentile(latencies, 50);
+  result->p90_ms = Percentile(latencies, 90);
+  result->p99_ms = Percentile(latencies, 99);
+  result->peak_rss_kb = PeakRssKb();
+  return MaceStatus::MACE_SUCCESS;
+}
+
+// Each result is written on its own line, so the baseline can be read back
+// without a JSON library.
+std::string ToJson(const std::vector<Result> &results) {
+  std::stringstream stream;
+  stream << "{\n  \"mace_version\": \"" << MaceVersion() << "\",\n"
+         << "  \"results\": [\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const Result &r = results[i];
+    stream << "    {\"name\": \"" << r.name << "\", "
+           << "\"model\": \"" << r.model << "\", "
+           << "\"num_threads\": " << r.num_threads << ", "
+           << "\"cpu_affinity_policy\": " << r.cpu_affinity_policy << ", "
+           << "\"batch\": " << r.batch << ", "
+           << "\"round\": " << r.round << ", "
+           << "\"cold_start_ms\": " << r.cold_start_ms << ", "
+           << "\"avg_ms\": " << r.avg_ms << ", "
+           << "\"p50_ms\": " << r.p50_ms << ", "
+           << "\"p90_ms\": " << r.p90_ms << ", "
+           << "\"p99_ms\": " << r.p99_ms << ", "
+           << "\"peak_rss_kb\": " << r.peak_rss_kb << "}"
+           << (i + 1 < results.size() ? ",\n" : "\n");
+  }
+  stream << "  ]\n}\n";
+  return stream.str();
+}
+
+bool FindNumber(const std::string &line, const std::string &key,
+                double *value) {
+  const std::string pattern = "\"" + key + "\": ";
+  auto pos = line.find(pattern);
+  if (pos == std::string::npos) {
+    return false;
+  }
+  *value = strtod(line.c_str() + pos + pattern.size(), nullptr);
+  return true;
+}
+
+std::map<std::string, Result> ReadBaseline(const std::string &path) {
+  std::map<std::string, Result> baseline;
+  std::ifstream file(path);
+  MACE_CHECK(file.is_open(), "can not open baseline: ", path);
+  const std::string name_key = "\"name\": \"";
+  std::string line;
+  while (std::getline(file, line)) {
+    auto pos = line.find(name_key);
+    if (pos == std::string::npos) {
+      continue;
+    }
+    pos += name_key.size();
+    Result result;
+    result.name = line.substr(pos, line.find('"', pos) - pos);
+    if (FindNumber(line, "p50_ms", &result.p50_ms) &&
+        FindNumber(line, "p90_ms", &result.p90_ms) &&
+        FindNumber(line, "p99_ms", &result.p99_ms)) {
+      baseline[result.name] = result;
+    }
+  }
+  return baseline;
+}
+
+// Return the number of regressions.
+int CompareWithBaseline(const std::vector<Result> &results,
+                        const std::map<std::string, Result> &baseline,
+                        double threshold) {
+  std::vector<std::string> header = {
+      "name", "p50(ms)", "base p50(ms)", "p90(ms)", "base p90(ms)", "status"
+  };
+  std::vector<std::vector<std::string>> data;
+  int regression_num = 0;
+  for (auto &result : results) {
+    auto iter = baseline.find(result.name);
+    if (iter == baseline.end()) {
+      data.push_back({result.name, FloatToString(result.p50_ms, 3), "-",
+                      FloatToString(result.p90_ms, 3), "-", "NEW"});
+      continue;
+    }
+    const Result &base = iter->second;
+    const bool regressed =
+        result.p50_ms > base.p50_ms * (1 + threshold) ||
+        result.p90_ms > base.p90_ms * (1 + threshold);
+    regression_num += regressed;
+    data.push_back({result.name,
+                    FloatToString(result.p50_ms, 3),
+                    FloatToString(base.p50_ms, 3),
+                    FloatToString(result.p90_ms, 3),
+                    FloatToString(base.p90_ms, 3),
+                    regressed ? "REGRESSED" : "OK"});
+  }
+  LOG(INFO) << string_util::StringFormatter::Table(
+      MakeString("Compare with baseline, threshold: ", threshold),
+      header, data);
+  return regression_num;
+}
+
+void PrintResults(const std::vector<Result> &results) {
+  std::vector<std::string> header = {
+      "name", "cold start(ms)", "avg(ms)", "p50(ms)", "p90(ms)", "p99(ms)",
+      "peak rss(KB)"
+  };
+  std::vector<std::vector<std::string>> data;
+  for (auto &r : results) {
+    data.push_back({r.name, FloatToString(r.cold_start_ms, 3),
+                    FloatToString(r.avg_ms, 3), FloatToString(r.p50_ms, 3),
+                    FloatToString(r.p90_ms, 3), FloatToString(r.p99_ms, 3),
+                    IntToString(r.peak_rss_kb)});
+  }
+  LOG(INFO) << string_util::StringFormatter::Table("Model Benchmark",
+                                                   header, data);
+}
+
+}  // namespace
+}  // namespace benchmark
+}  // namespace mace
+
+int main(int argc, char **argv) {
+  std::string usage = "run synthetic model benchmark\nusage: "
+      + std::string(argv[0]) + " [flags]";
+  gflags::SetUsageMessage(usage);
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  using namespace mace::benchmark;  // NOLINT(build/namespaces)
+  std::vector<std::string> models = SyntheticModelNames();
+  if (FLAGS_models != "all") {
+    models = mace::Split(FLAGS_models, ',');
+  }
+
+  std::vector<Result> results;
+  for (auto &model : models) {
+    for (int batch : ParseInts(FLAGS_batch)) {
+      for (int policy : ParseInts(FLAGS_cpu_affinity_policy)) {
+        for (int num_threads : ParseInts(FLAGS_num_threads)) {
+          Result result;
+          auto status = RunModel(model, num_threads, policy, batch, &result);
+          if (status != mace::MaceStatus::MACE_SUCCESS) {
+            LOG(ERROR) << "Run " << model << " failed: "
+                       << status.information();
+            return 1;
+          }
+          results.push_back(result);
+        }
+      }
+    }
+  }
+  PrintResults(results);
+
+  if (!FLAGS_output_json.empty()) {
+    std::ofstream file(FLAGS_output_json);
+    file << ToJson(results);
+    LOG(INFO) << "Write results to " << FLAGS_output_json;
+  }
+
+  if (!FLAGS_baseline_json.empty()) {
+    auto baseline = ReadBaseline(FLAGS_baseline_json);
+    if (CompareWithBaseline(results, baseline, FLAGS_threshold) > 0) {
+      LOG(ERROR) << "Performance regression found";
+      return 1;
+    }
+  }
+  return 0;
+}
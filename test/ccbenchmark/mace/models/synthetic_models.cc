@@ -0,0 +1,304 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mace/models/synthetic_models.h"
+
+#include <cstring>
+#include <functional>
+#include <numeric>
+#include <random>
+
+#include "mace/public/mace.h"
+#include "mace/utils/string_util.h"
+
+namespace mace {
+namespace benchmark {
+
+namespace {
+
+constexpr int kPaddingValid = 0;
+constexpr int kPaddingSame = 1;
+
+// Builds a float NetDef the same way as the BMNet of capability.cc.
+class ModelBuilder {
+ public:
+  ModelBuilder(const std::string &name, int batch)
+      : batch_(batch), model_(new SyntheticModel) {
+    model_->name = name;
+  }
+
+  void AddInput(const std::string &name, const std::vector<int64_t> &shape) {
+    model_->input_names.push_back(name);
+    model_->input_shapes.push_back(WithBatch(shape));
+  }
+
+  void AddOutput(const std::string &name, const std::vector<int64_t> &shape) {
+    model_->output_names.push_back(name);
+    model_->output_shapes.push_back(WithBatch(shape));
+  }
+
+  // filter_shape is OIHW, output_shape is HWC.
+  void AddConv(const std::string &conv_type,
+               const std::string &op_name,
+               const std::string &input_name,
+               const std::string &output_name,
+               const std::vector<int> &strides,
+               const std::vector<int64_t> &filter_shape,
+               const std::vector<int64_t> &output_shape,
+               bool has_relu6 = true) {
+    auto op_def = model_->net_def.add_op();
+    op_def->set_name(op_name);
+    op_def->set_type(conv_type);
+    op_def->add_input(input_name);
+    op_def->add_input(AddWeight(op_name + "/filter", filter_shape));
+    op_def->add_input(AddWeight(op_name + "/bias", {output_shape[2]}));
+    op_def->add_output(output_name);
+    AddIntsArg(op_def, "strides", strides);
+    AddIntArg(op_def, "padding", kPaddingSame);
+    AddCommonArgs(op_def, output_shape);
+    if (has_relu6) {
+      AddStringArg(op_def, "activation", "RELUX");
+      AddFloatArg(op_def, "max_limit", 6);
+    }
+  }
+
+  void AddEltwiseSum(const std::string &op_name,
+                     const std::vector<std::string> &inputs,
+                     const std::string &output_name,
+                     const std::vector<int64_t> &output_shape) {
+    auto op_def = model_->net_def.add_op();
+    op_def->set_name(op_name);
+    op_def->set_type("Eltwise");
+    for (auto &input : inputs) {
+      op_def->add_input(input);
+    }
+    op_def->add_output(output_name);
+    AddIntArg(op_def, "type", 0);
+    AddCommonArgs(op_def, output_shape);
+  }
+
+  void AddAvgPooling(const std::string &op_name,
+                     const std::string &input_name,
+                     const std::string &output_name,
+                     const std::vector<int> &kernels,
+                     const std::vector<int64_t> &output_shape) {
+    auto op_def = model_->net_def.add_op();
+    op_def->set_name(op_name);
+    op_def->set_type("Pooling");
+    op_def->add_input(input_name);
+    op_def->add_output(output_name);
+    AddIntArg(op_def, "pooling_type", 1);  // AVG
+    AddIntsArg(op_def, "kernels", kernels);
+    AddIntsArg(op_def, "strides", kernels);
+    AddIntArg(op_def, "padding", kPaddingValid);
+    AddCommonArgs(op_def, output_shape);
+  }
+
+  std::unique_ptr<SyntheticModel> Finalize() {
+    NetDef *net_def = &model_->net_def;
+    for (size_t i = 0; i < model_->input_names.size(); ++i) {
+      InputOutputInfo *info = net_def->add_input_info();
+      info->set_data_format(static_cast<int>(DataFormat::NHWC));
+      info->set_name(model_->input_names[i]);
+      for (auto d : model_->input_shapes[i]) {
+        info->add_dims(static_cast<int>(d));
+      }
+    }
+    for (size_t i = 0; i < model_->output_names.size(); ++i) {
+      InputOutputInfo *info = net_def->add_output_info();
+      info->set_data_format(static_cast<int>(DataFormat::NHWC));
+      info->set_name(model_->output_names[i]);
+      for (auto d : model_->output_shapes[i]) {
+        info->add_dims(static_cast<int>(d));
+      }
+    }
+    net_def->set_name(model_->name);
+    net_def->set_data_offset(0);
+    net_def->set_data_size(model_->weights.size());
+    return std::move(model_);
+  }
+
+  // Add a MobileNet-V2 inverted residual block, return its output name.
+  std::string AddExpandedConv(const std::string &blk_name,
+                              const std::string &input_name,
+                              int stride, int height, int width,
+                              int input_channel, int output_channel,
+                              bool has_expand, bool has_residual) {
+    const int kExpandScale = 6;
+    const int out_height = height / stride;
+    const int out_width = width / stride;
+    std::string middle_name = input_name;
+    int expand_channel = input_channel;
+    if (has_expand) {
+      expand_channel = input_channel * kExpandScale;
+      AddConv("Conv2D", blk_name + "/expand", middle_name,
+              blk_name + "/expand:0", {1, 1},
+              {expand_channel, input_channel, 1, 1},
+              {height, width, expand_channel});
+      middle_name = blk_name + "/expand:0";
+    }
+    AddConv("DepthwiseConv2d", blk_name + "/depthwise", middle_name,
+            blk_name + "/depthwise:0", {stride, stride},
+            {1, expand_channel, 3, 3},
+            {out_height, out_width, expand_channel});
+    AddConv("Conv2D", blk_name + "/project", blk_name + "/depthwise:0",
+            blk_name + "/project:0", {1, 1},
+            {output_channel, expand_channel, 1, 1},
+            {out_height, out_width, output_channel}, false);
+    if (!has_residual) {
+      return blk_name + "/project:0";
+    }
+    AddEltwiseSum(blk_name + "/add", {input_name, blk_name + "/project:0"},
+                  blk_name + "/add:0",
+                  {out_height, out_width, output_channel});
+    return blk_name + "/add:0";
+  }
+
+ private:
+  std::vector<int64_t> WithBatch(const std::vector<int64_t> &shape) const {
+    std::vector<int64_t> result(1, batch_);
+    result.insert(result.end(), shape.begin(), shape.end());
+    return result;
+  }
+
+  std::string AddWeight(const std::string &name,
+                        const std::vector<int64_t> &shape) {
+    const int64_t size = std::accumulate(shape.begin(), shape.end(), 1,
+                                         std::multiplies<int64_t>());
+    const int64_t offset = model_->weights.size();
+    ConstTensor *tensor = model_->net_def.add_tensors();
+    tensor->set_name(name);
+    for (auto dim : shape) {
+      tensor->add_dims(dim);
+    }
+    tensor->set_offset(offset);
+    tensor->set_data_size(size);
+    tensor->set_data_type(DT_FLOAT);
+
+    std::uniform_real_distribution<float> dist(-0.1f, 0.1f);
+    std::vector<float> data(size);
+    for (auto &value : data) {
+      value = dist(random_engine_);
+    }
+    model_->weights.resize(offset + size * sizeof(float));
+    memcpy(model_->weights.data() + offset, data.data(),
+           size * sizeof(float));
+    return name;
+  }
+
+  void AddCommonArgs(OperatorDef *op_def,
+                     const std::vector<int64_t> &output_shape) {
+    AddIntArg(op_def, "T", DT_FLOAT);
+    AddIntArg(op_def, "data_format", static_cast<int>(DataFormat::AUTO));
+    OutputShape *shape = op_def->add_output_shape();
+    for (auto dim : WithBatch(output_shape)) {
+      shape->add_dims(dim);
+    }
+  }
+
+  void AddIntArg(OperatorDef *op_def, const std::string &name, int value) {
+    auto arg = op_def->add_arg();
+    arg->set_name(name);
+    arg->set_i(value);
+  }
+
+  void AddIntsArg(OperatorDef *op_def, const std::string &name,
+                  const std::vector<int> &values) {
+    auto arg = op_def->add_arg();
+    arg->set_name(name);
+    for (auto value : values) {
+      arg->add_ints(value);
+    }
+  }
+
+  void AddStringArg(OperatorDef *op_def, const std::string &name,
+                    const std::string &value) {
+    auto arg = op_def->add_arg();
+    arg->set_name(name);
+    arg->set_s(value);
+  }
+
+  void AddFloatArg(OperatorDef *op_def, const std::string &name,
+                   float value) {
+    auto arg = op_def->add_arg();
+    arg->set_name(name);
+    arg->set_f(value);
+  }
+
+  int batch_;
+  std::unique_ptr<SyntheticModel> model_;
+  std::mt19937 random_engine_;
+};
+
+// The first blocks of MobileNet-V2, the same workload as capability.cc.
+std::unique_ptr<SyntheticModel> CreateMobileNetV2Head(int batch) {
+  ModelBuilder builder("mobilenet_v2_head", batch);
+  builder.AddInput("input", {224, 224, 3});
+  builder.AddConv("Conv2D", "conv", "input", "conv:0", {2, 2},
+                  {32, 3, 3, 3}, {112, 112, 32});
+  std::string output = "conv:0";
+  output = builder.AddExpandedConv("block0", output, 1, 112, 112, 32, 16,
+                                   false, false);
+  output = builder.AddExpandedConv("block1", output, 2, 112, 112, 16, 24,
+                                   true, false);
+  output = builder.AddExpandedConv("block2", output, 1, 56, 56, 24, 24,
+                                   true, true);
+  output = builder.AddExpandedConv("block3", output, 2, 56, 56, 24, 32,
+                                   true, false);
+  output = builder.AddExpandedConv("block4", output, 1, 28, 28, 32, 32,
+                                   true, true);
+  output = builder.AddExpandedConv("block5", output, 1, 28, 28, 32, 32,
+                                   true, true);
+  output = builder.AddExpandedConv("block6", output, 2, 28, 28, 32, 64,
+                                   true, false);
+  output = builder.AddExpandedConv("block7", output, 1, 14, 14, 64, 64,
+                                   true, true);
+  builder.AddOutput(output, {14, 14, 64});
+  return builder.Finalize();
+}
+
+// A VGG like stack of 3x3 convolutions, bound by the GEMM throughput.
+std::unique_ptr<SyntheticModel> CreateConvStack(int batch) {
+  ModelBuilder builder("conv3x3_stack", batch);
+  builder.AddInput("input", {56, 56, 64});
+  std::string output = "input";
+  for (int i = 0; i < 4; ++i) {
+    const std::string name = MakeString("conv", i);
+    builder.AddConv("Conv2D", name, output, name + ":0", {1, 1},
+                    {64, 64, 3, 3}, {56, 56, 64});
+    output = name + ":0";
+  }
+  builder.AddAvgPooling("pool", output, "pool:0", {56, 56}, {1, 1, 64});
+  builder.AddOutput("pool:0", {1, 1, 64});
+  return builder.Finalize();
+}
+
+}  // namespace
+
+std::vector<std::string> SyntheticModelNames() {
+  return {"mobilenet_v2_head", "conv3x3_stack"};
+}
+
+std::unique_ptr<SyntheticModel> CreateSyntheticModel(const std::string &name,
+                                                     int batch) {
+  if (name == "mobilenet_v2_head") {
+    return CreateMobileNetV2Head(batch);
+  } else if (name == "conv3x3_stack") {
+    return CreateConvStack(batch);
+  }
+  return nullptr;
+}
+
+}  // namespace benchmark
+}  // namespace mace
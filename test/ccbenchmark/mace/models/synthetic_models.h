@@ -0,0 +1,48 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MACE_MODELS_SYNTHETIC_MODELS_H_
+#define MACE_MODELS_SYNTHETIC_MODELS_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mace/proto/mace.pb.h"
+
+namespace mace {
+namespace benchmark {
+
+// A model built in code with random weights, so the benchmark needs no
+// model files.
+struct SyntheticModel {
+  std::string name;
+  NetDef net_def;
+  std::vector<unsigned char> weights;
+  std::vector<std::string> input_names;
+  std::vector<std::vector<int64_t>> input_shapes;
+  std::vector<std::string> output_names;
+  std::vector<std::vector<int64_t>> output_shapes;
+};
+
+std::vector<std::string> SyntheticModelNames();
+
+// Return nullptr if there is no model with the name.
+std::unique_ptr<SyntheticModel> CreateSyntheticModel(const std::string &name,
+                                                     int batch);
+
+}  // namespace benchmark
+}  // namespace mace
+
+#endif  // MACE_MODELS_SYNTHETIC_MODELS_H_
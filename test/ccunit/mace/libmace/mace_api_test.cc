@@ -12,9 +12,22 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <dirent.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <thread>  // NOLINT(build/c++11)
+
+#include "mace/core/memory/const_tensor_registry.h"
 #include "mace/core/memory/memory_manager.h"
+#include "mace/core/net_def_adapter.h"
 #include "mace/core/proto/arg_helper.h"
 #include "mace/libmace/mace_api_test.h"
+#include "mace/ops/common/eltwise_type.h"
 #ifdef MACE_ENABLE_OPENCL
 #include "mace/runtimes/opencl/opencl_runtime.h"
 #endif  // MACE_ENABLE_OPENCL
@@ -201,8 +214,779 @@ void MaceRun(const int in_out_size,
   CheckOutputs<D, T>(*net_def, inputs, outputs, data);
 }
 
+void AddIOInfo(const std::string &name,
+               const std::vector<int64_t> &shape,
+               InputOutputInfo *info) {
+  info->set_name(name);
+  info->set_data_format(static_cast<int>(DataFormat::NHWC));
+  info->set_data_type(DataType::DT_FLOAT);
+  for (auto d : shape) {
+    info->add_dims(static_cast<int>(d));
+  }
+}
+
+// Run a conv net followed by a relu net, as a pipeline and serially.
+void MacePipelineRun(const int request_num,
+                     const int thread_num,
+                     const std::vector<int64_t> &shape,
+                     const std::vector<int64_t> &filter_shape) {
+  const std::string input_name = "input";
+  const std::string inter_name = "conv_output";
+  const std::string output_name = "output";
+
+  std::shared_ptr<MultiNetDef> multi_net_def(new MultiNetDef());
+  NetDef *conv_net = multi_net_def->add_net_def();
+  conv_net->set_name("conv_net");
+  conv_net->set_infer_order(0);
+  std::vector<float> data;
+  ops::test::GenerateRandomRealTypeData<float>(filter_shape, &data);
+  AddTensor<float>("filter", filter_shape, 0, data.size(), conv_net);
+  AddIOInfo(input_name, shape, conv_net->add_input_info());
+  AddIOInfo(inter_name, shape, conv_net->add_output_info());
+  Conv3x3<float>(input_name, "filter", inter_name, shape, conv_net);
+
+  NetDef *relu_net = multi_net_def->add_net_def();
+  relu_net->set_name("relu_net");
+  relu_net->set_infer_order(1);
+  AddIOInfo(inter_name, shape, relu_net->add_input_info());
+  AddIOInfo(output_name, shape, relu_net->add_output_info());
+  Relu<float>(inter_name, output_name, RT_CPU, relu_net);
+
+  for (auto *net_def : {conv_net, relu_net}) {
+    SetProtoArg(net_def, "runtime_type", static_cast<int>(RT_CPU));
+    SetProtoArg(net_def, "opencl_mem_type", static_cast<int>(CPU_BUFFER));
+  }
+  multi_net_def->add_input_tensor(input_name);
+  multi_net_def->add_output_tensor(output_name);
+
+  const std::vector<std::string> input_names = {input_name};
+  const std::vector<std::string> output_names = {output_name};
+  std::vector<std::unique_ptr<MaceEngine>> engines;
+  for (bool pipelined : {false, true}) {
+    MaceEngineConfig config;
+    EXPECT_EQ(config.SetPipelineExecution(pipelined),
+              MaceStatus::MACE_SUCCESS);
+    engines.emplace_back(new MaceEngine(config));
+    MaceStatus status = engines.back()->Init(
+        multi_net_def.get(), input_names, output_names,
+        reinterpret_cast<unsigned char *>(data.data()),
+        data.size() * sizeof(float));
+    EXPECT_EQ(status, MaceStatus::MACE_SUCCESS);
+  }
+
+  std::vector<std::map<std::string, MaceTensor>> inputs(request_num);
+  std::vector<std::map<std::string, MaceTensor>> expected(request_num);
+  std::vector<std::map<std::string, MaceTensor>> outputs(request_num);
+  for (int i = 0; i < request_num; ++i) {
+    GenerateInputs(input_names, shape, &inputs[i]);
+    GenerateOutputs(output_names, shape, &expected[i]);
+    GenerateOutputs(output_names, shape, &outputs[i]);
+    EXPECT_EQ(engines[0]->Run(inputs[i], &expected[i]),
+              MaceStatus::MACE_SUCCESS);
+  }
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < thread_num; ++t) {
+    threads.emplace_back([&, t]() {
+      for (int i = t; i < request_num; i += thread_num) {
+        EXPECT_EQ(engines[1]->Run(inputs[i], &outputs[i]),
+                  MaceStatus::MACE_SUCCESS);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  const int64_t size = std::accumulate(shape.begin(), shape.end(), 1,
+                                       std::multiplies<int64_t>());
+  for (int i = 0; i < request_num; ++i) {
+    const float *expected_data = expected[i][output_name].data().get();
+    const float *output_data = outputs[i][output_name].data().get();
+    for (int64_t k = 0; k < size; ++k) {
+      EXPECT_NEAR(expected_data[k], output_data[k], 1e-5);
+    }
+  }
+}
+
+// Remove the init cache files in the dir, return the number of them.
+int RemoveInitCacheFiles(const std::string &dir) {
+  int count = 0;
+  DIR *dir_ptr = opendir(dir.c_str());
+  if (dir_ptr == nullptr) {
+    return 0;
+  }
+  const std::string prefix = "mace_init_cache_";
+  while (struct dirent *entry = readdir(dir_ptr)) {
+    std::string name = entry->d_name;
+    if (name.compare(0, prefix.size(), prefix) == 0) {
+      unlink((dir + "/" + name).c_str());
+      ++count;
+    }
+  }
+  closedir(dir_ptr);
+  return count;
+}
+
+// A CPU net of a 3x3 conv followed by an eltwise with a 4D constant, which
+// is transposed for CPU, from "input" to "output". The filter and the
+// constant are returned as the model data.
+std::shared_ptr<MultiNetDef> CreateCPUConvEltwiseNet(
+    const std::vector<int64_t> &shape,
+    const std::vector<int64_t> &filter_shape,
+    std::vector<float> *data) {
+  const std::string input_name = "input";
+  const std::string output_name = "output";
+  std::shared_ptr<MultiNetDef> multi_net_def(new MultiNetDef());
+  NetDef *net_def = multi_net_def->add_net_def();
+  std::vector<float> filter_data;
+  std::vector<float> addend_data;
+  ops::test::GenerateRandomRealTypeData<float>(filter_shape, &filter_data);
+  ops::test::GenerateRandomRealTypeData<float>(shape, &addend_data);
+  data->assign(filter_data.begin(), filter_data.end());
+  data->insert(data->end(), addend_data.begin(), addend_data.end());
+  AddTensor<float>("filter", filter_shape, 0, filter_data.size(), net_def);
+  AddTensor<float>("addend", shape, filter_data.size(), addend_data.size(),
+                   net_def);
+  AddIOInfo(input_name, shape, net_def->add_input_info());
+  AddIOInfo(output_name, shape, net_def->add_output_info());
+  Conv3x3<float>(input_name, "filter", "conv_output", shape, net_def);
+  OperatorDef eltwise_def;
+  ops::test::OpDefBuilder("Eltwise", "EltwiseTest")
+      .Input("conv_output")
+      .Input("addend")
+      .Output(output_name)
+      .AddIntArg("type", static_cast<int>(ops::EltwiseType::SUM))
+      .AddIntArg("T", static_cast<int>(DT_FLOAT))
+      .AddIntArg("data_format", static_cast<int>(DataFormat::AUTO))
+      .Finalize(&eltwise_def);
+  OutputShape *output_shape = eltwise_def.add_output_shape();
+  for (auto dim : shape) {
+    output_shape->add_dims(dim);
+  }
+  net_def->add_op()->CopyFrom(eltwise_def);
+  SetProtoArg(net_def, "runtime_type", static_cast<int>(RT_CPU));
+  SetProtoArg(net_def, "opencl_mem_type", static_cast<int>(CPU_BUFFER));
+  multi_net_def->add_input_tensor(input_name);
+  multi_net_def->add_output_tensor(output_name);
+  return multi_net_def;
+}
+
+// Run the conv and eltwise net without the init cache, with a cold and a
+// warm one.
+void MaceInitCacheRun(const std::vector<int64_t> &shape,
+                      const std::vector<int64_t> &filter_shape) {
+  const char *storage_path = getenv("MACE_INTERNAL_STORAGE_PATH");
+  const std::string cache_dir = storage_path == nullptr ? "." : storage_path;
+  RemoveInitCacheFiles(cache_dir);
+
+  const std::string input_name = "input";
+  const std::string output_name = "output";
+  std::vector<float> data;
+  std::shared_ptr<MultiNetDef> multi_net_def =
+      CreateCPUConvEltwiseNet(shape, filter_shape, &data);
+
+  const std::vector<std::string> input_names = {input_name};
+  const std::vector<std::string> output_names = {output_name};
+  std::map<std::string, MaceTensor> inputs;
+  GenerateInputs(input_names, shape, &inputs);
+  std::vector<std::map<std::string, MaceTensor>> outputs(3);
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    MaceEngineConfig config;
+    if (i > 0) {
+      EXPECT_EQ(config.SetInitCachePath(cache_dir), MaceStatus::MACE_SUCCESS);
+    }
+    MaceEngine engine(config);
+    const int64_t adapted_count = NetDefAdapter::AdaptedNetCount();
+    EXPECT_EQ(engine.Init(multi_net_def.get(), input_names, output_names,
+                          reinterpret_cast<unsigned char *>(data.data()),
+                          data.size() * sizeof(float)),
+              MaceStatus::MACE_SUCCESS);
+    // The net is adapted unless it is loaded from the warm cache.
+    EXPECT_EQ(NetDefAdapter::AdaptedNetCount() - adapted_count,
+              i < 2 ? 1 : 0);
+    GenerateOutputs(output_names, shape, &outputs[i]);
+    EXPECT_EQ(engine.Run(inputs, &outputs[i]), MaceStatus::MACE_SUCCESS);
+  }
+  EXPECT_EQ(RemoveInitCacheFiles(cache_dir), 1);
+
+  const int64_t size = std::accumulate(shape.begin(), shape.end(), 1,
+                                       std::multiplies<int64_t>());
+  const float *expected_data = outputs[0][output_name].data().get();
+  for (size_t i = 1; i < outputs.size(); ++i) {
+    const float *output_data = outputs[i][output_name].data().get();
+    for (int64_t k = 0; k < size; ++k) {
+      EXPECT_EQ(expected_data[k], output_data[k]);
+    }
+  }
+}
+
+#ifdef MACE_ENABLE_BFLOAT16
+// Run the conv and eltwise net in float, in mixed precision of BFloat16
+// without and with the init cache, and with the conv too sensitive to run
+// in BFloat16, in which case the net stays in float.
+void MaceMixedPrecisionRun(const std::vector<int64_t> &shape,
+                           const std::vector<int64_t> &filter_shape) {
+  const char *storage_path = getenv("MACE_INTERNAL_STORAGE_PATH");
+  const std::string cache_dir = storage_path == nullptr ? "." : storage_path;
+  RemoveInitCacheFiles(cache_dir);
+
+  const std::string input_name = "input";
+  const std::string output_name = "output";
+  std::vector<float> data;
+  std::shared_ptr<MultiNetDef> multi_net_def =
+      CreateCPUConvEltwiseNet(shape, filter_shape, &data);
+
+  const std::vector<std::string> input_names = {input_name};
+  const std::vector<std::string> output_names = {output_name};
+  std::map<std::string, MaceTensor> inputs;
+  GenerateInputs(input_names, shape, &inputs);
+  std::vector<std::map<std::string, MaceTensor>> outputs(5);
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    MaceEngineConfig config;
+    EXPECT_EQ(config.SetCPUMixedPrecision(IDT_INT32),
+              MaceStatus::MACE_INVALID_ARGS);
+    if (i > 0 && i < 4) {
+      EXPECT_EQ(config.SetCPUMixedPrecision(IDT_BFLOAT16),
+                MaceStatus::MACE_SUCCESS);
+    } else if (i == 4) {
+      EXPECT_EQ(config.SetCPUMixedPrecision(IDT_BFLOAT16, {{"Conv2D", 1.f}},
+                                            0.5f),
+                MaceStatus::MACE_SUCCESS);
+    }
+    if (i == 2 || i == 3) {
+      EXPECT_EQ(config.SetInitCachePath(cache_dir), MaceStatus::MACE_SUCCESS);
+    }
+    MaceEngine engine(config);
+    EXPECT_EQ(engine.Init(multi_net_def.get(), input_names, output_names,
+                          reinterpret_cast<unsigned char *>(data.data()),
+                          data.size() * sizeof(float)),
+              MaceStatus::MACE_SUCCESS);
+    GenerateOutputs(output_names, shape, &outputs[i]);
+    EXPECT_EQ(engine.Run(inputs, &outputs[i]), MaceStatus::MACE_SUCCESS);
+  }
+  EXPECT_EQ(RemoveInitCacheFiles(cache_dir), 1);
+
+  const int64_t size = std::accumulate(shape.begin(), shape.end(), 1,
+                                       std::multiplies<int64_t>());
+  const float *float_data = outputs[0][output_name].data().get();
+  const float *mixed_data = outputs[1][output_name].data().get();
+  float max_diff = 0.f;
+  for (int64_t k = 0; k < size; ++k) {
+    // BFloat16 truncates the inputs, the weights and the outputs.
+    const float diff = std::abs(float_data[k] - mixed_data[k]);
+    EXPECT_LE(diff, 5e-2 * std::abs(float_data[k]) + 1e-2);
+    max_diff = std::max(max_diff, diff);
+  }
+  // The net really runs in BFloat16.
+  EXPECT_GT(max_diff, 0.f);
+  for (size_t i = 2; i < 4; ++i) {
+    const float *output_data = outputs[i][output_name].data().get();
+    for (int64_t k = 0; k < size; ++k) {
+      EXPECT_EQ(mixed_data[k], output_data[k]);
+    }
+  }
+  const float *sensitive_data = outputs[4][output_name].data().get();
+  for (int64_t k = 0; k < size; ++k) {
+    EXPECT_NEAR(float_data[k], sensitive_data[k], 1e-5);
+  }
+}
+#endif  // MACE_ENABLE_BFLOAT16
+
+// A CPU net of a 3x3 conv from "input" to "output", the filter is
+// returned as the model data.
+std::shared_ptr<MultiNetDef> CreateCPUConvNet(
+    const std::vector<int64_t> &shape,
+    const std::vector<int64_t> &filter_shape,
+    std::vector<float> *data) {
+  std::shared_ptr<MultiNetDef> multi_net_def(new MultiNetDef());
+  NetDef *net_def = multi_net_def->add_net_def();
+  ops::test::GenerateRandomRealTypeData<float>(filter_shape, data);
+  AddTensor<float>("filter", filter_shape, 0, data->size(), net_def);
+  AddIOInfo("input", shape, net_def->add_input_info());
+  AddIOInfo("output", shape, net_def->add_output_info());
+  Conv3x3<float>("input", "filter", "output", shape, net_def);
+  SetProtoArg(net_def, "runtime_type", static_cast<int>(RT_CPU));
+  SetProtoArg(net_def, "opencl_mem_type", static_cast<int>(CPU_BUFFER));
+  multi_net_def->add_input_tensor("input");
+  multi_net_def->add_output_tensor("output");
+  return multi_net_def;
+}
+
+// Run a conv net without the CPU tuner, with the tuner in tuning mode and
+// with the parameters tuned.
+void MaceCPUTuningRun(const std::vector<int64_t> &shape,
+                      const std::vector<int64_t> &filter_shape) {
+  const char *storage_path = getenv("MACE_INTERNAL_STORAGE_PATH");
+  const std::string param_path =
+      (storage_path == nullptr ? "." : storage_path) +
+      std::string("/mace_cpu_tuning_test.bin");
+  unlink(param_path.c_str());
+  // The file of the OpenCL parameters, which the CPU tuner must not write.
+  const std::string run_param_path =
+      (storage_path == nullptr ? "." : storage_path) +
+      std::string("/mace_cpu_tuning_test_run.config");
+  unlink(run_param_path.c_str());
+  const char *old_run_param_path = getenv("MACE_RUN_PARAMETER_PATH");
+  const std::string saved_run_param_path =
+      old_run_param_path == nullptr ? "" : old_run_param_path;
+  setenv("MACE_RUN_PARAMETER_PATH", run_param_path.c_str(), 1);
+
+  const std::string input_name = "input";
+  const std::string output_name = "output";
+  std::vector<float> data;
+  std::shared_ptr<MultiNetDef> multi_net_def =
+      CreateCPUConvNet(shape, filter_shape, &data);
+
+  const std::vector<std::string> input_names = {input_name};
+  const std::vector<std::string> output_names = {output_name};
+  std::map<std::string, MaceTensor> inputs;
+  GenerateInputs(input_names, shape, &inputs);
+  std::vector<std::map<std::string, MaceTensor>> outputs(3);
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    if (i == 1) {
+      setenv("MACE_TUNING", "1", 1);
+    }
+    {
+      MaceEngineConfig config;
+      if (i > 0) {
+        EXPECT_EQ(config.SetCPUTuningParameterPath(param_path),
+                  MaceStatus::MACE_SUCCESS);
+      }
+      MaceEngine engine(config);
+      EXPECT_EQ(engine.Init(multi_net_def.get(), input_names, output_names,
+                            reinterpret_cast<unsigned char *>(data.data()),
+                            data.size() * sizeof(float)),
+                MaceStatus::MACE_SUCCESS);
+      GenerateOutputs(output_names, shape, &outputs[i]);
+      EXPECT_EQ(engine.Run(inputs, &outputs[i]), MaceStatus::MACE_SUCCESS);
+    }
+    if (i == 1) {
+      unsetenv("MACE_TUNING");
+      // The tuned parameters are written when the engine is destroyed.
+      EXPECT_EQ(access(param_path.c_str(), F_OK), 0);
+    }
+  }
+  EXPECT_NE(access(run_param_path.c_str(), F_OK), 0);
+  if (old_run_param_path == nullptr) {
+    unsetenv("MACE_RUN_PARAMETER_PATH");
+  } else {
+    setenv("MACE_RUN_PARAMETER_PATH", saved_run_param_path.c_str(), 1);
+  }
+  unlink(run_param_path.c_str());
+  unlink(param_path.c_str());
+
+  const int64_t size = std::accumulate(shape.begin(), shape.end(), 1,
+                                       std::multiplies<int64_t>());
+  const float *expected_data = outputs[0][output_name].data().get();
+  for (size_t i = 1; i < outputs.size(); ++i) {
+    const float *output_data = outputs[i][output_name].data().get();
+    for (int64_t k = 0; k < size; ++k) {
+      EXPECT_NEAR(expected_data[k], output_data[k], 1e-3);
+    }
+  }
+}
+
+// Run a conv net with the default config and with the configs set up by
+// the functions, the outputs should be the same.
+void MaceCPUConfigRun(
+    const std::vector<int64_t> &shape,
+    const std::vector<int64_t> &filter_shape,
+    const std::vector<std::function<void(MaceEngineConfig *)>> &setups) {
+  const std::string input_name = "input";
+  const std::string output_name = "output";
+  std::vector<float> data;
+  std::shared_ptr<MultiNetDef> multi_net_def =
+      CreateCPUConvNet(shape, filter_shape, &data);
+
+  const std::vector<std::string> input_names = {input_name};
+  const std::vector<std::string> output_names = {output_name};
+  std::map<std::string, MaceTensor> inputs;
+  GenerateInputs(input_names, shape, &inputs);
+  std::vector<std::map<std::string, MaceTensor>> outputs(setups.size() + 1);
+  for (size_t i = 0; i < outputs.size(); ++i) {
+    MaceEngineConfig config;
+    if (i > 0) {
+      setups[i - 1](&config);
+    }
+    MaceEngine engine(config);
+    EXPECT_EQ(engine.Init(multi_net_def.get(), input_names, output_names,
+                          reinterpret_cast<unsigned char *>(data.data()),
+                          data.size() * sizeof(float)),
+              MaceStatus::MACE_SUCCESS);
+    GenerateOutputs(output_names, shape, &outputs[i]);
+    EXPECT_EQ(engine.Run(inputs, &outputs[i]), MaceStatus::MACE_SUCCESS);
+  }
+
+  const int64_t size = std::accumulate(shape.begin(), shape.end(), 1,
+                                       std::multiplies<int64_t>());
+  const float *expected_data = outputs[0][output_name].data().get();
+  for (size_t i = 1; i < outputs.size(); ++i) {
+    const float *output_data = outputs[i][output_name].data().get();
+    for (int64_t k = 0; k < size; ++k) {
+      EXPECT_NEAR(expected_data[k], output_data[k], 1e-5);
+    }
+  }
+}
+
+// Run engines sharing the weights from a model data file and from different
+// copies of the model data, the outputs should be the same as without
+// sharing.
+void MaceConstTensorSharingRun(const std::vector<int64_t> &shape,
+                               const std::vector<int64_t> &filter_shape) {
+  const char *storage_path = getenv("MACE_INTERNAL_STORAGE_PATH");
+  const std::string data_path =
+      (storage_path == nullptr ? "." : storage_path) +
+      std::string("/mace_const_tensor_sharing_test.data");
+
+  const std::string input_name = "input";
+  const std::string output_name = "output";
+  std::vector<float> data;
+  std::shared_ptr<MultiNetDef> multi_net_def =
+      CreateCPUConvNet(shape, filter_shape, &data);
+  const int64_t data_size = data.size() * sizeof(float);
+  {
+    std::ofstream data_file(data_path, std::ios::binary);
+    data_file.write(reinterpret_cast<const char *>(data.data()), data_size);
+  }
+
+  const std::vector<std::string> input_names = {input_name};
+  const std::vector<std::string> output_names = {output_name};
+  std::map<std::string, MaceTensor> inputs;
+  GenerateInputs(input_names, shape, &inputs);
+  std::vector<std::map<std::string, MaceTensor>> outputs(5);
+  {
+    MaceEngineConfig config;
+    MaceEngine engine(config);
+    EXPECT_EQ(engine.Init(multi_net_def.get(), input_names, output_names,
+                          reinterpret_cast<unsigned char *>(data.data()),
+                          data_size),
+              MaceStatus::MACE_SUCCESS);
+    GenerateOutputs(output_names, shape, &outputs[0]);
+    EXPECT_EQ(engine.Run(inputs, &outputs[0]), MaceStatus::MACE_SUCCESS);
+  }
+
+  ConstTensorRegistry *registry = ConstTensorRegistry::Get();
+  {
+    MaceEngineConfig config;
+    EXPECT_EQ(config.SetConstTensorSharing(true), MaceStatus::MACE_SUCCESS);
+    std::vector<std::unique_ptr<MaceEngine>> engines;
+    for (int i = 0; i < 2; ++i) {
+      engines.emplace_back(new MaceEngine(config));
+      EXPECT_EQ(engines.back()->Init(multi_net_def.get(), input_names,
+                                     output_names, data_path),
+                MaceStatus::MACE_SUCCESS);
+    }
+    for (int i = 0; i < 2; ++i) {
+      std::vector<float> data_copy(data);
+      bool model_data_unused = false;
+      engines.emplace_back(new MaceEngine(config));
+      EXPECT_EQ(engines.back()->Init(
+          multi_net_def.get(), input_names, output_names,
+          reinterpret_cast<unsigned char *>(data_copy.data()), data_size,
+          &model_data_unused), MaceStatus::MACE_SUCCESS);
+      EXPECT_TRUE(model_data_unused);
+    }
+    // All the engines reference the filter in the mapped file.
+    EXPECT_EQ(registry->Size(), 1u);
+    for (size_t i = 0; i < engines.size(); ++i) {
+      GenerateOutputs(output_names, shape, &outputs[i + 1]);
+      EXPECT_EQ(engines[i]->Run(inputs, &outputs[i + 1]),
+                MaceStatus::MACE_SUCCESS);
+    }
+  }
+  EXPECT_EQ(registry->Size(), 0u);
+  unlink(data_path.c_str());
+
+  const int64_t size = std::accumulate(shape.begin(), shape.end(), 1,
+                                       std::multiplies<int64_t>());
+  const float *expected_data = outputs[0][output_name].data().get();
+  for (size_t i = 1; i < outputs.size(); ++i) {
+    const float *output_data = outputs[i][output_name].data().get();
+    for (int64_t k = 0; k < size; ++k) {
+      EXPECT_NEAR(expected_data[k], output_data[k], 1e-5);
+    }
+  }
+}
+
+void MaceRunAsyncRun(const std::vector<int64_t> &shape,
+                     const std::vector<int64_t> &filter_shape) {
+  const std::string input_name = "input";
+  const std::string output_name = "output";
+  std::vector<float> data;
+  std::shared_ptr<MultiNetDef> multi_net_def =
+      CreateCPUConvNet(shape, filter_shape, &data);
+
+  const std::vector<std::string> input_names = {input_name};
+  const std::vector<std::string> output_names = {output_name};
+  std::map<std::string, MaceTensor> inputs;
+  GenerateInputs(input_names, shape, &inputs);
+
+  MaceEngineConfig config;
+  MaceEngine engine(config);
+  EXPECT_EQ(engine.Init(multi_net_def.get(), input_names, output_names,
+                        reinterpret_cast<unsigned char *>(data.data()),
+                        data.size() * sizeof(float)),
+            MaceStatus::MACE_SUCCESS);
+  std::map<std::string, MaceTensor> expected_outputs;
+  GenerateOutputs(output_names, shape, &expected_outputs);
+  EXPECT_EQ(engine.Run(inputs, &expected_outputs), MaceStatus::MACE_SUCCESS);
+
+  // The runs behind the first one are still queued when they are cancelled
+  // or their timeout elapses.
+  std::vector<std::map<std::string, MaceTensor>> outputs(4);
+  for (auto &output : outputs) {
+    GenerateOutputs(output_names, shape, &output);
+  }
+  std::atomic<int> callback_count(0);
+  auto callback = [&callback_count](const MaceStatus &status) {
+    MACE_UNUSED(status);
+    ++callback_count;
+  };
+  RunFuture first = engine.RunAsync(inputs, &outputs[0], 0, callback);
+  RunFuture cancelled = engine.RunAsync(inputs, &outputs[1], 0, callback);
+  cancelled.Cancel();
+  RunFuture expired = engine.RunAsync(inputs, &outputs[2], 1, callback);
+  RunFuture last = engine.RunAsync(inputs, &outputs[3], 0, callback);
+
+  EXPECT_EQ(first.Wait(), MaceStatus::MACE_SUCCESS);
+  EXPECT_EQ(cancelled.Wait(), MaceStatus::MACE_CANCELLED);
+  EXPECT_EQ(expired.Wait(), MaceStatus::MACE_DEADLINE_EXCEEDED);
+  EXPECT_TRUE(last.WaitFor(10 * 1000 * 1000));
+  EXPECT_EQ(last.Wait(), MaceStatus::MACE_SUCCESS);
+  EXPECT_EQ(callback_count, 4);
+
+  const int64_t size = std::accumulate(shape.begin(), shape.end(), 1,
+                                       std::multiplies<int64_t>());
+  const float *expected_data = expected_outputs[output_name].data().get();
+  for (size_t i : {0, 3}) {
+    const float *output_data = outputs[i][output_name].data().get();
+    for (int64_t k = 0; k < size; ++k) {
+      EXPECT_NEAR(expected_data[k], output_data[k], 1e-5);
+    }
+  }
+
+  // The engine works synchronously after the asynchronous runs.
+  EXPECT_EQ(engine.Run(inputs, &outputs[1]), MaceStatus::MACE_SUCCESS);
+}
+
+void MaceCheckpointRun(const std::vector<int64_t> &shape,
+                       const std::vector<int64_t> &filter_shape) {
+  const std::string input_name = "input";
+  const std::string head_name = "head";
+  const std::string output_name = "output";
+  std::vector<float> data;
+  std::shared_ptr<MultiNetDef> multi_net_def(new MultiNetDef());
+  NetDef *net_def = multi_net_def->add_net_def();
+  ops::test::GenerateRandomRealTypeData<float>(filter_shape, &data);
+  AddTensor<float>("filter", filter_shape, 0, data.size(), net_def);
+  AddIOInfo(input_name, shape, net_def->add_input_info());
+  AddIOInfo(head_name, shape, net_def->add_output_info());
+  AddIOInfo(output_name, shape, net_def->add_output_info());
+  Conv3x3<float>(input_name, "filter", head_name, shape, net_def);
+  Conv3x3<float>(head_name, "filter", output_name, shape, net_def);
+  SetProtoArg(net_def, "runtime_type", static_cast<int>(RT_CPU));
+  SetProtoArg(net_def, "opencl_mem_type", static_cast<int>(CPU_BUFFER));
+  multi_net_def->add_input_tensor(input_name);
+  multi_net_def->add_output_tensor(head_name);
+  multi_net_def->add_output_tensor(output_name);
+
+  const std::vector<std::string> input_names = {input_name};
+  const std::vector<std::string> output_names = {head_name, output_name};
+  std::map<std::string, MaceTensor> inputs;
+  GenerateInputs(input_names, shape, &inputs);
+  const int64_t size = std::accumulate(shape.begin(), shape.end(), 1,
+                                       std::multiplies<int64_t>());
+
+  // exit: whether the predicate exits, budget_us: the latency budget.
+  // The checkpoint tensor seen by the predicate.
+  std::vector<float> checkpoint_data;
+  auto run = [&](bool exit, int64_t budget_us, int *predicate_calls,
+                 std::map<std::string, MaceTensor> *outputs) {
+    MaceEngineConfig config;
+    std::vector<float> *checkpoint = &checkpoint_data;
+    EXPECT_EQ(config.AddCheckpoint(head_name,
+                                   [=](const MaceTensor &tensor) {
+      ++(*predicate_calls);
+      // The CPU computes the head in NCHW, the predicate gets it in the
+      // NHWC of the model.
+      EXPECT_EQ(tensor.data_format(), DataFormat::NHWC);
+      EXPECT_EQ(tensor.shape(), shape);
+      const float *data = tensor.data().get();
+      checkpoint->assign(data, data + size);
+      return exit;
+    }), MaceStatus::MACE_SUCCESS);
+    EXPECT_EQ(config.SetCheckpointLatencyBudget(budget_us),
+              MaceStatus::MACE_SUCCESS);
+    MaceEngine engine(config);
+    EXPECT_EQ(engine.Init(multi_net_def.get(), input_names, output_names,
+                          reinterpret_cast<unsigned char *>(data.data()),
+                          data.size() * sizeof(float)),
+              MaceStatus::MACE_SUCCESS);
+    GenerateOutputs(output_names, shape, outputs);
+    EXPECT_EQ(engine.Run(inputs, outputs), MaceStatus::MACE_SUCCESS);
+  };
+
+  int continued_calls = 0;
+  std::map<std::string, MaceTensor> full_outputs;
+  run(false, 0, &continued_calls, &full_outputs);
+  EXPECT_EQ(continued_calls, 1);
+  EXPECT_EQ(full_outputs.size(), 2u);
+
+  int exited_calls = 0;
+  std::map<std::string, MaceTensor> exited_outputs;
+  run(true, 0, &exited_calls, &exited_outputs);
+  EXPECT_EQ(exited_calls, 1);
+
+  // The predicate is not called once the budget is exhausted.
+  int budget_calls = 0;
+  std::map<std::string, MaceTensor> budget_outputs;
+  run(false, 1, &budget_calls, &budget_outputs);
+  EXPECT_EQ(budget_calls, 0);
+
+  const float *expected_data = full_outputs[head_name].data().get();
+  ASSERT_EQ(checkpoint_data.size(), static_cast<size_t>(size));
+  for (int64_t k = 0; k < size; ++k) {
+    EXPECT_NEAR(expected_data[k], checkpoint_data[k], 1e-5);
+  }
+  for (auto *outputs : {&exited_outputs, &budget_outputs}) {
+    EXPECT_EQ(outputs->size(), 1u);
+    EXPECT_EQ(outputs->count(output_name), 0u);
+    const float *output_data = (*outputs)[head_name].data().get();
+    for (int64_t k = 0; k < size; ++k) {
+      EXPECT_NEAR(expected_data[k], output_data[k], 1e-5);
+    }
+  }
+}
+
+// Check an intermediate tensor of a depthwise conv net, which the CPU may
+// compute in NCHWc, against the same tensor returned as an output.
+void MaceIntermediateCheckpointRun(const std::vector<int64_t> &shape) {
+  const std::string input_name = "input";
+  const std::string mid_name = "mid";
+  const std::string output_name = "output";
+  const std::vector<int64_t> filter_shape = {1, shape[3], 3, 3};
+  std::vector<float> data;
+  ops::test::GenerateRandomRealTypeData<float>(filter_shape, &data);
+  std::map<std::string, MaceTensor> inputs;
+  GenerateInputs({input_name}, shape, &inputs);
+  const int64_t size = std::accumulate(shape.begin(), shape.end(), 1,
+                                       std::multiplies<int64_t>());
+
+  // Return the output of the depthwise conv, or check it at a checkpoint.
+  auto run = [&](bool checkpoint, std::vector<float> *mid_data) {
+    std::shared_ptr<MultiNetDef> multi_net_def(new MultiNetDef());
+    NetDef *net_def = multi_net_def->add_net_def();
+    AddTensor<float>("filter", filter_shape, 0, data.size(), net_def);
+    AddIOInfo(input_name, shape, net_def->add_input_info());
+    const std::string net_output = checkpoint ? output_name : mid_name;
+    AddIOInfo(net_output, shape, net_def->add_output_info());
+    OperatorDef *op_def = net_def->add_op();
+    ops::test::OpDefBuilder("DepthwiseConv2d", "DepthwiseConv2dOp")
+        .Input(input_name)
+        .Input("filter")
+        .Output(mid_name)
+        .OutputShape(std::vector<index_t>(shape.begin(), shape.end()))
+        .AddIntsArg("strides", {1, 1})
+        .AddIntArg("padding", Padding::SAME)
+        .AddIntsArg("dilations", {1, 1})
+        .AddIntArg("data_format", static_cast<int>(DataFormat::AUTO))
+        .Finalize(op_def);
+    if (checkpoint) {
+      Relu<float>(mid_name, output_name, RT_CPU, net_def);
+    }
+    SetProtoArg(net_def, "runtime_type", static_cast<int>(RT_CPU));
+    SetProtoArg(net_def, "opencl_mem_type", static_cast<int>(CPU_BUFFER));
+    multi_net_def->add_input_tensor(input_name);
+    multi_net_def->add_output_tensor(net_output);
+
+    MaceEngineConfig config;
+    if (checkpoint) {
+      EXPECT_EQ(config.AddCheckpoint(mid_name,
+                                     [=](const MaceTensor &tensor) {
+        EXPECT_EQ(tensor.data_format(), DataFormat::NHWC);
+        EXPECT_EQ(tensor.shape(), shape);
+        const float *tensor_data = tensor.data().get();
+        mid_data->assign(tensor_data, tensor_data + size);
+        return false;
+      }), MaceStatus::MACE_SUCCESS);
+    }
+    MaceEngine engine(config);
+    EXPECT_EQ(engine.Init(multi_net_def.get(), {input_name}, {net_output},
+                          reinterpret_cast<unsigned char *>(data.data()),
+                          data.size() * sizeof(float)),
+              MaceStatus::MACE_SUCCESS);
+    std::map<std::string, MaceTensor> outputs;
+    GenerateOutputs({net_output}, shape, &outputs);
+    EXPECT_EQ(engine.Run(inputs, &outputs), MaceStatus::MACE_SUCCESS);
+    if (!checkpoint) {
+      const float *output_data = outputs[net_output].data().get();
+      mid_data->assign(output_data, output_data + size);
+    }
+  };
+
+  std::vector<float> expected_data;
+  run(false, &expected_data);
+  std::vector<float> checkpoint_data;
+  run(true, &checkpoint_data);
+  ASSERT_EQ(checkpoint_data.size(), expected_data.size());
+  for (size_t k = 0; k < expected_data.size(); ++k) {
+    EXPECT_NEAR(expected_data[k], checkpoint_data[k], 1e-5);
+  }
+}
+
 }  // namespace
 
+TEST_F(MaceAPITest, PipelineMultiNet) {
+  MacePipelineRun(16, 4, {1, 16, 16, 8}, {8, 8, 3, 3});
+}
+
+TEST_F(MaceAPITest, InitCache) {
+  MaceInitCacheRun({1, 16, 16, 8}, {8, 8, 3, 3});
+}
+
+#ifdef MACE_ENABLE_BFLOAT16
+TEST_F(MaceAPITest, MixedPrecision) {
+  MaceMixedPrecisionRun({1, 16, 16, 8}, {8, 8, 3, 3});
+}
+#endif  // MACE_ENABLE_BFLOAT16
+
+TEST_F(MaceAPITest, CPUTuning) {
+  MaceCPUTuningRun({1, 16, 16, 8}, {8, 8, 3, 3});
+}
+
+TEST_F(MaceAPITest, NumaNode) {
+  MaceCPUConfigRun({1, 16, 16, 8}, {8, 8, 3, 3},
+                   {[](MaceEngineConfig *config) {
+                     config->SetCPUNumaNode(0);
+                   }});
+}
+
+TEST_F(MaceAPITest, HugePages) {
+  // The activations of 2MB could be backed by huge pages.
+  MaceCPUConfigRun({1, 128, 128, 32}, {32, 32, 3, 3},
+                   {[](MaceEngineConfig *config) {
+                     config->SetCPUHugePagePolicy(HUGE_PAGE_TRANSPARENT);
+                   },
+                   [](MaceEngineConfig *config) {
+                     config->SetCPUHugePagePolicy(HUGE_PAGE_EXPLICIT);
+                   }});
+}
+
+TEST_F(MaceAPITest, ConstTensorSharing) {
+  MaceConstTensorSharingRun({1, 16, 16, 8}, {8, 8, 3, 3});
+}
+
+TEST_F(MaceAPITest, RunAsync) {
+  MaceRunAsyncRun({1, 64, 64, 32}, {32, 32, 3, 3});
+}
+
+TEST_F(MaceAPITest, Checkpoint) {
+  MaceCheckpointRun({1, 32, 32, 16}, {16, 16, 3, 3});
+  // The channels are not a multiple of the NCHWc block.
+  MaceIntermediateCheckpointRun({1, 16, 16, 12});
+}
+
 TEST_F(MaceAPITest, SingleInputOutput) {
   MaceRun<RT_CPU, float>(1,
                          {1, 32, 32, 16},
@@ -368,6 +368,43 @@ TEST_F(ActivationOpTest, OPENCLSimpleSigmoid) {
   TestSimpleSigmoid<RuntimeType::RT_OPENCL>();
 }
 
+namespace {
+// A size that is not a multiple of the vector width, so the tails of the
+// vectorized kernels run too.
+void TestUnalignedTanhSigmoid(const char *type) {
+  const bool is_tanh = std::string(type) == "TANH";
+  std::vector<float> input_data(3 * 5 * 7);
+  std::vector<float> expected_data(input_data.size());
+  for (size_t i = 0; i < input_data.size(); ++i) {
+    input_data[i] = 0.25f * ((i * 11) % 61) - 7.5f;
+    expected_data[i] = is_tanh ? std::tanh(input_data[i])
+                               : 1.f / (1.f + std::exp(-input_data[i]));
+  }
+
+  OpsTestNet net;
+  net.AddInputFromArray<RT_CPU, float>("Input", {1, 3, 5, 7}, input_data);
+
+  OpDefBuilder("Activation", "ActivationTest")
+      .Input("Input")
+      .Output("Output")
+      .AddStringArg("activation", type)
+      .Finalize(net.NewOperatorDef());
+
+  net.RunOp();
+
+  auto expected = net.CreateTensor<float>({1, 3, 5, 7}, expected_data);
+  ExpectTensorNear<float>(*expected, *net.GetOutput("Output"), 1e-5);
+}
+}  // namespace
+
+TEST_F(ActivationOpTest, CPUUnalignedTanh) {
+  TestUnalignedTanhSigmoid("TANH");
+}
+
+TEST_F(ActivationOpTest, CPUUnalignedSigmoid) {
+  TestUnalignedTanhSigmoid("SIGMOID");
+}
+
 namespace {
 void TestQuantized(const index_t size, const char *type) {
   OpsTestNet net;
@@ -61,6 +61,52 @@ TEST_F(ArgMaxOpTest, Matrix) {
       {3, 3}, {4, 5, 6, 9, 8, 7, 1, 2, 3}, {3}, {2, 0, 2});
 }
 
+namespace {
+void ArgMaxAxisTest(const std::vector<index_t> &input_shape,
+                    const std::vector<float> &input,
+                    const int axis,
+                    const bool argmin,
+                    const std::vector<index_t> &output_shape,
+                    const std::vector<int32_t> &output) {
+  OpsTestNet net;
+
+  // Add input data
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>("Input", input_shape,
+                                                    input);
+  OpDefBuilder("ArgMax", "ArgMaxTest")
+      .Input("Input")
+      .Output("Output")
+      .AddIntArg("axis", axis)
+      .AddIntArg("argmin", argmin)
+      .AddIntArg("keepdims", 0)
+      .OutputType({DT_INT32})
+      .Finalize(net.NewOperatorDef());
+  // Run
+  net.RunOp(RuntimeType::RT_CPU);
+
+  // Check
+  auto expected = net.CreateTensor<int32_t>(output_shape, output);
+  ExpectTensorNear<int32_t>(*expected, *net.GetOutput("Output"), 1e-5);
+}
+}  // namespace
+
+TEST_F(ArgMaxOpTest, InnerAxis) {
+  ArgMaxAxisTest({2, 3, 2}, {1, 6, 5, 2, 3, 4, 9, 0, 7, 8, 9, 1},
+                 1, false, {2, 2}, {1, 0, 2, 1});
+  ArgMaxAxisTest({2, 3, 2}, {1, 6, 5, 2, 3, 4, 9, 0, 7, 8, 9, 1},
+                 1, true, {2, 2}, {0, 1, 1, 0});
+}
+
+TEST_F(ArgMaxOpTest, LongRow) {
+  std::vector<float> input(1001);
+  for (size_t i = 0; i < input.size(); ++i) {
+    input[i] = static_cast<float>((i * 37) % 1001);
+  }
+  // 1000 is at index 514, 0 is at index 0.
+  ArgMaxAxisTest({1, 1001}, input, -1, false, {1}, {514});
+  ArgMaxAxisTest({1, 1001}, input, -1, true, {1}, {0});
+}
+
 TEST_F(ArgMaxOpTest, HighRank) {
   ArgMaxTest<RuntimeType::RT_CPU>(
       {1, 2, 2, 3}, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11},
@@ -104,6 +104,140 @@ TEST_F(ConcatOpTest, CPUSimpleVertical) {
   }
 }
 
+TEST_F(ConcatOpTest, CPUInPlaceInputs) {
+  // Construct graph
+  OpsTestNet net;
+  std::vector<index_t> input_shape = {2, 3};
+  OpDefBuilder("Activation", "Relu0")
+      .Input("Input0")
+      .Output("Relu0")
+      .AddStringArg("activation", "RELU")
+      .OutputShape(input_shape)
+      .Finalize(net.AddNewOperatorDef());
+  OpDefBuilder("Activation", "Relu1")
+      .Input("Input1")
+      .Output("Relu1")
+      .AddStringArg("activation", "RELU")
+      .OutputShape(input_shape)
+      .Finalize(net.AddNewOperatorDef());
+  OpDefBuilder("Concat", "ConcatTest")
+      .Input("Relu0")
+      .Input("Relu1")
+      .AddIntArg("axis", 0)
+      .Output("Output")
+      .OutputShape({4, 3})
+      .Finalize(net.AddNewOperatorDef());
+
+  // Add inputs
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "Input0", input_shape, {-1, 2, -3, 4, -5, 6});
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "Input1", input_shape, {7, -8, 9, -10, 11, -12});
+
+  // Run
+  net.RunOp();
+
+  // The Relu outputs are written in place into the concat output.
+  auto output = net.GetOutput("Output");
+  const float *output_ptr = output->data<float>();
+  EXPECT_EQ(output_ptr, net.GetTensor("Relu0")->data<float>());
+  EXPECT_EQ(output_ptr + 6, net.GetTensor("Relu1")->data<float>());
+
+  auto expected = net.CreateTensor<float>(
+      {4, 3}, {0, 2, 0, 4, 0, 6, 7, 0, 9, 0, 11, 0});
+  ExpectTensorNear<float>(*expected, *output);
+}
+
+TEST_F(ConcatOpTest, CPUInPlaceInputsShrink) {
+  // Construct graph
+  OpsTestNet net;
+  std::vector<index_t> input_shape = {2, 3};
+  OpDefBuilder("Activation", "Relu0")
+      .Input("Input0")
+      .Output("Relu0")
+      .AddStringArg("activation", "RELU")
+      .OutputShape(input_shape)
+      .Finalize(net.AddNewOperatorDef());
+  OpDefBuilder("Activation", "Relu1")
+      .Input("Input1")
+      .Output("Relu1")
+      .AddStringArg("activation", "RELU")
+      .OutputShape(input_shape)
+      .Finalize(net.AddNewOperatorDef());
+  OpDefBuilder("Concat", "ConcatTest")
+      .Input("Relu0")
+      .Input("Relu1")
+      .AddIntArg("axis", 0)
+      .Output("Output")
+      .OutputShape({4, 3})
+      .Finalize(net.AddNewOperatorDef());
+
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "Input0", input_shape, {-1, 2, -3, 4, -5, 6});
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "Input1", input_shape, {7, -8, 9, -10, 11, -12});
+  net.Setup(RuntimeType::RT_CPU);
+  net.Run();
+  const float *output_ptr = net.GetOutput("Output")->data<float>();
+  EXPECT_EQ(output_ptr + 6, net.GetTensor("Relu1")->data<float>());
+
+  // The first input shrinks, so the second one is no longer at its offset
+  // in the output and must not be overwritten before it is moved.
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "Input0", {1, 3}, {-1, 2, -3});
+  net.Run();
+  EXPECT_NE(output_ptr, net.GetTensor("Relu0")->data<float>());
+
+  auto expected = net.CreateTensor<float>(
+      {3, 3}, {0, 2, 0, 7, 0, 9, 0, 11, 0});
+  ExpectTensorNear<float>(*expected, *net.GetOutput("Output"));
+}
+
+TEST_F(ConcatOpTest, CPUInPlaceInputsReshape) {
+  // Construct graph
+  OpsTestNet net;
+  std::vector<index_t> input_shape = {1, 6};
+  OpDefBuilder("Activation", "Relu0")
+      .Input("Input0")
+      .Output("Relu0")
+      .AddStringArg("activation", "RELU")
+      .OutputShape(input_shape)
+      .Finalize(net.AddNewOperatorDef());
+  OpDefBuilder("Activation", "Relu1")
+      .Input("Input1")
+      .Output("Relu1")
+      .AddStringArg("activation", "RELU")
+      .OutputShape(input_shape)
+      .Finalize(net.AddNewOperatorDef());
+  OpDefBuilder("Concat", "ConcatTest")
+      .Input("Relu0")
+      .Input("Relu1")
+      .AddIntArg("axis", 1)
+      .Output("Output")
+      .OutputShape({1, 12})
+      .Finalize(net.AddNewOperatorDef());
+
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "Input0", input_shape, {-1, 2, -3, 4, -5, 6});
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "Input1", input_shape, {7, -8, 9, -10, 11, -12});
+  net.Setup(RuntimeType::RT_CPU);
+  net.Run();
+
+  // The inputs keep their sizes, but they are no longer contiguous blocks
+  // of the output, so the second row of each input goes after the first
+  // row of the other one.
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "Input0", {2, 3}, {-1, 2, -3, 4, -5, 6});
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "Input1", {2, 3}, {7, -8, 9, -10, 11, -12});
+  net.Run();
+
+  auto expected = net.CreateTensor<float>(
+      {2, 6}, {0, 2, 0, 7, 0, 9, 4, 0, 6, 0, 11, 0});
+  ExpectTensorNear<float>(*expected, *net.GetOutput("Output"));
+}
+
 namespace {
 void CPURandomTest(int input_dim, int has_data_format) {
   static unsigned int seed = time(NULL);
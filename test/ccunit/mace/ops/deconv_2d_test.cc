@@ -313,6 +313,102 @@ void TestNHWCSimple2x2VALID() {
        2.f, 2.f, 1.f, 1.f, 2.f, 1.f, 1.f, 1.f, 1.f, 2.f, 1.f, 1.f},
       FrameworkType::TENSORFLOW);
 }
+
+void TestGemmCol2im(const std::vector<index_t> &input_shape,
+                    const index_t out_channels,
+                    const int kernel,
+                    const int stride,
+                    const int padding,
+                    const int group = 1) {
+  OpsTestNet net;
+  const index_t batch = input_shape[0];
+  const index_t in_channels = input_shape[1];
+  const index_t in_height = input_shape[2];
+  const index_t in_width = input_shape[3];
+  const index_t in_channels_g = in_channels / group;
+  const index_t out_channels_g = out_channels / group;
+
+  // The filter is [out_channels_g, in_channels, kernel, kernel], so that of
+  // a depthwise deconvolution is [1, channels, kernel, kernel].
+  net.AddRandomInput<RuntimeType::RT_CPU, float>("Input", input_shape);
+  net.AddRandomInput<RuntimeType::RT_CPU, float>(
+      "Filter", {out_channels_g, in_channels, kernel, kernel}, true);
+  net.AddRandomInput<RuntimeType::RT_CPU, float>(
+      "Bias", {out_channels}, true);
+
+  if (group == 1) {
+    OpDefBuilder("Deconv2D", "Deconv2dTest")
+        .Input("Input")
+        .Input("Filter")
+        .Input("Bias")
+        .Output("Output")
+        .AddIntsArg("strides", {stride, stride})
+        .AddIntArg("padding", Padding::VALID)
+        .AddIntsArg("padding_values", {padding, padding})
+        .AddIntArg("framework_type", FrameworkType::CAFFE)
+        .Finalize(net.NewOperatorDef());
+  } else {
+    OpDefBuilder("DepthwiseDeconv2d", "DepthwiseDeconv2dTest")
+        .Input("Input")
+        .Input("Filter")
+        .Input("Bias")
+        .Output("Output")
+        .AddIntArg("group", group)
+        .AddIntsArg("strides", {stride, stride})
+        .AddIntsArg("padding_values", {padding, padding})
+        .Finalize(net.NewOperatorDef());
+  }
+  net.RunOp(RuntimeType::RT_CPU);
+
+  // Scatter every input pixel to the full output, then crop the padding.
+  const index_t full_height = (in_height - 1) * stride + kernel;
+  const index_t full_width = (in_width - 1) * stride + kernel;
+  const index_t out_height = full_height - padding;
+  const index_t out_width = full_width - padding;
+  const index_t pad_begin = padding / 2;
+  auto input = net.GetTensor("Input")->data<float>();
+  auto filter = net.GetTensor("Filter")->data<float>();
+  auto bias = net.GetTensor("Bias")->data<float>();
+  std::vector<float> full(batch * out_channels * full_height * full_width, 0);
+  for (index_t b = 0; b < batch; ++b) {
+    for (index_t oc = 0; oc < out_channels; ++oc) {
+      float *full_base =
+          full.data() + (b * out_channels + oc) * full_height * full_width;
+      const index_t g = oc / out_channels_g;
+      const index_t p = oc % out_channels_g;
+      for (index_t ic = g * in_channels_g; ic < (g + 1) * in_channels_g;
+           ++ic) {
+        for (index_t h = 0; h < in_height; ++h) {
+          for (index_t w = 0; w < in_width; ++w) {
+            const float val = input[((b * in_channels + ic) * in_height + h)
+                * in_width + w];
+            for (index_t kh = 0; kh < kernel; ++kh) {
+              for (index_t kw = 0; kw < kernel; ++kw) {
+                full_base[(h * stride + kh) * full_width + w * stride + kw] +=
+                    val * filter[((p * in_channels + ic) * kernel + kh)
+                        * kernel + kw];
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+  std::vector<float> expected_data;
+  for (index_t n = 0; n < batch * out_channels; ++n) {
+    for (index_t h = 0; h < out_height; ++h) {
+      for (index_t w = 0; w < out_width; ++w) {
+        expected_data.push_back(
+            full[(n * full_height + h + pad_begin) * full_width + w
+                + pad_begin] + bias[n % out_channels]);
+      }
+    }
+  }
+
+  auto expected = net.CreateTensor<float>(
+      {batch, out_channels, out_height, out_width}, expected_data);
+  ExpectTensorNear<float>(*expected, *net.GetOutput("Output"), 1e-4, 1e-4);
+}
 }  // namespace
 
 TEST_F(Deconv2dOpTest, CPUSimple3X3PaddingSame_S1) {
@@ -343,6 +439,31 @@ TEST_F(Deconv2dOpTest, CPUSimple3X3PaddingValid_S2) {
   TestNHWCSimple3x3VALID_S2<RuntimeType::RT_CPU>();
 }
 
+TEST_F(Deconv2dOpTest, CPUGemmCol2im) {
+  // The input rows are split into several column tiles.
+  TestGemmCol2im({1, 3, 23, 37}, 5, 3, 1, 2);
+  TestGemmCol2im({2, 7, 19, 41}, 4, 4, 2, 2);
+  TestGemmCol2im({1, 4, 30, 20}, 3, 5, 2, 0);
+  TestGemmCol2im({1, 8, 17, 64}, 2, 8, 4, 4);
+  TestGemmCol2im({1, 2, 9, 300}, 6, 2, 2, 0);
+}
+
+TEST_F(Deconv2dOpTest, CPUGroupGemmCol2im) {
+  TestGemmCol2im({1, 6, 23, 37}, 4, 3, 1, 2, 2);
+  TestGemmCol2im({2, 4, 19, 41}, 6, 5, 2, 2, 2);
+  TestGemmCol2im({1, 9, 30, 20}, 6, 4, 2, 0, 3);
+  TestGemmCol2im({1, 8, 17, 64}, 4, 8, 4, 4, 4);
+}
+
+// The depthwise deconvolution has its own direct kernel, threaded over the
+// batch and the channels.
+TEST_F(Deconv2dOpTest, CPUDepthwise) {
+  TestGemmCol2im({1, 5, 29, 33}, 5, 3, 1, 2, 5);
+  TestGemmCol2im({2, 3, 31, 70}, 3, 5, 2, 4, 3);
+  TestGemmCol2im({1, 4, 30, 20}, 4, 4, 2, 0, 4);
+  TestGemmCol2im({1, 2, 17, 64}, 2, 8, 4, 4, 2);
+}
+
 TEST_F(Deconv2dOpTest, OPENCLSimple2X2PaddingSame) {
   TestNHWCSimple2x2SAME<RuntimeType::RT_OPENCL>();
 }
@@ -0,0 +1,73 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mace/ops/ops_test_util.h"
+
+namespace mace {
+namespace ops {
+namespace test {
+
+class DetectionOutputOpTest : public OpsTestBase {};
+
+namespace {
+void TestDetectionOutput(const int fast_nms,
+                         const std::vector<index_t> &expected_shape,
+                         const std::vector<float> &expected_data) {
+  OpsTestNet net;
+  // Zero locations, so the boxes are the prior boxes.
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "Location", {1, 16}, std::vector<float>(16, 0.f));
+  // Background and one class for each of the 4 priors.
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "Confidence", {1, 8}, {0.1, 0.9, 0.2, 0.8, 0.3, 0.7, 0.9, 0.04});
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "PriorBox", {1, 2, 16},
+      {0, 0, 1, 1, 0.2, 0, 1.2, 1, 0.5, 0, 1.5, 1, 2, 2, 3, 3,
+       0.1, 0.1, 0.2, 0.2, 0.1, 0.1, 0.2, 0.2,
+       0.1, 0.1, 0.2, 0.2, 0.1, 0.1, 0.2, 0.2});
+
+  OpDefBuilder("DetectionOutput", "DetectionOutputTest")
+      .Input("Location")
+      .Input("Confidence")
+      .Input("PriorBox")
+      .Output("Output")
+      .AddIntArg("num_classes", 2)
+      .AddFloatArg("nms_threshold", 0.5)
+      .AddIntArg("nms_top_k", 100)
+      .AddIntArg("keep_top_k", 100)
+      .AddFloatArg("confidence_threshold", 0.05)
+      .AddIntArg("fast_nms", fast_nms)
+      .Finalize(net.NewOperatorDef());
+
+  net.RunOp(RuntimeType::RT_CPU);
+
+  auto expected = net.CreateTensor<float>(expected_shape, expected_data);
+  ExpectTensorNear<float>(*expected, *net.GetOutput("Output"), 1e-5);
+}
+}  // namespace
+
+TEST_F(DetectionOutputOpTest, GreedyNms) {
+  // The third box overlaps the suppressed second box only.
+  TestDetectionOutput(0, {1, 1, 2, 7},
+                      {0, 1, 0.9, 0, 0, 1, 1,
+                       0, 1, 0.7, 0.5, 0, 1.5, 1});
+}
+
+TEST_F(DetectionOutputOpTest, FastNms) {
+  TestDetectionOutput(1, {1, 1, 1, 7}, {0, 1, 0.9, 0, 0, 1, 1});
+}
+
+}  // namespace test
+}  // namespace ops
+}  // namespace mace
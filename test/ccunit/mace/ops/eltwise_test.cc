@@ -495,6 +495,11 @@ TEST_F(EltwiseOpTest, CPUSimpleTensorTensor) {
   SimpleTensorEltwise<RuntimeType::RT_CPU, float, float>(
       ops::EltwiseType::FLOOR_DIV, {1, 2, 1, 3}, {-2, -3, -4, -5, -6, -7},
       {1, 2, 1, 3}, {1, 2, 3, 4, 5, 6}, {-2, -2, -2, -2, -2, -2});
+  // The quotients are exact, they must not be rounded down by FLOOR_DIV.
+  SimpleTensorEltwise<RuntimeType::RT_CPU, float, float>(
+      ops::EltwiseType::FLOOR_DIV, {1, 2, 1, 4},
+      {13, 26, 39, 52, 65, 78, 91, 104}, {1, 2, 1, 4},
+      {13, 13, 13, 13, 13, 13, 13, 13}, {1, 2, 3, 4, 5, 6, 7, 8});
   SimpleTensorEltwise<RuntimeType::RT_CPU, float, float>(
       ops::EltwiseType::MIN, {1, 2, 1, 5}, {1, 2, 3, 4, 5, 1, 2, 3, 4, 5},
       {1, 2, 1, 5}, {1, 2, 3, 4, 5, 6, 7, 8, 9, 10},
@@ -977,6 +982,66 @@ TEST_F(EltwiseOpTest, TensorGeneralBroadcastCPU) {
       {1, 1, 2, 1}, {1, 2}, {1, 1, 2, 3}, {1, 0, 0, 0, 0, 0});
 }
 
+TEST_F(EltwiseOpTest, CPUMutualBroadcast) {
+  TensorGeneralBroadcastEltwise<RuntimeType::RT_CPU, float, float>(
+      ops::EltwiseType::SUM, {2, 1, 3}, {1, 2, 3, 4, 5, 6}, {2, 1},
+      {10, 20}, {2, 2, 3},
+      {11, 12, 13, 21, 22, 23, 14, 15, 16, 24, 25, 26});
+  TensorGeneralBroadcastEltwise<RuntimeType::RT_CPU, float, float>(
+      ops::EltwiseType::SUB, {2, 1}, {10, 20}, {2, 1, 3},
+      {1, 2, 3, 4, 5, 6}, {2, 2, 3},
+      {9, 8, 7, 19, 18, 17, 6, 5, 4, 16, 15, 14});
+  TensorGeneralBroadcastEltwise<RuntimeType::RT_CPU, float, float>(
+      ops::EltwiseType::DIV, {1, 2, 1}, {2, -4}, {3, 1, 2},
+      {1, 2, 4, 8, 16, 32}, {3, 2, 2},
+      {2, 1, -4, -2, 0.5, 0.25, -1, -0.5, 0.125, 0.0625, -0.25, -0.125});
+  TensorGeneralBroadcastEltwise<RuntimeType::RT_CPU, float, float>(
+      ops::EltwiseType::FLOOR_DIV, {2, 1, 3}, {1, 2, 3, 4, 5, 6}, {2, 1},
+      {2, -2}, {2, 2, 3},
+      {0, 1, 1, -1, -1, -2, 2, 2, 3, -2, -3, -3});
+}
+
+TEST_F(EltwiseOpTest, CPUInPlace) {
+  // Construct graph
+  OpsTestNet net;
+  std::vector<index_t> input_shape = {2, 3, 7};
+  OpDefBuilder("Activation", "Relu")
+      .Input("Input0")
+      .Output("Relu")
+      .AddStringArg("activation", "RELU")
+      .OutputShape(input_shape)
+      .Finalize(net.AddNewOperatorDef());
+  OpDefBuilder("Eltwise", "EltwiseTest")
+      .Input("Relu")
+      .Input("Input1")
+      .AddIntArg("type", static_cast<int>(ops::EltwiseType::PROD))
+      .Output("Output")
+      .OutputShape(input_shape)
+      .Finalize(net.AddNewOperatorDef());
+
+  // Add inputs
+  std::vector<float> input0(42);
+  std::vector<float> expected_data(42);
+  for (index_t i = 0; i < 42; ++i) {
+    input0[i] = i % 2 == 0 ? i : -i;
+    expected_data[i] = i % 2 == 0 ? i * (i % 7) : 0;
+  }
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "Input0", input_shape, input0);
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "Input1", {7}, {0, 1, 2, 3, 4, 5, 6});
+
+  // Run
+  net.RunOp();
+
+  // The product is written over the Relu output.
+  auto output = net.GetOutput("Output");
+  EXPECT_EQ(output->data<float>(), net.GetTensor("Relu")->data<float>());
+
+  auto expected = net.CreateTensor<float>(input_shape, expected_data);
+  ExpectTensorNear<float>(*expected, *output);
+}
+
 TEST_F(EltwiseOpTest, TensorGeneralBroadcastGPU) {
   TensorGeneralBroadcastEltwise<RuntimeType::RT_OPENCL, float, float>(
       ops::EltwiseType::SUM, {1, 1, 2, 3}, {1, 2, 3, 4, 5, 6}, {1, 1, 2, 1},
@@ -69,6 +69,46 @@ void Simple(const std::vector<index_t> &input_shape,
 
   ExpectTensorNear<float>(*expected, *net.GetOutput("Output"), 1e-5);
 }
+
+void CPURandom(const index_t batch,
+               const index_t channels,
+               const index_t height,
+               const index_t width,
+               const index_t out_channel) {
+  OpsTestNet net;
+  net.AddRandomInput<RuntimeType::RT_CPU, float>(
+      "Input", {batch, channels, height, width}, false, false);
+  net.AddRandomInput<RuntimeType::RT_CPU, float>(
+      "Weight", {out_channel, channels, height, width}, true, false);
+  net.AddRandomInput<RuntimeType::RT_CPU, float>(
+      "Bias", {out_channel}, true, false);
+
+  OpDefBuilder("FullyConnected", "FullyConnectedTest")
+      .Input("Input")
+      .Input("Weight")
+      .Input("Bias")
+      .Output("Output")
+      .Finalize(net.NewOperatorDef());
+  net.RunOp(RuntimeType::RT_CPU);
+
+  const index_t input_size = channels * height * width;
+  auto input = net.GetTensor("Input")->data<float>();
+  auto weight = net.GetTensor("Weight")->data<float>();
+  auto bias = net.GetTensor("Bias")->data<float>();
+  std::vector<float> expected_data;
+  for (index_t b = 0; b < batch; ++b) {
+    for (index_t o = 0; o < out_channel; ++o) {
+      float sum = bias[o];
+      for (index_t i = 0; i < input_size; ++i) {
+        sum += input[b * input_size + i] * weight[o * input_size + i];
+      }
+      expected_data.push_back(sum);
+    }
+  }
+  auto expected = net.CreateTensor<float>({batch, out_channel, 1, 1},
+                                          expected_data);
+  ExpectTensorNear<float>(*expected, *net.GetOutput("Output"), 1e-4, 1e-4);
+}
 }  // namespace
 
 TEST_F(FullyConnectedOpTest, SimpleCPU) {
@@ -92,6 +132,14 @@ TEST_F(FullyConnectedOpTest, SimpleCPUWithBatch) {
       {1, 2, 3, 4}, {1}, {2}, {2, 1, 1, 1}, {32, 72});
 }
 
+TEST_F(FullyConnectedOpTest, RandomCPU) {
+  // Below and above the batch size where the GEMM is used.
+  CPURandom(1, 3, 5, 7, 13);
+  CPURandom(3, 16, 4, 4, 32);
+  CPURandom(4, 3, 5, 7, 13);
+  CPURandom(9, 16, 4, 4, 33);
+}
+
 TEST_F(FullyConnectedOpTest, SimpleOPENCL) {
   Simple<RuntimeType::RT_OPENCL>(
       {1, 2, 2, 2}, {1, 2, 3, 4, 5, 6, 7, 8}, {1, 2, 2, 2},
@@ -116,6 +116,7 @@ void Complex(const std::vector<index_t> &batch,
       MACE_DELEGATOR_KEY(Gemm, RuntimeType::RT_CPU, float, ImplType::REF),
       delegator::GemmParam());
   auto cpu_runtime = OpTestContext::Get()->GetRuntime(RuntimeType::RT_CPU);
+  OpContext context(net.ws(), cpu_runtime);
   Tensor expected_output_tensor(cpu_runtime, DT_FLOAT);
   std::vector<index_t> expected_output_shape({rows, cols});
   expected_output_shape.insert(expected_output_shape.begin(),
@@ -124,7 +125,7 @@ void Complex(const std::vector<index_t> &batch,
   expected_output_tensor.Resize(expected_output_shape);
   index_t batch_count = std::accumulate(batch.begin(), batch.end(), 1,
                                         std::multiplies<index_t>());
-  gemm->Compute(nullptr,
+  gemm->Compute(&context,
                 net.GetTensor("A"),
                 net.GetTensor("B"),
                 batch_count,
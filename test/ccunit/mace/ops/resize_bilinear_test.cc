@@ -83,6 +83,40 @@ TEST_F(ResizeBilinearTest, ResizeBilinearWAlignCorners) {
   ExpectTensorNear<float>(*expected, *net.GetOutput("Output"), 1e-5);
 }
 
+TEST_F(ResizeBilinearTest, CPUResizeBilinearChangeSize) {
+  testing::internal::LogToStderr();
+  // Construct graph
+  OpsTestNet net;
+
+  // Add input data
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>("Input", {1, 1, 2, 2},
+                                                    {0, 1, 2, 3});
+  net.AddInputFromArray<RuntimeType::RT_CPU, int32_t>("Size", {2}, {4, 4});
+
+  OpDefBuilder("ResizeBilinear", "ResizeBilinearTest")
+      .Input("Input")
+      .Input("Size")
+      .Output("Output")
+      .Finalize(net.NewOperatorDef());
+
+  // Run
+  net.Setup(RuntimeType::RT_CPU);
+  net.Run();
+
+  // Check
+  auto expected = net.CreateTensor<float>(
+      {1, 1, 4, 4},
+      {0, 0.5, 1, 1, 1, 1.5, 2, 2, 2, 2.5, 3, 3, 2, 2.5, 3, 3});
+  ExpectTensorNear<float>(*expected, *net.GetOutput("Output"), 1e-5);
+
+  // Run the same op with another size, the cached tables are rebuilt.
+  net.AddInputFromArray<RuntimeType::RT_CPU, int32_t>("Size", {2}, {1, 2});
+  net.Run();
+
+  expected = net.CreateTensor<float>({1, 1, 1, 2}, {0, 1});
+  ExpectTensorNear<float>(*expected, *net.GetOutput("Output"), 1e-5);
+}
+
 namespace {
 template <RuntimeType D>
 void TestRandomResizeBilinear() {
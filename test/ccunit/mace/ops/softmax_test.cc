@@ -102,6 +102,64 @@ TEST_F(SoftmaxOpTest, OPENCLSimple) { Simple<RuntimeType::RT_OPENCL>(); }
 TEST_F(LogSoftmaxOpTest, CPUSimple) { Simple<RuntimeType::RT_CPU>(true); }
 TEST_F(LogSoftmaxOpTest, OPENCLSimple) { Simple<RuntimeType::RT_OPENCL>(true); }
 
+namespace {
+// A class size that is not a multiple of the vector width, so the tails of
+// the vectorized max, exp, sum and log run too.
+void CPUUnAligned(bool use_log = false) {
+  const index_t rows = 15;
+  const index_t class_size = 13;
+  std::vector<float> input_data(rows * class_size);
+  std::vector<float> expected_data(rows * class_size);
+  for (index_t r = 0; r < rows; ++r) {
+    float sum = 0.f;
+    for (index_t c = 0; c < class_size; ++c) {
+      input_data[r * class_size + c] = 0.5f * ((r * 7 + c * 5) % 23) - 5.f;
+      sum += std::exp(input_data[r * class_size + c]);
+    }
+    for (index_t c = 0; c < class_size; ++c) {
+      const float output = std::exp(input_data[r * class_size + c]) / sum;
+      expected_data[r * class_size + c] = use_log ? std::log(output) : output;
+    }
+  }
+
+  OpsTestNet net;
+  net.AddInputFromArray<RT_CPU, float>("Input", {1, 3, 5, class_size},
+                                       input_data);
+  auto expected = net.CreateTensor<float>({1, 3, 5, class_size},
+                                          expected_data);
+
+  // 4d softmax, computed in NCHW
+  net.TransformDataFormat<RuntimeType::RT_CPU, float>(
+      "Input", DataFormat::NHWC, "InputNCHW", DataFormat::NCHW);
+  OpDefBuilder("Softmax", "SoftmaxTest")
+      .Input("InputNCHW")
+      .Output("OutputNCHW")
+      .AddIntArg("has_data_format", 1)
+      .AddIntArg("use_log", static_cast<int>(use_log))
+      .Finalize(net.NewOperatorDef());
+  net.RunOp();
+  net.TransformDataFormat<RuntimeType::RT_CPU, float>(
+      "OutputNCHW", DataFormat::NCHW, "Output", DataFormat::NHWC);
+  ExpectTensorNear<float>(*expected, *net.GetOutput("Output"), 1e-5);
+
+  // 2d softmax, computed on the last axis
+  net.AddInputFromArray<RT_CPU, float>("Input2d", {rows, class_size},
+                                       input_data);
+  OpDefBuilder("Softmax", "SoftmaxTest")
+      .Input("Input2d")
+      .Output("Output")
+      .AddIntArg("use_log", static_cast<int>(use_log))
+      .Finalize(net.NewOperatorDef());
+  net.RunOp();
+  net.GetOutput("Output")->Reshape({1, 3, 5, class_size});
+  ExpectTensorNear<float>(*expected, *net.GetOutput("Output"), 1e-5);
+}
+}  // namespace
+
+TEST_F(SoftmaxOpTest, CPUUnAligned) { CPUUnAligned(); }
+
+TEST_F(LogSoftmaxOpTest, CPUUnAligned) { CPUUnAligned(true); }
+
 namespace {
 template <RuntimeType D>
 void Complex(const std::vector<index_t> &logits_shape,
@@ -275,6 +275,15 @@ TEST_F(StridedSliceOpTest, TestStridedSliceRank4) {
                    {23, 22});
 }
 
+TEST_F(StridedSliceOpTest, TestStridedSliceRank5) {
+  TestStridedSlice({1, 2, 1, 2, 3}, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11},
+                   {0, 1, 0, 0, 0}, {1, 2, 1, 2, 3}, {1, 1, 1, 1, 2},
+                   0, 0, 0, 0, 0, {1, 1, 1, 2, 2}, {6, 8, 9, 11});
+  TestStridedSlice({1, 2, 1, 2, 3}, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11},
+                   {0, 1, 0, 1, 2}, {1, 0, 1, 0, 0}, {1, -1, 1, -1, -1},
+                   0, 8, 0, 0, 1, {1, 1, 2, 2}, {11, 10, 8, 7});
+}
+
 TEST_F(StridedSliceOpTest, TestStridedSliceWithDataFormat) {
   TestStridedSliceWithDataFormat(
                    {2, 2, 2, 3}, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13,
@@ -0,0 +1,115 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <numeric>
+
+#include "mace/ops/ops_test_util.h"
+
+namespace mace {
+namespace ops {
+namespace test {
+
+class TopKOpTest : public OpsTestBase {};
+
+namespace {
+void TopKTest(const std::vector<index_t> &input_shape,
+              const std::vector<float> &input,
+              const int k,
+              const int axis,
+              const int largest,
+              const std::vector<index_t> &output_shape,
+              const std::vector<float> &values,
+              const std::vector<int32_t> &indices) {
+  OpsTestNet net;
+
+  // Add input data
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>("Input", input_shape,
+                                                    input);
+  OpDefBuilder("TopK", "TopKTest")
+      .Input("Input")
+      .Output("Values")
+      .Output("Indices")
+      .AddIntArg("k", k)
+      .AddIntArg("axis", axis)
+      .AddIntArg("largest", largest)
+      .OutputType({DT_FLOAT, DT_INT32})
+      .Finalize(net.NewOperatorDef());
+
+  // Run
+  net.RunOp(RuntimeType::RT_CPU);
+
+  // Check
+  auto expected_values = net.CreateTensor<float>(output_shape, values);
+  ExpectTensorNear<float>(*expected_values, *net.GetOutput("Values"));
+  auto expected_indices = net.CreateTensor<int32_t>(output_shape, indices);
+  ExpectTensorNear<int32_t>(*expected_indices, *net.GetOutput("Indices"));
+}
+
+void TopKRandomTest(const index_t outer, const index_t axis_dim,
+                    const int k) {
+  OpsTestNet net;
+  net.AddRandomInput<RuntimeType::RT_CPU, float>("Input", {outer, axis_dim});
+  net.AddInputFromArray<RuntimeType::RT_CPU, int32_t>("K", {}, {k});
+  OpDefBuilder("TopK", "TopKTest")
+      .Input("Input")
+      .Input("K")
+      .Output("Values")
+      .Output("Indices")
+      .OutputType({DT_FLOAT, DT_INT32})
+      .Finalize(net.NewOperatorDef());
+  net.RunOp(RuntimeType::RT_CPU);
+
+  const float *input = net.GetTensor("Input")->data<float>();
+  Tensor *values = net.GetOutput("Values");
+  Tensor *indices = net.GetOutput("Indices");
+  ASSERT_EQ(values->dim(1), k);
+  const float *values_data = values->data<float>();
+  const int32_t *indices_data = indices->data<int32_t>();
+  std::vector<int> order(axis_dim);
+  for (index_t i = 0; i < outer; ++i) {
+    const float *row = input + i * axis_dim;
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [row](int a, int b) {
+      return row[a] > row[b];
+    });
+    for (int j = 0; j < k; ++j) {
+      EXPECT_EQ(order[j], indices_data[i * k + j]);
+      EXPECT_EQ(row[order[j]], values_data[i * k + j]);
+    }
+  }
+}
+}  // namespace
+
+TEST_F(TopKOpTest, Simple) {
+  TopKTest({2, 4}, {1, 4, 2, 4, 7, 5, 6, 8}, 2, -1, 1,
+           {2, 2}, {4, 4, 8, 7}, {1, 3, 3, 0});
+  TopKTest({2, 4}, {1, 4, 2, 4, 7, 5, 6, 8}, 3, 1, 0,
+           {2, 3}, {1, 2, 4, 5, 6, 7}, {0, 2, 1, 1, 2, 0});
+}
+
+TEST_F(TopKOpTest, Axis) {
+  TopKTest({3, 2}, {1, 6, 5, 2, 3, 4}, 2, 0, 1,
+           {2, 2}, {5, 6, 3, 4}, {1, 0, 2, 2});
+}
+
+TEST_F(TopKOpTest, Random) {
+  TopKRandomTest(3, 1000, 5);
+  TopKRandomTest(4, 37, 30);
+  TopKRandomTest(2, 64, 64);
+}
+
+}  // namespace test
+}  // namespace ops
+}  // namespace mace
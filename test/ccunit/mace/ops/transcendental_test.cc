@@ -0,0 +1,152 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <vector>
+
+#include "mace/ops/common/transcendental.h"
+
+namespace mace {
+namespace ops {
+namespace test {
+
+namespace {
+const float kInf = std::numeric_limits<float>::infinity();
+const float kNaN = std::numeric_limits<float>::quiet_NaN();
+
+// The sizes cover the vector body and all the tail lengths.
+void TestFunction(
+    const std::function<void(const float *, float *, index_t)> &func,
+    const std::function<double(double)> &expected_func,
+    const float min, const float max, const double rel_error,
+    const double abs_error) {
+  for (index_t size : {1, 3, 7, 15, 16, 17, 33, 1000, 100001}) {
+    std::vector<float> input(size);
+    for (index_t i = 0; i < size; ++i) {
+      input[i] = size == 1 ? min : min + (max - min) * i / (size - 1);
+    }
+    std::vector<float> output(size);
+    func(input.data(), output.data(), size);
+    for (index_t i = 0; i < size; ++i) {
+      const double expected = expected_func(input[i]);
+      EXPECT_NEAR(expected, output[i],
+                  rel_error * std::abs(expected) + abs_error)
+          << "input " << input[i];
+    }
+    // In place.
+    func(input.data(), input.data(), size);
+    for (index_t i = 0; i < size; ++i) {
+      EXPECT_EQ(output[i], input[i]);
+    }
+  }
+}
+
+void ExpectSpecialValues(
+    const std::function<void(const float *, float *, index_t)> &func,
+    const std::vector<float> &input, const std::vector<float> &expected) {
+  std::vector<float> output(input.size());
+  func(input.data(), output.data(), input.size());
+  for (size_t i = 0; i < input.size(); ++i) {
+    if (std::isnan(expected[i])) {
+      EXPECT_TRUE(std::isnan(output[i])) << "input " << input[i];
+    } else {
+      EXPECT_FLOAT_EQ(expected[i], output[i]) << "input " << input[i];
+    }
+  }
+}
+}  // namespace
+
+TEST(TranscendentalTest, Exp) {
+  TestFunction(VectorExp, [](double x) { return std::exp(x); },
+               -87.f, 88.7f, 5e-7, 0);
+  ExpectSpecialValues(VectorExp,
+                      {0.f, 1.f, 100.f, -100.f, kInf, -kInf, kNaN},
+                      {1.f, std::exp(1.f), kInf, 0.f, kInf, 0.f, kNaN});
+}
+
+TEST(TranscendentalTest, Log) {
+  TestFunction(VectorLog, [](double x) { return std::log(x); },
+               1e-3f, 1e3f, 0, 3e-7);
+  TestFunction(VectorLog, [](double x) { return std::log(x); },
+               1e-40f, 1e-38f, 2e-7, 0);
+  ExpectSpecialValues(VectorLog,
+                      {1.f, 0.f, -0.f, -1.f, kInf, -kInf, kNaN},
+                      {0.f, -kInf, -kInf, kNaN, kInf, kNaN, kNaN});
+}
+
+TEST(TranscendentalTest, Tanh) {
+  TestFunction(VectorTanh, [](double x) { return std::tanh(x); },
+               -10.f, 10.f, 0, 5e-7);
+  ExpectSpecialValues(VectorTanh, {0.f, 100.f, kInf, -kInf, kNaN},
+                      {0.f, 1.f, 1.f, -1.f, kNaN});
+}
+
+TEST(TranscendentalTest, Sigmoid) {
+  TestFunction(VectorSigmoid,
+               [](double x) { return 1 / (1 + std::exp(-x)); },
+               -20.f, 20.f, 0, 2e-7);
+  ExpectSpecialValues(VectorSigmoid, {0.f, 100.f, kInf, kNaN},
+                      {0.5f, 1.f, 1.f, kNaN});
+}
+
+TEST(TranscendentalTest, Erf) {
+  TestFunction(VectorErf, [](double x) { return std::erf(x); },
+               -5.f, 5.f, 0, 4e-7);
+  ExpectSpecialValues(VectorErf, {0.f, 10.f, kInf, -kInf, kNaN},
+                      {0.f, 1.f, 1.f, -1.f, kNaN});
+}
+
+TEST(TranscendentalTest, Pow) {
+  auto pow_scalar_exponent = [](const float *src, float *dst, index_t size) {
+    VectorPow(src, 2.5f, dst, size);
+  };
+  TestFunction(pow_scalar_exponent,
+               [](double x) { return std::pow(x, 2.5); },
+               1e-2f, 1e2f, 2e-6, 0);
+  auto pow_scalar_base = [](const float *src, float *dst, index_t size) {
+    VectorPow(3.f, src, dst, size);
+  };
+  TestFunction(pow_scalar_base, [](double x) { return std::pow(3., x); },
+               -20.f, 20.f, 2e-6, 0);
+
+  // The elements out of the domain of log are the same as std::pow.
+  const std::vector<float> base = {2.f, -2.f, -2.f, 0.f, 0.f, kInf, 1.f,
+                                   kNaN, 4.f};
+  const std::vector<float> exponent = {10.f, 3.f, 0.5f, 2.f, -1.f, -1.f,
+                                       kNaN, 0.f, 0.5f};
+  std::vector<float> expected(base.size());
+  for (size_t i = 0; i < base.size(); ++i) {
+    expected[i] = std::pow(base[i], exponent[i]);
+  }
+  std::vector<float> output(base.size());
+  VectorPow(base.data(), exponent.data(), output.data(), base.size());
+  for (size_t i = 0; i < base.size(); ++i) {
+    if (std::isnan(expected[i])) {
+      EXPECT_TRUE(std::isnan(output[i])) << base[i] << "^" << exponent[i];
+    } else if (std::isinf(expected[i])) {
+      EXPECT_EQ(expected[i], output[i]) << base[i] << "^" << exponent[i];
+    } else {
+      EXPECT_NEAR(expected[i], output[i], 1e-6 * std::abs(expected[i]))
+          << base[i] << "^" << exponent[i];
+    }
+  }
+}
+
+}  // namespace test
+}  // namespace ops
+}  // namespace mace
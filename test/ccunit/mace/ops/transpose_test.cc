@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include "mace/ops/ops_test_util.h"
+#include "mace/ops/testing/test_utils.h"
+#include "mace/utils/transpose.h"
 
 namespace mace {
 namespace ops {
@@ -159,6 +161,111 @@ Transpose3DTest({2, 3, 2},
                 {1, 7, 3, 9, 5, 11, 2, 8, 4, 10, 6, 12});
 }
 
+namespace {
+void TransposeRandomTest(const std::vector<index_t> &input_shape,
+                         const std::vector<int> &dest_dims) {
+  // Construct graph
+  OpsTestNet net;
+  // Add input data
+  net.AddRandomInput<RuntimeType::RT_CPU, float>("Input", input_shape);
+
+  OpDefBuilder("Transpose", "TransposeRandomTest")
+      .Input("Input")
+      .Output("Output")
+      .AddIntsArg("dims", dest_dims)
+      .Finalize(net.NewOperatorDef());
+
+  // Run on cpu
+  net.RunOp();
+
+  const size_t rank = input_shape.size();
+  std::vector<index_t> output_shape(rank);
+  std::vector<index_t> in_stride(rank, 1);
+  for (size_t i = 0; i < rank; ++i) {
+    output_shape[i] = input_shape[dest_dims[i]];
+  }
+  for (int i = static_cast<int>(rank) - 2; i >= 0; --i) {
+    in_stride[i] = in_stride[i + 1] * input_shape[i + 1];
+  }
+  Tensor *input = net.GetTensor("Input");
+  const float *input_data = input->data<float>();
+  std::vector<float> expected_data(input->size());
+  for (index_t o = 0; o < input->size(); ++o) {
+    index_t in_offset = 0;
+    index_t remain = o;
+    for (int i = static_cast<int>(rank) - 1; i >= 0; --i) {
+      in_offset += (remain % output_shape[i]) * in_stride[dest_dims[i]];
+      remain /= output_shape[i];
+    }
+    expected_data[o] = input_data[in_offset];
+  }
+
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "ExpectedOutput", output_shape, expected_data);
+
+  ExpectTensorNear<float>(*net.GetOutput("ExpectedOutput"),
+                          *net.GetOutput("Output"));
+}
+}  // namespace
+
+TEST_F(TransposeOpTest, RandomRankN) {
+  TransposeRandomTest({67, 45}, {1, 0});
+  TransposeRandomTest({1, 5}, {1, 0});
+  TransposeRandomTest({3, 37, 70}, {2, 1, 0});
+  TransposeRandomTest({2, 33, 9, 17}, {0, 2, 1, 3});
+  TransposeRandomTest({2, 33, 9, 17}, {3, 1, 0, 2});
+  TransposeRandomTest({5, 1, 13, 6}, {2, 1, 3, 0});
+  TransposeRandomTest({1, 7, 1, 6}, {0, 2, 1, 3});
+  TransposeRandomTest({2, 3, 4, 5, 6}, {0, 3, 4, 1, 2});
+  TransposeRandomTest({2, 3, 4, 5, 6}, {4, 2, 0, 3, 1});
+  TransposeRandomTest({3, 2, 5, 4, 2, 3}, {5, 0, 4, 1, 3, 2});
+}
+
+#ifdef MACE_ENABLE_BFLOAT16
+namespace {
+// The float <-> BFloat16 transposes of the CPU BFloat16 flow must match the
+// float transpose converted element by element.
+void TransposeBFloat16Test(const std::vector<index_t> &input_shape,
+                           const std::vector<int> &dest_dims) {
+  utils::ThreadPool *thread_pool = &OpTestContext::Get()->GetRuntime(
+      RuntimeType::RT_CPU)->thread_pool();
+  std::vector<float> input;
+  GenerateRandomRealTypeData<float>(input_shape, &input, false);
+  const size_t size = input.size();
+  std::vector<BFloat16> bf16_input(input.begin(), input.end());
+  std::vector<float> bf16_input_float(bf16_input.begin(), bf16_input.end());
+
+  std::vector<float> expected(size);
+  std::vector<BFloat16> bf16_output(size);
+  ops::Transpose(thread_pool, input.data(), input_shape, dest_dims,
+                 expected.data());
+  ops::Transpose(thread_pool, input.data(), input_shape, dest_dims,
+                 bf16_output.data());
+  for (size_t i = 0; i < size; ++i) {
+    ASSERT_EQ(static_cast<float>(BFloat16(expected[i])),
+              static_cast<float>(bf16_output[i]));
+  }
+
+  std::vector<float> float_output(size);
+  ops::Transpose(thread_pool, bf16_input_float.data(), input_shape, dest_dims,
+                 expected.data());
+  ops::Transpose(thread_pool, bf16_input.data(), input_shape, dest_dims,
+                 float_output.data());
+  for (size_t i = 0; i < size; ++i) {
+    ASSERT_EQ(expected[i], float_output[i]);
+  }
+}
+}  // namespace
+
+TEST_F(TransposeOpTest, BFloat16Conversion) {
+  TransposeBFloat16Test({1000}, {0});
+  TransposeBFloat16Test({67, 45}, {1, 0});
+  TransposeBFloat16Test({3, 37, 70}, {2, 1, 0});
+  TransposeBFloat16Test({2, 33, 9, 17}, {0, 2, 1, 3});
+  TransposeBFloat16Test({1, 64, 48, 35}, {0, 2, 3, 1});
+}
+#endif  // MACE_ENABLE_BFLOAT16
+
 }  // namespace test
 }  // namespace ops
 }  // namespace mace
@@ -0,0 +1,95 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include "mace/core/ops/op_context.h"
+#include "mace/core/tensor.h"
+#include "mace/ops/delegator/conv_2d.h"
+#include "mace/ops/ops_test_util.h"
+#include "mace/ops/testing/test_utils.h"
+
+namespace mace {
+namespace ops {
+namespace test {
+
+template<typename T>
+void TestConv2d(const std::vector<index_t> &input_shape,
+                const index_t out_channels,
+                const int kernel,
+                const int stride,
+                const int dilation,
+                const Padding padding) {
+  auto *cpu_runtime = OpTestContext::Get()->GetRuntime(RuntimeType::RT_CPU);
+  const DataType dtype = DataTypeToEnum<T>::value;
+  Tensor input(cpu_runtime, dtype);
+  Tensor filter(cpu_runtime, dtype, MemoryType::CPU_BUFFER, {}, true);
+  Tensor output(cpu_runtime, dtype);
+  Tensor expected_output(cpu_runtime, dtype);
+  input.Resize(input_shape);
+  filter.Resize({out_channels, input_shape[1], kernel, kernel});
+  {
+    Tensor::MappingGuard input_guard(&input);
+    Tensor::MappingGuard filter_guard(&filter);
+    GenerateRandomRealTypeData<T>(input.shape(), input.mutable_data<T>());
+    GenerateRandomRealTypeData<T>(filter.shape(), filter.mutable_data<T>());
+  }
+
+  OpsTestNet net;
+  OpContext context(net.ws(), cpu_runtime);
+  const std::vector<int> strides = {stride, stride};
+  const std::vector<int> dilations = {dilation, dilation};
+  const std::vector<int> paddings;
+  delegator::Conv2dParam param(strides, dilations, paddings, padding);
+  std::unique_ptr<delegator::Conv2d> conv2d = delegator::Conv2d::Create(
+      context.workspace(),
+      MACE_DELEGATOR_KEY(Conv2d, RuntimeType::RT_CPU, T, ImplType::X86),
+      param);
+  std::unique_ptr<delegator::Conv2d> conv2d_ref = delegator::Conv2d::Create(
+      context.workspace(),
+      MACE_DELEGATOR_KEY(Conv2d, RuntimeType::RT_CPU, T, ImplType::REF),
+      param);
+  conv2d->Compute(&context, &input, &filter, &output);
+  conv2d_ref->Compute(&context, &input, &filter, &expected_output);
+
+  ExpectTensorSimilar<T>(expected_output, output, 1e-4);
+}
+
+template<typename T>
+void TestConv2dShapes() {
+  for (int kernel : {1, 3, 5}) {
+    for (int stride : {1, 2}) {
+      TestConv2d<T>({1, 16, 17, 19}, 24, kernel, stride, 1, SAME);
+      TestConv2d<T>({2, 5, 16, 35}, 9, kernel, stride, 1, VALID);
+    }
+  }
+  TestConv2d<T>({1, 8, 20, 20}, 13, 3, 1, 2, SAME);
+  TestConv2d<T>({1, 3, 9, 11}, 7, 7, 3, 1, SAME);
+  TestConv2d<T>({1, 32, 8, 64}, 64, 1, 1, 1, VALID);
+}
+
+TEST(X86Conv2d, TestFloat) {
+  TestConv2dShapes<float>();
+}
+
+#ifdef MACE_ENABLE_BFLOAT16
+TEST(X86Conv2d, TestBFloat16) {
+  TestConv2dShapes<BFloat16>();
+}
+#endif  // MACE_ENABLE_BFLOAT16
+
+}  // namespace test
+}  // namespace ops
+}  // namespace mace
@@ -0,0 +1,171 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "mace/core/ops/op_context.h"
+#include "mace/core/tensor.h"
+#include "mace/ops/common/eltwise_type.h"
+#include "mace/ops/common/pooling_type.h"
+#include "mace/ops/delegator/depthwise_conv_2d.h"
+#include "mace/ops/ops_test_util.h"
+#include "mace/ops/testing/test_utils.h"
+
+namespace mace {
+namespace ops {
+namespace test {
+
+void TestDepthwiseConv2dNCHWc(const std::vector<index_t> &input_shape,
+                              const int kernel,
+                              const int stride,
+                              const int dilation,
+                              const Padding padding) {
+  auto *cpu_runtime = OpTestContext::Get()->GetRuntime(RuntimeType::RT_CPU);
+  Tensor input(cpu_runtime, DataType::DT_FLOAT);
+  Tensor filter(cpu_runtime, DataType::DT_FLOAT, MemoryType::CPU_BUFFER, {},
+                true);
+  Tensor output(cpu_runtime, DataType::DT_FLOAT);
+  Tensor expected_output(cpu_runtime, DataType::DT_FLOAT);
+  input.Resize(input_shape);
+  filter.Resize({1, input_shape[1], kernel, kernel});
+  {
+    Tensor::MappingGuard input_guard(&input);
+    Tensor::MappingGuard filter_guard(&filter);
+    GenerateRandomRealTypeData<float>(input.shape(),
+                                      input.mutable_data<float>());
+    GenerateRandomRealTypeData<float>(filter.shape(),
+                                      filter.mutable_data<float>());
+  }
+
+  OpsTestNet net;
+  OpContext context(net.ws(), cpu_runtime);
+  const std::vector<int> strides = {stride, stride};
+  const std::vector<int> dilations = {dilation, dilation};
+  const std::vector<int> paddings;
+  delegator::DepthwiseConv2dParam param(strides, dilations, paddings, padding);
+  std::unique_ptr<delegator::DepthwiseConv2d> depthwise_conv2d =
+      delegator::DepthwiseConv2d::Create(
+          context.workspace(),
+          MACE_DELEGATOR_KEY(DepthwiseConv2d, RuntimeType::RT_CPU, float,
+                             ImplType::X86),
+          param);
+  std::unique_ptr<delegator::DepthwiseConv2d> depthwise_conv2d_ref =
+      delegator::DepthwiseConv2d::Create(
+          context.workspace(),
+          MACE_DELEGATOR_KEY(DepthwiseConv2d, RuntimeType::RT_CPU, float,
+                             ImplType::REF),
+          param);
+  depthwise_conv2d->Compute(&context, &input, &filter, &output);
+  depthwise_conv2d_ref->Compute(&context, &input, &filter, &expected_output);
+
+  ExpectTensorNear<float>(expected_output, output, 1e-5, 1e-4);
+}
+
+TEST(X86DepthwiseConv2d, TestNCHWc) {
+  for (int kernel : {3, 5}) {
+    for (int stride : {1, 2}) {
+      TestDepthwiseConv2dNCHWc({1, 32, 17, 19}, kernel, stride, 1, SAME);
+      TestDepthwiseConv2dNCHWc({2, 13, 16, 15}, kernel, stride, 1, VALID);
+    }
+  }
+  TestDepthwiseConv2dNCHWc({1, 24, 20, 20}, 3, 1, 2, SAME);
+  TestDepthwiseConv2dNCHWc({1, 7, 9, 11}, 7, 3, 1, SAME);
+  TestDepthwiseConv2dNCHWc({1, 40, 8, 8}, 1, 1, 1, VALID);
+}
+
+// The ops run in NCHWc only if the output shapes are known.
+void TestNCHWcNet(const std::vector<index_t> &input_shape) {
+  const index_t batch = input_shape[0];
+  const index_t channels = input_shape[1];
+  const index_t height = input_shape[2];
+  const index_t width = input_shape[3];
+  const std::vector<index_t> conv_shape = {batch, height, width, channels};
+  const std::vector<index_t> pool_shape = {batch, height / 2, width / 2,
+                                           channels};
+  std::vector<float> input_data, filter_data, bias_data;
+  GenerateRandomRealTypeData<float>(input_shape, &input_data);
+  GenerateRandomRealTypeData<float>({1, channels, 3, 3}, &filter_data);
+  GenerateRandomRealTypeData<float>({channels}, &bias_data);
+
+  std::vector<float> expected_data;
+  for (bool blocked : {false, true}) {
+    OpsTestNet net;
+    net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+        "Input", input_shape, input_data);
+    net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+        "Filter", {1, channels, 3, 3}, filter_data, true);
+    net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+        "Bias", {channels}, bias_data, true);
+    auto add_op = [&net, blocked](OpDefBuilder builder,
+                                  const std::vector<index_t> &shape) {
+      if (blocked) {
+        builder.OutputShape(shape);
+      }
+      builder.AddIntArg("has_data_format", 1)
+          .Finalize(net.AddNewOperatorDef());
+    };
+    add_op(OpDefBuilder("DepthwiseConv2d", "DepthwiseConv2dTest")
+               .Input("Input")
+               .Input("Filter")
+               .Input("Bias")
+               .Output("Conv")
+               .AddIntsArg("strides", {1, 1})
+               .AddIntArg("padding", Padding::SAME)
+               .AddIntsArg("dilations", {1, 1}), conv_shape);
+    add_op(OpDefBuilder("Activation", "ActivationTest")
+               .Input("Conv")
+               .Output("Relu")
+               .AddStringArg("activation", "RELU"), conv_shape);
+    add_op(OpDefBuilder("Pooling", "PoolingTest")
+               .Input("Relu")
+               .Output("Pool")
+               .AddIntsArg("kernels", {2, 2})
+               .AddIntsArg("strides", {2, 2})
+               .AddIntArg("padding", Padding::VALID)
+               .AddIntsArg("dilations", {1, 1})
+               .AddIntArg("pooling_type", PoolingType::AVG), pool_shape);
+    add_op(OpDefBuilder("Eltwise", "EltwiseTest")
+               .Input("Pool")
+               .Input("Pool")
+               .Output("Output")
+               .AddIntArg("type", static_cast<int>(EltwiseType::PROD)),
+           pool_shape);
+    net.RunOp(RuntimeType::RT_CPU);
+
+    const DataFormat data_format =
+        blocked ? DataFormat::NCHWc : DataFormat::NCHW;
+    EXPECT_EQ(data_format, net.ws()->GetTensor("Conv")->data_format());
+    EXPECT_EQ(data_format, net.ws()->GetTensor("Pool")->data_format());
+    auto output = net.GetOutput("Output");
+    EXPECT_EQ(DataFormat::NCHW, output->data_format());
+    Tensor::MappingGuard output_guard(output);
+    if (!blocked) {
+      expected_data.assign(output->data<float>(),
+                           output->data<float>() + output->size());
+    } else {
+      auto expected_output =
+          net.CreateTensor<float>(output->shape(), expected_data);
+      ExpectTensorNear<float>(*expected_output, *output, 1e-5, 1e-4);
+    }
+  }
+}
+
+TEST(X86DepthwiseConv2d, TestNCHWcNet) {
+  TestNCHWcNet({1, 32, 16, 16});
+  TestNCHWcNet({2, 13, 10, 14});
+}
+
+}  // namespace test
+}  // namespace ops
+}  // namespace mace
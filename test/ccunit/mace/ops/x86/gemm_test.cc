@@ -0,0 +1,104 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include "mace/core/ops/op_context.h"
+#include "mace/core/tensor.h"
+#include "mace/ops/delegator/gemm.h"
+#include "mace/ops/ops_test_util.h"
+#include "mace/ops/testing/test_utils.h"
+
+namespace mace {
+namespace ops {
+namespace test {
+
+template<typename T>
+void TestGemm(const index_t batch,
+              const index_t rows,
+              const index_t cols,
+              const index_t depth,
+              const MatrixMajor lhs_major,
+              const MatrixMajor rhs_major,
+              const MatrixMajor output_major,
+              const bool lhs_batched,
+              const bool rhs_batched) {
+  auto *cpu_runtime = OpTestContext::Get()->GetRuntime(RuntimeType::RT_CPU);
+  const DataType dtype = DataTypeToEnum<T>::value;
+  Tensor lhs(cpu_runtime, dtype);
+  Tensor rhs(cpu_runtime, dtype);
+  Tensor output(cpu_runtime, dtype);
+  Tensor expected_output(cpu_runtime, dtype);
+  lhs.Resize({lhs_batched ? batch : 1, rows, depth});
+  rhs.Resize({rhs_batched ? batch : 1, depth, cols});
+  output.Resize({batch, rows, cols});
+  expected_output.Resize({batch, rows, cols});
+  {
+    Tensor::MappingGuard lhs_guard(&lhs);
+    Tensor::MappingGuard rhs_guard(&rhs);
+    GenerateRandomRealTypeData<T>(lhs.shape(), lhs.mutable_data<T>());
+    GenerateRandomRealTypeData<T>(rhs.shape(), rhs.mutable_data<T>());
+  }
+
+  OpsTestNet net;
+  OpContext context(net.ws(), cpu_runtime);
+  std::unique_ptr<delegator::Gemm> gemm = delegator::Gemm::Create(
+      context.workspace(),
+      MACE_DELEGATOR_KEY(Gemm, RuntimeType::RT_CPU, T, ImplType::X86),
+      delegator::GemmParam());
+  std::unique_ptr<delegator::Gemm> gemm_ref = delegator::Gemm::Create(
+      context.workspace(),
+      MACE_DELEGATOR_KEY(Gemm, RuntimeType::RT_CPU, T, ImplType::REF),
+      delegator::GemmParam());
+  gemm->Compute(&context, &lhs, &rhs, batch, rows, cols, depth, lhs_major,
+                rhs_major, output_major, lhs_batched, rhs_batched, &output);
+  gemm_ref->Compute(&context, &lhs, &rhs, batch, rows, cols, depth, lhs_major,
+                    rhs_major, output_major, lhs_batched, rhs_batched,
+                    &expected_output);
+
+  ExpectTensorSimilar<T>(expected_output, output, 1e-4);
+}
+
+template<typename T>
+void TestGemmMajors() {
+  for (MatrixMajor lhs_major : {RowMajor, ColMajor}) {
+    for (MatrixMajor rhs_major : {RowMajor, ColMajor}) {
+      for (MatrixMajor output_major : {RowMajor, ColMajor}) {
+        TestGemm<T>(1, 47, 69, 37, lhs_major, rhs_major, output_major,
+                    true, true);
+        TestGemm<T>(3, 47, 69, 37, lhs_major, rhs_major, output_major,
+                    true, true);
+      }
+    }
+  }
+  TestGemm<T>(3, 47, 69, 37, RowMajor, RowMajor, RowMajor, true, false);
+  TestGemm<T>(3, 47, 69, 37, RowMajor, RowMajor, RowMajor, false, true);
+  TestGemm<T>(2, 64, 128, 96, RowMajor, RowMajor, RowMajor, true, true);
+  TestGemm<T>(16, 31, 61, 67, RowMajor, ColMajor, RowMajor, true, true);
+}
+
+TEST(X86Gemm, TestFloat) {
+  TestGemmMajors<float>();
+}
+
+#ifdef MACE_ENABLE_BFLOAT16
+TEST(X86Gemm, TestBFloat16) {
+  TestGemmMajors<BFloat16>();
+}
+#endif  // MACE_ENABLE_BFLOAT16
+
+}  // namespace test
+}  // namespace ops
+}  // namespace mace
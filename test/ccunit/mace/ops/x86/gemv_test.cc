@@ -0,0 +1,192 @@
+// Copyright 2020 The MACE Authors. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "mace/core/ops/op_context.h"
+#include "mace/core/tensor.h"
+#include "mace/ops/delegator/gemv.h"
+#include "mace/ops/ops_test_util.h"
+#include "mace/ops/testing/test_utils.h"
+
+namespace mace {
+namespace ops {
+namespace test {
+
+void TestGemv(const index_t batch,
+              const index_t height,
+              const index_t width,
+              const bool lhs_batched,
+              const DataType lhs_dtype) {
+  auto *cpu_runtime = OpTestContext::Get()->GetRuntime(RuntimeType::RT_CPU);
+  const index_t lhs_batch = lhs_batched ? batch : 1;
+  Tensor lhs(cpu_runtime, DataType::DT_FLOAT);
+  Tensor lhs_x86(cpu_runtime, lhs_dtype);
+  Tensor rhs(cpu_runtime, DataType::DT_FLOAT);
+  Tensor bias(cpu_runtime, DataType::DT_FLOAT);
+  Tensor output(cpu_runtime, DataType::DT_FLOAT);
+  Tensor expected_output(cpu_runtime, DataType::DT_FLOAT);
+  lhs.Resize({lhs_batch, height, width});
+  lhs_x86.Resize({lhs_batch, height, width});
+  rhs.Resize({batch, width});
+  bias.Resize({height});
+  {
+    Tensor::MappingGuard lhs_guard(&lhs);
+    Tensor::MappingGuard lhs_x86_guard(&lhs_x86);
+    Tensor::MappingGuard rhs_guard(&rhs);
+    Tensor::MappingGuard bias_guard(&bias);
+    float *lhs_data = lhs.mutable_data<float>();
+    GenerateRandomRealTypeData<float>(lhs.shape(), lhs_data);
+    GenerateRandomRealTypeData<float>(rhs.shape(), rhs.mutable_data<float>());
+    GenerateRandomRealTypeData<float>(bias.shape(),
+                                      bias.mutable_data<float>());
+    for (index_t i = 0; i < lhs.size(); ++i) {
+      if (lhs_dtype == DT_HALF) {
+        half v = half_float::half_cast<half>(lhs_data[i]);
+        lhs_x86.mutable_data<half>()[i] = v;
+        lhs_data[i] = half_float::half_cast<float>(v);
+      } else {
+        lhs_x86.mutable_data<float>()[i] = lhs_data[i];
+      }
+    }
+  }
+
+  OpsTestNet net;
+  OpContext context(net.ws(), cpu_runtime);
+  std::unique_ptr<delegator::Gemv> gemv = delegator::Gemv::Create(
+      context.workspace(),
+      MACE_DELEGATOR_KEY(Gemv, RuntimeType::RT_CPU, float, ImplType::X86),
+      DelegatorParam());
+  std::unique_ptr<delegator::Gemv> gemv_ref = delegator::Gemv::Create(
+      context.workspace(),
+      MACE_DELEGATOR_KEY(Gemv, RuntimeType::RT_CPU, float, ImplType::REF),
+      DelegatorParam());
+  output.Resize({batch, height});
+  expected_output.Resize({batch, height});
+  gemv->Compute(&context, &lhs_x86, &rhs, &bias, batch, height, width,
+                lhs_batched, true, &output);
+  gemv_ref->Compute(&context, &lhs, &rhs, &bias, batch, height, width,
+                    lhs_batched, true, &expected_output);
+
+  ExpectTensorNear<float>(expected_output, output, 1e-4, 1e-3);
+}
+
+TEST(X86Gemv, TestFloat) {
+  for (index_t batch : {1, 3, 4, 9}) {
+    TestGemv(batch, 17, 61, false, DT_FLOAT);
+    TestGemv(batch, 32, 256, false, DT_FLOAT);
+    TestGemv(batch, 7, 5, true, DT_FLOAT);
+  }
+}
+
+#ifdef MACE_ENABLE_BFLOAT16
+void TestGemvBFloat16(const index_t batch,
+                      const index_t height,
+                      const index_t width,
+                      const bool lhs_batched) {
+  auto *cpu_runtime = OpTestContext::Get()->GetRuntime(RuntimeType::RT_CPU);
+  Tensor lhs(cpu_runtime, DT_BFLOAT16);
+  Tensor rhs(cpu_runtime, DT_BFLOAT16);
+  Tensor bias(cpu_runtime, DT_BFLOAT16);
+  Tensor output(cpu_runtime, DT_BFLOAT16);
+  Tensor expected_output(cpu_runtime, DT_BFLOAT16);
+  lhs.Resize({lhs_batched ? batch : 1, height, width});
+  rhs.Resize({batch, width});
+  bias.Resize({height});
+  output.Resize({batch, height});
+  expected_output.Resize({batch, height});
+  {
+    Tensor::MappingGuard lhs_guard(&lhs);
+    Tensor::MappingGuard rhs_guard(&rhs);
+    Tensor::MappingGuard bias_guard(&bias);
+    GenerateRandomRealTypeData<BFloat16>(lhs.shape(),
+                                         lhs.mutable_data<BFloat16>());
+    GenerateRandomRealTypeData<BFloat16>(rhs.shape(),
+                                         rhs.mutable_data<BFloat16>());
+    GenerateRandomRealTypeData<BFloat16>(bias.shape(),
+                                         bias.mutable_data<BFloat16>());
+  }
+
+  OpsTestNet net;
+  OpContext context(net.ws(), cpu_runtime);
+  std::unique_ptr<delegator::Gemv> gemv = delegator::Gemv::Create(
+      context.workspace(),
+      MACE_DELEGATOR_KEY(Gemv, RuntimeType::RT_CPU, BFloat16, ImplType::X86),
+      DelegatorParam());
+  std::unique_ptr<delegator::Gemv> gemv_ref = delegator::Gemv::Create(
+      context.workspace(),
+      MACE_DELEGATOR_KEY(Gemv, RuntimeType::RT_CPU, BFloat16, ImplType::REF),
+      DelegatorParam());
+  gemv->Compute(&context, &lhs, &rhs, &bias, batch, height, width,
+                lhs_batched, true, &output);
+  gemv_ref->Compute(&context, &lhs, &rhs, &bias, batch, height, width,
+                    lhs_batched, true, &expected_output);
+
+  ExpectTensorSimilar<BFloat16>(expected_output, output, 1e-4);
+}
+
+TEST(X86Gemv, TestBFloat16) {
+  for (index_t batch : {1, 3, 4, 9}) {
+    TestGemvBFloat16(batch, 17, 61, false);
+    TestGemvBFloat16(batch, 32, 256, false);
+    TestGemvBFloat16(batch, 7, 5, true);
+  }
+}
+#endif  // MACE_ENABLE_BFLOAT16
+
+#ifdef MACE_ENABLE_X86_HALF_WEIGHTS
+TEST(X86Gemv, TestHalfWeights) {
+  for (index_t batch : {1, 3, 4, 9}) {
+    TestGemv(batch, 17, 61, false, DT_HALF);
+    TestGemv(batch, 32, 256, false, DT_HALF);
+    TestGemv(batch, 7, 5, true, DT_HALF);
+  }
+}
+
+TEST(X86Gemv, TestFullyConnectedHalfWeights) {
+  OpsTestNet net;
+  const std::vector<index_t> weight_shape = {10, 3, 4, 5};
+  std::vector<half> weight(10 * 3 * 4 * 5);
+  std::vector<float> weight_float(weight.size());
+  for (size_t i = 0; i < weight.size(); ++i) {
+    weight[i] = half_float::half_cast<half>(
+        static_cast<float>(i % 13) * 0.125f - 0.75f);
+    weight_float[i] = half_float::half_cast<float>(weight[i]);
+  }
+  net.AddRandomInput<RuntimeType::RT_CPU, float>("Input", {6, 3, 4, 5});
+  net.AddInputFromArray<RuntimeType::RT_CPU, half>(
+      "Weight", weight_shape, weight, true);
+  net.AddInputFromArray<RuntimeType::RT_CPU, float>(
+      "WeightFloat", weight_shape, weight_float, true);
+  net.AddRandomInput<RuntimeType::RT_CPU, float>("Bias", {10}, true);
+
+  for (auto weight_name : {"Weight", "WeightFloat"}) {
+    OpDefBuilder("FullyConnected", "FullyConnectedTest")
+        .Input("Input")
+        .Input(weight_name)
+        .Input("Bias")
+        .Output(std::string("Output") + weight_name)
+        .AddIntArg("T", static_cast<int>(DT_FLOAT))
+        .Finalize(net.NewOperatorDef());
+    net.RunOp(RuntimeType::RT_CPU);
+  }
+
+  ExpectTensorNear<float>(*net.GetOutput("OutputWeightFloat"),
+                          *net.GetOutput("OutputWeight"), 1e-4, 1e-3);
+}
+#endif  // MACE_ENABLE_X86_HALF_WEIGHTS
+
+}  // namespace test
+}  // namespace ops
+}  // namespace mace
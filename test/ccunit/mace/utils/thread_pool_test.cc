@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 #include <cstdlib>
 #include <vector>
+#include "mace/port/env.h"
 #include "mace/utils/thread_pool.h"
 
 namespace mace {
@@ -105,6 +106,31 @@ TEST_F(ThreadPoolTest, Compute3D) {
   }
 }
 
+TEST(NumaNodeTest, GetNumaNodeCoresToUse) {
+  std::vector<std::vector<size_t>> node_cpus;
+  if (port::Env::Default()->GetNumaNodeCPUs(&node_cpus)
+      != MaceStatus::MACE_SUCCESS || node_cpus.empty()
+      || node_cpus[0].empty()) {
+    return;  // no NUMA information on this system
+  }
+  int thread_count = -1;
+  std::vector<size_t> cores;
+  EXPECT_EQ(GetNumaNodeCoresToUse(0, &thread_count, &cores),
+            MaceStatus::MACE_SUCCESS);
+  EXPECT_EQ(node_cpus[0], cores);
+  EXPECT_EQ(static_cast<int>(cores.size()), thread_count);
+
+  thread_count = 1;
+  EXPECT_EQ(GetNumaNodeCoresToUse(0, &thread_count, &cores),
+            MaceStatus::MACE_SUCCESS);
+  EXPECT_EQ(1, thread_count);
+  EXPECT_EQ(std::vector<size_t>({node_cpus[0][0]}), cores);
+
+  EXPECT_NE(GetNumaNodeCoresToUse(static_cast<int>(node_cpus.size()),
+                                  &thread_count, &cores),
+            MaceStatus::MACE_SUCCESS);
+}
+
 }  // namespace
 }  // namespace utils
 }  // namespace mace
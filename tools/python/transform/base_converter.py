@@ -176,6 +176,7 @@ MaceSupportedOps = [
     'SumGroup',
     'TargetRMSNorm',
     'Tile',
+    'TopK',
     'Transpose',
     'DetectionOutput',
     'Where',
@@ -134,6 +134,7 @@ TFSupportedOps = [
     'Sum',
     'Tanh',
     'Tile',
+    'TopKV2',
     'Transpose',
     'Unpack',
     'Unstack',
@@ -302,6 +303,7 @@ class TensorflowConverter(base_converter.ConverterInterface):
             TFOpType.StridedSlice.name: self.convert_stridedslice,
             TFOpType.Sum.name: self.convert_reduce,
             TFOpType.Tile.name: self.convert_tile,
+            TFOpType.TopKV2.name: self.convert_topk,
             TFOpType.Transpose.name: self.convert_transpose,
             TFOpType.Unpack.name: self.convert_unstack,
             TFOpType.Unstack.name: self.convert_unstack,
@@ -1167,6 +1169,12 @@ class TensorflowConverter(base_converter.ConverterInterface):
         op = self.convert_general_op(tf_op)
         op.type = MaceOp.Tile.name
 
+    def convert_topk(self, tf_op):
+        op = self.convert_general_op(tf_op)
+        op.type = MaceOp.TopK.name
+        data_type = ConverterUtil.get_arg(op, 'T').i
+        op.output_type.extend([data_type, mace_pb2.DT_INT32])
+
     def convert_fake_quantize(self, tf_op):
         op = self.convert_general_op(tf_op)
         min_arg = op.arg.add()